@@ -142,6 +142,9 @@ enum IOCtlNumber {
     VIRGL_IOCTL_TRANSFER_DATA,
     KDSETMODE,
     KDGETMODE,
+    PERF_EVENTS_IOCTL_START_STREAMING,
+    PERF_EVENTS_IOCTL_STOP_STREAMING,
+    PERF_EVENTS_IOCTL_GET_RING_INFO,
 };
 
 #define TIOCGPGRP TIOCGPGRP
@@ -200,3 +203,6 @@ enum IOCtlNumber {
 #define VIRGL_IOCTL_TRANSFER_DATA VIRGL_IOCTL_TRANSFER_DATA
 #define KDSETMODE KDSETMODE
 #define KDGETMODE KDGETMODE
+#define PERF_EVENTS_IOCTL_START_STREAMING PERF_EVENTS_IOCTL_START_STREAMING
+#define PERF_EVENTS_IOCTL_STOP_STREAMING PERF_EVENTS_IOCTL_STOP_STREAMING
+#define PERF_EVENTS_IOCTL_GET_RING_INFO PERF_EVENTS_IOCTL_GET_RING_INFO
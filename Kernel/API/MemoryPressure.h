@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// /dev/memory_pressure becomes readable whenever the system's memory pressure level has changed
+// since the last read on the same description (the first read never blocks). Each read returns a
+// single MemoryPressureEvent describing the current level.
+//
+// Processes that keep caches of their own are expected to shrink them when the level rises, so the
+// kernel doesn't have to start failing allocations.
+
+enum MemoryPressureLevel : u32 {
+    MEMORY_PRESSURE_NORMAL = 0,
+    MEMORY_PRESSURE_LOW = 1,      // Below the low watermark; the kernel is reclaiming its own caches.
+    MEMORY_PRESSURE_CRITICAL = 2, // Below the min watermark; allocations are about to fail.
+};
+
+struct MemoryPressureEvent {
+    u32 level;
+    u32 reserved;
+    u64 sequence; // Bumped every time the level changes.
+    u64 uncommitted_pages;
+    u64 total_pages;
+};
@@ -51,6 +51,11 @@ extern "C" {
 #define AT_REMOVEDIR 0x200
 #define AT_EACCESS 0x400
 
+#define SPLICE_F_MOVE (1 << 0)
+#define SPLICE_F_NONBLOCK (1 << 1)
+#define SPLICE_F_MORE (1 << 2)
+#define SPLICE_F_GIFT (1 << 3)
+
 struct flock {
     short l_type;
     short l_whence;
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/API/POSIX/fcntl.h>
+#include <Kernel/API/POSIX/sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IO_RING_CLOEXEC O_CLOEXEC
+
+#define IO_RING_MAX_ENTRIES 4096
+
+enum {
+    IO_RING_OP_NOP = 0,
+    IO_RING_OP_READ,
+    IO_RING_OP_WRITE,
+    IO_RING_OP_FSYNC,
+    IO_RING_OP_ACCEPT,
+    IO_RING_OP_CONNECT,
+    IO_RING_OP_SEND,
+    IO_RING_OP_RECV,
+    IO_RING_OP_POLL_ADD,
+};
+
+// A request to perform one operation. Which fields are used depends on the opcode:
+//   READ, WRITE: fd, address and length of the buffer, and offset (-1 to use and advance the file offset)
+//   FSYNC:       fd
+//   ACCEPT:      fd, address of a sockaddr and address_length of a socklen_t for the peer (both may be 0),
+//                and SOCK_NONBLOCK / SOCK_CLOEXEC in op_flags. The result is the new fd.
+//   CONNECT:     fd, address and length of the sockaddr to connect to
+//   SEND, RECV:  fd, address and length of the buffer, and MSG_* flags in op_flags
+//   POLL_ADD:    fd and the POLL* events to wait for in op_flags. The result is the events that happened.
+// user_data is passed back unchanged in the completion.
+struct io_ring_sqe {
+    uint8_t opcode;
+    uint8_t reserved[3];
+    int32_t fd;
+    int64_t offset;
+    uint64_t address;
+    uint64_t address_length;
+    uint32_t length;
+    uint32_t op_flags;
+    uint64_t user_data;
+};
+
+// The outcome of one operation. result is what the equivalent system call would have returned,
+// with errors reported as negative errno values.
+struct io_ring_cqe {
+    uint64_t user_data;
+    int32_t result;
+    uint32_t flags;
+};
+
+// The header at the start of the shared ring memory. Each index only ever increases (and wraps
+// around); the slot it refers to is the index modulo the number of entries in its queue.
+struct io_ring_header {
+    uint32_t sq_head; // Advanced by the kernel once it has taken submissions from the queue.
+    uint32_t sq_tail; // Advanced by the process after it has put submissions into the queue.
+    uint32_t cq_head; // Advanced by the process after it has looked at completions.
+    uint32_t cq_tail; // Advanced by the kernel after it has put completions into the queue.
+};
+
+struct io_ring_params {
+    uint32_t sq_entries;   // In: the requested number of submission queue entries. Out: the actual number.
+    uint32_t cq_entries;   // Out: the number of completion queue entries.
+    uint32_t flags;        // In: IO_RING_CLOEXEC.
+    uint32_t sqes_offset;  // Out: where the io_ring_sqe array starts in the ring memory.
+    uint32_t cqes_offset;  // Out: where the io_ring_cqe array starts in the ring memory.
+    uint32_t mapping_size; // Out: how much to mmap() from the ring fd, with MAP_SHARED.
+};
+
+#ifdef __cplusplus
+}
+#endif
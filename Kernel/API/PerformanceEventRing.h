@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// While the whole system is being profiled in streaming mode, every processor writes its performance
+// events into a ring of its own. The rings are mapped from /dev/perf_events: the ring of processor N
+// starts at offset N * mapping_size, and must be mapped shared and writable.
+//
+// Each ring starts with a PerformanceEventRingHeader, followed by data_size bytes of records. The kernel
+// is the only writer and the process that maps the ring is the only reader, so neither has to lock.
+// head and tail count bytes since the ring was created and never wrap; a record at position P is found
+// at data_offset + (P % data_size).
+
+struct PerformanceEventRingInfo {
+    u32 ring_count;
+    u32 mapping_size;
+};
+
+struct PerformanceEventRingHeader {
+    u64 head;        // Advanced by the kernel after it has written records.
+    u64 tail;        // Advanced by the reader after it has consumed records.
+    u64 lost_events; // How many events the kernel had to drop because the ring was full.
+    u32 data_offset;
+    u32 data_size; // Always a power of two.
+    u32 processor_id;
+    u32 reserved;
+};
+
+// Records are aligned to 8 bytes, and never wrap around the end of the ring; if the next one doesn't
+// fit, the rest of the ring is filled with a padding record (whose type is 0), and it starts over at
+// the beginning.
+//
+// What the arguments mean depends on the type of the event:
+//   PERF_EVENT_MALLOC, PERF_EVENT_KMALLOC, PERF_EVENT_KFREE: arg1 is the size, arg2 the pointer
+//   PERF_EVENT_FREE:                                           arg1 is the pointer
+//   PERF_EVENT_MMAP, PERF_EVENT_MUNMAP:                        arg1 is the pointer, arg2 the size, name is the region name
+//   PERF_EVENT_PROCESS_CREATE:                                 arg1 is the parent PID, name is the executable
+//   PERF_EVENT_PROCESS_EXEC:                                   name is the executable
+//   PERF_EVENT_THREAD_CREATE:                                  arg1 is the parent TID
+//   PERF_EVENT_CONTEXT_SWITCH:                                 arg1 is the next PID, arg2 the next TID
+//   PERF_EVENT_SIGNPOST:                                       arg1 and arg2 are the signpost's arguments
+//   PERF_EVENT_READ:                                           arg1 is the fd, arg2 the size, arg3 the start timestamp,
+//                                                              arg4 whether it succeeded; the file name is one of the
+//                                                              strings in /sys/kernel/profile, with index arg5
+struct PerformanceEventRecord {
+    u32 size; // Of the whole record, including the stack and the name.
+    u32 type;
+    u32 pid;
+    u32 tid;
+    u64 timestamp; // In milliseconds since boot.
+    u32 lost_samples;
+    u16 stack_size;
+    u16 name_length;
+    u64 arg1;
+    u64 arg2;
+    u64 arg3;
+    u64 arg4;
+    u64 arg5;
+    // Followed by stack_size return addresses (u64), and name_length bytes of name.
+};
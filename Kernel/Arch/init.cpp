@@ -22,6 +22,7 @@
 #include <Kernel/Devices/Generic/DeviceControlDevice.h>
 #include <Kernel/Devices/Generic/FullDevice.h>
 #include <Kernel/Devices/Generic/MemoryDevice.h>
+#include <Kernel/Devices/Generic/MemoryPressureDevice.h>
 #include <Kernel/Devices/Generic/NullDevice.h>
 #include <Kernel/Devices/Generic/RandomDevice.h>
 #include <Kernel/Devices/Generic/SelfTTYDevice.h>
@@ -29,6 +30,7 @@
 #include <Kernel/Devices/HID/Management.h>
 #include <Kernel/Devices/KCOVDevice.h>
 #include <Kernel/Devices/PCISerialDevice.h>
+#include <Kernel/Devices/PerformanceEventsDevice.h>
 #include <Kernel/Devices/SerialDevice.h>
 #include <Kernel/Devices/Storage/StorageManagement.h>
 #include <Kernel/FileSystem/SysFS/Registry.h>
@@ -49,6 +51,7 @@
 #include <Kernel/TTY/PTYMultiplexer.h>
 #include <Kernel/TTY/VirtualConsole.h>
 #include <Kernel/Tasks/FinalizerTask.h>
+#include <Kernel/Tasks/MemoryReclaimTask.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
 #include <Kernel/Tasks/SyncTask.h>
@@ -384,6 +387,7 @@ void init_stage2(void*)
     ConsoleManagement::the().initialize();
 
     SyncTask::spawn();
+    MemoryReclaimTask::spawn();
     FinalizerTask::spawn();
 
     auto boot_profiling = kernel_command_line().is_boot_profiling_enabled();
@@ -403,10 +407,12 @@ void init_stage2(void*)
     (void)KCOVDevice::must_create().leak_ref();
 #endif
     (void)MemoryDevice::must_create().leak_ref();
+    (void)MemoryPressureDevice::must_create().leak_ref();
     (void)ZeroDevice::must_create().leak_ref();
     (void)FullDevice::must_create().leak_ref();
     (void)RandomDevice::must_create().leak_ref();
     (void)SelfTTYDevice::must_create().leak_ref();
+    (void)PerformanceEventsDevice::must_create().leak_ref();
     PTYMultiplexer::initialize();
 
     AudioManagement::the().initialize();
@@ -4,8 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BuiltinWrappers.h>
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/DeviceIdentifiers/BlockDevicesDirectory.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
@@ -17,16 +20,48 @@ AsyncBlockDeviceRequest::AsyncBlockDeviceRequest(Device& block_device, RequestTy
     , m_block_count(block_count)
     , m_buffer(buffer)
     , m_buffer_size(buffer_size)
+    , m_submitting_processor_id(Processor::current_id())
 {
 }
 
 void AsyncBlockDeviceRequest::start()
 {
+    m_start_time = TimeManagement::the().monotonic_time(TimePrecision::Precise);
     m_block_device.start_request(*this);
 }
 
 BlockDevice::~BlockDevice() = default;
 
+void BlockDevice::RequestLatencyHistogram::record(u64 microseconds)
+{
+    size_t bucket = microseconds == 0 ? 0 : sizeof(u64) * 8 - count_leading_zeroes(microseconds);
+    ++buckets[min(bucket, bucket_count - 1)];
+    ++request_count;
+    total_microseconds += microseconds;
+    max_microseconds = max(max_microseconds, microseconds);
+}
+
+void BlockDevice::did_complete_request(AsyncDeviceRequest const& request)
+{
+    auto const& block_request = static_cast<AsyncBlockDeviceRequest const&>(request);
+    auto start_time = block_request.start_time();
+    if (!start_time.has_value())
+        return;
+    auto latency = TimeManagement::the().monotonic_time(TimePrecision::Precise) - start_time.value();
+    u64 microseconds = max<i64>(0, latency.to_microseconds());
+    m_request_statistics.with([&](auto& statistics) {
+        if (block_request.request_type() == AsyncBlockDeviceRequest::Read)
+            statistics.reads.record(microseconds);
+        else
+            statistics.writes.record(microseconds);
+    });
+}
+
+BlockDevice::RequestStatistics BlockDevice::request_statistics() const
+{
+    return m_request_statistics.with([](auto& statistics) { return statistics; });
+}
+
 void BlockDevice::after_inserting_add_symlink_to_device_identifier_directory()
 {
     VERIFY(m_symlink_sysfs_component);
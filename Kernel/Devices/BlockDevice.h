@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/IntegralMath.h>
+#include <AK/Optional.h>
+#include <AK/Time.h>
 #include <Kernel/Devices/Device.h>
 #include <Kernel/Library/LockWeakable.h>
+#include <Kernel/Locking/SpinlockProtected.h>
 
 namespace Kernel {
 
@@ -27,6 +31,29 @@ public:
 
     virtual void start_request(AsyncBlockDeviceRequest&) = 0;
 
+    // The largest number of blocks a single request may cover.
+    virtual u32 max_blocks_per_request() const { return max<u32>(1, PAGE_SIZE >> m_block_size_log); }
+
+    struct RequestLatencyHistogram {
+        // Bucket N counts requests that took less than 2^N microseconds to complete,
+        // and the last bucket also counts everything slower than that.
+        static constexpr size_t bucket_count = 24;
+
+        Array<u64, bucket_count> buckets {};
+        u64 request_count { 0 };
+        u64 total_microseconds { 0 };
+        u64 max_microseconds { 0 };
+
+        void record(u64 microseconds);
+    };
+
+    struct RequestStatistics {
+        RequestLatencyHistogram reads;
+        RequestLatencyHistogram writes;
+    };
+
+    RequestStatistics request_statistics() const;
+
 protected:
     BlockDevice(MajorNumber major, MinorNumber minor, size_t block_size = PAGE_SIZE)
         : Device(major, minor)
@@ -41,6 +68,8 @@ protected:
 protected:
     virtual bool is_block_device() const final { return true; }
 
+    virtual void did_complete_request(AsyncDeviceRequest const&) override;
+
     virtual void after_inserting_add_symlink_to_device_identifier_directory() override final;
     virtual void before_will_be_destroyed_remove_symlink_from_device_identifier_directory() override final;
 
@@ -51,6 +80,8 @@ private:
 
     size_t m_block_size { 0 };
     u8 m_block_size_log { 0 };
+
+    SpinlockProtected<RequestStatistics, LockRank::None> m_request_statistics {};
 };
 
 class AsyncBlockDeviceRequest final : public AsyncDeviceRequest {
@@ -70,6 +101,10 @@ public:
     UserOrKernelBuffer const& buffer() const { return m_buffer; }
     size_t buffer_size() const { return m_buffer_size; }
 
+    // Drivers with several hardware queues should use the one belonging to this processor.
+    u32 submitting_processor_id() const { return m_submitting_processor_id; }
+    Optional<MonotonicTime> start_time() const { return m_start_time; }
+
     virtual void start() override;
     virtual StringView name() const override
     {
@@ -90,6 +125,8 @@ private:
     const u32 m_block_count;
     UserOrKernelBuffer m_buffer;
     const size_t m_buffer_size;
+    u32 const m_submitting_processor_id { 0 };
+    Optional<MonotonicTime> m_start_time;
 };
 
 }
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <Kernel/Devices/BlockRequestBatch.h>
+
+namespace Kernel {
+
+BlockRequestBatch::BlockRequestBatch(BlockDevice& device)
+    : m_device(device)
+{
+}
+
+ErrorOr<void> BlockRequestBatch::add(AsyncBlockDeviceRequest::RequestType type, u64 block_index, u32 block_count, UserOrKernelBuffer const& buffer)
+{
+    // Split up anything that is too big for a single request right away; the pieces can't be merged anyway.
+    auto max_blocks_per_request = m_device.max_blocks_per_request();
+    for (u32 offset = 0; offset < block_count; offset += max_blocks_per_request) {
+        auto count = min(block_count - offset, max_blocks_per_request);
+        TRY(m_segments.try_append({ type, block_index + offset, count, buffer.offset(static_cast<size_t>(offset) * m_device.block_size()) }));
+    }
+    return {};
+}
+
+ErrorOr<void> BlockRequestBatch::submit_and_wait()
+{
+    if (m_segments.is_empty())
+        return {};
+
+    quick_sort(m_segments, [](auto& a, auto& b) {
+        if (a.type != b.type)
+            return a.type < b.type;
+        return a.block_index < b.block_index;
+    });
+
+    auto block_size = m_device.block_size();
+    auto max_blocks_per_request = m_device.max_blocks_per_request();
+
+    Vector<MergedRequest, 16> requests;
+    for (size_t i = 0; i < m_segments.size(); ++i) {
+        auto& segment = m_segments[i];
+        if (!requests.is_empty()) {
+            auto& previous_request = requests.last();
+            auto& previous = m_segments[previous_request.first_segment + previous_request.segment_count - 1];
+            if (previous.type == segment.type
+                && previous.block_index + previous.block_count == segment.block_index
+                && previous_request.block_count + segment.block_count <= max_blocks_per_request) {
+                // Segments that continue right where the previous one ends in memory can share its buffer,
+                // all others have to go through a bounce buffer.
+                auto previous_end = static_cast<u8 const*>(previous.buffer.user_or_kernel_ptr()) + previous.block_count * block_size;
+                if (previous.buffer.is_kernel_buffer() != segment.buffer.is_kernel_buffer() || previous_end != segment.buffer.user_or_kernel_ptr())
+                    previous_request.needs_bounce_buffer = true;
+                ++previous_request.segment_count;
+                previous_request.block_count += segment.block_count;
+                continue;
+            }
+        }
+        TRY(requests.try_append({ i, 1, segment.block_count, false, {}, {} }));
+    }
+
+    ErrorOr<void> result {};
+    for (auto& request : requests) {
+        result = submit(request);
+        if (result.is_error())
+            break;
+    }
+
+    // NOTE: Requests that have been handed to the device may still access our buffers,
+    //       so we have to wait for all of them, even if some of them failed.
+    for (auto& request : requests) {
+        if (!request.request)
+            continue;
+        auto wait_result = wait_for(request);
+        if (!result.is_error() && wait_result.is_error())
+            result = wait_result.release_error();
+    }
+
+    m_segments.clear_with_capacity();
+    return result;
+}
+
+ErrorOr<void> BlockRequestBatch::submit(MergedRequest& merged_request)
+{
+    auto block_size = m_device.block_size();
+    auto& first_segment = m_segments[merged_request.first_segment];
+    auto buffer = first_segment.buffer;
+    auto buffer_size = static_cast<size_t>(merged_request.block_count) * block_size;
+
+    if (merged_request.needs_bounce_buffer) {
+        merged_request.bounce_buffer = TRY(KBuffer::try_create_with_size("BlockRequestBatch: Bounce buffer"sv, buffer_size));
+        buffer = UserOrKernelBuffer::for_kernel_buffer(merged_request.bounce_buffer->data());
+        if (first_segment.type == AsyncBlockDeviceRequest::Write) {
+            size_t offset = 0;
+            for (size_t i = 0; i < merged_request.segment_count; ++i) {
+                auto& segment = m_segments[merged_request.first_segment + i];
+                auto segment_size = static_cast<size_t>(segment.block_count) * block_size;
+                TRY(segment.buffer.read(merged_request.bounce_buffer->data() + offset, segment_size));
+                offset += segment_size;
+            }
+        }
+    }
+
+    merged_request.request = TRY(m_device.try_make_request<AsyncBlockDeviceRequest>(first_segment.type, first_segment.block_index, merged_request.block_count, buffer, buffer_size));
+    return {};
+}
+
+ErrorOr<void> BlockRequestBatch::wait_for(MergedRequest& merged_request)
+{
+    bool was_interrupted = false;
+    auto result = merged_request.request->wait();
+    while (result.wait_result().was_interrupted()) {
+        // The device may still be using our buffers, so we can't just leave.
+        was_interrupted = true;
+        result = merged_request.request->wait();
+    }
+
+    switch (result.request_result()) {
+    case AsyncDeviceRequest::Success:
+        break;
+    case AsyncDeviceRequest::MemoryFault:
+        return EFAULT;
+    default:
+        return EIO;
+    }
+    if (was_interrupted)
+        return EINTR;
+
+    if (merged_request.bounce_buffer && m_segments[merged_request.first_segment].type == AsyncBlockDeviceRequest::Read) {
+        size_t offset = 0;
+        for (size_t i = 0; i < merged_request.segment_count; ++i) {
+            auto& segment = m_segments[merged_request.first_segment + i];
+            auto segment_size = static_cast<size_t>(segment.block_count) * m_device.block_size();
+            TRY(segment.buffer.write(merged_request.bounce_buffer->data() + offset, segment_size));
+            offset += segment_size;
+        }
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Vector.h>
+#include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/Library/KBuffer.h>
+
+namespace Kernel {
+
+// Collects reads and writes of a block device instead of sending them off one at a time.
+// When the batch is submitted, requests for adjacent blocks are merged (up to the size the
+// device can handle in one go), and all of them are handed to the device at once, so that
+// devices with deep queues can work on them in parallel.
+//
+// NOTE: Requests within one batch may complete in any order, so callers must not add
+//       overlapping requests to the same batch.
+class BlockRequestBatch {
+    AK_MAKE_NONCOPYABLE(BlockRequestBatch);
+    AK_MAKE_NONMOVABLE(BlockRequestBatch);
+
+public:
+    explicit BlockRequestBatch(BlockDevice&);
+
+    ErrorOr<void> add(AsyncBlockDeviceRequest::RequestType, u64 block_index, u32 block_count, UserOrKernelBuffer const&);
+
+    // Waits until all requests in the batch have completed, even if some of them failed.
+    ErrorOr<void> submit_and_wait();
+
+    bool is_empty() const { return m_segments.is_empty(); }
+
+private:
+    struct Segment {
+        AsyncBlockDeviceRequest::RequestType type;
+        u64 block_index;
+        u32 block_count;
+        UserOrKernelBuffer buffer;
+    };
+
+    struct MergedRequest {
+        size_t first_segment { 0 };
+        size_t segment_count { 0 };
+        u32 block_count { 0 };
+        bool needs_bounce_buffer { false };
+        OwnPtr<KBuffer> bounce_buffer;
+        LockRefPtr<AsyncBlockDeviceRequest> request;
+    };
+
+    ErrorOr<void> submit(MergedRequest&);
+    ErrorOr<void> wait_for(MergedRequest&);
+
+    BlockDevice& m_device;
+    Vector<Segment, 16> m_segments;
+};
+
+}
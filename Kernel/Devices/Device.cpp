@@ -69,16 +69,39 @@ ErrorOr<NonnullRefPtr<OpenFileDescription>> Device::open(int options)
     return File::open(options);
 }
 
+void Device::start_queued_requests(SpinlockLocker<Spinlock<LockRank::None>>& lock)
+{
+    // Requests are started in the order they were queued, so the ones that have already been
+    // started are always at the front of the list.
+    while (m_started_request_count < max_outstanding_requests()) {
+        auto it = m_requests.begin();
+        for (size_t i = 0; i < m_started_request_count && it != m_requests.end(); ++i)
+            ++it;
+        if (it == m_requests.end())
+            return;
+
+        ++m_started_request_count;
+        auto request = *it;
+        request->do_start(move(lock));
+        if (!lock.have_lock())
+            lock.lock();
+    }
+}
+
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const& completed_request)
 {
+    did_complete_request(completed_request);
+
     SpinlockLocker lock(m_requests_lock);
-    VERIFY(!m_requests.is_empty());
-    VERIFY(m_requests.first().ptr() == &completed_request);
-    m_requests.remove(m_requests.begin());
-    if (!m_requests.is_empty()) {
-        auto* next_request = m_requests.first().ptr();
-        next_request->do_start(move(lock));
-    }
+    VERIFY(m_started_request_count > 0);
+    auto it = m_requests.begin();
+    while (it != m_requests.end() && it->ptr() != &completed_request)
+        ++it;
+    VERIFY(it != m_requests.end());
+    m_requests.remove(it);
+    --m_started_request_count;
+    start_queued_requests(lock);
+    lock.unlock();
 
     evaluate_block_conditions();
 }
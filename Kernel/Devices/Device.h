@@ -59,13 +59,14 @@ public:
     {
         auto request = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) AsyncRequestType(*this, forward<Args>(args)...)));
         SpinlockLocker lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
         TRY(m_requests.try_append(request));
-        if (was_empty)
-            request->do_start(move(lock));
+        start_queued_requests(lock);
         return request;
     }
 
+    // How many requests the device can work on at the same time.
+    virtual size_t max_outstanding_requests() const { return 1; }
+
 protected:
     Device(MajorNumber major, MinorNumber minor);
     void set_uid(UserID uid) { m_uid = uid; }
@@ -82,7 +83,11 @@ protected:
     virtual void after_inserting_add_to_device_identifier_directory() = 0;
     virtual void before_will_be_destroyed_remove_from_device_identifier_directory() = 0;
 
+    virtual void did_complete_request(AsyncDeviceRequest const&) { }
+
 private:
+    void start_queued_requests(SpinlockLocker<Spinlock<LockRank::None>>&);
+
     MajorNumber const m_major { 0 };
     MinorNumber const m_minor { 0 };
     UserID m_uid { 0 };
@@ -92,6 +97,7 @@ private:
 
     Spinlock<LockRank::None> m_requests_lock {};
     DoublyLinkedList<LockRefPtr<AsyncDeviceRequest>> m_requests;
+    size_t m_started_request_count { 0 };
 
 protected:
     // FIXME: This pointer will be eventually removed after all nodes in /sys/dev/block/ and
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/API/MemoryPressure.h>
+#include <Kernel/Devices/DeviceManagement.h>
+#include <Kernel/Devices/Generic/MemoryPressureDevice.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+// NOTE: The device is created once during boot and never goes away.
+static MemoryPressureDevice* s_the;
+
+struct MemoryPressureDeviceData : public OpenFileDescriptionData {
+    static constexpr u64 never_read = NumericLimits<u64>::max();
+    Atomic<u64> last_read_sequence { never_read };
+};
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<MemoryPressureDevice> MemoryPressureDevice::must_create()
+{
+    auto device_or_error = DeviceManagement::try_create_device<MemoryPressureDevice>();
+    // FIXME: Find a way to propagate errors
+    VERIFY(!device_or_error.is_error());
+    auto device = device_or_error.release_value();
+    s_the = device.ptr();
+    return device;
+}
+
+UNMAP_AFTER_INIT MemoryPressureDevice::MemoryPressureDevice()
+    : CharacterDevice(32, 0)
+{
+}
+
+UNMAP_AFTER_INIT MemoryPressureDevice::~MemoryPressureDevice() = default;
+
+void MemoryPressureDevice::notify_level_changed()
+{
+    if (s_the)
+        s_the->evaluate_block_conditions();
+}
+
+ErrorOr<NonnullRefPtr<OpenFileDescription>> MemoryPressureDevice::open(int options)
+{
+    auto description = TRY(CharacterDevice::open(options));
+    description->data() = TRY(adopt_nonnull_own_or_enomem(new (nothrow) MemoryPressureDeviceData));
+    return description;
+}
+
+bool MemoryPressureDevice::can_read(OpenFileDescription const& description, u64) const
+{
+    auto const& data = static_cast<MemoryPressureDeviceData const&>(*description.data());
+    return data.last_read_sequence.load(AK::MemoryOrder::memory_order_relaxed) != MM.memory_pressure_sequence();
+}
+
+ErrorOr<size_t> MemoryPressureDevice::read(OpenFileDescription& description, u64, UserOrKernelBuffer& buffer, size_t size)
+{
+    if (size < sizeof(MemoryPressureEvent))
+        return EINVAL;
+
+    auto& data = static_cast<MemoryPressureDeviceData&>(*description.data());
+    auto sequence = MM.memory_pressure_sequence();
+    if (data.last_read_sequence.exchange(sequence, AK::MemoryOrder::memory_order_relaxed) == sequence)
+        return EAGAIN;
+
+    auto memory_info = MM.get_system_memory_info();
+    MemoryPressureEvent event {
+        .level = MM.memory_pressure_level(),
+        .reserved = 0,
+        .sequence = sequence,
+        .uncommitted_pages = memory_info.physical_pages_uncommitted,
+        .total_pages = memory_info.physical_pages,
+    };
+    TRY(buffer.write(&event, sizeof(event)));
+    return sizeof(event);
+}
+
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/Devices/CharacterDevice.h>
+
+namespace Kernel {
+
+// /dev/memory_pressure tells userspace when the memory pressure level changes, see Kernel/API/MemoryPressure.h.
+class MemoryPressureDevice final : public CharacterDevice {
+    friend class DeviceManagement;
+
+public:
+    static NonnullLockRefPtr<MemoryPressureDevice> must_create();
+    virtual ~MemoryPressureDevice() override;
+
+    // Wakes up everyone who is waiting for the level to change.
+    static void notify_level_changed();
+
+private:
+    MemoryPressureDevice();
+
+    // ^CharacterDevice
+    virtual ErrorOr<NonnullRefPtr<OpenFileDescription>> open(int options) override;
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual StringView class_name() const override { return "MemoryPressureDevice"sv; }
+};
+
+}
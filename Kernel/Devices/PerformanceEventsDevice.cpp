@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/API/Ioctl.h>
+#include <Kernel/API/PerformanceEventRing.h>
+#include <Kernel/Devices/DeviceManagement.h>
+#include <Kernel/Devices/PerformanceEventsDevice.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PerformanceEventBuffer.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<PerformanceEventsDevice> PerformanceEventsDevice::must_create()
+{
+    auto device_or_error = DeviceManagement::try_create_device<PerformanceEventsDevice>();
+    // FIXME: Find a way to propagate errors
+    VERIFY(!device_or_error.is_error());
+    return device_or_error.release_value();
+}
+
+UNMAP_AFTER_INIT PerformanceEventsDevice::PerformanceEventsDevice()
+    : CharacterDevice(31, 0)
+{
+}
+
+UNMAP_AFTER_INIT PerformanceEventsDevice::~PerformanceEventsDevice() = default;
+
+ErrorOr<void> PerformanceEventsDevice::ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg)
+{
+    auto& process = Process::current();
+    switch (request) {
+    case PERF_EVENTS_IOCTL_START_STREAMING: {
+        // Like sys$profiling_enable(), this is off-limits to pledged processes.
+        TRY(process.require_no_promises());
+        auto event_mask = TRY(copy_typed_from_user(static_ptr_cast<u64 const*>(arg)));
+        return process.profiling_enable_streaming(event_mask);
+    }
+    case PERF_EVENTS_IOCTL_STOP_STREAMING:
+        TRY(process.require_no_promises());
+        return process.profiling_disable_all_threads();
+    case PERF_EVENTS_IOCTL_GET_RING_INFO: {
+        if (!process.credentials()->is_superuser())
+            return EPERM;
+        PerformanceEventRingInfo info {};
+        {
+            ScopedCritical critical;
+            if (!g_global_perf_events || !g_global_perf_events->is_streaming())
+                return ENODEV;
+            auto const& rings = g_global_perf_events->rings();
+            info.ring_count = rings.size();
+            info.mapping_size = rings.first()->mapping_size();
+        }
+        return copy_to_user(static_ptr_cast<PerformanceEventRingInfo*>(arg), &info);
+    }
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> PerformanceEventsDevice::vmobject_for_mmap(Process& process, Memory::VirtualRange const& range, u64& offset, bool shared)
+{
+    // The events contain kernel addresses, which are only for the superuser's eyes.
+    if (!process.credentials()->is_superuser())
+        return EPERM;
+    if (!shared)
+        return EINVAL;
+
+    ScopedCritical critical;
+    if (!g_global_perf_events || !g_global_perf_events->is_streaming())
+        return ENODEV;
+    auto const& rings = g_global_perf_events->rings();
+    auto mapping_size = rings.first()->mapping_size();
+    if (offset % mapping_size != 0 || range.size() > mapping_size)
+        return EINVAL;
+    auto index = offset / mapping_size;
+    if (index >= rings.size())
+        return EINVAL;
+
+    // Every ring is a VMObject of its own, so the mapping starts at the beginning of it.
+    offset = 0;
+    return rings[index]->vmobject();
+}
+
+}
@@ -45,6 +45,20 @@ void DiskPartition::start_request(AsyncBlockDeviceRequest& request)
     request.add_sub_request(sub_request_or_error.release_value());
 }
 
+// Requests to the partition are passed straight on to the underlying device, so we can
+// take as many of them at once as it can.
+size_t DiskPartition::max_outstanding_requests() const
+{
+    auto device = m_device.strong_ref();
+    return device ? device->max_outstanding_requests() : 1;
+}
+
+u32 DiskPartition::max_blocks_per_request() const
+{
+    auto device = m_device.strong_ref();
+    return device ? device->max_blocks_per_request() : BlockDevice::max_blocks_per_request();
+}
+
 ErrorOr<size_t> DiskPartition::read(OpenFileDescription& fd, u64 offset, UserOrKernelBuffer& outbuf, size_t len)
 {
     u64 adjust = m_metadata.start_block() * block_size();
@@ -21,6 +21,10 @@ public:
     virtual ~DiskPartition();
 
     virtual void start_request(AsyncBlockDeviceRequest&) override;
+    virtual u32 max_blocks_per_request() const override;
+
+    // ^Device
+    virtual size_t max_outstanding_requests() const override;
 
     // ^BlockDevice
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
@@ -179,6 +179,15 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
             return EFAULT;
         }
     }
+    // All namespaces share the IO queues, so they have to share the queue entries as well.
+    size_t namespace_count = 0;
+    for (auto nsid : active_namespace_list) {
+        if (nsid == 0)
+            break;
+        ++namespace_count;
+    }
+    auto max_outstanding_requests_per_namespace = max<size_t>(1, (IO_QUEUE_SIZE - 1) / max<size_t>(1, namespace_count));
+
     // Get the NAMESPACE attributes
     {
         NVMeSubmission sub {};
@@ -208,7 +217,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
 
             dbgln_if(NVME_DEBUG, "NVMe: Block count is {} and Block size is {}", block_counts, block_size);
 
-            m_namespaces.append(TRY(NVMeNameSpace::try_create(*this, m_queues, nsid, block_counts, block_size)));
+            m_namespaces.append(TRY(NVMeNameSpace::try_create(*this, m_queues, nsid, block_counts, block_size, max_outstanding_requests_per_namespace)));
             m_device_count++;
             dbgln_if(NVME_DEBUG, "NVMe: Initialized namespace with NSID: {}", nsid);
         }
@@ -56,7 +56,7 @@ void NVMePollQueue::complete_current_request(u16 cmdid, u16 status)
     }
 
     if (current_request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
-        if (auto result = current_request->write_to_buffer(current_request->buffer(), m_rw_dma_region->vaddr().as_ptr(), current_request->buffer_size()); result.is_error()) {
+        if (auto result = current_request->write_to_buffer(current_request->buffer(), rw_dma_buffer(cmdid), current_request->buffer_size()); result.is_error()) {
             req_result = AsyncBlockDeviceRequest::MemoryFault;
             return;
         }
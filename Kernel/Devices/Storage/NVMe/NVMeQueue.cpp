@@ -14,12 +14,12 @@
 namespace Kernel {
 ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(NVMeController& device, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Memory::TypedMapping<DoorbellRegister volatile> db_regs, QueueType queue_type)
 {
-    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalPage> rw_dma_page;
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page));
-
-    if (rw_dma_page.is_null())
-        return ENOMEM;
+    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it),
+    //       but every command identifier of an IO queue gets a page of its own. The admin queue only does synchronous commands with their own buffers.
+    Vector<NonnullRefPtr<Memory::PhysicalPage>> rw_dma_pages;
+    auto rw_dma_region_size = qid == 0 ? PAGE_SIZE : q_depth * PAGE_SIZE;
+    auto rw_dma_region = TRY(MM.allocate_dma_buffer_pages(rw_dma_region_size, "NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_pages));
+    RefPtr<Memory::PhysicalPage> rw_dma_page = rw_dma_pages.first();
 
     if (queue_type == QueueType::Polled) {
         auto queue = NVMePollQueue::try_create(move(rw_dma_region), rw_dma_page.release_nonnull(), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
@@ -105,20 +105,25 @@ void NVMeQueue::submit_sqe(NVMeSubmission& sub)
     update_sq_doorbell();
 }
 
+u16 NVMeQueue::reserve_command_id(RefPtr<AsyncBlockDeviceRequest> request, Function<void(u16 status)> end_io_handler)
+{
+    SpinlockLocker req_lock(m_request_lock);
+    for (u32 i = 1; i <= m_qdepth; ++i) {
+        u16 cid = (m_last_command_id + i) % m_qdepth;
+        if (auto it = m_requests.find(cid); it != m_requests.end() && it->value.used)
+            continue;
+        m_requests.set(cid, { move(request), true, move(end_io_handler) });
+        m_last_command_id = cid;
+        return cid;
+    }
+    // NOTE: The namespaces never have more requests outstanding than there are entries in a queue.
+    VERIFY_NOT_REACHED();
+}
+
 u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
 {
-    // For now let's use sq tail as a unique command id.
     u16 cmd_status;
-    u16 cid = get_request_cid();
-    sub.cmdid = cid;
-
-    {
-        SpinlockLocker req_lock(m_request_lock);
-
-        if (m_requests.contains(sub.cmdid) && m_requests.get(sub.cmdid).release_value().used)
-            VERIFY_NOT_REACHED();
-        m_requests.set(sub.cmdid, { nullptr, true, [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } });
-    }
+    sub.cmdid = reserve_command_id(nullptr, [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); });
     submit_sqe(sub);
 
     // FIXME: Only sync submissions (usually used for admin commands) use a WaitQueue based IO. Eventually we need to
@@ -135,15 +140,8 @@ void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32
     sub.rw.slba = AK::convert_between_host_and_little_endian(index);
     // No. of lbas is 0 based
     sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
-
-    {
-        SpinlockLocker req_lock(m_request_lock);
-        if (m_requests.contains(sub.cmdid) && m_requests.get(sub.cmdid).release_value().used)
-            VERIFY_NOT_REACHED();
-        m_requests.set(sub.cmdid, { request, true, nullptr });
-    }
+    sub.cmdid = reserve_command_id(request, nullptr);
+    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(rw_dma_address(sub.cmdid).as_ptr()));
 
     full_memory_barrier();
     submit_sqe(sub);
@@ -158,17 +156,10 @@ void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32
     sub.rw.slba = AK::convert_between_host_and_little_endian(index);
     // No. of lbas is 0 based
     sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
-
-    {
-        SpinlockLocker req_lock(m_request_lock);
-        if (m_requests.contains(sub.cmdid) && m_requests.get(sub.cmdid).release_value().used)
-            VERIFY_NOT_REACHED();
-        m_requests.set(sub.cmdid, { request, true, nullptr });
-    }
+    sub.cmdid = reserve_command_id(request, nullptr);
+    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(rw_dma_address(sub.cmdid).as_ptr()));
 
-    if (auto result = request.read_from_buffer(request.buffer(), m_rw_dma_region->vaddr().as_ptr(), request.buffer_size()); result.is_error()) {
+    if (auto result = request.read_from_buffer(request.buffer(), rw_dma_buffer(sub.cmdid), request.buffer_size()); result.is_error()) {
         complete_current_request(sub.cmdid, AsyncDeviceRequest::MemoryFault);
         return;
     }
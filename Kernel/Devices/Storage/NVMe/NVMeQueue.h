@@ -58,18 +58,12 @@ protected:
     }
     NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Memory::TypedMapping<DoorbellRegister volatile> db_regs);
 
-    [[nodiscard]] u32 get_request_cid()
-    {
-        u32 expected_tag = m_tag.load(AK::memory_order_acquire);
+    // Finds a command identifier that no command in flight is using, and associates it with the new command.
+    [[nodiscard]] u16 reserve_command_id(RefPtr<AsyncBlockDeviceRequest>, Function<void(u16 status)> end_io_handler);
 
-        for (;;) {
-            u32 cid = expected_tag + 1;
-            if (cid == m_qdepth)
-                cid = 0;
-            if (m_tag.compare_exchange_strong(expected_tag, cid, AK::memory_order_acquire))
-                return cid;
-        }
-    }
+    // Every command identifier has its own page in the DMA region, so that several reads and writes can be in flight at once.
+    PhysicalAddress rw_dma_address(u16 cid) const { return m_rw_dma_page->paddr().offset(cid * PAGE_SIZE); }
+    u8* rw_dma_buffer(u16 cid) const { return m_rw_dma_region->vaddr().offset(cid * PAGE_SIZE).as_ptr(); }
 
 private:
     bool cqe_available();
@@ -93,7 +87,7 @@ private:
     u16 m_cq_head {};
     bool m_admin_queue { false };
     u32 m_qdepth {};
-    Atomic<u32> m_tag { 0 }; // used for the cid in a submission queue entry
+    u16 m_last_command_id { 0 }; // protected by m_request_lock
     Spinlock<LockRank::Interrupts> m_sq_lock {};
     OwnPtr<Memory::Region> m_cq_dma_region;
     Span<NVMeSubmission> m_sqe_array;
@@ -7,6 +7,7 @@
 #include <AK/StringView.h>
 #include <Kernel/API/Ioctl.h>
 #include <Kernel/Debug.h>
+#include <Kernel/Devices/BlockRequestBatch.h>
 #include <Kernel/Devices/DeviceManagement.h>
 #include <Kernel/Devices/Storage/StorageDevice.h>
 #include <Kernel/Devices/Storage/StorageManagement.h>
@@ -23,7 +24,7 @@ StorageDevice::StorageDevice(LUNAddress logical_unit_number_address, u32 hardwar
     , m_logical_unit_number_address(logical_unit_number_address)
     , m_hardware_relative_controller_id(hardware_relative_controller_id)
     , m_max_addressable_block(max_addressable_block)
-    , m_blocks_per_page(PAGE_SIZE / block_size())
+    , m_max_blocks_per_transfer(max_transfer_size / block_size())
 {
 }
 
@@ -32,7 +33,7 @@ StorageDevice::StorageDevice(Badge<RamdiskDevice>, LUNAddress logical_unit_numbe
     , m_logical_unit_number_address(logical_unit_number_address)
     , m_hardware_relative_controller_id(hardware_relative_controller_id)
     , m_max_addressable_block(max_addressable_block)
-    , m_blocks_per_page(PAGE_SIZE / block_size())
+    , m_max_blocks_per_transfer(max_transfer_size / block_size())
 {
 }
 
@@ -90,10 +91,10 @@ ErrorOr<size_t> StorageDevice::read(OpenFileDescription&, u64 offset, UserOrKern
     size_t whole_blocks = len >> block_size_log();
     size_t remaining = len - (whole_blocks << block_size_log());
 
-    // PATAChannel will chuck a wobbly if we try to read more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= m_blocks_per_page) {
-        whole_blocks = m_blocks_per_page;
+    // Larger transfers are split up into several requests (see max_blocks_per_request()), which are
+    // all submitted at once. We still limit how much we read per call to keep the batch reasonably small.
+    if (whole_blocks >= m_max_blocks_per_transfer) {
+        whole_blocks = m_max_blocks_per_transfer;
         remaining = 0;
     }
 
@@ -103,19 +104,9 @@ ErrorOr<size_t> StorageDevice::read(OpenFileDescription&, u64 offset, UserOrKern
     dbgln_if(STORAGE_DEVICE_DEBUG, "StorageDevice::read() index={}, whole_blocks={}, remaining={}", index, whole_blocks, remaining);
 
     if (whole_blocks > 0) {
-        auto read_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Read, index, whole_blocks, outbuf, whole_blocks * block_size()));
-        auto result = read_request->wait();
-        if (result.wait_result().was_interrupted())
-            return EINTR;
-        switch (result.request_result()) {
-        case AsyncDeviceRequest::Failure:
-        case AsyncDeviceRequest::Cancelled:
-            return EIO;
-        case AsyncDeviceRequest::MemoryFault:
-            return EFAULT;
-        default:
-            break;
-        }
+        BlockRequestBatch batch(*this);
+        TRY(batch.add(AsyncBlockDeviceRequest::Read, index, whole_blocks, outbuf));
+        TRY(batch.submit_and_wait());
     }
 
     off_t pos = whole_blocks * block_size();
@@ -156,10 +147,10 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, UserOrKer
     size_t whole_blocks = len >> block_size_log();
     size_t remaining = len - (whole_blocks << block_size_log());
 
-    // PATAChannel will chuck a wobbly if we try to write more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= m_blocks_per_page) {
-        whole_blocks = m_blocks_per_page;
+    // Larger transfers are split up into several requests (see max_blocks_per_request()), which are
+    // all submitted at once. We still limit how much we write per call to keep the batch reasonably small.
+    if (whole_blocks >= m_max_blocks_per_transfer) {
+        whole_blocks = m_max_blocks_per_transfer;
         remaining = 0;
     }
 
@@ -175,19 +166,9 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, UserOrKer
     dbgln_if(STORAGE_DEVICE_DEBUG, "StorageDevice::write() index={}, whole_blocks={}, remaining={}", index, whole_blocks, remaining);
 
     if (whole_blocks > 0) {
-        auto write_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Write, index, whole_blocks, inbuf, whole_blocks * block_size()));
-        auto result = write_request->wait();
-        if (result.wait_result().was_interrupted())
-            return EINTR;
-        switch (result.request_result()) {
-        case AsyncDeviceRequest::Failure:
-        case AsyncDeviceRequest::Cancelled:
-            return EIO;
-        case AsyncDeviceRequest::MemoryFault:
-            return EFAULT;
-        default:
-            break;
-        }
+        BlockRequestBatch batch(*this);
+        TRY(batch.add(AsyncBlockDeviceRequest::Write, index, whole_blocks, inbuf));
+        TRY(batch.submit_and_wait());
     }
 
     off_t pos = whole_blocks * block_size();
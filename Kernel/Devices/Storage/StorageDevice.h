@@ -104,8 +104,10 @@ private:
     // controller among its fellow controllers of the same hardware type in the system.
     u32 const m_hardware_relative_controller_id { 0 };
 
+    static constexpr size_t max_transfer_size = 256 * KiB;
+
     u64 m_max_addressable_block { 0 };
-    size_t m_blocks_per_page { 0 };
+    size_t m_max_blocks_per_transfer { 0 };
 };
 
 }
@@ -4,117 +4,15 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/IntrusiveList.h>
 #include <Kernel/Debug.h>
+#include <Kernel/Devices/BlockRequestBatch.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/FileSystem/DiskCache.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel {
 
-struct CacheEntry {
-    IntrusiveListNode<CacheEntry> list_node;
-    BlockBasedFileSystem::BlockIndex block_index { 0 };
-    u8* data { nullptr };
-    bool has_data { false };
-};
-
-class DiskCache {
-public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
-    {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs->block_size();
-            m_clean_list.append(entries()[i]);
-        }
-    }
-
-    ~DiskCache() = default;
-
-    bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
-
-    void mark_all_clean()
-    {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
-    }
-
-    void mark_dirty(CacheEntry& entry)
-    {
-        m_dirty_list.prepend(entry);
-    }
-
-    void mark_clean(CacheEntry& entry)
-    {
-        m_clean_list.prepend(entry);
-    }
-
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
-    {
-        auto it = m_hash.find(block_index);
-        if (it == m_hash.end())
-            return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
-        VERIFY(entry.block_index == block_index);
-        if (!entry_is_dirty(entry) && (m_clean_list.first() != &entry)) {
-            // Cache hit! Promote the entry to the front of the list.
-            m_clean_list.prepend(entry);
-        }
-        return &entry;
-    }
-
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
-    {
-        if (auto* entry = get(block_index))
-            return entry;
-
-        if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            m_fs->flush_writes_impl();
-            return ensure(block_index);
-        }
-
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
-
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
-
-        new_entry.block_index = block_index;
-        new_entry.has_data = false;
-
-        return &new_entry;
-    }
-
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
-
-    template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
-    {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
-    }
-
-private:
-    mutable NonnullRefPtr<BlockBasedFileSystem> m_fs;
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
-
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
-    NonnullOwnPtr<KBuffer> m_entries;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
-};
-
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
     : FileBackedFileSystem(file_description)
 {
@@ -136,9 +34,7 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto disk_cache = TRY(DiskCache::try_create(*this));
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
@@ -159,25 +55,16 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
-        if (!allow_cache) {
-            flush_specific_block_if_needed(index);
-            u64 base_offset = index.value() * block_size() + offset;
-            auto nwritten = TRY(file_description().write(base_offset, data, count));
-            VERIFY(nwritten == count);
-            return {};
-        }
-
-        auto entry = TRY(cache->ensure(index));
-        if (count < block_size()) {
-            // Fill the cache first.
-            TRY(read_block(index, nullptr, block_size()));
-        }
-        memcpy(entry->data + offset, buffered_data.data(), count);
-
-        cache->mark_dirty(*entry);
-        entry->has_data = true;
+    if (!allow_cache) {
+        flush_specific_block_if_needed(index);
+        u64 base_offset = index.value() * block_size() + offset;
+        auto nwritten = TRY(file_description().write(base_offset, data, count));
+        VERIFY(nwritten == count);
         return {};
+    }
+
+    return m_cache.with_shared([&](auto& cache) {
+        return cache->write(index, buffered_data.bytes(), offset);
     });
 }
 
@@ -197,8 +84,33 @@ ErrorOr<void> BlockBasedFileSystem::raw_write(BlockIndex index, UserOrKernelBuff
     return {};
 }
 
+BlockDevice* BlockBasedFileSystem::block_device_for_batching() const
+{
+    auto& file = file_description().file();
+    if (!file.is_block_device())
+        return nullptr;
+    auto& device = static_cast<BlockDevice&>(file);
+    if (m_logical_block_size % device.block_size() != 0 || block_size() % device.block_size() != 0)
+        return nullptr;
+    return &device;
+}
+
+ErrorOr<void> BlockBasedFileSystem::add_to_batch(BlockRequestBatch& batch, AsyncBlockDeviceRequest::RequestType type, u64 offset, size_t size, UserOrKernelBuffer const& buffer) const
+{
+    auto* device = block_device_for_batching();
+    VERIFY(device);
+    VERIFY(offset % device->block_size() == 0 && size % device->block_size() == 0);
+    return batch.add(type, offset >> device->block_size_log(), size >> device->block_size_log(), buffer);
+}
+
 ErrorOr<void> BlockBasedFileSystem::raw_read_blocks(BlockIndex index, size_t count, UserOrKernelBuffer& buffer)
 {
+    if (auto* device = block_device_for_batching()) {
+        BlockRequestBatch batch(*device);
+        TRY(add_to_batch(batch, AsyncBlockDeviceRequest::Read, index.value() * m_logical_block_size, count * m_logical_block_size, buffer));
+        return batch.submit_and_wait();
+    }
+
     auto current = buffer;
     for (auto block = index.value(); block < (index.value() + count); block++) {
         TRY(raw_read(BlockIndex { block }, current));
@@ -209,6 +121,12 @@ ErrorOr<void> BlockBasedFileSystem::raw_read_blocks(BlockIndex index, size_t cou
 
 ErrorOr<void> BlockBasedFileSystem::raw_write_blocks(BlockIndex index, size_t count, UserOrKernelBuffer const& buffer)
 {
+    if (auto* device = block_device_for_batching()) {
+        BlockRequestBatch batch(*device);
+        TRY(add_to_batch(batch, AsyncBlockDeviceRequest::Write, index.value() * m_logical_block_size, count * m_logical_block_size, buffer));
+        return batch.submit_and_wait();
+    }
+
     auto current = buffer;
     for (auto block = index.value(); block < (index.value() + count); block++) {
         TRY(raw_write(block, current));
@@ -221,6 +139,13 @@ ErrorOr<void> BlockBasedFileSystem::write_blocks(BlockIndex index, unsigned coun
 {
     VERIFY(m_logical_block_size);
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::write_blocks {}, count={}", index, count);
+    if (auto* device = block_device_for_batching(); device && !allow_cache && count > 1) {
+        BlockRequestBatch batch(*device);
+        for (unsigned i = 0; i < count; ++i)
+            flush_specific_block_if_needed(BlockIndex { index.value() + i });
+        TRY(add_to_batch(batch, AsyncBlockDeviceRequest::Write, index.value() * block_size(), count * block_size(), data));
+        return batch.submit_and_wait();
+    }
     for (unsigned i = 0; i < count; ++i) {
         TRY(write_block(BlockIndex { index.value() + i }, data.offset(i * block_size()), block_size(), 0, allow_cache));
     }
@@ -233,26 +158,16 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
-        if (!allow_cache) {
-            const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
-            u64 base_offset = index.value() * block_size() + offset;
-            auto nread = TRY(file_description().read(*buffer, base_offset, count));
-            VERIFY(nread == count);
-            return {};
-        }
-
-        auto* entry = TRY(cache->ensure(index));
-        if (!entry->has_data) {
-            auto base_offset = index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-            auto nread = TRY(file_description().read(entry_data_buffer, base_offset, block_size()));
-            VERIFY(nread == block_size());
-            entry->has_data = true;
-        }
-        if (buffer)
-            TRY(buffer->write(entry->data + offset, count));
+    if (!allow_cache) {
+        const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
+        u64 base_offset = index.value() * block_size() + offset;
+        auto nread = TRY(file_description().read(*buffer, base_offset, count));
+        VERIFY(nread == count);
         return {};
+    }
+
+    return m_cache.with_shared([&](auto& cache) {
+        return cache->read(index, buffer, count, offset);
     });
 }
 
@@ -263,6 +178,13 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
         return EINVAL;
     if (count == 1)
         return read_block(index, &buffer, block_size(), 0, allow_cache);
+    if (auto* device = block_device_for_batching(); device && !allow_cache) {
+        BlockRequestBatch batch(*device);
+        for (unsigned i = 0; i < count; ++i)
+            const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(BlockIndex { index.value() + i });
+        TRY(add_to_batch(batch, AsyncBlockDeviceRequest::Read, index.value() * block_size(), count * block_size(), buffer));
+        return batch.submit_and_wait();
+    }
     auto out = buffer;
     for (unsigned i = 0; i < count; ++i) {
         TRY(read_block(BlockIndex { index.value() + i }, &out, block_size(), 0, allow_cache));
@@ -272,36 +194,90 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
-void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
+void BlockBasedFileSystem::schedule_read_ahead(Vector<BlockIndex>&& blocks) const
 {
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        auto* entry = cache->get(index);
-        if (!entry)
-            return;
-        if (!cache->entry_is_dirty(*entry))
+    if (blocks.is_empty())
+        return;
+
+    // NOTE: Read-ahead is purely an optimization, so if we can't queue it we simply don't do it.
+    [[maybe_unused]] auto result = g_io_work->try_queue([fs = NonnullRefPtr<BlockBasedFileSystem const>(*this), blocks = move(blocks)] {
+        fs->read_ahead_blocks(blocks);
+    });
+}
+
+void BlockBasedFileSystem::read_ahead_blocks(ReadonlySpan<BlockIndex> blocks) const
+{
+    static constexpr size_t max_blocks_per_read = 32;
+    auto buffer_or_error = KBuffer::try_create_with_size("BlockBasedFS: Read-ahead"sv, max_blocks_per_read * block_size());
+    if (buffer_or_error.is_error())
+        return;
+    auto buffer = buffer_or_error.release_value();
+
+    m_cache.with_shared([&](auto& cache) {
+        // The cache is gone if we were unmounted in the meantime.
+        if (!cache)
             return;
-        size_t base_offset = entry->block_index.value() * block_size();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-        (void)file_description().write(base_offset, entry_data_buffer, block_size());
+
+        size_t index = 0;
+        while (index < blocks.size()) {
+            if (cache->has_data_for(blocks[index])) {
+                ++index;
+                continue;
+            }
+
+            size_t run_length = 1;
+            while (index + run_length < blocks.size()
+                && run_length < max_blocks_per_read
+                && blocks[index + run_length].value() == blocks[index].value() + run_length
+                && !cache->has_data_for(blocks[index + run_length]))
+                ++run_length;
+
+            Array<u64, max_blocks_per_read> write_generations;
+            for (size_t i = 0; i < run_length; ++i)
+                write_generations[i] = cache->write_generation(blocks[index + i]);
+
+            auto base_offset = blocks[index].value() * block_size();
+            auto run_size = run_length * block_size();
+            auto data_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+            auto nread_or_error = file_description().read(data_buffer, base_offset, run_size);
+            if (nread_or_error.is_error() || nread_or_error.value() != run_size)
+                return;
+
+            for (size_t i = 0; i < run_length; ++i) {
+                auto block_data = buffer->bytes().slice(i * block_size(), block_size());
+                if (cache->fill(blocks[index + i], block_data, write_generations[i]).is_error())
+                    return;
+            }
+            dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_ahead_blocks {}, count={}", blocks[index], run_length);
+            index += run_length;
+        }
+    });
+}
+
+void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
+{
+    m_cache.with_shared([&](auto& cache) {
+        cache->flush_block_if_dirty(index);
     });
 }
 
 void BlockBasedFileSystem::flush_writes_impl()
 {
-    size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
+    m_cache.with_shared([&](auto& cache) {
+        if (!cache)
             return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size());
-            ++count;
-        });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+        auto count = cache->flush_dirty_blocks();
+        if (count > 0)
+            dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+    });
+}
+
+size_t BlockBasedFileSystem::release_cached_memory(size_t bytes_to_release)
+{
+    return m_cache.with_shared([&](auto& cache) -> size_t {
+        if (!cache)
+            return 0;
+        return cache->release_memory(bytes_to_release);
     });
 }
 
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/Locking/MutexProtected.h>
 
@@ -20,8 +21,14 @@ public:
     u64 logical_block_size() const { return m_logical_block_size; };
 
     virtual void flush_writes() override;
+    virtual size_t release_cached_memory(size_t bytes_to_release) override;
     void flush_writes_impl();
 
+    // If we live directly on a block device, reads and writes of whole blocks can bypass our
+    // file description and be handed to the device together in a BlockRequestBatch.
+    BlockDevice* block_device_for_batching() const;
+    ErrorOr<void> add_to_batch(BlockRequestBatch&, AsyncBlockDeviceRequest::RequestType, u64 offset, size_t size, UserOrKernelBuffer const&) const;
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -39,12 +46,17 @@ protected:
     ErrorOr<void> write_block(BlockIndex, UserOrKernelBuffer const&, size_t count, u64 offset = 0, bool allow_cache = true);
     ErrorOr<void> write_blocks(BlockIndex, unsigned count, UserOrKernelBuffer const&, bool allow_cache = true);
 
+    // Asynchronously reads the given blocks into the disk cache on the I/O work queue.
+    // Contiguous runs of blocks are fetched from the device with a single read.
+    void schedule_read_ahead(Vector<BlockIndex>&&) const;
+
     u64 m_logical_block_size { 512 };
 
     void remove_disk_cache_before_last_unmount();
 
 private:
     void flush_specific_block_if_needed(BlockIndex index);
+    void read_ahead_blocks(ReadonlySpan<BlockIndex>) const;
 
     mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
 };
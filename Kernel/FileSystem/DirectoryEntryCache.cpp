@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
+#include <Kernel/FileSystem/Inode.h>
+
+namespace Kernel {
+
+static Singleton<DirectoryEntryCache> s_the;
+
+DirectoryEntryCache& DirectoryEntryCache::the()
+{
+    return *s_the;
+}
+
+DirectoryEntryCache::DirectoryEntryCache() = default;
+
+DirectoryEntryCache::~DirectoryEntryCache()
+{
+    clear();
+}
+
+ErrorOr<RefPtr<Custody>> DirectoryEntryCache::lookup(Custody& parent, StringView name)
+{
+    auto& parent_inode = parent.inode();
+    return m_state.with([&](auto& state) -> ErrorOr<RefPtr<Custody>> {
+        auto it = state.entries.find(Key { parent_inode.identifier(), name });
+        if (it == state.entries.end()) {
+            ++state.statistics.misses;
+            return nullptr;
+        }
+
+        auto& entry = *it->value;
+        if (entry.child) {
+            // The directory may also be reachable through other custodies, e.g. via bind mounts,
+            // in which case we need a different custody for the child.
+            if (entry.parent != &parent) {
+                ++state.statistics.misses;
+                return nullptr;
+            }
+            ++state.statistics.hits;
+            state.lru_list.prepend(entry);
+            return entry.child;
+        }
+
+        // If the parent inode went away, its identifier may have been reused by an unrelated directory.
+        if (entry.parent_inode.unsafe_ptr() != &parent_inode) {
+            ++state.statistics.misses;
+            return nullptr;
+        }
+        ++state.statistics.negative_hits;
+        state.lru_list.prepend(entry);
+        return ENOENT;
+    });
+}
+
+u64 DirectoryEntryCache::generation() const
+{
+    return m_state.with([](auto& state) { return state.generation; });
+}
+
+void DirectoryEntryCache::add(u64 generation, Custody& parent, StringView name, Custody& child)
+{
+    auto name_or_error = KString::try_create(name);
+    if (name_or_error.is_error())
+        return;
+    auto entry = adopt_own_if_nonnull(new (nothrow) Entry { {}, parent.inode().identifier(), name_or_error.release_value(), &parent, child, {} });
+    if (!entry)
+        return;
+    insert(generation, entry.release_nonnull());
+}
+
+void DirectoryEntryCache::add_negative(u64 generation, Custody& parent, StringView name)
+{
+    auto name_or_error = KString::try_create(name);
+    if (name_or_error.is_error())
+        return;
+    auto parent_inode_or_error = parent.inode().try_make_weak_ptr<Inode>();
+    if (parent_inode_or_error.is_error())
+        return;
+    auto entry = adopt_own_if_nonnull(new (nothrow) Entry { {}, parent.inode().identifier(), name_or_error.release_value(), nullptr, nullptr, parent_inode_or_error.release_value() });
+    if (!entry)
+        return;
+    insert(generation, entry.release_nonnull());
+}
+
+void DirectoryEntryCache::insert(u64 generation, NonnullOwnPtr<Entry> entry)
+{
+    // NOTE: Entries hold references to custodies and inodes, whose destruction may have to take
+    //       all kinds of locks. We always drop them after letting go of our own lock.
+    EntryList removed_entries;
+    m_state.with([&](auto& state) {
+        if (state.generation != generation)
+            return;
+
+        Key key { entry->parent_inode_identifier, entry->name->view() };
+        if (auto it = state.entries.find(key); it != state.entries.end())
+            remove(state, *it->value, removed_entries);
+        while (state.entries.size() >= capacity)
+            remove(state, *state.lru_list.last(), removed_entries);
+
+        if (state.entries.try_set(key, entry.ptr()).is_error())
+            return;
+        state.lru_list.prepend(*entry.leak_ptr());
+    });
+    destroy(removed_entries);
+}
+
+void DirectoryEntryCache::invalidate(InodeIdentifier parent, StringView name)
+{
+    EntryList removed_entries;
+    m_state.with([&](auto& state) {
+        ++state.generation;
+        if (auto it = state.entries.find(Key { parent, name }); it != state.entries.end()) {
+            remove(state, *it->value, removed_entries);
+            ++state.statistics.invalidations;
+        }
+    });
+    destroy(removed_entries);
+}
+
+void DirectoryEntryCache::clear()
+{
+    EntryList removed_entries;
+    m_state.with([&](auto& state) {
+        ++state.generation;
+        while (!state.lru_list.is_empty())
+            remove(state, *state.lru_list.first(), removed_entries);
+    });
+    destroy(removed_entries);
+}
+
+DirectoryEntryCache::Statistics DirectoryEntryCache::statistics() const
+{
+    return m_state.with([](auto& state) {
+        auto statistics = state.statistics;
+        statistics.entry_count = state.entries.size();
+        statistics.capacity = capacity;
+        return statistics;
+    });
+}
+
+void DirectoryEntryCache::remove(State& state, Entry& entry, EntryList& removed_entries)
+{
+    state.entries.remove(Key { entry.parent_inode_identifier, entry.name->view() });
+    removed_entries.append(entry);
+}
+
+void DirectoryEntryCache::destroy(EntryList& removed_entries)
+{
+    while (auto* entry = removed_entries.take_first())
+        delete entry;
+}
+
+}
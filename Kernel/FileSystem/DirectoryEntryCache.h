@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/RefPtr.h>
+#include <Kernel/FileSystem/InodeIdentifier.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Library/KString.h>
+#include <Kernel/Library/LockWeakPtr.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// A global cache of path component lookups, mapping a parent custody and a name to the custody
+// of the child, or to the knowledge that the parent has no child by that name.
+//
+// Entries are keyed by the inode of the parent directory, so that they can be invalidated when
+// a child is added to or removed from it, no matter which custody it was reached through. Only
+// filesystems that report every such change via Inode::did_add_child() and did_remove_child()
+// take part in this (see FileSystem::supports_lookup_caching()).
+class DirectoryEntryCache {
+    AK_MAKE_NONCOPYABLE(DirectoryEntryCache);
+    AK_MAKE_NONMOVABLE(DirectoryEntryCache);
+
+public:
+    static DirectoryEntryCache& the();
+
+    DirectoryEntryCache();
+    ~DirectoryEntryCache();
+
+    struct Statistics {
+        u64 hits { 0 };
+        u64 negative_hits { 0 };
+        u64 misses { 0 };
+        u64 invalidations { 0 };
+        size_t entry_count { 0 };
+        size_t capacity { 0 };
+    };
+
+    // Returns the cached custody of the child, ENOENT if the child is known not to exist,
+    // or nullptr if we don't know anything about it.
+    ErrorOr<RefPtr<Custody>> lookup(Custody& parent, StringView name);
+
+    // The result of a lookup may only be added if nothing was invalidated while it was being
+    // looked up, so callers have to sample the generation before looking up the child themselves.
+    u64 generation() const;
+    void add(u64 generation, Custody& parent, StringView name, Custody& child);
+    void add_negative(u64 generation, Custody& parent, StringView name);
+
+    void invalidate(InodeIdentifier parent, StringView name);
+    void clear();
+
+    Statistics statistics() const;
+
+private:
+    static constexpr size_t capacity = 4096;
+
+    struct Entry {
+        IntrusiveListNode<Entry> lru_list_node;
+        InodeIdentifier parent_inode_identifier;
+        NonnullOwnPtr<KString> name;
+
+        // Positive entries point to the parent through the child, which keeps it alive.
+        // Negative entries only depend on the parent inode, which they must not keep alive.
+        Custody* parent { nullptr };
+        RefPtr<Custody> child;
+        LockWeakPtr<Inode> parent_inode;
+    };
+
+    struct Key {
+        InodeIdentifier parent_inode_identifier;
+        StringView name;
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public GenericTraits<Key> {
+        static unsigned hash(Key const& key)
+        {
+            return pair_int_hash(pair_int_hash(key.parent_inode_identifier.fsid().value(), u64_hash(key.parent_inode_identifier.index().value())), key.name.hash());
+        }
+    };
+
+    using EntryList = IntrusiveList<&Entry::lru_list_node>;
+
+    struct State {
+        HashMap<Key, Entry*, KeyTraits> entries;
+        EntryList lru_list;
+        u64 generation { 0 };
+        Statistics statistics;
+    };
+
+    void insert(u64 generation, NonnullOwnPtr<Entry>);
+    static void remove(State&, Entry&, EntryList& removed_entries);
+    static void destroy(EntryList& removed_entries);
+
+    SpinlockProtected<State, LockRank::None> m_state {};
+};
+
+}
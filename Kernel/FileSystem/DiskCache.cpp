@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2018-2022, Andreas Kling <kling@serenityos.org>
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/Devices/BlockRequestBatch.h>
+#include <Kernel/FileSystem/DiskCache.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Tasks/SyncTask.h>
+
+namespace Kernel {
+
+// A single filesystem may use up to this fraction of the available physical memory for its block cache.
+static constexpr size_t available_memory_divisor = 16;
+static constexpr size_t min_cache_size = 4 * MiB;
+static constexpr size_t max_cache_size = 256 * MiB;
+
+ErrorOr<NonnullOwnPtr<DiskCache>> DiskCache::try_create(BlockBasedFileSystem& fs)
+{
+    auto memory_info = MM.get_system_memory_info();
+    auto available_bytes = static_cast<size_t>(memory_info.physical_pages_uncommitted * PAGE_SIZE);
+    auto cache_size = clamp(available_bytes / available_memory_divisor, min_cache_size, max_cache_size);
+    auto chunks_per_shard = max(cache_size / fs.block_size() / shard_count / Chunk::entry_count, static_cast<size_t>(1));
+
+    auto cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(fs, chunks_per_shard)));
+    for (auto& shard : cache->m_shards) {
+        TRY(shard.with_exclusive([&](auto& shard) -> ErrorOr<void> {
+            TRY(shard.ghost_ring.try_ensure_capacity(cache->capacity_per_shard() / 2));
+            TRY(shard.chunks.try_ensure_capacity(chunks_per_shard));
+            return {};
+        }));
+    }
+    dbgln_if(BBFS_DEBUG, "DiskCache: Using up to {} blocks of {} bytes", chunks_per_shard * Chunk::entry_count * shard_count, fs.block_size());
+    return cache;
+}
+
+DiskCache::DiskCache(BlockBasedFileSystem& fs, size_t chunks_per_shard)
+    : m_fs(fs)
+    , m_block_size(fs.block_size())
+    , m_chunks_per_shard(chunks_per_shard)
+{
+}
+
+DiskCache::~DiskCache()
+{
+    for (auto& shard : m_shards) {
+        shard.with_exclusive([&](auto& shard) {
+            // NOTE: The lists must be emptied before the chunks holding their entries go away.
+            shard.free_list.clear();
+            shard.recent_list.clear();
+            shard.frequent_list.clear();
+            shard.dirty_list.clear();
+            shard.entries.clear();
+            shard.chunks.clear();
+        });
+    }
+}
+
+ErrorOr<void> DiskCache::read(BlockIndex block_index, UserOrKernelBuffer* buffer, size_t count, u64 offset)
+{
+    return shard_for(block_index).with_exclusive([&](auto& shard) -> ErrorOr<void> {
+        auto* entry = TRY(ensure(shard, block_index));
+        if (!entry->has_data)
+            TRY(read_from_device(*entry));
+        if (buffer)
+            TRY(buffer->write(entry->data + offset, count));
+        return {};
+    });
+}
+
+ErrorOr<void> DiskCache::write(BlockIndex block_index, ReadonlyBytes data, u64 offset)
+{
+    VERIFY(offset + data.size() <= m_block_size);
+    return shard_for(block_index).with_exclusive([&](auto& shard) -> ErrorOr<void> {
+        auto* entry = TRY(ensure(shard, block_index));
+        if (!entry->has_data && data.size() < m_block_size) {
+            // Fill the cache first.
+            TRY(read_from_device(*entry));
+        }
+        memcpy(entry->data + offset, data.data(), data.size());
+        entry->has_data = true;
+        mark_dirty(shard, *entry);
+        return {};
+    });
+}
+
+u64 DiskCache::write_generation(BlockIndex block_index)
+{
+    return shard_for(block_index).with_exclusive([](auto& shard) { return shard.write_generation; });
+}
+
+bool DiskCache::has_data_for(BlockIndex block_index)
+{
+    return shard_for(block_index).with_exclusive([&](auto& shard) {
+        auto it = shard.entries.find(block_index);
+        return it != shard.entries.end() && it->value->has_data;
+    });
+}
+
+ErrorOr<void> DiskCache::fill(BlockIndex block_index, ReadonlyBytes data, u64 write_generation)
+{
+    VERIFY(data.size() == m_block_size);
+    return shard_for(block_index).with_exclusive([&](auto& shard) -> ErrorOr<void> {
+        // If anything in this shard was written since the data was read from the
+        // device, we can't know whether it is still up to date.
+        if (shard.write_generation != write_generation)
+            return {};
+        auto* entry = TRY(ensure(shard, block_index));
+        if (entry->has_data)
+            return {};
+        memcpy(entry->data, data.data(), m_block_size);
+        entry->has_data = true;
+        return {};
+    });
+}
+
+void DiskCache::flush_block_if_dirty(BlockIndex block_index)
+{
+    shard_for(block_index).with_exclusive([&](auto& shard) {
+        auto it = shard.entries.find(block_index);
+        if (it == shard.entries.end() || !it->value->is_dirty())
+            return;
+        (void)write_back(shard, *it->value);
+    });
+}
+
+size_t DiskCache::flush_dirty_blocks()
+{
+    size_t count = 0;
+    for (auto& shard : m_shards) {
+        shard.with_exclusive([&](auto& shard) {
+            if (auto* device = m_fs->block_device_for_batching()) {
+                // Hand all of the shard's dirty blocks to the device at once, so that it can merge
+                // neighbouring ones and keep several requests in flight.
+                BlockRequestBatch batch(*device);
+                while (auto* entry = shard.dirty_list.first()) {
+                    shard.dirty_list.remove(*entry);
+                    --shard.dirty_count;
+                    ++count;
+                    auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+                    if (m_fs->add_to_batch(batch, AsyncBlockDeviceRequest::Write, entry->block_index.value() * m_block_size, m_block_size, entry_data_buffer).is_error())
+                        (void)m_fs->file_description().write(entry->block_index.value() * m_block_size, entry_data_buffer, m_block_size);
+                }
+                if (auto result = batch.submit_and_wait(); result.is_error())
+                    dbgln("DiskCache: Failed to write back dirty blocks: {}", result.error());
+                return;
+            }
+
+            while (auto* entry = shard.dirty_list.first()) {
+                // NOTE: write_back() always marks the entry clean, even if the write failed.
+                [[maybe_unused]] auto result = write_back(shard, *entry);
+                ++count;
+            }
+        });
+    }
+    return count;
+}
+
+size_t DiskCache::release_memory(size_t bytes_to_release)
+{
+    size_t released = 0;
+    for (auto& shard : m_shards) {
+        if (released >= bytes_to_release)
+            break;
+        shard.with_exclusive([&](auto& shard) {
+            while (released < bytes_to_release && !shard.chunks.is_empty()) {
+                auto& chunk = *shard.chunks.last();
+                for (auto& entry : chunk.entries) {
+                    if (entry.is_dirty())
+                        (void)write_back(shard, entry);
+                    if (entry.queue == Queue::Free)
+                        shard.free_list.remove(entry);
+                    else
+                        unlink(shard, entry, false);
+                }
+                released += chunk.data->size();
+                shard.chunks.take_last();
+            }
+        });
+    }
+    dbgln_if(BBFS_DEBUG, "DiskCache: Released {} bytes of cache memory", released);
+    return released;
+}
+
+ErrorOr<DiskCache::Entry*> DiskCache::ensure(Shard& shard, BlockIndex block_index)
+{
+    if (auto it = shard.entries.find(block_index); it != shard.entries.end()) {
+        auto& entry = *it->value;
+        VERIFY(entry.block_index == block_index);
+        // Cache hit! Entries in the frequent queue are kept in LRU order, while the
+        // recent queue is a plain FIFO so that one-off accesses age out quickly.
+        if (entry.queue == Queue::Frequent && shard.frequent_list.first() != &entry)
+            shard.frequent_list.prepend(entry);
+        return &entry;
+    }
+
+    auto* entry = TRY(take_free_entry(shard));
+    if (auto result = shard.entries.try_set(block_index, entry); result.is_error()) {
+        shard.free_list.prepend(*entry);
+        return result.release_error();
+    }
+
+    entry->block_index = block_index;
+    entry->has_data = false;
+    if (shard.ghosts.remove(block_index)) {
+        // We've seen this block recently, so it's likely part of the working set.
+        entry->queue = Queue::Frequent;
+        shard.frequent_list.prepend(*entry);
+    } else {
+        entry->queue = Queue::Recent;
+        shard.recent_list.prepend(*entry);
+        ++shard.recent_count;
+    }
+    return entry;
+}
+
+ErrorOr<DiskCache::Entry*> DiskCache::take_free_entry(Shard& shard)
+{
+    if (shard.free_list.is_empty() && shard.chunks.size() < m_chunks_per_shard) {
+        // If we can't grow the cache right now, we'll just have to make do with what we've got.
+        if (auto result = allocate_chunk(shard); result.is_error() && shard.chunks.is_empty())
+            return result.release_error();
+    }
+
+    if (auto* entry = shard.free_list.take_first())
+        return entry;
+    return evict_one(shard);
+}
+
+ErrorOr<void> DiskCache::allocate_chunk(Shard& shard)
+{
+    auto data = TRY(KBuffer::try_create_with_size("DiskCache: Cache blocks"sv, Chunk::entry_count * m_block_size));
+    auto chunk = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Chunk(move(data))));
+    for (size_t i = 0; i < Chunk::entry_count; ++i) {
+        auto& entry = chunk->entries[i];
+        entry.data = chunk->data->data() + i * m_block_size;
+        shard.free_list.append(entry);
+    }
+    TRY(shard.chunks.try_append(move(chunk)));
+    return {};
+}
+
+DiskCache::Entry* DiskCache::find_clean_victim(Shard& shard)
+{
+    auto find_last_clean = [](auto& list) -> Entry* {
+        for (auto it = list.rbegin(); it != list.rend(); ++it) {
+            if (!it->is_dirty())
+                return &*it;
+        }
+        return nullptr;
+    };
+
+    // 2Q: Evict from the recent queue while it holds more than its share of the cache,
+    // otherwise evict the least recently used entry of the frequent queue.
+    bool prefer_recent = shard.recent_count > capacity_per_shard() / 4;
+    auto& preferred_list = prefer_recent ? shard.recent_list : shard.frequent_list;
+    auto& other_list = prefer_recent ? shard.frequent_list : shard.recent_list;
+    if (auto* entry = find_last_clean(preferred_list))
+        return entry;
+    return find_last_clean(other_list);
+}
+
+ErrorOr<DiskCache::Entry*> DiskCache::evict_one(Shard& shard)
+{
+    auto* victim = find_clean_victim(shard);
+    if (!victim) {
+        // Not a single clean entry in this shard! Write back the oldest dirty block so we can
+        // reuse it, and let the sync task write back the rest in the background.
+        victim = shard.dirty_list.last();
+        VERIFY(victim);
+        TRY(write_back(shard, *victim));
+        SyncTask::request_writeback();
+    }
+
+    unlink(shard, *victim, true);
+    return victim;
+}
+
+void DiskCache::unlink(Shard& shard, Entry& entry, bool remember_as_ghost)
+{
+    VERIFY(!entry.is_dirty());
+    VERIFY(entry.queue != Queue::Free);
+    shard.entries.remove(entry.block_index);
+    if (entry.queue == Queue::Recent) {
+        shard.recent_list.remove(entry);
+        --shard.recent_count;
+        if (remember_as_ghost)
+            remember_ghost(shard, entry.block_index);
+    } else {
+        shard.frequent_list.remove(entry);
+    }
+    entry.queue = Queue::Free;
+    entry.has_data = false;
+}
+
+void DiskCache::remember_ghost(Shard& shard, BlockIndex block_index)
+{
+    if (shard.ghost_ring.capacity() == 0)
+        return;
+    if (shard.ghosts.try_set(block_index).is_error())
+        return;
+    if (shard.ghost_ring.size() < shard.ghost_ring.capacity()) {
+        shard.ghost_ring.unchecked_append(block_index);
+        return;
+    }
+    // The ghost queue is full, forget about the oldest ghost.
+    auto& oldest = shard.ghost_ring[shard.ghost_ring_head];
+    shard.ghosts.remove(oldest);
+    oldest = block_index;
+    shard.ghost_ring_head = (shard.ghost_ring_head + 1) % shard.ghost_ring.size();
+}
+
+void DiskCache::mark_dirty(Shard& shard, Entry& entry)
+{
+    ++shard.write_generation;
+    if (entry.is_dirty())
+        return;
+    shard.dirty_list.append(entry);
+    ++shard.dirty_count;
+    if (shard.dirty_count > capacity_per_shard() / 2)
+        SyncTask::request_writeback();
+}
+
+ErrorOr<void> DiskCache::read_from_device(Entry& entry)
+{
+    auto base_offset = entry.block_index.value() * m_block_size;
+    auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+    auto nread = TRY(m_fs->file_description().read(entry_data_buffer, base_offset, m_block_size));
+    VERIFY(nread == m_block_size);
+    entry.has_data = true;
+    return {};
+}
+
+ErrorOr<void> DiskCache::write_back(Shard& shard, Entry& entry)
+{
+    VERIFY(entry.is_dirty());
+    shard.dirty_list.remove(entry);
+    --shard.dirty_count;
+    auto base_offset = entry.block_index.value() * m_block_size;
+    auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+    TRY(m_fs->file_description().write(base_offset, entry_data_buffer, m_block_size));
+    return {};
+}
+
+}
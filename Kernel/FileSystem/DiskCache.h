@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018-2022, Andreas Kling <kling@serenityos.org>
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Locking/MutexProtected.h>
+
+namespace Kernel {
+
+// The block cache of a BlockBasedFileSystem.
+//
+// Blocks are spread over a fixed number of shards by their index, each with its own lock,
+// so that accesses to unrelated blocks don't serialize on a single filesystem-wide lock.
+//
+// Each shard uses the 2Q replacement policy: blocks enter a FIFO "recent" queue on their
+// first access and are only promoted to the LRU "frequent" queue if they are accessed again
+// shortly after having been evicted from it. This keeps large sequential scans from flushing
+// out the working set.
+//
+// The cache is sized based on the amount of available physical memory, grows lazily in
+// chunks of blocks and can give memory back when the system is running low on memory.
+class DiskCache {
+    AK_MAKE_NONCOPYABLE(DiskCache);
+    AK_MAKE_NONMOVABLE(DiskCache);
+
+public:
+    using BlockIndex = BlockBasedFileSystem::BlockIndex;
+
+    static ErrorOr<NonnullOwnPtr<DiskCache>> try_create(BlockBasedFileSystem&);
+    ~DiskCache();
+
+    ErrorOr<void> read(BlockIndex, UserOrKernelBuffer*, size_t count, u64 offset);
+    ErrorOr<void> write(BlockIndex, ReadonlyBytes, u64 offset);
+
+    // Read-ahead support: Inserts data that was read from the device outside of the cache,
+    // as long as nothing was written to the block's shard since `write_generation` was sampled.
+    u64 write_generation(BlockIndex);
+    bool has_data_for(BlockIndex);
+    ErrorOr<void> fill(BlockIndex, ReadonlyBytes, u64 write_generation);
+
+    void flush_block_if_dirty(BlockIndex);
+    size_t flush_dirty_blocks();
+
+    // Returns the number of bytes that were actually released.
+    size_t release_memory(size_t bytes_to_release);
+
+private:
+    static constexpr size_t shard_count = 16;
+
+    enum class Queue : u8 {
+        Free,
+        Recent,
+        Frequent,
+    };
+
+    struct Entry {
+        IntrusiveListNode<Entry> list_node;
+        IntrusiveListNode<Entry> dirty_list_node;
+        BlockIndex block_index { 0 };
+        u8* data { nullptr };
+        Queue queue { Queue::Free };
+        bool has_data { false };
+
+        bool is_dirty() const { return dirty_list_node.is_in_list(); }
+    };
+
+    struct Chunk {
+        static constexpr size_t entry_count = 64;
+
+        NonnullOwnPtr<KBuffer> data;
+        Array<Entry, entry_count> entries;
+
+        explicit Chunk(NonnullOwnPtr<KBuffer> data)
+            : data(move(data))
+        {
+        }
+    };
+
+    struct Shard {
+        IntrusiveList<&Entry::list_node> free_list;
+        IntrusiveList<&Entry::list_node> recent_list;
+        IntrusiveList<&Entry::list_node> frequent_list;
+        IntrusiveList<&Entry::dirty_list_node> dirty_list;
+        HashMap<BlockIndex, Entry*> entries;
+
+        // Indices of blocks that were recently evicted from the recent queue (2Q's "A1out").
+        HashTable<BlockIndex> ghosts;
+        Vector<BlockIndex> ghost_ring;
+        size_t ghost_ring_head { 0 };
+
+        Vector<NonnullOwnPtr<Chunk>> chunks;
+        size_t recent_count { 0 };
+        size_t dirty_count { 0 };
+        u64 write_generation { 0 };
+    };
+
+    explicit DiskCache(BlockBasedFileSystem&, size_t chunks_per_shard);
+
+    MutexProtected<Shard>& shard_for(BlockIndex block_index) { return m_shards[block_index.value() % shard_count]; }
+    size_t capacity_per_shard() const { return m_chunks_per_shard * Chunk::entry_count; }
+
+    ErrorOr<Entry*> ensure(Shard&, BlockIndex);
+    ErrorOr<Entry*> take_free_entry(Shard&);
+    ErrorOr<void> allocate_chunk(Shard&);
+    ErrorOr<Entry*> evict_one(Shard&);
+    Entry* find_clean_victim(Shard&);
+    void unlink(Shard&, Entry&, bool remember_as_ghost);
+    void remember_ghost(Shard&, BlockIndex);
+    void mark_dirty(Shard&, Entry&);
+    ErrorOr<void> read_from_device(Entry&);
+    ErrorOr<void> write_back(Shard&, Entry&);
+
+    NonnullRefPtr<BlockBasedFileSystem> m_fs;
+    size_t const m_block_size { 0 };
+    size_t const m_chunks_per_shard { 0 };
+    Array<MutexProtected<Shard>, shard_count> m_shards;
+};
+
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KString.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+ErrorOr<NonnullRefPtr<EPoll>> EPoll::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EPoll);
+}
+
+EPoll::~EPoll()
+{
+    auto interests = m_state.with([](auto& state) {
+        for (auto& it : state.interests)
+            mark_removed(state, *it.value);
+        return move(state.interests);
+    });
+
+    // NOTE: A watched file may be notifying one of our interests right now; detaching it
+    //       serializes with that, and the notification will see that it has been removed.
+    for (auto& it : interests)
+        it.value->m_blocker_set.remove_readiness_watcher(*it.value);
+}
+
+EPoll::Interest::Interest(EPoll& epoll, int fd, OpenFileDescription& description, epoll_event const& event)
+    : m_epoll(epoll)
+    , m_fd(fd)
+    , m_file(description.file())
+    , m_blocker_set(description.blocker_set())
+    , m_description(&description)
+    , m_events(event.events)
+    , m_data(event.data.u64)
+{
+}
+
+void EPoll::Interest::readiness_may_have_changed()
+{
+    bool became_ready = m_epoll.m_state.with([&](auto& state) {
+        if (m_removed || !m_description)
+            return false;
+        ++m_generation;
+        if (m_disabled || m_ready_list_node.is_in_list())
+            return false;
+        state.ready_list.append(*this);
+        return true;
+    });
+    if (became_ready)
+        m_epoll.evaluate_block_conditions();
+}
+
+void EPoll::Interest::watched_description_will_be_destroyed()
+{
+    // The file descriptor was closed, so drop the interest just like EPOLL_CTL_DEL would.
+    // NOTE: The owning reference is released after the state lock has been dropped.
+    RefPtr<Interest> self = m_epoll.m_state.with([&](auto& state) -> RefPtr<Interest> {
+        m_description = nullptr;
+        if (m_removed)
+            return nullptr;
+        mark_removed(state, *this);
+        return state.interests.take(m_fd).release_value();
+    });
+}
+
+void EPoll::mark_removed(State& state, Interest& interest)
+{
+    interest.m_removed = true;
+    state.ready_list.remove(interest);
+}
+
+void EPoll::mark_ready(State& state, Interest& interest)
+{
+    if (!interest.m_ready_list_node.is_in_list())
+        state.ready_list.append(interest);
+}
+
+bool EPoll::can_read(OpenFileDescription const&, u64) const
+{
+    return m_state.with([](auto& state) { return !state.ready_list.is_empty(); });
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EPoll::pseudo_path(OpenFileDescription const&) const
+{
+    return m_state.with([](auto& state) {
+        return KString::formatted("EPoll:({})", state.interests.size());
+    });
+}
+
+ErrorOr<void> EPoll::add_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    // NOTE: Nesting is not supported, as notifying one EPoll from within another could deadlock.
+    if (description.is_epoll())
+        return EINVAL;
+
+    auto interest = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Interest(*this, fd, description, event)));
+
+    // The new interest is considered ready until the first wait has looked at it,
+    // so we have to register it as a watcher before it can be found by anyone else.
+    interest->m_blocker_set.add_readiness_watcher(*interest);
+
+    RefPtr<Interest> stale_interest;
+    auto result = m_state.with([&](auto& state) -> ErrorOr<void> {
+        if (auto it = state.interests.find(fd); it != state.interests.end()) {
+            if (it->value->m_description == &description)
+                return EEXIST;
+            // The fd was closed and reused, or dup'ed over, while its old description is still alive.
+            stale_interest = it->value;
+            mark_removed(state, *stale_interest);
+        }
+        TRY(state.interests.try_set(fd, interest));
+        mark_ready(state, *interest);
+        return {};
+    });
+
+    if (stale_interest)
+        stale_interest->m_blocker_set.remove_readiness_watcher(*stale_interest);
+
+    if (result.is_error()) {
+        m_state.with([&](auto& state) { mark_removed(state, *interest); });
+        interest->m_blocker_set.remove_readiness_watcher(*interest);
+        return result.release_error();
+    }
+
+    evaluate_block_conditions();
+    return {};
+}
+
+ErrorOr<void> EPoll::modify_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    TRY(m_state.with([&](auto& state) -> ErrorOr<void> {
+        auto it = state.interests.find(fd);
+        if (it == state.interests.end() || it->value->m_description != &description)
+            return ENOENT;
+        auto& interest = *it->value;
+        interest.m_events = event.events;
+        interest.m_data = event.data.u64;
+        interest.m_disabled = false;
+        mark_ready(state, interest);
+        return {};
+    }));
+
+    evaluate_block_conditions();
+    return {};
+}
+
+ErrorOr<void> EPoll::remove_interest(int fd, OpenFileDescription& description)
+{
+    auto interest = TRY(m_state.with([&](auto& state) -> ErrorOr<NonnullRefPtr<Interest>> {
+        auto it = state.interests.find(fd);
+        if (it == state.interests.end() || it->value->m_description != &description)
+            return ENOENT;
+        auto interest = it->value;
+        state.interests.remove(it);
+        mark_removed(state, *interest);
+        return interest;
+    }));
+
+    interest->m_blocker_set.remove_readiness_watcher(*interest);
+    return {};
+}
+
+ErrorOr<size_t> EPoll::collect_ready_events(Span<epoll_event> events)
+{
+    struct Candidate {
+        NonnullRefPtr<Interest> interest;
+        NonnullRefPtr<OpenFileDescription> description;
+        u32 events { 0 };
+        u64 data { 0 };
+        u32 generation { 0 };
+    };
+
+    // First, take a snapshot of the ready list. Readiness is evaluated without holding our lock,
+    // as the files may take their own locks while notifying us.
+    Vector<Candidate, 16> candidates;
+    TRY(candidates.try_ensure_capacity(events.size()));
+    m_state.with([&](auto& state) {
+        for (auto it = state.ready_list.begin(); it != state.ready_list.end() && candidates.size() < events.size();) {
+            auto& interest = *it;
+            ++it;
+            if (interest.m_disabled || !interest.m_description || !interest.m_description->try_ref()) {
+                state.ready_list.remove(interest);
+                continue;
+            }
+            candidates.unchecked_append({ interest, adopt_ref(*interest.m_description), interest.m_events, interest.m_data, interest.m_generation });
+        }
+    });
+
+    for (auto& candidate : candidates) {
+        auto block_flags = BlockFlags::None;
+        if (candidate.events & EPOLLIN)
+            block_flags |= BlockFlags::Read;
+        if (candidate.events & EPOLLOUT)
+            block_flags |= BlockFlags::Write;
+        auto unblock_flags = candidate.description->should_unblock(block_flags);
+
+        candidate.events = 0;
+        if (has_flag(unblock_flags, BlockFlags::Read))
+            candidate.events |= EPOLLIN;
+        if (has_flag(unblock_flags, BlockFlags::Write))
+            candidate.events |= EPOLLOUT;
+    }
+
+    size_t event_count = 0;
+    m_state.with([&](auto& state) {
+        for (auto& candidate : candidates) {
+            auto& interest = *candidate.interest;
+            if (interest.m_removed || interest.m_disabled || interest.m_description != candidate.description.ptr())
+                continue;
+
+            // Nothing happened to the file since we looked at it, so it will notify us once it does.
+            bool unchanged = interest.m_generation == candidate.generation;
+
+            if (candidate.events == 0) {
+                if (unchanged)
+                    state.ready_list.remove(interest);
+                continue;
+            }
+
+            events[event_count].events = candidate.events;
+            events[event_count].data.u64 = candidate.data;
+            ++event_count;
+
+            if (interest.m_events & EPOLLONESHOT) {
+                interest.m_disabled = true;
+                state.ready_list.remove(interest);
+            } else if (interest.m_events & EPOLLET) {
+                if (unchanged)
+                    state.ready_list.remove(interest);
+            } else {
+                // Level-triggered interests stay ready, but go to the back of the list so that
+                // they don't starve others when there are more ready interests than room for events.
+                state.ready_list.append(interest);
+            }
+        }
+    });
+
+    return event_count;
+}
+
+}
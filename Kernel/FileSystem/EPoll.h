@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// An EPoll is a persistent set of file descriptions a process is interested in.
+//
+// Instead of registering blockers on every file for every wait like poll() and select() do,
+// each interest is registered once as a FileReadinessWatcher. Whenever a watched file
+// re-evaluates its blocking conditions, its interest is put on the ready list, so waiting
+// only ever has to look at the files that might actually be ready.
+class EPoll final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<EPoll>> try_create();
+    virtual ~EPoll() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EPoll"sv; }
+    virtual bool is_epoll() const override { return true; }
+
+    ErrorOr<void> add_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove_interest(int fd, OpenFileDescription&);
+
+    // Fills `events` with the interests that are currently ready without blocking.
+    ErrorOr<size_t> collect_ready_events(Span<epoll_event> events);
+
+private:
+    EPoll() = default;
+
+    class Interest final
+        : public AtomicRefCounted<Interest>
+        , public FileReadinessWatcher {
+    public:
+        Interest(EPoll&, int fd, OpenFileDescription&, epoll_event const&);
+
+        virtual OpenFileDescription const* watched_description() const override { return m_description; }
+        virtual void readiness_may_have_changed() override;
+        virtual void watched_description_will_be_destroyed() override;
+
+        EPoll& m_epoll;
+        int const m_fd { -1 };
+        NonnullRefPtr<File> const m_file;
+        FileBlockerSet& m_blocker_set;
+
+        // The following are protected by the EPoll's state lock.
+        // NOTE: m_description is cleared before the description goes away, so it may
+        //       only be dereferenced while holding that lock.
+        OpenFileDescription* m_description { nullptr };
+        u32 m_events { 0 };
+        u64 m_data { 0 };
+        u32 m_generation { 0 };
+        bool m_removed { false };
+        bool m_disabled { false };
+        IntrusiveListNode<Interest> m_ready_list_node;
+    };
+
+    struct State {
+        HashMap<int, NonnullRefPtr<Interest>> interests;
+        IntrusiveList<&Interest::m_ready_list_node> ready_list;
+    };
+
+    static void mark_removed(State&, Interest&);
+    void mark_ready(State&, Interest&);
+
+    SpinlockProtected<State, LockRank::None> m_state {};
+};
+
+}
@@ -223,9 +223,14 @@ ErrorOr<void> Ext2FS::write_ext2_inode(InodeIndex inode, ext2_inode const& e2ino
     return write_block(block_index, buffer, inode_size(), offset);
 }
 
-auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) -> ErrorOr<Vector<BlockIndex>>
+auto Ext2FS::first_block_of_group(GroupIndex group_index) const -> BlockIndex
 {
-    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {})", preferred_group_index, count);
+    return (group_index.value() - 1) * blocks_per_group() + first_block_index().value();
+}
+
+auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal) -> ErrorOr<Vector<BlockIndex>>
+{
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {}, goal {})", preferred_group_index, count, goal);
     if (count == 0)
         return Vector<BlockIndex> {};
 
@@ -233,52 +238,172 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
     TRY(blocks.try_ensure_capacity(count));
 
     MutexLocker locker(m_lock);
-    auto group_index = preferred_group_index;
 
-    if (!group_descriptor(preferred_group_index).bg_free_blocks_count) {
+    // Blocks that have been set aside for growing inodes are only a hint, so we give them back before running out of space.
+    if (count > super_block().s_free_blocks_count)
+        TRY(release_all_block_reservations());
+    if (count > super_block().s_free_blocks_count)
+        return ENOSPC;
+
+    // If we know which block comes right before the new ones, we start looking right behind it.
+    BlockIndex start_block = goal.value() ? goal.value() + 1 : 0;
+    if (start_block.value() >= super_block().s_blocks_count)
+        start_block = 0;
+    auto group_index = start_block.value() ? group_index_from_block_index(start_block) : preferred_group_index;
+    if (!group_index.value() || group_index.value() > m_block_group_count)
         group_index = 1;
-    }
+    size_t hint = start_block.value() ? start_block.value() - first_block_of_group(group_index).value() : 0;
 
+    size_t blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
+    size_t groups_visited = 0;
     while (blocks.size() < count) {
-        bool found_a_group = false;
-        if (group_descriptor(group_index).bg_free_blocks_count) {
-            found_a_group = true;
-        } else {
-            if (group_index == preferred_group_index)
-                group_index = 1;
-            for (; group_index <= m_block_group_count; group_index = GroupIndex { group_index.value() + 1 }) {
-                if (group_descriptor(group_index).bg_free_blocks_count) {
-                    found_a_group = true;
-                    break;
+        auto const& bgd = group_descriptor(group_index);
+        Optional<size_t> run_length;
+        size_t run_start = hint;
+        if (bgd.bg_free_blocks_count) {
+            auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+            auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
+            auto remaining = count - blocks.size();
+
+            // We prefer (in this order):
+            // - the blocks right behind the previous ones, so the file doesn't get fragmented at all,
+            // - the first run after those that fits all of the remaining blocks,
+            // - the longest run there is in this group.
+            run_length = block_bitmap.find_next_range_of_unset_bits(run_start, 1, remaining);
+            if (!run_length.has_value() || run_start != hint) {
+                run_start = hint;
+                run_length = block_bitmap.find_next_range_of_unset_bits(run_start, remaining, remaining);
+            }
+            if (!run_length.has_value()) {
+                size_t longest_run_length = 0;
+                auto longest_run_start = block_bitmap.find_longest_range_of_unset_bits(remaining, longest_run_length);
+                if (longest_run_start.has_value()) {
+                    run_start = longest_run_start.value();
+                    run_length = longest_run_length;
                 }
             }
         }
 
-        VERIFY(found_a_group);
-        auto const& bgd = group_descriptor(group_index);
-
-        auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
-
-        int blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
-        auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
-
-        BlockIndex first_block_in_group = (group_index.value() - 1) * blocks_per_group() + first_block_index().value();
-        size_t free_region_size = 0;
-        auto first_unset_bit_index = block_bitmap.find_longest_range_of_unset_bits(count - blocks.size(), free_region_size);
-        VERIFY(first_unset_bit_index.has_value());
-        dbgln_if(EXT2_DEBUG, "Ext2FS: allocating free region of size: {} [{}]", free_region_size, group_index);
-        for (size_t i = 0; i < free_region_size; ++i) {
-            BlockIndex block_index = (first_unset_bit_index.value() + i) + first_block_in_group.value();
-            TRY(set_block_allocation_state(block_index, true));
-            blocks.unchecked_append(block_index);
-            dbgln_if(EXT2_DEBUG, "  allocated > {}", block_index);
+        if (!run_length.has_value() || run_length.value() == 0) {
+            if (++groups_visited > m_block_group_count) {
+                dmesgln("Ext2FS: allocate_blocks found no free blocks, despite the superblock claiming there are {}", super_block().s_free_blocks_count);
+                for (auto block_index : blocks)
+                    TRY(set_block_allocation_state(block_index, false));
+                return EIO;
+            }
+            group_index = group_index.value() == m_block_group_count ? 1 : group_index.value() + 1;
+            hint = 0;
+            continue;
         }
+
+        BlockIndex first_block = first_block_of_group(group_index).value() + run_start;
+        dbgln_if(EXT2_DEBUG, "Ext2FS: allocating run of {} blocks at {} [{}]", run_length.value(), first_block, group_index);
+        TRY(set_block_run_allocation_state(first_block, run_length.value(), true));
+        for (size_t i = 0; i < run_length.value(); ++i)
+            blocks.unchecked_append(first_block.value() + i);
+        hint = run_start + run_length.value();
     }
 
     VERIFY(blocks.size() == count);
     return blocks;
 }
 
+auto Ext2FS::allocate_blocks_for_inode(InodeIndex inode_index, BlockIndex goal, size_t count, size_t reservation_window) -> ErrorOr<Vector<BlockIndex>>
+{
+    if (count == 0)
+        return Vector<BlockIndex> {};
+
+    Vector<BlockIndex> blocks;
+    TRY(blocks.try_ensure_capacity(count));
+
+    MutexLocker locker(m_lock);
+
+    // If the inode still has blocks set aside right behind its last one, those come first.
+    if (auto it = m_block_reservations.find(inode_index); it != m_block_reservations.end()) {
+        auto& reservation = it->value;
+        if (goal.value() && reservation.first_block.value() == goal.value() + 1) {
+            auto blocks_to_take = min(count, reservation.count);
+            for (size_t i = 0; i < blocks_to_take; ++i)
+                blocks.unchecked_append(reservation.first_block.value() + i);
+            reservation.first_block = reservation.first_block.value() + blocks_to_take;
+            reservation.count -= blocks_to_take;
+            m_reserved_block_count -= blocks_to_take;
+            if (reservation.count == 0)
+                m_block_reservations.remove(it);
+        } else {
+            TRY(release_block_reservation(inode_index));
+        }
+    }
+
+    if (blocks.size() < count) {
+        auto previous_block = blocks.is_empty() ? goal : blocks.last();
+        auto more_blocks = TRY(allocate_blocks(group_index_from_inode(inode_index), count - blocks.size(), previous_block));
+        TRY(blocks.try_extend(move(more_blocks)));
+    }
+
+    if (reservation_window && !m_block_reservations.contains(inode_index))
+        TRY(reserve_blocks_after(inode_index, blocks.last(), reservation_window));
+
+    return blocks;
+}
+
+ErrorOr<void> Ext2FS::reserve_blocks_after(InodeIndex inode_index, BlockIndex block_index, size_t window)
+{
+    MutexLocker locker(m_lock);
+
+    // When space is getting tight, it's better to let other inodes have it.
+    if (super_block().s_free_blocks_count < window * 16)
+        return {};
+
+    BlockIndex first_block = block_index.value() + 1;
+    if (first_block.value() >= super_block().s_blocks_count)
+        return {};
+
+    auto group_index = group_index_from_block_index(first_block);
+    auto const& bgd = group_descriptor(group_index);
+    if (!bgd.bg_free_blocks_count)
+        return {};
+
+    size_t blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
+    size_t bit_index = first_block.value() - first_block_of_group(group_index).value();
+    if (bit_index >= blocks_in_group)
+        return {};
+
+    auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+    auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
+    size_t run_start = bit_index;
+    auto run_length = block_bitmap.find_next_range_of_unset_bits(run_start, 1, min(window, blocks_in_group - bit_index));
+    if (!run_length.has_value() || run_start != bit_index)
+        return {};
+
+    TRY(m_block_reservations.try_ensure_capacity(m_block_reservations.size() + 1));
+    TRY(set_block_run_allocation_state(first_block, run_length.value(), true));
+    m_block_reservations.set(inode_index, { first_block, run_length.value() });
+    m_reserved_block_count += run_length.value();
+    dbgln_if(EXT2_DEBUG, "Ext2FS: Reserved {} blocks at {} for inode {}", run_length.value(), first_block, inode_index);
+    return {};
+}
+
+ErrorOr<void> Ext2FS::release_block_reservation(InodeIndex inode_index)
+{
+    MutexLocker locker(m_lock);
+    auto reservation = m_block_reservations.take(inode_index);
+    if (!reservation.has_value())
+        return {};
+    m_reserved_block_count -= reservation->count;
+    return set_block_run_allocation_state(reservation->first_block, reservation->count, false);
+}
+
+ErrorOr<void> Ext2FS::release_all_block_reservations()
+{
+    MutexLocker locker(m_lock);
+    auto reservations = move(m_block_reservations);
+    m_reserved_block_count = 0;
+    for (auto& it : reservations)
+        TRY(set_block_run_allocation_state(it.value.first_block, it.value.count, false));
+    return {};
+}
+
 ErrorOr<InodeIndex> Ext2FS::allocate_inode(GroupIndex preferred_group)
 {
     dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_inode(preferred_group: {})", preferred_group);
@@ -343,7 +468,7 @@ Ext2FS::GroupIndex Ext2FS::group_index_from_block_index(BlockIndex block_index)
 {
     if (!block_index)
         return 0;
-    return (block_index.value() - 1) / blocks_per_group() + 1;
+    return (block_index.value() - first_block_index().value()) / blocks_per_group() + 1;
 }
 
 auto Ext2FS::group_index_from_inode(InodeIndex inode) const -> GroupIndex
@@ -437,6 +562,34 @@ ErrorOr<void> Ext2FS::set_block_allocation_state(BlockIndex block_index, bool ne
     return update_bitmap_block(bgd.bg_block_bitmap, bit_index, new_state, m_super_block.s_free_blocks_count, bgd.bg_free_blocks_count);
 }
 
+ErrorOr<void> Ext2FS::set_block_run_allocation_state(BlockIndex first_block, size_t count, bool new_state)
+{
+    VERIFY(first_block != 0);
+    MutexLocker locker(m_lock);
+
+    auto group_index = group_index_from_block_index(first_block);
+    size_t bit_index = first_block.value() - first_block_of_group(group_index).value();
+    VERIFY(bit_index + count <= blocks_per_group());
+    auto& bgd = const_cast<ext2_group_desc&>(group_descriptor(group_index));
+
+    dbgln_if(EXT2_DEBUG, "Ext2FS: Blocks {}-{} state -> {} (in bitmap block {})", first_block, first_block.value() + count - 1, new_state, bgd.bg_block_bitmap);
+    auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+    cached_bitmap->bitmap(blocks_per_group()).set_range_and_verify_that_all_bits_flip(bit_index, count, new_state);
+    cached_bitmap->dirty = true;
+
+    if (new_state) {
+        m_super_block.s_free_blocks_count -= count;
+        bgd.bg_free_blocks_count -= count;
+    } else {
+        m_super_block.s_free_blocks_count += count;
+        bgd.bg_free_blocks_count += count;
+    }
+
+    m_super_block_dirty = true;
+    m_block_group_descriptors_dirty = true;
+    return {};
+}
+
 ErrorOr<NonnullRefPtr<Inode>> Ext2FS::create_directory(Ext2FSInode& parent_inode, StringView name, mode_t mode, UserID uid, GroupID gid)
 {
     MutexLocker locker(m_lock);
@@ -517,7 +670,8 @@ unsigned Ext2FS::total_block_count() const
 unsigned Ext2FS::free_block_count() const
 {
     MutexLocker locker(m_lock);
-    return super_block().s_free_blocks_count;
+    // NOTE: Blocks that are set aside for growing inodes are still available to everyone else.
+    return super_block().s_free_blocks_count + m_reserved_block_count;
 }
 
 unsigned Ext2FS::total_inode_count() const
@@ -552,6 +706,8 @@ ErrorOr<void> Ext2FS::free_inode(Ext2FSInode& inode)
     VERIFY(inode.m_raw_inode.i_links_count == 0);
     dbgln_if(EXT2_DEBUG, "Ext2FS[{}]::free_inode(): Inode {} has no more links, time to delete!", fsid(), inode.index());
 
+    TRY(release_block_reservation(inode.index()));
+
     // Mark all blocks used by this inode as free.
     {
         auto blocks = TRY(inode.compute_block_list_with_meta_blocks());
@@ -595,6 +751,9 @@ void Ext2FS::flush_writes()
 {
     {
         MutexLocker locker(m_lock);
+        // The reserved blocks are marked as used in the bitmaps, which is not what we want to end up on disk.
+        if (auto result = release_all_block_reservations(); result.is_error())
+            dbgln("Ext2FS[{}]::flush_writes(): Failed to release block reservations: {}", fsid(), result.error());
         if (m_super_block_dirty) {
             auto result = flush_super_block();
             if (result.is_error()) {
@@ -37,6 +37,7 @@ public:
     virtual unsigned free_inode_count() const override;
 
     virtual bool supports_watchers() const override { return true; }
+    virtual bool supports_lookup_caching() const override { return true; }
 
     virtual u8 internal_file_type_to_directory_entry_type(DirectoryEntryView const& entry) const override;
 
@@ -78,13 +79,30 @@ private:
 
     BlockIndex first_block_index() const;
     ErrorOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
-    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+    BlockIndex first_block_of_group(GroupIndex) const;
+    // If given, the goal is the block that the new blocks should follow on disk.
+    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal = 0);
+    ErrorOr<Vector<BlockIndex>> allocate_blocks_for_inode(InodeIndex, BlockIndex goal, size_t count, size_t reservation_window);
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
 
     ErrorOr<bool> get_inode_allocation_state(InodeIndex) const;
     ErrorOr<void> set_inode_allocation_state(InodeIndex, bool);
     ErrorOr<void> set_block_allocation_state(BlockIndex, bool);
+    ErrorOr<void> set_block_run_allocation_state(BlockIndex first_block, size_t count, bool);
+
+    // A growing inode gets the blocks right behind its last one set aside for a while, so its next blocks
+    // end up there, even if other inodes are growing at the same time. Reserved blocks are marked as used in
+    // the bitmaps, and are given back when the inode stops growing there, when we run out of space, or when
+    // the bitmaps are about to be written to disk.
+    struct BlockReservation {
+        BlockIndex first_block { 0 };
+        size_t count { 0 };
+    };
+
+    ErrorOr<void> reserve_blocks_after(InodeIndex, BlockIndex, size_t window);
+    ErrorOr<void> release_block_reservation(InodeIndex);
+    ErrorOr<void> release_all_block_reservations();
 
     void uncache_inode(InodeIndex);
     ErrorOr<void> free_inode(Ext2FSInode&);
@@ -125,6 +143,8 @@ private:
     ErrorOr<void> update_bitmap_block(BlockIndex bitmap_block, size_t bit_index, bool new_state, u32& super_block_counter, u16& group_descriptor_counter);
 
     Vector<OwnPtr<CachedBitmap>> m_cached_bitmaps;
+    HashMap<InodeIndex, BlockReservation> m_block_reservations;
+    size_t m_reserved_block_count { 0 };
     RefPtr<Ext2FSInode> m_root_inode;
 };
 
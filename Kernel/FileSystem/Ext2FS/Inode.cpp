@@ -585,10 +585,50 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
         nread += num_bytes_to_copy;
     }
 
+    if (allow_cache && description && Kernel::is_regular_file(m_raw_inode.i_mode)) {
+        if (auto window = description->update_read_ahead_state(offset, nread, size()); window.has_value())
+            schedule_read_ahead(window.value());
+    }
+
     return nread;
 }
 
-ErrorOr<void> Ext2FSInode::resize(u64 new_size)
+void Ext2FSInode::schedule_read_ahead(ReadAheadState::Window window) const
+{
+    u64 const block_size = fs().block_size();
+    auto first_block_logical_index = window.offset / block_size;
+    auto end_block_logical_index = min(ceil_div(window.offset + window.size, block_size), static_cast<u64>(m_block_list.size()));
+    if (first_block_logical_index >= end_block_logical_index)
+        return;
+
+    Vector<BlockBasedFileSystem::BlockIndex> blocks;
+    if (blocks.try_ensure_capacity(end_block_logical_index - first_block_logical_index).is_error())
+        return;
+    for (auto bi = first_block_logical_index; bi < end_block_logical_index; ++bi) {
+        auto block_index = m_block_list[bi];
+        // Holes don't need to be read from disk.
+        if (block_index.value() != 0)
+            blocks.unchecked_append(block_index);
+    }
+
+    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::schedule_read_ahead(): {} bytes at offset {} ({} blocks)", identifier(), window.size, window.offset, blocks.size());
+    fs().schedule_read_ahead(move(blocks));
+}
+
+// A growing file gets about as many blocks set aside behind its last one as it already has, within limits.
+static constexpr size_t min_block_reservation_window = 8;
+static constexpr size_t max_block_reservation_window = 1024;
+
+BlockBasedFileSystem::BlockIndex Ext2FSInode::last_allocated_block() const
+{
+    for (size_t i = m_block_list.size(); i > 0; --i) {
+        if (m_block_list[i - 1].value())
+            return m_block_list[i - 1];
+    }
+    return 0;
+}
+
+ErrorOr<void> Ext2FSInode::resize(u64 new_size, ShouldZeroFill should_zero_fill)
 {
     auto old_size = size();
     if (old_size == new_size)
@@ -608,7 +648,7 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 
     if (blocks_needed_after > blocks_needed_before) {
         auto additional_blocks_needed = blocks_needed_after - blocks_needed_before;
-        if (additional_blocks_needed > fs().super_block().s_free_blocks_count)
+        if (additional_blocks_needed > fs().free_block_count())
             return ENOSPC;
     }
 
@@ -616,9 +656,14 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
         m_block_list = TRY(compute_block_list());
 
     if (blocks_needed_after > blocks_needed_before) {
-        auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before));
+        size_t reservation_window = 0;
+        if (Kernel::is_regular_file(m_raw_inode.i_mode))
+            reservation_window = clamp(static_cast<size_t>(blocks_needed_after), min_block_reservation_window, max_block_reservation_window);
+        auto blocks = TRY(fs().allocate_blocks_for_inode(index(), last_allocated_block(), blocks_needed_after - blocks_needed_before, reservation_window));
         TRY(m_block_list.try_extend(move(blocks)));
     } else if (blocks_needed_after < blocks_needed_before) {
+        // Whatever was set aside behind the old end of the inode is no use anymore.
+        TRY(fs().release_block_reservation(index()));
         if constexpr (EXT2_VERY_DEBUG) {
             dbgln("Ext2FSInode[{}]::resize(): Shrinking inode, old block list is {} entries:", identifier(), m_block_list.size());
             for (auto block_index : m_block_list) {
@@ -644,7 +689,7 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 
     set_metadata_dirty(true);
 
-    if (new_size > old_size) {
+    if (new_size > old_size && should_zero_fill == ShouldZeroFill::Yes) {
         // If we're growing the inode, make sure we zero out all the new space.
         // FIXME: There are definitely more efficient ways to achieve this.
         auto bytes_to_clear = new_size - old_size;
@@ -686,7 +731,12 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
     auto const block_size = fs().block_size();
     auto new_size = max(static_cast<u64>(offset) + count, size());
 
-    TRY(resize(new_size));
+    // A gap between the old end of the inode and the start of the write has to read back as zeroes,
+    // but the new space after that is about to be written anyway, so there's no need to clear it first.
+    if (static_cast<u64>(offset) > size())
+        TRY(resize(offset));
+    auto size_before_write = size();
+    TRY(resize(new_size, ShouldZeroFill::No));
 
     if (m_block_list.is_empty())
         m_block_list = TRY(compute_block_list());
@@ -714,6 +764,8 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
         dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), m_block_list[bi.value()], offset_into_block);
         if (auto result = fs().write_block(m_block_list[bi.value()], data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
             dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write block {} (index {})", identifier(), m_block_list[bi.value()], bi);
+            // The rest of the new space was never cleared, so it must not become part of the inode.
+            (void)resize(max(size_before_write, static_cast<u64>(offset) + nwritten));
             return result.release_error();
         }
         remaining_count -= num_bytes_to_copy;
@@ -1069,6 +1121,48 @@ ErrorOr<void> Ext2FSInode::truncate(u64 size)
     return {};
 }
 
+ErrorOr<void> Ext2FSInode::preallocate(u64 offset, u64 length)
+{
+    MutexLocker locker(m_inode_lock);
+
+    if (m_block_list.is_empty())
+        m_block_list = TRY(compute_block_list());
+
+    // Holes in the part of the range that's already inside the inode get blocks of their own.
+    u64 block_size = fs().block_size();
+    auto end_of_range = offset + length;
+    auto first_block_logical_index = offset / block_size;
+    auto end_block_logical_index = min(ceil_div(min(end_of_range, size()), block_size), static_cast<u64>(m_block_list.size()));
+    bool filled_holes = false;
+    for (auto bi = first_block_logical_index; bi < end_block_logical_index;) {
+        if (m_block_list[bi].value()) {
+            ++bi;
+            continue;
+        }
+        auto hole_length = 1u;
+        while (bi + hole_length < end_block_logical_index && !m_block_list[bi + hole_length].value())
+            ++hole_length;
+
+        auto goal = bi > 0 ? m_block_list[bi - 1] : BlockBasedFileSystem::BlockIndex { 0 };
+        auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), hole_length, goal));
+        auto zero_buffer = TRY(ByteBuffer::create_zeroed(block_size));
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            TRY(fs().write_block(blocks[i], UserOrKernelBuffer::for_kernel_buffer(zero_buffer.data()), block_size));
+            m_block_list[bi + i] = blocks[i];
+        }
+        filled_holes = true;
+        bi += hole_length;
+    }
+    if (filled_holes)
+        TRY(flush_block_list());
+
+    if (end_of_range > size())
+        TRY(resize(end_of_range));
+
+    set_metadata_dirty(true);
+    return {};
+}
+
 ErrorOr<int> Ext2FSInode::get_block_address(int index)
 {
     MutexLocker locker(m_inode_lock);
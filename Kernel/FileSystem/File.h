@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -21,10 +22,60 @@ namespace Kernel {
 
 class File;
 
+// A FileReadinessWatcher is notified whenever the blocking conditions of the
+// OpenFileDescription it watches are re-evaluated, i.e. whenever the file might
+// have become readable or writable. This is what EPoll is built on.
+class FileReadinessWatcher {
+public:
+    virtual ~FileReadinessWatcher() = default;
+
+    virtual OpenFileDescription const* watched_description() const = 0;
+
+    // NOTE: Both of these are called with the FileBlockerSet lock held.
+    virtual void readiness_may_have_changed() = 0;
+    virtual void watched_description_will_be_destroyed() = 0;
+
+private:
+    friend class FileBlockerSet;
+    IntrusiveListNode<FileReadinessWatcher> m_watcher_list_node;
+};
+
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
     FileBlockerSet() { }
 
+    virtual ~FileBlockerSet() override
+    {
+        VERIFY(m_readiness_watchers.is_empty());
+    }
+
+    void add_readiness_watcher(FileReadinessWatcher& watcher)
+    {
+        SpinlockLocker lock(m_lock);
+        m_readiness_watchers.append(watcher);
+    }
+
+    void remove_readiness_watcher(FileReadinessWatcher& watcher)
+    {
+        SpinlockLocker lock(m_lock);
+        // NOTE: The watcher may already have been detached by detach_readiness_watchers_for().
+        if (watcher.m_watcher_list_node.is_in_list())
+            m_readiness_watchers.remove(watcher);
+    }
+
+    void detach_readiness_watchers_for(OpenFileDescription const& description)
+    {
+        SpinlockLocker lock(m_lock);
+        for (auto it = m_readiness_watchers.begin(); it != m_readiness_watchers.end();) {
+            auto& watcher = *it;
+            ++it;
+            if (watcher.watched_description() != &description)
+                continue;
+            m_readiness_watchers.remove(watcher);
+            watcher.watched_description_will_be_destroyed();
+        }
+    }
+
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
@@ -40,7 +91,12 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& watcher : m_readiness_watchers)
+            watcher.readiness_may_have_changed();
     }
+
+private:
+    IntrusiveList<&FileReadinessWatcher::m_watcher_list_node> m_readiness_watchers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -114,6 +170,8 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_epoll() const { return false; }
+    virtual bool is_io_ring() const { return false; }
 
     virtual bool is_regular_file() const { return false; }
 
@@ -34,6 +34,10 @@ public:
     virtual Inode& root_inode() = 0;
     virtual bool supports_watchers() const { return false; }
 
+    // Whether the children of a directory only ever change through Inode::did_add_child() and
+    // Inode::did_remove_child(), so that lookups may be cached in the DirectoryEntryCache.
+    virtual bool supports_lookup_caching() const { return false; }
+
     bool is_readonly() const { return m_readonly; }
 
     virtual unsigned total_block_count() const { return 0; }
@@ -53,6 +57,9 @@ public:
 
     virtual void flush_writes() { }
 
+    // Gives memory used for caching back to the system. Returns the number of bytes actually released.
+    virtual size_t release_cached_memory(size_t) { return 0; }
+
     u64 block_size() const { return m_block_size; }
     size_t fragment_size() const { return m_fragment_size; }
 
@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/API/POSIX/poll.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KString.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static constexpr u32 header_size = 64;
+static_assert(sizeof(io_ring_header) <= header_size);
+
+ErrorOr<NonnullRefPtr<IORing>> IORing::try_create(Process& process, u32 requested_entries)
+{
+    VERIFY(requested_entries > 0 && requested_entries <= IO_RING_MAX_ENTRIES);
+    u32 sq_entries = 1;
+    while (sq_entries < requested_entries)
+        sq_entries <<= 1;
+    u32 cq_entries = 2 * sq_entries;
+
+    size_t size = header_size + sq_entries * sizeof(io_ring_sqe) + cq_entries * sizeof(io_ring_cqe);
+    size = TRY(Memory::page_round_up(size));
+
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "IORing"sv, Memory::Region::Access::ReadWrite));
+    memset(region->vaddr().as_ptr(), 0, size);
+    return adopt_nonnull_ref_or_enomem(new (nothrow) IORing(process, sq_entries, move(vmobject), move(region)));
+}
+
+IORing::IORing(Process& process, u32 sq_entries, NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region)
+    : m_process(process)
+    , m_sq_entries(sq_entries)
+    , m_cq_entries(2 * sq_entries)
+    , m_vmobject(move(vmobject))
+    , m_region(move(region))
+{
+}
+
+IORing::~IORing()
+{
+    VERIFY(m_state.with([](auto& state) { return state.waiting_operations.is_empty(); }));
+}
+
+u32 IORing::sqes_offset() const
+{
+    return header_size;
+}
+
+u32 IORing::cqes_offset() const
+{
+    return header_size + m_sq_entries * sizeof(io_ring_sqe);
+}
+
+io_ring_sqe const& IORing::sqe_at(u32 index) const
+{
+    auto* sqes = reinterpret_cast<io_ring_sqe const*>(m_region->vaddr().offset(sqes_offset()).as_ptr());
+    return sqes[index & (m_sq_entries - 1)];
+}
+
+io_ring_cqe& IORing::cqe_at(u32 index)
+{
+    auto* cqes = reinterpret_cast<io_ring_cqe*>(m_region->vaddr().offset(cqes_offset()).as_ptr());
+    return cqes[index & (m_cq_entries - 1)];
+}
+
+size_t IORing::available_completions() const
+{
+    u32 head = AK::atomic_load(&header().cq_head, AK::MemoryOrder::memory_order_acquire);
+    u32 tail = AK::atomic_load(&m_cq_tail, AK::MemoryOrder::memory_order_relaxed);
+    // The process may have put anything into the head, so don't trust it to be sensible.
+    return min(tail - head, m_cq_entries);
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> IORing::vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared)
+{
+    // A private mapping would be a copy of the ring, which wouldn't be of much use to anyone.
+    if (offset != 0 || !shared)
+        return EINVAL;
+    return m_vmobject;
+}
+
+ErrorOr<void> IORing::close()
+{
+    IntrusiveList<&Operation::m_waiting_list_node> cancelled_operations;
+    m_state.with([&](auto& state) {
+        state.is_closed = true;
+        while (!state.waiting_operations.is_empty()) {
+            auto operation = state.waiting_operations.take_first();
+            operation->m_is_waiting = false;
+            cancelled_operations.append(*operation);
+        }
+    });
+
+    // NOTE: Operations that are already on the work queue will notice that we're closed once they run.
+    while (!cancelled_operations.is_empty()) {
+        auto operation = cancelled_operations.take_first();
+        operation->m_description->blocker_set().remove_readiness_watcher(*operation);
+        operation->m_is_watching = false;
+        complete(operation->m_sqe.user_data, ECANCELED);
+    }
+
+    m_completion_wait_queue.wake_all();
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KString>> IORing::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::formatted("IORing:({})", m_sq_entries);
+}
+
+ErrorOr<size_t> IORing::submit(Process& process, u32 count)
+{
+    MutexLocker locker(m_submission_lock);
+
+    u32 tail = AK::atomic_load(&header().sq_tail, AK::MemoryOrder::memory_order_acquire);
+    u32 queued = tail - m_sq_head;
+    if (queued > m_sq_entries)
+        return EINVAL;
+    count = min(count, queued);
+
+    auto* address_space = process.address_space().with([](auto& space) { return space.ptr(); });
+
+    size_t submitted = 0;
+    for (; submitted < count; ++submitted) {
+        // Every operation gets a place in the completion queue before it starts, so it never overflows.
+        bool has_room = m_state.with([&](auto& state) {
+            if (state.in_flight + available_completions() >= m_cq_entries)
+                return false;
+            ++state.in_flight;
+            return true;
+        });
+        if (!has_room)
+            break;
+
+        // The process can change the entry under our feet, so we only look at it once.
+        io_ring_sqe sqe;
+        memcpy(&sqe, &sqe_at(m_sq_head), sizeof(sqe));
+        ++m_sq_head;
+        AK::atomic_store(&header().sq_head, m_sq_head, AK::MemoryOrder::memory_order_release);
+
+        if (auto result = start(process, sqe, address_space); result.is_error())
+            complete(sqe.user_data, result.release_error());
+    }
+
+    if (submitted == 0 && count > 0)
+        return EBUSY;
+    return submitted;
+}
+
+ErrorOr<void> IORing::start(Process& process, io_ring_sqe const& sqe, Memory::AddressSpace* address_space)
+{
+    if (sqe.opcode == IO_RING_OP_NOP) {
+        complete(sqe.user_data, 0);
+        return {};
+    }
+
+    auto description = TRY(process.open_file_description(sqe.fd));
+    // NOTE: Nesting is not supported, as an operation on a ring would keep it alive after it has been closed.
+    if (description->is_io_ring())
+        return EINVAL;
+
+    switch (sqe.opcode) {
+    case IO_RING_OP_READ:
+    case IO_RING_OP_WRITE:
+    case IO_RING_OP_FSYNC:
+    case IO_RING_OP_POLL_ADD:
+        break;
+    case IO_RING_OP_ACCEPT:
+        if (!description->is_socket())
+            return ENOTSOCK;
+        TRY(process.require_promise(Pledge::accept));
+        break;
+    case IO_RING_OP_CONNECT:
+        if (!description->is_socket())
+            return ENOTSOCK;
+        // NOTE: Connecting a local socket resolves its path relative to the current process, which the work queue
+        //       threads are not, so they'd bypass the submitter's working directory and unveil() restrictions.
+        if (description->socket()->domain() != AF_INET)
+            return EOPNOTSUPP;
+        TRY(process.require_promise(Pledge::inet));
+        break;
+    case IO_RING_OP_SEND:
+    case IO_RING_OP_RECV:
+        if (!description->is_socket())
+            return ENOTSOCK;
+        break;
+    default:
+        return EINVAL;
+    }
+
+    switch (sqe.opcode) {
+    case IO_RING_OP_READ:
+    case IO_RING_OP_WRITE:
+    case IO_RING_OP_SEND:
+    case IO_RING_OP_RECV:
+        if (!Memory::is_user_range(VirtualAddress(sqe.address), sqe.length))
+            return EFAULT;
+        break;
+    default:
+        break;
+    }
+
+    auto operation = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Operation(*this, sqe, move(description), address_space)));
+    return queue(move(operation));
+}
+
+ErrorOr<void> IORing::queue(NonnullRefPtr<Operation> operation)
+{
+    return g_io_ring_work->try_queue([operation = move(operation)] {
+        operation->m_ring->execute(operation);
+    });
+}
+
+void IORing::execute(NonnullRefPtr<Operation> operation)
+{
+    if (operation->m_is_watching) {
+        operation->m_description->blocker_set().remove_readiness_watcher(*operation);
+        operation->m_is_watching = false;
+    }
+
+    if (m_state.with([](auto& state) { return state.is_closed; }) || m_process->is_dying()) {
+        complete(operation->m_sqe.user_data, ECANCELED);
+        return;
+    }
+
+    bool has_same_address_space = m_process->address_space().with([&](auto& space) { return space.ptr() == operation->m_address_space; });
+    if (!has_same_address_space) {
+        complete(operation->m_sqe.user_data, ECANCELED);
+        return;
+    }
+
+    ErrorOr<FlatPtr> result = 0;
+    {
+        ScopedAddressSpaceSwitcher switcher(*m_process);
+        result = operation->perform();
+    }
+    if (!result.is_error() || result.error().code() != EAGAIN) {
+        complete(operation->m_sqe.user_data, move(result));
+        return;
+    }
+
+    // The file isn't ready, so wait for it to tell us that it might be.
+    operation->m_description->blocker_set().add_readiness_watcher(*operation);
+    operation->m_is_watching = true;
+    bool is_waiting = m_state.with([&](auto& state) {
+        if (state.is_closed)
+            return false;
+        operation->m_is_waiting = true;
+        state.waiting_operations.append(*operation);
+        return true;
+    });
+    if (!is_waiting) {
+        operation->m_description->blocker_set().remove_readiness_watcher(*operation);
+        operation->m_is_watching = false;
+        complete(operation->m_sqe.user_data, ECANCELED);
+        return;
+    }
+
+    // The file may have become ready before we started watching it, in which case nobody is going to tell us.
+    if (!operation->is_ready())
+        return;
+    bool should_retry = m_state.with([&](auto& state) {
+        if (!operation->m_is_waiting)
+            return false;
+        operation->m_is_waiting = false;
+        state.waiting_operations.remove(*operation);
+        return true;
+    });
+    if (!should_retry)
+        return;
+    if (auto queue_result = queue(operation); queue_result.is_error()) {
+        operation->m_description->blocker_set().remove_readiness_watcher(*operation);
+        operation->m_is_watching = false;
+        complete(operation->m_sqe.user_data, queue_result.release_error());
+    }
+}
+
+void IORing::complete(u64 user_data, ErrorOr<FlatPtr> result)
+{
+    i32 value = result.is_error() ? -static_cast<i32>(result.error().code()) : static_cast<i32>(min<FlatPtr>(result.value(), NumericLimits<i32>::max()));
+    post_completion(user_data, value);
+    m_state.with([](auto& state) { --state.in_flight; });
+}
+
+void IORing::post_completion(u64 user_data, i32 result)
+{
+    {
+        SpinlockLocker locker(m_completion_lock);
+        // Submissions are throttled so that this can only happen if the process moved the head backwards.
+        if (available_completions() >= m_cq_entries) {
+            dbgln("IORing: Dropping completion for {:#x}, the completion queue is full", user_data);
+            return;
+        }
+        auto& cqe = cqe_at(m_cq_tail);
+        cqe.user_data = user_data;
+        cqe.result = result;
+        cqe.flags = 0;
+        AK::atomic_store(&m_cq_tail, m_cq_tail + 1, AK::MemoryOrder::memory_order_relaxed);
+        AK::atomic_store(&header().cq_tail, m_cq_tail, AK::MemoryOrder::memory_order_release);
+    }
+
+    m_completion_wait_queue.wake_all();
+    evaluate_block_conditions();
+}
+
+IORing::Operation::Operation(IORing& ring, io_ring_sqe const& sqe, RefPtr<OpenFileDescription> description, Memory::AddressSpace* address_space)
+    : m_ring(ring)
+    , m_sqe(sqe)
+    , m_description(move(description))
+    , m_address_space(address_space)
+{
+}
+
+void IORing::Operation::readiness_may_have_changed()
+{
+    // NOTE: We may not stop watching the file from in here, so that's left to execute().
+    //       Until then, the waiting flag keeps us from being queued more than once.
+    NonnullRefPtr<Operation> self = *this;
+    bool should_queue = m_ring->m_state.with([&](auto&) {
+        if (!m_is_waiting)
+            return false;
+        m_is_waiting = false;
+        return true;
+    });
+    if (!should_queue)
+        return;
+
+    if (m_ring->queue(self).is_error()) {
+        // We'll try again the next time the file notifies us.
+        m_ring->m_state.with([&](auto&) {
+            if (m_waiting_list_node.is_in_list())
+                m_is_waiting = true;
+        });
+        return;
+    }
+
+    m_ring->m_state.with([&](auto& state) {
+        if (m_waiting_list_node.is_in_list())
+            state.waiting_operations.remove(*this);
+    });
+}
+
+bool IORing::Operation::is_ready() const
+{
+    switch (m_sqe.opcode) {
+    case IO_RING_OP_READ:
+    case IO_RING_OP_RECV:
+    case IO_RING_OP_ACCEPT:
+        return m_description->can_read();
+    case IO_RING_OP_WRITE:
+    case IO_RING_OP_SEND:
+        return m_description->can_write();
+    case IO_RING_OP_CONNECT:
+        return !m_connect_in_progress || m_description->socket()->setup_state() != Socket::SetupState::InProgress;
+    case IO_RING_OP_POLL_ADD:
+        return poll_events() != 0;
+    default:
+        return true;
+    }
+}
+
+ErrorOr<FlatPtr> IORing::Operation::perform()
+{
+    auto& description = *m_description;
+    switch (m_sqe.opcode) {
+    case IO_RING_OP_READ: {
+        if (!description.can_read())
+            return EAGAIN;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(m_sqe.address), m_sqe.length));
+        if (m_sqe.offset < 0)
+            return TRY(description.read(buffer, m_sqe.length));
+        return TRY(description.read(buffer, m_sqe.offset, m_sqe.length));
+    }
+    case IO_RING_OP_WRITE: {
+        if (!description.can_write())
+            return EAGAIN;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(m_sqe.address), m_sqe.length));
+        if (m_sqe.offset < 0)
+            return TRY(description.write(buffer, m_sqe.length));
+        return TRY(description.write(m_sqe.offset, buffer, m_sqe.length));
+    }
+    case IO_RING_OP_FSYNC:
+        TRY(description.sync());
+        return 0;
+    case IO_RING_OP_ACCEPT:
+        return accept();
+    case IO_RING_OP_CONNECT:
+        return connect();
+    case IO_RING_OP_SEND: {
+        auto& socket = *description.socket();
+        if (socket.is_shut_down_for_writing())
+            return EPIPE;
+        if (!description.can_write())
+            return EAGAIN;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(m_sqe.address), m_sqe.length));
+        return TRY(socket.sendto(description, buffer, m_sqe.length, m_sqe.op_flags | MSG_NOSIGNAL, {}, 0));
+    }
+    case IO_RING_OP_RECV: {
+        auto& socket = *description.socket();
+        if (socket.is_shut_down_for_reading())
+            return 0;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(m_sqe.address), m_sqe.length));
+        UnixDateTime timestamp {};
+        return TRY(socket.recvfrom(description, buffer, m_sqe.length, m_sqe.op_flags | MSG_DONTWAIT, {}, {}, timestamp, false));
+    }
+    case IO_RING_OP_POLL_ADD: {
+        auto events = poll_events();
+        if (events == 0)
+            return EAGAIN;
+        return events;
+    }
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+ErrorOr<FlatPtr> IORing::Operation::accept()
+{
+    auto& process = *m_ring->m_process;
+    auto& socket = *m_description->socket();
+
+    Userspace<sockaddr*> user_address(m_sqe.address);
+    Userspace<socklen_t*> user_address_size(m_sqe.address_length);
+    socklen_t address_size = 0;
+    if (user_address)
+        TRY(copy_from_user(&address_size, static_ptr_cast<socklen_t const*>(user_address_size)));
+
+    auto fd_allocation = TRY(process.fds().with_exclusive([](auto& fds) { return fds.allocate(); }));
+    auto accepted_socket = socket.accept(process);
+    if (!accepted_socket)
+        return EAGAIN;
+
+    if (user_address) {
+        sockaddr_un address_buffer {};
+        address_size = min(sizeof(sockaddr_un), static_cast<size_t>(address_size));
+        accepted_socket->get_peer_address((sockaddr*)&address_buffer, &address_size);
+        TRY(copy_to_user(user_address, &address_buffer, address_size));
+        TRY(copy_to_user(user_address_size, &address_size));
+    }
+
+    auto accepted_socket_description = TRY(OpenFileDescription::try_create(*accepted_socket));
+    accepted_socket_description->set_readable(true);
+    accepted_socket_description->set_writable(true);
+    if (m_sqe.op_flags & SOCK_NONBLOCK)
+        accepted_socket_description->set_blocking(false);
+    int fd_flags = 0;
+    if (m_sqe.op_flags & SOCK_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    process.fds().with_exclusive([&](auto& fds) {
+        fds[fd_allocation.fd].set(move(accepted_socket_description), fd_flags);
+    });
+
+    // NOTE: Moving this state to Completed is what causes connect() to unblock on the client side.
+    accepted_socket->set_setup_state(Socket::SetupState::Completed);
+    return fd_allocation.fd;
+}
+
+ErrorOr<FlatPtr> IORing::Operation::connect()
+{
+    auto& socket = *m_description->socket();
+    if (!m_connect_in_progress) {
+        // Never block a work queue thread until the connection is established, wait for the socket to tell us instead.
+        auto result = socket.connect(*m_ring->m_process->credentials(), *m_description, Userspace<sockaddr const*>(m_sqe.address), m_sqe.length, false);
+        if (!result.is_error())
+            return 0;
+        if (result.error().code() != EINPROGRESS)
+            return result.release_error();
+        m_connect_in_progress = true;
+    }
+
+    if (socket.setup_state() == Socket::SetupState::InProgress)
+        return EAGAIN;
+    if (socket.is_connected())
+        return 0;
+    // NOTE: This is what a blocking connect() reports as well.
+    return ECONNREFUSED;
+}
+
+u32 IORing::Operation::poll_events() const
+{
+    auto block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp;
+    if (m_sqe.op_flags & POLLIN)
+        block_flags |= BlockFlags::Read;
+    if (m_sqe.op_flags & POLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (m_sqe.op_flags & POLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (m_sqe.op_flags & POLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    auto unblock_flags = m_description->should_unblock(block_flags);
+
+    u32 events = 0;
+    if (has_flag(unblock_flags, BlockFlags::WriteHangUp))
+        events |= POLLHUP;
+    if (has_flag(unblock_flags, BlockFlags::WriteError))
+        events |= POLLERR;
+    if (has_flag(unblock_flags, BlockFlags::Read))
+        events |= POLLIN;
+    if (has_flag(unblock_flags, BlockFlags::ReadPriority))
+        events |= POLLPRI;
+    if (!has_flag(unblock_flags, BlockFlags::WriteHangUp) && has_flag(unblock_flags, BlockFlags::Write))
+        events |= POLLOUT;
+    if (has_flag(unblock_flags, BlockFlags::ReadHangUp))
+        events |= POLLRDHUP;
+    return events;
+}
+
+}
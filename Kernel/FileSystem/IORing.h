@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/IntrusiveList.h>
+#include <Kernel/API/POSIX/sys/io_ring.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Tasks/WaitQueue.h>
+
+namespace Kernel {
+
+// An IORing lets a process queue up I/O operations in memory it shares with the kernel, and pick up
+// their results from there, instead of making a (blocking) system call for each one of them.
+//
+// Submitted operations are carried out by the IORing work queue threads, in the address space of the
+// submitting process. Operations on files that aren't ready yet don't occupy a thread; like EPoll, they
+// register as a FileReadinessWatcher and go back to the work queue when the file might be ready.
+class IORing final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<IORing>> try_create(Process&, u32 requested_entries);
+    virtual ~IORing() override;
+
+    u32 sq_entries() const { return m_sq_entries; }
+    u32 cq_entries() const { return m_cq_entries; }
+    u32 sqes_offset() const;
+    u32 cqes_offset() const;
+    u32 mapping_size() const { return m_vmobject->size(); }
+
+    // Takes up to `count` operations off the submission queue and starts them. Returns how many
+    // were taken, which is fewer if the queue runs dry or too many operations are still in flight.
+    ErrorOr<size_t> submit(Process&, u32 count);
+
+    size_t available_completions() const;
+    WaitQueue& completion_wait_queue() { return m_completion_wait_queue; }
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override { return available_completions() > 0; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+    virtual ErrorOr<void> close() override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "IORing"sv; }
+    virtual bool is_io_ring() const override { return true; }
+
+private:
+    IORing(Process&, u32 sq_entries, NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>);
+
+    class Operation final
+        : public AtomicRefCounted<Operation>
+        , public FileReadinessWatcher {
+    public:
+        Operation(IORing&, io_ring_sqe const&, RefPtr<OpenFileDescription>, Memory::AddressSpace*);
+
+        virtual OpenFileDescription const* watched_description() const override { return m_description; }
+        virtual void readiness_may_have_changed() override;
+        // NOTE: We keep the description alive until the operation is done.
+        virtual void watched_description_will_be_destroyed() override { }
+
+        // Returns EAGAIN if the operation has to wait for the file to become ready.
+        ErrorOr<FlatPtr> perform();
+        bool is_ready() const;
+
+        NonnullRefPtr<IORing> const m_ring;
+        io_ring_sqe const m_sqe;
+        RefPtr<OpenFileDescription> const m_description;
+        // The operation is cancelled if the process has replaced its address space (by exec'ing) since submitting it.
+        Memory::AddressSpace* const m_address_space { nullptr };
+        bool m_is_watching { false };
+        bool m_connect_in_progress { false };
+
+        // Protected by the ring's state lock.
+        bool m_is_waiting { false };
+        IntrusiveListNode<Operation, RefPtr<Operation>> m_waiting_list_node;
+
+    private:
+        ErrorOr<FlatPtr> accept();
+        ErrorOr<FlatPtr> connect();
+        u32 poll_events() const;
+    };
+
+    struct State {
+        IntrusiveList<&Operation::m_waiting_list_node> waiting_operations;
+        size_t in_flight { 0 };
+        bool is_closed { false };
+    };
+
+    io_ring_header& header() { return *reinterpret_cast<io_ring_header*>(m_region->vaddr().as_ptr()); }
+    io_ring_header const& header() const { return *reinterpret_cast<io_ring_header const*>(m_region->vaddr().as_ptr()); }
+    io_ring_sqe const& sqe_at(u32 index) const;
+    io_ring_cqe& cqe_at(u32 index);
+
+    ErrorOr<void> start(Process&, io_ring_sqe const&, Memory::AddressSpace*);
+    ErrorOr<void> queue(NonnullRefPtr<Operation>);
+    void execute(NonnullRefPtr<Operation>);
+    void complete(u64 user_data, ErrorOr<FlatPtr>);
+    void post_completion(u64 user_data, i32 result);
+
+    NonnullRefPtr<Process> const m_process;
+    u32 const m_sq_entries { 0 };
+    u32 const m_cq_entries { 0 };
+    NonnullLockRefPtr<Memory::AnonymousVMObject> const m_vmobject;
+    NonnullOwnPtr<Memory::Region> const m_region;
+
+    // Our own copies of the indices we advance, as the process can write whatever it wants to the header.
+    Mutex m_submission_lock { "IORing submission"sv };
+    u32 m_sq_head { 0 };
+    Spinlock<LockRank::None> m_completion_lock {};
+    u32 m_cq_tail { 0 };
+    WaitQueue m_completion_wait_queue;
+
+    SpinlockProtected<State, LockRank::None> m_state {};
+};
+
+}
@@ -10,6 +10,7 @@
 #include <AK/StringView.h>
 #include <Kernel/API/InodeWatcherEvent.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
@@ -130,6 +131,14 @@ ErrorOr<void> Inode::decrement_link_count()
     return ENOTIMPL;
 }
 
+ErrorOr<void> Inode::preallocate(u64 offset, u64 length)
+{
+    // NOTE: File systems that don't allocate storage ahead of time only have to make sure that the inode is big enough.
+    if (size() >= offset + length)
+        return {};
+    return truncate(offset + length);
+}
+
 ErrorOr<void> Inode::set_shared_vmobject(Memory::SharedInodeVMObject& vmobject)
 {
     MutexLocker locker(m_inode_lock);
@@ -213,6 +222,9 @@ void Inode::set_metadata_dirty(bool metadata_dirty)
 
 void Inode::did_add_child(InodeIdentifier, StringView name)
 {
+    if (fs().supports_lookup_caching())
+        DirectoryEntryCache::the().invalidate(identifier(), name);
+
     m_watchers.for_each([&](auto& watcher) {
         watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::ChildCreated, name);
     });
@@ -220,6 +232,9 @@ void Inode::did_add_child(InodeIdentifier, StringView name)
 
 void Inode::did_remove_child(InodeIdentifier, StringView name)
 {
+    if (fs().supports_lookup_caching())
+        DirectoryEntryCache::the().invalidate(identifier(), name);
+
     if (name == "." || name == "..") {
         // These are just aliases and are not interesting to userspace.
         return;
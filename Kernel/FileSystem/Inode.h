@@ -71,6 +71,8 @@ public:
     virtual ErrorOr<void> chmod(mode_t) = 0;
     virtual ErrorOr<void> chown(UserID, GroupID) = 0;
     virtual ErrorOr<void> truncate(u64) { return {}; }
+    // Makes sure that storage has been allocated for the given range, growing the inode if needed.
+    virtual ErrorOr<void> preallocate(u64 offset, u64 length);
 
     ErrorOr<NonnullRefPtr<Custody>> resolve_as_link(Credentials const&, Custody& base, RefPtr<Custody>* out_parent, int options, int symlink_recursion_level) const;
 
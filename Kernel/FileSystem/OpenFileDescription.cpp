@@ -9,6 +9,8 @@
 #include <Kernel/API/POSIX/errno.h>
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/IORing.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/InodeFile.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
@@ -52,6 +54,7 @@ OpenFileDescription::OpenFileDescription(File& file)
 
 OpenFileDescription::~OpenFileDescription()
 {
+    blocker_set().detach_readiness_watchers_for(*this);
     m_file->detach(*this);
     // FIXME: Should this error path be observed somehow?
     (void)m_file->close();
@@ -313,6 +316,30 @@ InodeWatcher* OpenFileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool OpenFileDescription::is_epoll() const
+{
+    return m_file->is_epoll();
+}
+
+EPoll* OpenFileDescription::epoll()
+{
+    if (!is_epoll())
+        return nullptr;
+    return static_cast<EPoll*>(m_file.ptr());
+}
+
+bool OpenFileDescription::is_io_ring() const
+{
+    return m_file->is_io_ring();
+}
+
+IORing* OpenFileDescription::io_ring()
+{
+    if (!is_io_ring())
+        return nullptr;
+    return static_cast<IORing*>(m_file.ptr());
+}
+
 bool OpenFileDescription::is_master_pty() const
 {
     return m_file->is_master_pty();
@@ -519,11 +546,21 @@ OwnPtr<OpenFileDescriptionData>& OpenFileDescription::data()
     return m_state.with([](auto& state) -> OwnPtr<OpenFileDescriptionData>& { return state.data; });
 }
 
+OpenFileDescriptionData const* OpenFileDescription::data() const
+{
+    return m_state.with([](auto const& state) { return state.data.ptr(); });
+}
+
 off_t OpenFileDescription::offset() const
 {
     return m_state.with([](auto& state) { return state.current_offset; });
 }
 
+Optional<ReadAheadState::Window> OpenFileDescription::update_read_ahead_state(u64 offset, size_t nread, u64 file_size)
+{
+    return m_state.with([&](auto& state) { return state.read_ahead.did_read(offset, nread, file_size); });
+}
+
 RefPtr<Custody const> OpenFileDescription::custody() const
 {
     return m_state.with([](auto& state) { return state.custody; });
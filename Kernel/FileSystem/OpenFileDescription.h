@@ -13,6 +13,7 @@
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/ReadAheadState.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/KBuffer.h>
 #include <Kernel/Memory/VirtualAddress.h>
@@ -80,6 +81,12 @@ public:
     InodeWatcher const* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_epoll() const;
+    EPoll* epoll();
+
+    bool is_io_ring() const;
+    IORing* io_ring();
+
     bool is_master_pty() const;
     MasterPTY const* master_pty() const;
     MasterPTY* master_pty();
@@ -111,6 +118,7 @@ public:
     void set_fifo_direction(Badge<FIFO>, FIFO::Direction direction);
 
     OwnPtr<OpenFileDescriptionData>& data();
+    OpenFileDescriptionData const* data() const;
 
     void set_original_inode(Badge<VirtualFileSystem>, NonnullRefPtr<Inode> inode) { m_inode = move(inode); }
     void set_original_custody(Badge<VirtualFileSystem>, Custody& custody);
@@ -120,6 +128,8 @@ public:
 
     off_t offset() const;
 
+    Optional<ReadAheadState::Window> update_read_ahead_state(u64 offset, size_t nread, u64 file_size);
+
     ErrorOr<void> chown(Credentials const& credentials, UserID, GroupID);
 
     FileBlockerSet& blocker_set();
@@ -145,6 +155,7 @@ private:
         OwnPtr<OpenFileDescriptionData> data;
         RefPtr<Custody> custody;
         off_t current_offset { 0 };
+        ReadAheadState read_ahead {};
         u32 file_flags { 0 };
         bool readable : 1 { false };
         bool writable : 1 { false };
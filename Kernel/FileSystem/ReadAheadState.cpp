@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/ReadAheadState.h>
+
+namespace Kernel {
+
+Atomic<size_t> g_max_read_ahead_size { ReadAheadState::default_max_window_size };
+
+Optional<ReadAheadState::Window> ReadAheadState::did_read(u64 offset, size_t nread, u64 file_size)
+{
+    bool is_sequential = offset == m_next_expected_offset;
+    u64 read_end = offset + nread;
+    m_next_expected_offset = read_end;
+
+    auto max_window_size = g_max_read_ahead_size.load(AK::MemoryOrder::memory_order_relaxed);
+    if (!is_sequential || nread == 0 || max_window_size == 0) {
+        // Random access (or read-ahead being disabled) collapses the window,
+        // it will have to grow again from scratch once we see sequential reads.
+        m_window_size = 0;
+        m_read_ahead_end = 0;
+        return {};
+    }
+
+    if (read_end >= file_size)
+        return {};
+
+    // Only issue new read-ahead once the reader has consumed half of what we
+    // fetched last time, so we don't queue up the same blocks over and over.
+    if (m_read_ahead_end > read_end && m_read_ahead_end - read_end >= m_window_size / 2)
+        return {};
+
+    if (m_window_size == 0)
+        m_window_size = min(initial_window_size, max_window_size);
+    else
+        m_window_size = min(m_window_size * 2, max_window_size);
+
+    auto window_start = max(read_end, m_read_ahead_end);
+    auto window_end = min(read_end + m_window_size, file_size);
+    if (window_start >= window_end)
+        return {};
+
+    m_read_ahead_end = window_end;
+    return Window { window_start, static_cast<size_t>(window_end - window_start) };
+}
+
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// The upper bound for the read-ahead window of a single open file description,
+// adjustable through /sys/kernel/variables/read_ahead_max_kib.
+extern Atomic<size_t> g_max_read_ahead_size;
+
+class ReadAheadState {
+public:
+    static constexpr size_t initial_window_size = 16 * KiB;
+    static constexpr size_t default_max_window_size = 512 * KiB;
+
+    struct Window {
+        u64 offset { 0 };
+        size_t size { 0 };
+    };
+
+    // Updates the access pattern with a completed read of `nread` bytes at `offset`
+    // and returns the byte range that should be read ahead, if any.
+    Optional<Window> did_read(u64 offset, size_t nread, u64 file_size);
+
+    size_t window_size() const { return m_window_size; }
+
+private:
+    u64 m_next_expected_offset { 0 };
+    u64 m_read_ahead_end { 0 };
+    size_t m_window_size { 0 };
+};
+
+}
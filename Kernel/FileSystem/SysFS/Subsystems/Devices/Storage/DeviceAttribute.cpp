@@ -4,9 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/JsonArraySerializer.h>
+#include <AK/JsonObjectSerializer.h>
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/Access.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Devices/Storage/DeviceAttribute.h>
+#include <Kernel/Library/KBufferBuilder.h>
 #include <Kernel/Sections.h>
 
 namespace Kernel {
@@ -20,6 +23,8 @@ StringView StorageDeviceAttributeSysFSComponent::name() const
         return "sector_size"sv;
     case Type::CommandSet:
         return "command_set"sv;
+    case Type::RequestLatency:
+        return "request_latency"sv;
     default:
         VERIFY_NOT_REACHED();
     }
@@ -49,8 +54,35 @@ ErrorOr<size_t> StorageDeviceAttributeSysFSComponent::read_bytes(off_t offset, s
     return nread;
 }
 
+static ErrorOr<void> add_latency_histogram(JsonObjectSerializer<KBufferBuilder>& json, StringView name, BlockDevice::RequestLatencyHistogram const& histogram)
+{
+    auto histogram_object = TRY(json.add_object(name));
+    TRY(histogram_object.add("requests"sv, histogram.request_count));
+    TRY(histogram_object.add("total_us"sv, histogram.total_microseconds));
+    TRY(histogram_object.add("max_us"sv, histogram.max_microseconds));
+    auto buckets = TRY(histogram_object.add_array("buckets"sv));
+    for (auto count : histogram.buckets)
+        TRY(buckets.add(count));
+    TRY(buckets.finish());
+    TRY(histogram_object.finish());
+    return {};
+}
+
 ErrorOr<NonnullOwnPtr<KBuffer>> StorageDeviceAttributeSysFSComponent::try_to_generate_buffer() const
 {
+    if (m_type == Type::RequestLatency) {
+        auto statistics = m_device->request_statistics();
+        auto builder = TRY(KBufferBuilder::try_create());
+        auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+        TRY(add_latency_histogram(json, "read"sv, statistics.reads));
+        TRY(add_latency_histogram(json, "write"sv, statistics.writes));
+        TRY(json.finish());
+        auto buffer = builder.build();
+        if (!buffer)
+            return ENOMEM;
+        return buffer.release_nonnull();
+    }
+
     OwnPtr<KString> value;
     switch (m_type) {
     case Type::EndLBA:
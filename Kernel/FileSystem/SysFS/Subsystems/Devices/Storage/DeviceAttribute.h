@@ -18,6 +18,7 @@ public:
         EndLBA,
         SectorSize,
         CommandSet,
+        RequestLatency,
     };
 
 public:
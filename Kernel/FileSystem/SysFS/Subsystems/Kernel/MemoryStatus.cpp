@@ -35,8 +35,15 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_available"sv, system_memory.physical_pages - system_memory.physical_pages_used));
     TRY(json.add("physical_committed"sv, system_memory.physical_pages_committed));
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
+    TRY(json.add("physical_large_pages_allocated"sv, system_memory.large_pages_allocated));
+    TRY(json.add("physical_large_page_allocation_failures"sv, system_memory.large_page_allocation_failures));
+    TRY(json.add("physical_large_page_splits"sv, system_memory.large_page_splits));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    TRY(json.add("kmalloc_magazine_hit_count"sv, stats.magazine_hit_count));
+    TRY(json.add("kmalloc_depot_exchange_count"sv, stats.depot_exchange_count));
+    TRY(json.add("kmalloc_lock_acquisition_count"sv, stats.lock_acquisition_count));
+    TRY(json.add("kmalloc_lock_contention_count"sv, stats.lock_contention_count));
     TRY(json.finish());
     return {};
 }
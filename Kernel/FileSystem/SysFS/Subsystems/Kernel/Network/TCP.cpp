@@ -41,6 +41,23 @@ ErrorOr<void> SysFSNetworkTCPStats::try_generate(KBufferBuilder& builder)
         TRY(obj.add("bytes_in"sv, socket.bytes_in()));
         TRY(obj.add("packets_out"sv, socket.packets_out()));
         TRY(obj.add("bytes_out"sv, socket.bytes_out()));
+        TRY(obj.add("retransmitted_packets"sv, socket.retransmitted_packets()));
+        TRY(obj.add("congestion_control"sv, socket.congestion_control_name()));
+        TRY(obj.add("congestion_window"sv, socket.congestion_window()));
+        TRY(obj.add("slow_start_threshold"sv, socket.slow_start_threshold()));
+        TRY(obj.add("bytes_in_flight"sv, socket.bytes_in_flight()));
+        TRY(obj.add("peer_window"sv, socket.peer_window()));
+        if (auto smoothed_rtt = socket.smoothed_rtt(); smoothed_rtt.has_value()) {
+            TRY(obj.add("rtt_us"sv, smoothed_rtt->to_microseconds()));
+            TRY(obj.add("rtt_variance_us"sv, socket.rtt_variance().to_microseconds()));
+        }
+        TRY(obj.add("retransmission_timeout_ms"sv, socket.retransmission_timeout().to_milliseconds()));
+        if (socket.window_scaling_enabled()) {
+            TRY(obj.add("send_window_scale"sv, socket.send_window_shift()));
+            TRY(obj.add("receive_window_scale"sv, socket.receive_window_shift()));
+        }
+        TRY(obj.add("sack"sv, socket.sack_enabled()));
+        TRY(obj.add("timestamps"sv, socket.timestamps_enabled()));
         auto current_process_credentials = Process::current().credentials();
         if (current_process_credentials->is_superuser() || current_process_credentials->uid() == socket.origin_uid()) {
             TRY(obj.add("origin_pid"sv, socket.origin_pid().value()));
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/ReadyQueues.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/Scheduler.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSReadyQueues::SysFSReadyQueues(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSReadyQueues> SysFSReadyQueues::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSReadyQueues(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSReadyQueues::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    TRY(Processor::try_for_each(
+        [&](Processor& proc) -> ErrorOr<void> {
+            auto statistics = Scheduler::ready_queue_statistics(proc.id());
+            auto obj = TRY(array.add_object());
+            TRY(obj.add("processor"sv, proc.id()));
+            TRY(obj.add("runnable_threads"sv, statistics.runnable_threads));
+            TRY(obj.add("steals"sv, statistics.steals));
+            TRY(obj.add("stolen"sv, statistics.stolen));
+            TRY(obj.add("balance_migrations"sv, statistics.balance_migrations));
+            TRY(obj.finish());
+            return {};
+        }));
+    TRY(array.finish());
+    return {};
+}
+
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/ReadAheadState.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Variables/ReadAheadMaximum.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+// Read-ahead runs on the I/O work queue with a single bounce buffer, so
+// don't let a single window grow beyond what is reasonable to buffer.
+static constexpr u64 max_read_ahead_kib = 16 * KiB;
+
+UNMAP_AFTER_INIT SysFSReadAheadMaximum::SysFSReadAheadMaximum(SysFSDirectory const& parent_directory)
+    : SysFSSystemUnsignedIntegerVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSReadAheadMaximum> SysFSReadAheadMaximum::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSReadAheadMaximum(parent_directory)).release_nonnull();
+}
+
+u64 SysFSReadAheadMaximum::value() const
+{
+    return g_max_read_ahead_size.load() / KiB;
+}
+
+ErrorOr<void> SysFSReadAheadMaximum::set_value(u64 new_value)
+{
+    if (new_value > max_read_ahead_kib)
+        return EINVAL;
+    g_max_read_ahead_size.store(new_value * KiB);
+    return {};
+}
+
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Variables/UnsignedIntegerVariable.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+class SysFSReadAheadMaximum final : public SysFSSystemUnsignedIntegerVariable {
+public:
+    virtual StringView name() const override { return "read_ahead_max_kib"sv; }
+    static NonnullRefPtr<SysFSReadAheadMaximum> must_create(SysFSDirectory const&);
+
+private:
+    virtual u64 value() const override;
+    virtual ErrorOr<void> set_value(u64 new_value) override;
+
+    explicit SysFSReadAheadMaximum(SysFSDirectory const&);
+};
+
+}
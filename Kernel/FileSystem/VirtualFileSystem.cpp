@@ -14,6 +14,7 @@
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/Devices/DeviceManagement.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
@@ -62,7 +63,7 @@ bool VirtualFileSystem::mount_point_exists_at_inode(InodeIdentifier inode_identi
 ErrorOr<void> VirtualFileSystem::mount(FileSystem& fs, Custody& mount_point, int flags)
 {
     auto new_mount = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Mount(fs, &mount_point, flags)));
-    return m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
+    TRY(m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
         auto& inode = mount_point.inode();
         dbgln("VirtualFileSystem: FileSystemID {}, Mounting {} at inode {} with flags {}",
             fs.fsid(),
@@ -99,13 +100,17 @@ ErrorOr<void> VirtualFileSystem::mount(FileSystem& fs, Custody& mount_point, int
         // deleted after being added.
         mounts.append(*new_mount.leak_ptr());
         return {};
-    });
+    }));
+
+    // Lookups of the mount point now lead somewhere else.
+    DirectoryEntryCache::the().clear();
+    return {};
 }
 
 ErrorOr<void> VirtualFileSystem::bind_mount(Custody& source, Custody& mount_point, int flags)
 {
     auto new_mount = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Mount(source.inode(), mount_point, flags)));
-    return m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
+    TRY(m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
         auto& inode = mount_point.inode();
         dbgln("VirtualFileSystem: Bind-mounting inode {} at inode {}", source.inode().identifier(), inode.identifier());
         if (mount_point_exists_at_inode(inode.identifier())) {
@@ -118,7 +123,10 @@ ErrorOr<void> VirtualFileSystem::bind_mount(Custody& source, Custody& mount_poin
         // deleted after being added.
         mounts.append(*new_mount.leak_ptr());
         return {};
-    });
+    }));
+
+    DirectoryEntryCache::the().clear();
+    return {};
 }
 
 ErrorOr<void> VirtualFileSystem::remount(Custody& mount_point, int new_flags)
@@ -130,6 +138,9 @@ ErrorOr<void> VirtualFileSystem::remount(Custody& mount_point, int new_flags)
         return ENODEV;
 
     mount->set_flags(new_flags);
+
+    // Cached custodies below the mount point still carry the old flags.
+    DirectoryEntryCache::the().clear();
     return {};
 }
 
@@ -145,6 +156,23 @@ void VirtualFileSystem::sync_filesystems()
         fs->flush_writes();
 }
 
+size_t VirtualFileSystem::release_cached_memory(size_t bytes_to_release)
+{
+    Vector<NonnullRefPtr<FileSystem>, 32> file_systems;
+    m_file_systems_list.with([&](auto const& list) {
+        for (auto& fs : list)
+            file_systems.append(fs);
+    });
+
+    size_t released = 0;
+    for (auto& fs : file_systems) {
+        if (released >= bytes_to_release)
+            break;
+        released += fs->release_cached_memory(bytes_to_release - released);
+    }
+    return released;
+}
+
 void VirtualFileSystem::lock_all_filesystems()
 {
     Vector<NonnullRefPtr<FileSystem>, 32> file_systems;
@@ -163,7 +191,10 @@ ErrorOr<void> VirtualFileSystem::unmount(Custody& mountpoint_custody)
     auto custody_path = TRY(mountpoint_custody.try_serialize_absolute_path());
     dbgln("VirtualFileSystem: unmount called with inode {} on mountpoint {}", guest_inode.identifier(), custody_path->view());
 
-    return m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
+    // The cached custodies keep inodes of the filesystem alive, which would make it appear busy.
+    DirectoryEntryCache::the().clear();
+
+    TRY(m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
         for (auto& mount : mounts) {
             if (&mount.guest() != &guest_inode)
                 continue;
@@ -198,7 +229,11 @@ ErrorOr<void> VirtualFileSystem::unmount(Custody& mountpoint_custody)
         }
         dbgln("VirtualFileSystem: Nothing mounted on inode {}", guest_inode.identifier());
         return ENODEV;
-    });
+    }));
+
+    // Lookups of the mount point may have been cached again in the meantime.
+    DirectoryEntryCache::the().clear();
+    return {};
 }
 
 ErrorOr<void> VirtualFileSystem::mount_root(FileSystem& fs)
@@ -1085,6 +1120,40 @@ static bool safe_to_follow_symlink(Credentials const& credentials, Inode const&
     return false;
 }
 
+ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::lookup_child(Custody& parent, StringView name)
+{
+    auto& dentry_cache = DirectoryEntryCache::the();
+    bool use_dentry_cache = parent.inode().fs().supports_lookup_caching();
+    u64 dentry_cache_generation = 0;
+    if (use_dentry_cache) {
+        if (auto cached_child = TRY(dentry_cache.lookup(parent, name)))
+            return cached_child.release_nonnull();
+        dentry_cache_generation = dentry_cache.generation();
+    }
+
+    auto child_or_error = parent.inode().lookup(name);
+    if (child_or_error.is_error()) {
+        if (use_dentry_cache && child_or_error.error().code() == ENOENT)
+            dentry_cache.add_negative(dentry_cache_generation, parent, name);
+        return child_or_error.release_error();
+    }
+    auto child_inode = child_or_error.release_value();
+
+    int mount_flags_for_child = parent.mount_flags();
+
+    // See if there's something mounted on the child; in that case
+    // we would need to return the guest inode, not the host inode.
+    if (auto mount = find_mount_for_host(child_inode->identifier())) {
+        child_inode = mount->guest();
+        mount_flags_for_child = mount->flags();
+    }
+
+    auto child = TRY(Custody::try_create(&parent, name, *child_inode, mount_flags_for_child));
+    if (use_dentry_cache)
+        dentry_cache.add(dentry_cache_generation, parent, name, *child);
+    return child;
+}
+
 ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(Credentials const& credentials, StringView path, NonnullRefPtr<Custody> base, RefPtr<Custody>* out_parent, int options, int symlink_recursion_level)
 {
     if (symlink_recursion_level >= symlink_recursion_limit)
@@ -1124,7 +1193,7 @@ ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(Cre
         }
 
         // Okay, let's look up this part.
-        auto child_or_error = parent.inode().lookup(part);
+        auto child_or_error = lookup_child(parent, part);
         if (child_or_error.is_error()) {
             if (out_parent) {
                 // ENOENT with a non-null parent custody signals to caller that
@@ -1134,20 +1203,10 @@ ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(Cre
             }
             return child_or_error.release_error();
         }
-        auto child_inode = child_or_error.release_value();
-
-        int mount_flags_for_child = parent.mount_flags();
-
-        // See if there's something mounted on the child; in that case
-        // we would need to return the guest inode, not the host inode.
-        if (auto mount = find_mount_for_host(child_inode->identifier())) {
-            child_inode = mount->guest();
-            mount_flags_for_child = mount->flags();
-        }
-
-        custody = TRY(Custody::try_create(&parent, part, *child_inode, mount_flags_for_child));
+        custody = child_or_error.release_value();
+        auto& child_inode = custody->inode();
 
-        if (child_inode->metadata().is_symlink()) {
+        if (child_inode.metadata().is_symlink()) {
             if (!have_more_parts) {
                 if (options & O_NOFOLLOW)
                     return ELOOP;
@@ -1155,12 +1214,12 @@ ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(Cre
                     break;
             }
 
-            if (!safe_to_follow_symlink(credentials, *child_inode, parent_metadata))
+            if (!safe_to_follow_symlink(credentials, child_inode, parent_metadata))
                 return EACCES;
 
             TRY(validate_path_against_process_veil(*custody, options));
 
-            auto symlink_target = TRY(child_inode->resolve_as_link(credentials, parent, out_parent, options, symlink_recursion_level + 1));
+            auto symlink_target = TRY(child_inode.resolve_as_link(credentials, parent, out_parent, options, symlink_recursion_level + 1));
             if (!have_more_parts)
                 return symlink_target;
 
@@ -87,6 +87,7 @@ public:
     InodeIdentifier root_inode_id() const;
 
     void sync_filesystems();
+    size_t release_cached_memory(size_t bytes_to_release);
     void lock_all_filesystems();
 
     static void sync();
@@ -109,6 +110,8 @@ private:
 
     ErrorOr<void> traverse_directory_inode(Inode&, Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)>);
 
+    ErrorOr<NonnullRefPtr<Custody>> lookup_child(Custody& parent, StringView name);
+
     bool mount_point_exists_at_inode(InodeIdentifier inode);
 
     // FIXME: These functions are totally unsafe as someone could unmount the returned Mount underneath us.
@@ -14,6 +14,7 @@ namespace Kernel {
 enum class LockRank;
 
 class BlockDevice;
+class BlockRequestBatch;
 class CharacterDevice;
 class Coredump;
 class Credentials;
@@ -21,6 +22,7 @@ class Custody;
 class Device;
 class DiskCache;
 class DoubleBuffer;
+class EPoll;
 class File;
 class FATInode;
 class OpenFileDescription;
@@ -31,6 +33,7 @@ class IPv4Socket;
 class Inode;
 class InodeIdentifier;
 class InodeWatcher;
+class IORing;
 class Jail;
 class KBuffer;
 class KString;
@@ -62,6 +65,7 @@ class ThreadTracer;
 class RAMFSInode;
 class UDPSocket;
 class UserOrKernelBuffer;
+class UserOrKernelBufferVector;
 class VirtualFileSystem;
 class WaitQueue;
 class WorkQueue;
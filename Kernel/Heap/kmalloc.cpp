@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -86,6 +87,8 @@ public:
         return m_freelist == nullptr;
     }
 
+    size_t slab_size() const { return m_slab_size; }
+
     size_t allocated_bytes() const
     {
         return m_allocated_slabs * m_slab_size;
@@ -123,6 +126,14 @@ public:
     size_t slab_size() const { return m_slab_size; }
 
     void* allocate(CallerWillInitializeMemory caller_will_initialize_memory)
+    {
+        auto* ptr = allocate_without_scrubbing();
+        if (ptr && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+            memset(ptr, KMALLOC_SCRUB_BYTE, m_slab_size);
+        return ptr;
+    }
+
+    void* allocate_without_scrubbing()
     {
         if (m_usable_blocks.is_empty()) {
             // FIXME: This allocation wastes `block_size` bytes due to the implementation of kmalloc_aligned().
@@ -139,17 +150,17 @@ public:
         auto* ptr = block->allocate();
         if (block->is_full())
             m_full_blocks.append(*block);
-
-        if (caller_will_initialize_memory == CallerWillInitializeMemory::No) {
-            memset(ptr, KMALLOC_SCRUB_BYTE, m_slab_size);
-        }
         return ptr;
     }
 
     void deallocate(void* ptr)
     {
         memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
+        deallocate_without_scrubbing(ptr);
+    }
 
+    void deallocate_without_scrubbing(void* ptr)
+    {
         auto* block = (KmallocSlabBlock*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
         bool block_was_full = block->is_full();
         block->deallocate(ptr);
@@ -205,6 +216,111 @@ private:
     KmallocSlabBlock::List m_full_blocks;
 };
 
+static constexpr size_t slabheap_count = 6;
+
+// A magazine is a small stack of free objects of one slab size (see "Magazines and Vmem" by
+// Bonwick and Adams). Each processor keeps two of them per slab size, so that most allocations
+// and frees can be satisfied without taking the global kmalloc lock. Full and empty magazines
+// are exchanged with a global depot, which is protected by that lock.
+struct KmallocMagazine {
+    static constexpr size_t capacity = 30;
+
+    bool is_empty() const { return count == 0; }
+    bool is_full() const { return count == capacity; }
+
+    void push(void* ptr)
+    {
+        VERIFY(!is_full());
+        objects[count++] = ptr;
+    }
+
+    void* pop()
+    {
+        VERIFY(!is_empty());
+        return objects[--count];
+    }
+
+    KmallocMagazine* next { nullptr };
+    size_t count { 0 };
+    void* objects[capacity];
+};
+static_assert(sizeof(KmallocMagazine) == 256);
+
+struct KmallocMagazineDepot {
+    // Objects in full magazines are unavailable to the other slab sizes, so don't hoard too many.
+    static constexpr size_t max_full_magazines = 8;
+
+    KmallocMagazine* take_full() { return take(full_magazines, full_count); }
+    KmallocMagazine* take_empty() { return take(empty_magazines, empty_count); }
+    void add_full(KmallocMagazine& magazine) { add(full_magazines, full_count, magazine); }
+    void add_empty(KmallocMagazine& magazine) { add(empty_magazines, empty_count, magazine); }
+
+    KmallocMagazine* full_magazines { nullptr };
+    KmallocMagazine* empty_magazines { nullptr };
+    size_t full_count { 0 };
+    size_t empty_count { 0 };
+
+private:
+    static KmallocMagazine* take(KmallocMagazine*& list, size_t& count)
+    {
+        auto* magazine = list;
+        if (magazine) {
+            list = exchange(magazine->next, nullptr);
+            --count;
+        }
+        return magazine;
+    }
+
+    static void add(KmallocMagazine*& list, size_t& count, KmallocMagazine& magazine)
+    {
+        magazine.next = exchange(list, &magazine);
+        ++count;
+    }
+};
+
+// NOTE: This is only ever accessed by its own processor with interrupts disabled,
+//       except for statistics, which are read racily.
+struct alignas(64) KmallocProcessorCache {
+    struct SizeClass {
+        // Invariant (after the first exchange): `previous` is either full or empty.
+        KmallocMagazine* loaded { nullptr };
+        KmallocMagazine* previous { nullptr };
+    };
+    SizeClass size_classes[slabheap_count];
+
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+    size_t magazine_hit_count { 0 };
+    size_t nested_kfree_calls { 0 };
+};
+
+static KmallocProcessorCache s_processor_caches[MAX_CPU_COUNT];
+
+static void* allocate_from_magazine(KmallocProcessorCache::SizeClass& size_class)
+{
+    if (size_class.loaded && !size_class.loaded->is_empty())
+        return size_class.loaded->pop();
+    if (size_class.previous && !size_class.previous->is_empty()) {
+        swap(size_class.loaded, size_class.previous);
+        return size_class.loaded->pop();
+    }
+    return nullptr;
+}
+
+static bool deallocate_to_magazine(KmallocProcessorCache::SizeClass& size_class, void* ptr)
+{
+    if (size_class.loaded && !size_class.loaded->is_full()) {
+        size_class.loaded->push(ptr);
+        return true;
+    }
+    if (size_class.previous && size_class.previous->is_empty()) {
+        swap(size_class.loaded, size_class.previous);
+        size_class.loaded->push(ptr);
+        return true;
+    }
+    return false;
+}
+
 struct KmallocGlobalData {
     static constexpr size_t minimum_subheap_size = 1 * MiB;
 
@@ -239,7 +355,7 @@ struct KmallocGlobalData {
         if (size <= KmallocSlabBlock::block_size * 2 + sizeof(ptrdiff_t) + sizeof(size_t)) {
             // FIXME: We should propagate a freed pointer, to find the specific subheap it belonged to
             //        This would save us iterating over them in the next step and remove a recursion
-            bool did_purge = false;
+            bool did_purge = flush_full_magazines_in_depots();
             for (auto& slabheap : slabheaps) {
                 if (slabheap.try_purge()) {
                     dbgln_if(KMALLOC_DEBUG, "Kmalloc purged block(s) from slabheap of size {} to avoid expansion", slabheap.slab_size());
@@ -259,6 +375,133 @@ struct KmallocGlobalData {
         return allocate(size, alignment, caller_will_initialize_memory);
     }
 
+    // Called when the processor's magazines for this slab size are both empty.
+    void* allocate_with_depot(KmallocProcessorCache::SizeClass& size_class, size_t slabheap_index)
+    {
+        VERIFY(!expansion_in_progress);
+        auto& depot = depots[slabheap_index];
+        auto& slabheap = slabheaps[slabheap_index];
+
+        if (auto* full_magazine = depot.take_full()) {
+            if (size_class.previous)
+                depot.add_empty(*size_class.previous);
+            size_class.previous = size_class.loaded;
+            size_class.loaded = full_magazine;
+            ++depot_exchange_count;
+            return size_class.loaded->pop();
+        }
+
+        if (!size_class.loaded) {
+            size_class.loaded = take_or_allocate_empty_magazine(depot);
+            if (!size_class.loaded)
+                return slabheap.allocate_without_scrubbing();
+        }
+
+        // The depot has nothing for us, so fill up half a magazine from the slab heap at once.
+        while (size_class.loaded->count < KmallocMagazine::capacity / 2) {
+            auto* ptr = slabheap.allocate_without_scrubbing();
+            if (!ptr)
+                break;
+            size_class.loaded->push(ptr);
+        }
+        if (size_class.loaded->is_empty())
+            return nullptr;
+        return size_class.loaded->pop();
+    }
+
+    // Called when the processor's magazines for this slab size are both full.
+    void deallocate_with_depot(KmallocProcessorCache::SizeClass& size_class, size_t slabheap_index, void* ptr)
+    {
+        VERIFY(!expansion_in_progress);
+        auto& depot = depots[slabheap_index];
+
+        KmallocMagazine* empty_magazine = nullptr;
+        if (size_class.previous) {
+            if (depot.full_count < KmallocMagazineDepot::max_full_magazines) {
+                depot.add_full(*size_class.previous);
+                ++depot_exchange_count;
+            } else {
+                return_to_slabheap(slabheap_index, *size_class.previous);
+                empty_magazine = size_class.previous;
+            }
+            size_class.previous = nullptr;
+        }
+
+        if (!empty_magazine)
+            empty_magazine = take_or_allocate_empty_magazine(depot);
+        if (!empty_magazine) {
+            slabheaps[slabheap_index].deallocate_without_scrubbing(ptr);
+            return;
+        }
+
+        size_class.previous = size_class.loaded;
+        size_class.loaded = empty_magazine;
+        size_class.loaded->push(ptr);
+    }
+
+    KmallocMagazine* take_or_allocate_empty_magazine(KmallocMagazineDepot& depot)
+    {
+        if (auto* magazine = depot.take_empty())
+            return magazine;
+        // NOTE: Magazines come straight from the slab heaps, as going through kmalloc() would
+        //       recurse into the magazine layer. They are never freed.
+        auto* slot = allocate(sizeof(KmallocMagazine), alignof(KmallocMagazine), CallerWillInitializeMemory::Yes);
+        if (!slot)
+            return nullptr;
+        return new (slot) KmallocMagazine;
+    }
+
+    void return_to_slabheap(size_t slabheap_index, KmallocMagazine& magazine)
+    {
+        while (!magazine.is_empty())
+            slabheaps[slabheap_index].deallocate_without_scrubbing(magazine.pop());
+    }
+
+    bool flush_full_magazines_in_depots()
+    {
+        bool did_flush = false;
+        for (size_t i = 0; i < slabheap_count; ++i) {
+            while (auto* magazine = depots[i].take_full()) {
+                return_to_slabheap(i, *magazine);
+                depots[i].add_empty(*magazine);
+                did_flush = true;
+            }
+        }
+        return did_flush;
+    }
+
+    size_t bytes_in_depots() const
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < slabheap_count; ++i)
+            total += depots[i].full_count * KmallocMagazine::capacity * slabheaps[i].slab_size();
+        return total;
+    }
+
+    Optional<size_t> slabheap_index_for_allocation(size_t size, size_t alignment) const
+    {
+        for (size_t i = 0; i < slabheap_count; ++i) {
+            if (size <= slabheaps[i].slab_size() && alignment <= slabheaps[i].slab_size())
+                return i;
+        }
+        return {};
+    }
+
+    Optional<size_t> slabheap_index_for_deallocation(void* ptr, size_t size) const
+    {
+        if (size > slabheaps[slabheap_count - 1].slab_size())
+            return {};
+        VERIFY(is_valid_kmalloc_address(VirtualAddress { ptr }));
+        // NOTE: Aligned allocations may have come from a larger slab size than `size` suggests,
+        //       but the block they live in knows.
+        auto* block = (KmallocSlabBlock const*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
+        for (size_t i = 0; i < slabheap_count; ++i) {
+            if (block->slab_size() == slabheaps[i].slab_size())
+                return i;
+        }
+        VERIFY_NOT_REACHED();
+    }
+
     void deallocate(void* ptr, size_t size)
     {
         VERIFY(!expansion_in_progress);
@@ -394,7 +637,12 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[slabheap_count] = { 16, 32, 64, 128, 256, 512 };
+    KmallocMagazineDepot depots[slabheap_count];
+
+    size_t depot_exchange_count { 0 };
+    size_t lock_acquisition_count { 0 };
+    size_t lock_contention_count { 0 };
 
     bool expansion_in_progress { false };
 };
@@ -402,9 +650,6 @@ struct KmallocGlobalData {
 READONLY_AFTER_INIT static KmallocGlobalData* g_kmalloc_global;
 alignas(KmallocGlobalData) static u8 g_kmalloc_global_heap[sizeof(KmallocGlobalData)];
 
-static size_t g_kmalloc_call_count;
-static size_t g_kfree_call_count;
-static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
 void kmalloc_enable_expand()
@@ -421,6 +666,22 @@ UNMAP_AFTER_INIT void kmalloc_init()
     s_lock.initialize();
 }
 
+class KmallocLocker {
+public:
+    KmallocLocker()
+        : m_was_contended(s_lock.is_locked() && !s_lock.is_locked_by_current_processor())
+        , m_locker(s_lock)
+    {
+        ++g_kmalloc_global->lock_acquisition_count;
+        if (m_was_contended)
+            ++g_kmalloc_global->lock_contention_count;
+    }
+
+private:
+    bool m_was_contended { false };
+    SpinlockLocker<RecursiveSpinlock<LockRank::None>> m_locker;
+};
+
 static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
 {
     // Catch bad callers allocating under spinlock.
@@ -431,15 +692,33 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
-
     if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
+        SpinlockLocker lock(s_lock);
         dbgln("kmalloc({})", size);
         Kernel::dump_backtrace();
     }
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    // NOTE: Keeping interrupts disabled pins us to this processor while using its cache.
+    InterruptDisabler disabler;
+    auto& cache = s_processor_caches[Processor::current_id()];
+    ++cache.kmalloc_call_count;
+
+    void* ptr = nullptr;
+    if (auto slabheap_index = g_kmalloc_global->slabheap_index_for_allocation(size, alignment); slabheap_index.has_value()) {
+        auto& size_class = cache.size_classes[*slabheap_index];
+        ptr = allocate_from_magazine(size_class);
+        if (ptr) {
+            ++cache.magazine_hit_count;
+        } else {
+            KmallocLocker locker;
+            ptr = g_kmalloc_global->allocate_with_depot(size_class, *slabheap_index);
+        }
+        if (ptr && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+            memset(ptr, KMALLOC_SCRUB_BYTE, g_kmalloc_global->slabheaps[*slabheap_index].slab_size());
+    } else {
+        KmallocLocker locker;
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    }
 
     Thread* current_thread = Thread::current();
     if (!current_thread)
@@ -482,11 +761,12 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
-    SpinlockLocker lock(s_lock);
-    ++g_kfree_call_count;
-    ++g_nested_kfree_calls;
+    InterruptDisabler disabler;
+    auto& cache = s_processor_caches[Processor::current_id()];
+    ++cache.kfree_call_count;
+    ++cache.nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
+    if (cache.nested_kfree_calls == 1) {
         Thread* current_thread = Thread::current();
         if (!current_thread)
             current_thread = Processor::idle_thread();
@@ -496,8 +776,20 @@ void kfree_sized(void* ptr, size_t size)
         }
     }
 
-    g_kmalloc_global->deallocate(ptr, size);
-    --g_nested_kfree_calls;
+    if (auto slabheap_index = g_kmalloc_global->slabheap_index_for_deallocation(ptr, size); slabheap_index.has_value()) {
+        memset(ptr, KFREE_SCRUB_BYTE, g_kmalloc_global->slabheaps[*slabheap_index].slab_size());
+        auto& size_class = cache.size_classes[*slabheap_index];
+        if (deallocate_to_magazine(size_class, ptr)) {
+            ++cache.magazine_hit_count;
+        } else {
+            KmallocLocker locker;
+            g_kmalloc_global->deallocate_with_depot(size_class, *slabheap_index, ptr);
+        }
+    } else {
+        KmallocLocker locker;
+        g_kmalloc_global->deallocate(ptr, size);
+    }
+    --cache.nested_kfree_calls;
 }
 
 size_t kmalloc_good_size(size_t size)
@@ -581,9 +873,34 @@ void operator delete[](void* ptr, size_t size) noexcept
 
 void get_kmalloc_stats(kmalloc_stats& stats)
 {
+    stats = {};
+
+    // NOTE: The processor caches are read without synchronization, so these numbers are approximate.
+    size_t bytes_in_magazines = 0;
+    for (auto const& cache : s_processor_caches) {
+        stats.kmalloc_call_count += cache.kmalloc_call_count;
+        stats.kfree_call_count += cache.kfree_call_count;
+        stats.magazine_hit_count += cache.magazine_hit_count;
+        for (size_t i = 0; i < slabheap_count; ++i) {
+            auto const& size_class = cache.size_classes[i];
+            size_t object_count = 0;
+            if (auto const* magazine = size_class.loaded)
+                object_count += magazine->count;
+            if (auto const* magazine = size_class.previous)
+                object_count += magazine->count;
+            bytes_in_magazines += object_count * g_kmalloc_global->slabheaps[i].slab_size();
+        }
+    }
+
     SpinlockLocker lock(s_lock);
-    stats.bytes_allocated = g_kmalloc_global->allocated_bytes();
-    stats.bytes_free = g_kmalloc_global->free_bytes();
-    stats.kmalloc_call_count = g_kmalloc_call_count;
-    stats.kfree_call_count = g_kfree_call_count;
+    bytes_in_magazines += g_kmalloc_global->bytes_in_depots();
+
+    // Objects cached in magazines are free as far as the rest of the system is concerned.
+    auto bytes_allocated = g_kmalloc_global->allocated_bytes();
+    bytes_in_magazines = min(bytes_in_magazines, bytes_allocated);
+    stats.bytes_allocated = bytes_allocated - bytes_in_magazines;
+    stats.bytes_free = g_kmalloc_global->free_bytes() + bytes_in_magazines;
+    stats.depot_exchange_count = g_kmalloc_global->depot_exchange_count;
+    stats.lock_acquisition_count = g_kmalloc_global->lock_acquisition_count;
+    stats.lock_contention_count = g_kmalloc_global->lock_contention_count;
 }
@@ -52,6 +52,10 @@ struct kmalloc_stats {
     size_t bytes_free;
     size_t kmalloc_call_count;
     size_t kfree_call_count;
+    size_t magazine_hit_count;     // kmalloc() and kfree() calls served by a per-processor magazine
+    size_t depot_exchange_count;   // magazines exchanged with the global depot
+    size_t lock_acquisition_count; // acquisitions of the global kmalloc lock
+    size_t lock_contention_count;  // ...of which found it held by another processor
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
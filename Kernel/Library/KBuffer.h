@@ -46,6 +46,8 @@ public:
     [[nodiscard]] ReadonlyBytes bytes() const { return { data(), size() }; }
     [[nodiscard]] Bytes bytes() { return { data(), size() }; }
 
+    [[nodiscard]] Memory::Region const& region() const { return *m_region; }
+
     void set_size(size_t size)
     {
         VERIFY(size <= capacity());
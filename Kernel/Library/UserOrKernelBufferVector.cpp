@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Library/UserOrKernelBufferVector.h>
+
+namespace Kernel {
+
+ErrorOr<UserOrKernelBufferVector> UserOrKernelBufferVector::for_user_iovecs(ReadonlySpan<iovec> iovecs)
+{
+    UserOrKernelBufferVector vector;
+    TRY(vector.m_segments.try_ensure_capacity(iovecs.size()));
+    for (auto& iov : iovecs) {
+        vector.m_size += iov.iov_len;
+        if (vector.m_size > NumericLimits<i32>::max())
+            return EINVAL;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(static_cast<u8*>(iov.iov_base), iov.iov_len));
+        vector.m_segments.unchecked_append({ buffer, iov.iov_len });
+    }
+    return vector;
+}
+
+ErrorOr<UserOrKernelBufferVector> UserOrKernelBufferVector::for_user_iovecs(Userspace<iovec const*> user_iovecs, int iov_count)
+{
+    if (iov_count < 0)
+        return EINVAL;
+    if (iov_count > IOV_MAX)
+        return EFAULT;
+    Vector<iovec, 8> iovecs;
+    TRY(iovecs.try_resize(iov_count));
+    TRY(copy_n_from_user(iovecs.data(), user_iovecs, iov_count));
+    return for_user_iovecs(iovecs.span());
+}
+
+template<typename Callback>
+ErrorOr<void> UserOrKernelBufferVector::for_each_segment_in_range(size_t offset, size_t len, Callback callback) const
+{
+    VERIFY(offset + len <= m_size);
+    size_t done = 0;
+    for (auto& segment : m_segments) {
+        if (done == len)
+            break;
+        if (offset >= segment.size) {
+            offset -= segment.size;
+            continue;
+        }
+        size_t chunk_size = min(segment.size - offset, len - done);
+        TRY(callback(segment.buffer, offset, done, chunk_size));
+        done += chunk_size;
+        offset = 0;
+    }
+    return {};
+}
+
+ErrorOr<void> UserOrKernelBufferVector::write(void const* src, size_t offset, size_t len)
+{
+    return for_each_segment_in_range(offset, len, [&](UserOrKernelBuffer buffer, size_t offset_in_segment, size_t done, size_t chunk_size) {
+        return buffer.write(static_cast<u8 const*>(src) + done, offset_in_segment, chunk_size);
+    });
+}
+
+ErrorOr<void> UserOrKernelBufferVector::read(void* dest, size_t offset, size_t len) const
+{
+    return for_each_segment_in_range(offset, len, [&](UserOrKernelBuffer const& buffer, size_t offset_in_segment, size_t done, size_t chunk_size) {
+        return buffer.read(static_cast<u8*>(dest) + done, offset_in_segment, chunk_size);
+    });
+}
+
+}
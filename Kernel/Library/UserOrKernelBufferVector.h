@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Vector.h>
+#include <Kernel/API/POSIX/sys/uio.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+// A list of buffers that is read from and written to as if it were a single buffer, so that
+// vectored I/O can move data straight between the individual buffers and wherever it's going.
+class UserOrKernelBufferVector {
+public:
+    struct Segment {
+        UserOrKernelBuffer buffer;
+        size_t size { 0 };
+    };
+
+    static ErrorOr<UserOrKernelBufferVector> for_user_iovecs(ReadonlySpan<iovec>);
+    static ErrorOr<UserOrKernelBufferVector> for_user_iovecs(Userspace<iovec const*>, int iov_count);
+    static UserOrKernelBufferVector for_buffer(UserOrKernelBuffer buffer, size_t size)
+    {
+        UserOrKernelBufferVector vector;
+        vector.m_segments.unchecked_append({ buffer, size });
+        vector.m_size = size;
+        return vector;
+    }
+
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] ReadonlySpan<Segment> segments() const { return m_segments; }
+
+    ErrorOr<void> write(void const* src, size_t offset, size_t len);
+    ErrorOr<void> write(ReadonlyBytes bytes) { return write(bytes.data(), 0, bytes.size()); }
+
+    ErrorOr<void> read(void* dest, size_t offset, size_t len) const;
+
+private:
+    UserOrKernelBufferVector() = default;
+
+    // Calls `callback` with every part of the given range that falls into a single segment.
+    template<typename Callback>
+    ErrorOr<void> for_each_segment_in_range(size_t offset, size_t len, Callback) const;
+
+    Vector<Segment, 8> m_segments;
+    size_t m_size { 0 };
+};
+
+}
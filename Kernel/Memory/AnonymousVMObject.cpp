@@ -11,6 +11,7 @@
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/PhysicalPage.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel::Memory {
 
@@ -84,7 +85,7 @@ ErrorOr<NonnullLockRefPtr<AnonymousVMObject>> AnonymousVMObject::try_create_with
 
     auto new_physical_pages = TRY(VMObject::try_create_physical_pages(size));
 
-    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) AnonymousVMObject(move(new_physical_pages), strategy, move(committed_pages)));
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) AnonymousVMObject(move(new_physical_pages), strategy, move(committed_pages), false));
 }
 
 ErrorOr<NonnullLockRefPtr<AnonymousVMObject>> AnonymousVMObject::try_create_physically_contiguous_with_size(size_t size)
@@ -105,9 +106,7 @@ ErrorOr<NonnullLockRefPtr<AnonymousVMObject>> AnonymousVMObject::try_create_purg
 
     auto new_physical_pages = TRY(VMObject::try_create_physical_pages(size));
 
-    auto vmobject = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) AnonymousVMObject(move(new_physical_pages), strategy, move(committed_pages))));
-    vmobject->m_purgeable = true;
-    return vmobject;
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) AnonymousVMObject(move(new_physical_pages), strategy, move(committed_pages), true));
 }
 
 ErrorOr<NonnullLockRefPtr<AnonymousVMObject>> AnonymousVMObject::try_create_with_physical_pages(Span<NonnullRefPtr<PhysicalPage>> physical_pages)
@@ -139,14 +138,27 @@ ErrorOr<NonnullLockRefPtr<AnonymousVMObject>> AnonymousVMObject::try_create_with
     return vmobject;
 }
 
-AnonymousVMObject::AnonymousVMObject(FixedArray<RefPtr<PhysicalPage>>&& new_physical_pages, AllocationStrategy strategy, Optional<CommittedPhysicalPageSet> committed_pages)
+AnonymousVMObject::AnonymousVMObject(FixedArray<RefPtr<PhysicalPage>>&& new_physical_pages, AllocationStrategy strategy, Optional<CommittedPhysicalPageSet> committed_pages, bool purgeable)
     : VMObject(move(new_physical_pages))
     , m_unused_committed_pages(move(committed_pages))
+    , m_purgeable(purgeable)
 {
     if (strategy == AllocationStrategy::AllocateNow) {
         // Allocate all pages right now. We know we can get all because we committed the amount needed
-        for (size_t i = 0; i < page_count(); ++i)
-            physical_pages()[i] = m_unused_committed_pages->take_one();
+        bool try_large_pages = !m_purgeable;
+        for (size_t i = 0; i < page_count();) {
+            if (try_large_pages && i % PAGES_PER_LARGE_PAGE == 0 && page_count() - i >= PAGES_PER_LARGE_PAGE) {
+                auto large_page = m_unused_committed_pages->take_large_page();
+                if (!large_page.is_empty()) {
+                    for (auto& page : large_page)
+                        physical_pages()[i++] = move(page);
+                    continue;
+                }
+                // If we can't find one now, we won't find one for the rest of this object either.
+                try_large_pages = false;
+            }
+            physical_pages()[i++] = m_unused_committed_pages->take_one();
+        }
     } else {
         auto& initial_page = (strategy == AllocationStrategy::Reserve) ? MM.lazy_committed_page() : MM.shared_zero_page();
         for (size_t i = 0; i < page_count(); ++i)
@@ -239,6 +251,7 @@ ErrorOr<void> AnonymousVMObject::set_volatile(bool is_volatile, bool& was_purged
 
         m_volatile = true;
         m_was_purged = false;
+        m_volatile_since = TimeManagement::the().uptime_ms();
 
         for_each_region([&](auto& region) { region.remap(); });
         return {};
@@ -275,6 +288,32 @@ NonnullRefPtr<PhysicalPage> AnonymousVMObject::allocate_committed_page(Badge<Reg
     return m_unused_committed_pages->take_one();
 }
 
+// Replaces the lazily committed pages starting at the given index with a physically contiguous
+// large page. Purgeable objects don't take part in this, as splitting up large pages when purging
+// them would require memory just when we're trying to free some up.
+bool AnonymousVMObject::try_allocate_large_page(size_t first_page_index)
+{
+    SpinlockLocker lock(m_lock);
+
+    if (is_purgeable() || !m_unused_committed_pages.has_value())
+        return false;
+    if (first_page_index + PAGES_PER_LARGE_PAGE > page_count())
+        return false;
+
+    auto pages = physical_pages().slice(first_page_index, PAGES_PER_LARGE_PAGE);
+    for (auto const& page : pages) {
+        if (!page || !page->is_lazy_committed_page())
+            return false;
+    }
+
+    auto large_page = m_unused_committed_pages->take_large_page();
+    if (large_page.is_empty())
+        return false;
+    for (size_t i = 0; i < PAGES_PER_LARGE_PAGE; ++i)
+        pages[i] = move(large_page[i]);
+    return true;
+}
+
 ErrorOr<void> AnonymousVMObject::ensure_cow_map()
 {
     if (m_cow_map.is_null())
@@ -26,6 +26,7 @@ public:
     virtual ErrorOr<NonnullLockRefPtr<VMObject>> try_clone() override;
 
     [[nodiscard]] NonnullRefPtr<PhysicalPage> allocate_committed_page(Badge<Region>);
+    bool try_allocate_large_page(size_t first_page_index);
     PageFaultResponse handle_cow_fault(size_t, VirtualAddress);
     size_t cow_pages() const;
     bool should_cow(size_t page_index, bool) const;
@@ -36,6 +37,9 @@ public:
 
     ErrorOr<void> set_volatile(bool is_volatile, bool& was_purged);
 
+    // In milliseconds since boot, for purging the least recently used volatile memory first.
+    u64 volatile_since() const { return m_volatile_since; }
+
     size_t purge();
 
 private:
@@ -43,7 +47,7 @@ private:
 
     static ErrorOr<NonnullLockRefPtr<AnonymousVMObject>> try_create_with_shared_cow(AnonymousVMObject const&, NonnullLockRefPtr<SharedCommittedCowPages>, FixedArray<RefPtr<PhysicalPage>>&&);
 
-    explicit AnonymousVMObject(FixedArray<RefPtr<PhysicalPage>>&&, AllocationStrategy, Optional<CommittedPhysicalPageSet>);
+    explicit AnonymousVMObject(FixedArray<RefPtr<PhysicalPage>>&&, AllocationStrategy, Optional<CommittedPhysicalPageSet>, bool purgeable);
     explicit AnonymousVMObject(PhysicalAddress, FixedArray<RefPtr<PhysicalPage>>&&);
     explicit AnonymousVMObject(FixedArray<RefPtr<PhysicalPage>>&&);
     explicit AnonymousVMObject(LockWeakPtr<AnonymousVMObject>, NonnullLockRefPtr<SharedCommittedCowPages>, FixedArray<RefPtr<PhysicalPage>>&&);
@@ -88,6 +92,7 @@ private:
     bool m_purgeable { false };
     bool m_volatile { false };
     bool m_was_purged { false };
+    u64 m_volatile_since { 0 };
 };
 
 }
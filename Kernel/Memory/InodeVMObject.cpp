@@ -6,6 +6,7 @@
 
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Memory/InodeVMObject.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel::Memory {
 
@@ -86,6 +87,11 @@ int InodeVMObject::try_release_clean_pages(int page_amount)
     return count;
 }
 
+void InodeVMObject::did_fault()
+{
+    m_last_fault_time.store(TimeManagement::the().uptime_ms(), AK::MemoryOrder::memory_order_relaxed);
+}
+
 u32 InodeVMObject::writable_mappings() const
 {
     u32 count = 0;
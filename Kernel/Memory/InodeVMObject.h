@@ -27,6 +27,10 @@ public:
 
     u32 writable_mappings() const;
 
+    // In milliseconds since boot, for releasing the clean pages of the least recently used files first.
+    u64 last_fault_time() const { return m_last_fault_time.load(AK::MemoryOrder::memory_order_relaxed); }
+    void did_fault();
+
 protected:
     explicit InodeVMObject(Inode&, FixedArray<RefPtr<PhysicalPage>>&&, Bitmap dirty_pages);
     explicit InodeVMObject(InodeVMObject const&, FixedArray<RefPtr<PhysicalPage>>&&, Bitmap dirty_pages);
@@ -39,6 +43,7 @@ protected:
 
     NonnullRefPtr<Inode> const m_inode;
     Bitmap m_dirty_pages;
+    Atomic<u64> m_last_fault_time { 0 };
 };
 
 }
@@ -24,6 +24,7 @@
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Prekernel/Prekernel.h>
 #include <Kernel/Sections.h>
+#include <Kernel/Tasks/MemoryReclaimTask.h>
 #include <Kernel/Tasks/Process.h>
 
 extern u8 start_of_kernel_image[];
@@ -401,6 +402,11 @@ UNMAP_AFTER_INIT void MemoryManager::parse_memory_map()
         // We start out with no committed pages
         global_data.system_memory_info.physical_pages_uncommitted = global_data.system_memory_info.physical_pages;
 
+        auto total_pages = global_data.system_memory_info.physical_pages;
+        m_watermarks.min = total_pages / 128;
+        m_watermarks.low = total_pages / 32;
+        m_watermarks.high = total_pages / 16;
+
         for (auto& used_range : global_data.used_memory_ranges) {
             dmesgln("MM: {} range @ {} - {} (size {:#x})", UserMemoryRangeTypeNames[to_underlying(used_range.type)], used_range.start, used_range.end.offset(-1), used_range.end.as_ptr() - used_range.start.as_ptr());
         }
@@ -579,6 +585,16 @@ PhysicalAddress MemoryManager::get_physical_address(PhysicalPage const& physical
     return PhysicalAddress((PhysicalPtr)physical_page_entry_index * PAGE_SIZE);
 }
 
+static bool is_large_page_mapping(PageDirectoryEntry const& pde)
+{
+#if ARCH(X86_64)
+    return pde.is_present() && pde.is_huge();
+#else
+    (void)pde;
+    return false;
+#endif
+}
+
 PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress vaddr)
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -592,6 +608,11 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     if (!pde.is_present())
         return nullptr;
 
+    // NOTE: Large pages don't have a page table. Callers that want to change individual
+    //       pages in them have to go through ensure_pte(), which splits them up.
+    if (is_large_page_mapping(pde))
+        return nullptr;
+
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
 
@@ -605,6 +626,14 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     auto& pde = pd[page_directory_index];
+    if (is_large_page_mapping(pde)) {
+        if (!split_large_page(page_directory, vaddr))
+            return nullptr;
+        // Allocating the page table may have had to purge memory, which may have quickmapped
+        // another page directory in the meantime.
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+        VERIFY(&pde == &pd[page_directory_index]); // Sanity check
+    }
     if (pde.is_present())
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
 
@@ -646,6 +675,12 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
+    if (is_large_page_mapping(pde)) {
+        // Large pages are only used where a single region covers all of them,
+        // so they are always released as a whole.
+        pde.clear();
+        return;
+    }
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
@@ -669,6 +704,97 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+bool MemoryManager::map_large_page(PageDirectory& page_directory, VirtualAddress vaddr, PageDirectoryEntry const& entry)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % LARGE_PAGE_SIZE == 0);
+#if ARCH(X86_64)
+    VERIFY(entry.is_huge());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+
+    // The large page replaces all entries of the page table that used to be here.
+    // NOTE: This adopts the leaked ref from MemoryManager::ensure_pte()
+    RefPtr<PhysicalPage> page_table;
+    if (pde.is_present() && !pde.is_huge())
+        page_table = adopt_ref(get_physical_page_entry(PhysicalAddress { pde.page_table_base() }).allocated.physical_page);
+
+    pde = entry;
+
+    // Other processors may still have the old page table cached, so we can't let it be reused before flushing it out.
+    if (page_table)
+        flush_tlb(&page_directory, vaddr, PAGES_PER_LARGE_PAGE);
+    return true;
+#else
+    (void)entry;
+    return false;
+#endif
+}
+
+// Replaces a large page with a page table that maps the same physical pages one by one,
+// so that they can be remapped or protected individually.
+bool MemoryManager::split_large_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+#if ARCH(X86_64)
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+    auto large_page_vaddr = VirtualAddress { vaddr.get() & ~(LARGE_PAGE_SIZE - 1) };
+
+    auto page_table_or_error = allocate_physical_page(ShouldZeroFill::No);
+    if (page_table_or_error.is_error()) {
+        dbgln("MM: Unable to allocate page table to split large page at {}", large_page_vaddr);
+        return false;
+    }
+    auto page_table = page_table_or_error.release_value();
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (!is_large_page_mapping(pde)) {
+        // Purging memory to get the page table has already taken care of it.
+        return true;
+    }
+
+    auto* page_table_entries = quickmap_pt(page_table->paddr());
+    for (size_t i = 0; i < PAGES_PER_LARGE_PAGE; ++i) {
+        auto& pte = page_table_entries[i];
+        pte.clear();
+        pte.set_physical_page_base(pde.page_table_base() + i * PAGE_SIZE);
+        pte.set_write_through(pde.is_write_through());
+        pte.set_cache_disabled(pde.is_cache_disabled());
+        pte.set_execute_disabled(pde.is_execute_disabled());
+        pte.set_user_allowed(pde.is_user_allowed());
+        pte.set_writable(pde.is_writable());
+        pte.set_present(true);
+    }
+
+    PageDirectoryEntry new_pde;
+    new_pde.clear();
+    new_pde.set_page_table_base(page_table->paddr().get());
+    new_pde.set_user_allowed(true);
+    new_pde.set_present(true);
+    new_pde.set_writable(true);
+    new_pde.set_global(&page_directory == m_kernel_page_directory.ptr());
+    pde = new_pde;
+
+    // NOTE: This leaked ref is matched by the unref in MemoryManager::release_pte()
+    (void)page_table.leak_ref();
+
+    flush_tlb(&page_directory, large_page_vaddr, PAGES_PER_LARGE_PAGE);
+    m_global_data.with([](auto& global_data) { ++global_data.system_memory_info.large_page_splits; });
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    VERIFY_NOT_REACHED();
+#endif
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     dmesgln("Initialize MMU");
@@ -847,7 +973,9 @@ ErrorOr<NonnullOwnPtr<Region>> MemoryManager::allocate_kernel_region(size_t size
         name_kstring = TRY(KString::try_create(name));
     auto vmobject = TRY(AnonymousVMObject::try_create_with_size(size, strategy));
     auto region = TRY(Region::create_unplaced(move(vmobject), 0, move(name_kstring), access, cacheable));
-    TRY(m_global_data.with([&](auto& global_data) { return global_data.region_tree.place_anywhere(*region, RandomizeVirtualAddress::No, size); }));
+    // Aligning larger regions allows their memory to be mapped with large pages.
+    auto alignment = size >= LARGE_PAGE_SIZE ? LARGE_PAGE_SIZE : PAGE_SIZE;
+    TRY(m_global_data.with([&](auto& global_data) { return global_data.region_tree.place_anywhere(*region, RandomizeVirtualAddress::No, size, alignment); }));
     TRY(region->map(kernel_page_directory()));
     return region;
 }
@@ -890,8 +1018,10 @@ ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t pa
 
         global_data.system_memory_info.physical_pages_uncommitted -= page_count;
         global_data.system_memory_info.physical_pages_committed += page_count;
+        update_memory_pressure_level(global_data.system_memory_info);
         return CommittedPhysicalPageSet { {}, page_count };
     });
+    wake_reclaim_task_if_needed();
     if (result.is_error()) {
         Process::for_each_ignoring_jails([&](Process const& process) {
             size_t amount_resident = 0;
@@ -925,6 +1055,7 @@ void MemoryManager::uncommit_physical_pages(Badge<CommittedPhysicalPageSet>, siz
 
         global_data.system_memory_info.physical_pages_uncommitted += page_count;
         global_data.system_memory_info.physical_pages_committed -= page_count;
+        update_memory_pressure_level(global_data.system_memory_info);
     });
 }
 
@@ -943,6 +1074,7 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
             // committed and allocated are only freed upon request. Once
             // returned there is no guarantee being able to get them back.
             ++global_data.system_memory_info.physical_pages_uncommitted;
+            update_memory_pressure_level(global_data.system_memory_info);
             return;
         }
         PANIC("MM: deallocate_physical_page couldn't figure out region for page @ {}", paddr);
@@ -962,6 +1094,7 @@ RefPtr<PhysicalPage> MemoryManager::find_free_physical_page(bool committed)
             if (global_data.system_memory_info.physical_pages_uncommitted == 0)
                 return;
             global_data.system_memory_info.physical_pages_uncommitted--;
+            update_memory_pressure_level(global_data.system_memory_info);
         }
         for (auto& region : global_data.physical_regions) {
             page = region->take_free_page();
@@ -993,43 +1126,25 @@ NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_physical_page(Badg
 
 ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
-    return m_global_data.with([&](auto&) -> ErrorOr<NonnullRefPtr<PhysicalPage>> {
+    auto result = m_global_data.with([&](auto&) -> ErrorOr<NonnullRefPtr<PhysicalPage>> {
         auto page = find_free_physical_page(false);
         bool purged_pages = false;
 
         if (!page) {
             // We didn't have a single free physical page. Let's try to free something up!
             // First, we look for a purgeable VMObject in the volatile state.
-            for_each_vmobject([&](auto& vmobject) {
-                if (!vmobject.is_anonymous())
-                    return IterationDecision::Continue;
-                auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
-                if (!anonymous_vmobject.is_purgeable() || !anonymous_vmobject.is_volatile())
-                    return IterationDecision::Continue;
-                if (auto purged_page_count = anonymous_vmobject.purge()) {
-                    dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
-                    page = find_free_physical_page(false);
-                    purged_pages = true;
-                    VERIFY(page);
-                    return IterationDecision::Break;
-                }
-                return IterationDecision::Continue;
-            });
+            if (auto purged_page_count = purge_volatile_pages(1)) {
+                dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
+                page = find_free_physical_page(false);
+                purged_pages = true;
+            }
         }
         if (!page) {
             // Second, we look for a file-backed VMObject with clean pages.
-            for_each_vmobject([&](auto& vmobject) {
-                if (!vmobject.is_inode())
-                    return IterationDecision::Continue;
-                auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
-                if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
-                    dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
-                    page = find_free_physical_page(false);
-                    VERIFY(page);
-                    return IterationDecision::Break;
-                }
-                return IterationDecision::Continue;
-            });
+            if (auto released_page_count = release_clean_inode_pages(1)) {
+                dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
+                page = find_free_physical_page(false);
+            }
         }
         if (!page) {
             dmesgln("MM: no physical pages available");
@@ -1046,6 +1161,8 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(Shoul
             *did_purge = purged_pages;
         return page.release_nonnull();
     });
+    wake_reclaim_task_if_needed();
+    return result;
 }
 
 ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> MemoryManager::allocate_contiguous_physical_pages(size_t size)
@@ -1063,6 +1180,7 @@ ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> MemoryManager::allocate_contiguous_
             if (!physical_pages.is_empty()) {
                 global_data.system_memory_info.physical_pages_uncommitted -= page_count;
                 global_data.system_memory_info.physical_pages_used += page_count;
+                update_memory_pressure_level(global_data.system_memory_info);
                 return physical_pages;
             }
         }
@@ -1077,6 +1195,35 @@ ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> MemoryManager::allocate_contiguous_
     return physical_pages;
 }
 
+Vector<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_committed_large_page(Badge<CommittedPhysicalPageSet>)
+{
+    if constexpr (!large_pages_supported)
+        return {};
+
+    auto physical_pages = m_global_data.with([&](auto& global_data) -> Vector<NonnullRefPtr<PhysicalPage>> {
+        VERIFY(global_data.system_memory_info.physical_pages_committed >= PAGES_PER_LARGE_PAGE);
+        for (auto& physical_region : global_data.physical_regions) {
+            auto physical_pages = physical_region->take_contiguous_free_pages(PAGES_PER_LARGE_PAGE, LARGE_PAGE_SIZE);
+            if (!physical_pages.is_empty()) {
+                global_data.system_memory_info.physical_pages_committed -= PAGES_PER_LARGE_PAGE;
+                global_data.system_memory_info.physical_pages_used += PAGES_PER_LARGE_PAGE;
+                ++global_data.system_memory_info.large_pages_allocated;
+                return physical_pages;
+            }
+        }
+        ++global_data.system_memory_info.large_page_allocation_failures;
+        return {};
+    });
+
+    for (auto& physical_page : physical_pages) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(physical_page);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+    return physical_pages;
+}
+
 void MemoryManager::enter_process_address_space(Process& process)
 {
     process.address_space().with([](auto& space) {
@@ -1233,6 +1380,18 @@ NonnullRefPtr<PhysicalPage> CommittedPhysicalPageSet::take_one()
     return MM.allocate_committed_physical_page({}, MemoryManager::ShouldZeroFill::Yes);
 }
 
+// Returns an empty vector if there is no suitably aligned run of free physical pages,
+// in which case the caller has to fall back to taking the pages one by one.
+Vector<NonnullRefPtr<PhysicalPage>> CommittedPhysicalPageSet::take_large_page()
+{
+    if (m_page_count < PAGES_PER_LARGE_PAGE)
+        return {};
+    auto physical_pages = MM.allocate_committed_large_page({});
+    if (!physical_pages.is_empty())
+        m_page_count -= PAGES_PER_LARGE_PAGE;
+    return physical_pages;
+}
+
 void CommittedPhysicalPageSet::uncommit_one()
 {
     VERIFY(m_page_count > 0);
@@ -1272,4 +1431,139 @@ MemoryManager::SystemMemoryInfo MemoryManager::get_system_memory_info()
         return global_data.system_memory_info;
     });
 }
+
+void MemoryManager::update_memory_pressure_level(SystemMemoryInfo const& info)
+{
+    // NOTE: Between the low and the high watermark, we stay at whatever level we were at before
+    //       (unless it was critical), so we don't flap between levels while the reclaim task works.
+    auto uncommitted = info.physical_pages_uncommitted;
+    auto old_level = memory_pressure_level();
+    auto new_level = old_level;
+    if (uncommitted < m_watermarks.min)
+        new_level = MEMORY_PRESSURE_CRITICAL;
+    else if (uncommitted < m_watermarks.low)
+        new_level = MEMORY_PRESSURE_LOW;
+    else if (uncommitted >= m_watermarks.high)
+        new_level = MEMORY_PRESSURE_NORMAL;
+    else if (old_level == MEMORY_PRESSURE_CRITICAL)
+        new_level = MEMORY_PRESSURE_LOW;
+
+    if (new_level == old_level)
+        return;
+    m_memory_pressure_level.store(new_level, AK::MemoryOrder::memory_order_relaxed);
+    m_memory_pressure_sequence.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    m_memory_pressure_changed.store(true, AK::MemoryOrder::memory_order_release);
+}
+
+void MemoryManager::wake_reclaim_task_if_needed()
+{
+    // NOTE: Waking up the reclaim task needs the scheduler lock, which we can't take if the caller is holding
+    //       a spinlock. If that's the case, the reclaim task notices the change the next time it checks by itself.
+    if (Processor::in_critical())
+        return;
+    if (m_memory_pressure_changed.exchange(false, AK::MemoryOrder::memory_order_acq_rel))
+        MemoryReclaimTask::request_reclaim();
+}
+
+// Calls `callback` for the VMObjects of type T that `get_last_use` returns a value for, from the one that
+// was used the longest time ago to the most recently used one, until it returns IterationDecision::Break.
+// NOTE: We only collect a small batch of the least recently used VMObjects at a time, so we don't have to
+//       allocate any memory while we're trying to free some up, and don't hold the VMObject list lock for
+//       longer than a single pass over it. The callback runs with the lock released.
+template<typename T, typename GetLastUse, typename Callback>
+static void for_each_vmobject_in_lru_order(GetLastUse get_last_use, Callback callback)
+{
+    static constexpr size_t batch_size = 32;
+
+    struct Candidate {
+        T* vmobject { nullptr };
+        u64 last_use { 0 };
+    };
+
+    // Ties are broken by address, so every VMObject is visited exactly once.
+    auto comes_before = [](u64 a_last_use, T const* a, u64 b_last_use, T const* b) {
+        return a_last_use < b_last_use || (a_last_use == b_last_use && bit_cast<FlatPtr>(a) < bit_cast<FlatPtr>(b));
+    };
+
+    Optional<u64> previous_last_use;
+    T const* previous = nullptr;
+    for (;;) {
+        Array<RefPtr<T>, batch_size> batch;
+        size_t batch_count = 0;
+        u64 batch_last_use = 0;
+
+        VMObject::all_instances().with([&](auto& list) {
+            Array<Candidate, batch_size> candidates;
+            for (auto& vmobject : list) {
+                Optional<u64> last_use = get_last_use(vmobject);
+                if (!last_use.has_value())
+                    continue;
+                auto* candidate = static_cast<T*>(&vmobject);
+                if (previous_last_use.has_value() && !comes_before(*previous_last_use, previous, *last_use, candidate))
+                    continue;
+                if (batch_count == batch_size && !comes_before(*last_use, candidate, candidates[batch_size - 1].last_use, candidates[batch_size - 1].vmobject))
+                    continue;
+
+                // Keep the candidates sorted, dropping the most recently used one if the batch is full.
+                size_t index = min(batch_count, batch_size - 1);
+                for (; index > 0 && comes_before(*last_use, candidate, candidates[index - 1].last_use, candidates[index - 1].vmobject); --index)
+                    candidates[index] = candidates[index - 1];
+                candidates[index] = { candidate, *last_use };
+                if (batch_count < batch_size)
+                    ++batch_count;
+            }
+
+            // NOTE: VMObjects are only removed from the list while it's locked, so all of these are still alive.
+            for (size_t i = 0; i < batch_count; ++i)
+                batch[i] = candidates[i].vmobject;
+            if (batch_count > 0)
+                batch_last_use = candidates[batch_count - 1].last_use;
+        });
+
+        for (size_t i = 0; i < batch_count; ++i) {
+            if (callback(*batch[i]) == IterationDecision::Break)
+                return;
+        }
+        if (batch_count < batch_size)
+            return;
+        previous_last_use = batch_last_use;
+        previous = batch[batch_count - 1].ptr();
+    }
+}
+
+size_t MemoryManager::purge_volatile_pages(size_t page_count)
+{
+    size_t purged_page_count = 0;
+    for_each_vmobject_in_lru_order<AnonymousVMObject>(
+        [](VMObject& vmobject) -> Optional<u64> {
+            if (!vmobject.is_anonymous())
+                return {};
+            auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
+            if (!anonymous_vmobject.is_purgeable() || !anonymous_vmobject.is_volatile())
+                return {};
+            return anonymous_vmobject.volatile_since();
+        },
+        [&](AnonymousVMObject& vmobject) {
+            purged_page_count += vmobject.purge();
+            return purged_page_count >= page_count ? IterationDecision::Break : IterationDecision::Continue;
+        });
+    return purged_page_count;
+}
+
+size_t MemoryManager::release_clean_inode_pages(size_t page_count)
+{
+    size_t released_page_count = 0;
+    for_each_vmobject_in_lru_order<InodeVMObject>(
+        [](VMObject& vmobject) -> Optional<u64> {
+            if (!vmobject.is_inode())
+                return {};
+            return static_cast<InodeVMObject&>(vmobject).last_fault_time();
+        },
+        [&](InodeVMObject& vmobject) {
+            auto pages_to_release = min(page_count - released_page_count, static_cast<size_t>(NumericLimits<int>::max()));
+            released_page_count += vmobject.try_release_clean_pages(static_cast<int>(pages_to_release));
+            return released_page_count >= page_count ? IterationDecision::Break : IterationDecision::Continue;
+        });
+    return released_page_count;
+}
 }
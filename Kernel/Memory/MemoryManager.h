@@ -10,6 +10,7 @@
 #include <AK/Concepts.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveRedBlackTree.h>
+#include <Kernel/API/MemoryPressure.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/AllocationStrategy.h>
@@ -33,6 +34,16 @@ constexpr FlatPtr page_round_down(FlatPtr x)
     return ((FlatPtr)(x)) & ~(PAGE_SIZE - 1);
 }
 
+// Anonymous memory is opportunistically backed by physically contiguous 2 MiB pages,
+// which are mapped by a single page directory entry instead of a whole page table.
+#if ARCH(X86_64)
+static constexpr bool large_pages_supported = true;
+#else
+static constexpr bool large_pages_supported = false;
+#endif
+static constexpr size_t LARGE_PAGE_SIZE = 2 * MiB;
+static constexpr size_t PAGES_PER_LARGE_PAGE = LARGE_PAGE_SIZE / PAGE_SIZE;
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - physical_to_virtual_offset;
@@ -113,6 +124,7 @@ public:
     size_t page_count() const { return m_page_count; }
 
     [[nodiscard]] NonnullRefPtr<PhysicalPage> take_one();
+    [[nodiscard]] Vector<NonnullRefPtr<PhysicalPage>> take_large_page();
     void uncommit_one();
 
     void operator=(CommittedPhysicalPageSet&&) = delete;
@@ -165,6 +177,7 @@ public:
     NonnullRefPtr<PhysicalPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
     ErrorOr<NonnullRefPtr<PhysicalPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> allocate_contiguous_physical_pages(size_t size);
+    Vector<NonnullRefPtr<PhysicalPage>> allocate_committed_large_page(Badge<CommittedPhysicalPageSet>);
     void deallocate_physical_page(PhysicalAddress);
 
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, Region::Cacheable = Region::Cacheable::Yes);
@@ -183,10 +196,31 @@ public:
         PhysicalSize physical_pages_used { 0 };
         PhysicalSize physical_pages_committed { 0 };
         PhysicalSize physical_pages_uncommitted { 0 };
+        u64 large_pages_allocated { 0 };
+        u64 large_page_allocation_failures { 0 };
+        u64 large_page_splits { 0 };
     };
 
     SystemMemoryInfo get_system_memory_info();
 
+    // Once fewer than `low` pages are left uncommitted, the memory reclaim task starts giving cached
+    // memory back to the system, until there are at least `high` pages again. Below `min`, we're
+    // about to start failing allocations.
+    struct Watermarks {
+        PhysicalSize min { 0 };
+        PhysicalSize low { 0 };
+        PhysicalSize high { 0 };
+    };
+
+    Watermarks const& watermarks() const { return m_watermarks; }
+    MemoryPressureLevel memory_pressure_level() const { return static_cast<MemoryPressureLevel>(m_memory_pressure_level.load(AK::MemoryOrder::memory_order_relaxed)); }
+    u64 memory_pressure_sequence() const { return m_memory_pressure_sequence.load(AK::MemoryOrder::memory_order_relaxed); }
+
+    // These give up to `page_count` pages back to the system, starting with the VMObjects that
+    // were used the longest time ago. They return how many pages they actually released.
+    size_t purge_volatile_pages(size_t page_count);
+    size_t release_clean_inode_pages(size_t page_count);
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -251,6 +285,9 @@ private:
 
     RefPtr<PhysicalPage> find_free_physical_page(bool);
 
+    void update_memory_pressure_level(SystemMemoryInfo const&);
+    void wake_reclaim_task_if_needed();
+
     ALWAYS_INLINE u8* quickmap_page(PhysicalPage& page)
     {
         return quickmap_page(page.paddr());
@@ -263,6 +300,8 @@ private:
 
     PageTableEntry* pte(PageDirectory&, VirtualAddress);
     PageTableEntry* ensure_pte(PageDirectory&, VirtualAddress);
+    bool map_large_page(PageDirectory&, VirtualAddress, PageDirectoryEntry const&);
+    bool split_large_page(PageDirectory&, VirtualAddress);
     enum class IsLastPTERelease {
         Yes,
         No
@@ -280,6 +319,11 @@ private:
     //       and then never change.
     PhysicalPageEntry* m_physical_page_entries { nullptr };
     size_t m_physical_page_entries_count { 0 };
+    Watermarks m_watermarks;
+
+    Atomic<u32> m_memory_pressure_level { MEMORY_PRESSURE_NORMAL };
+    Atomic<u64> m_memory_pressure_sequence { 0 };
+    Atomic<bool> m_memory_pressure_changed { false };
 
     struct GlobalData {
         GlobalData();
@@ -257,6 +257,94 @@ bool Region::map_individual_page_impl(size_t page_index)
     return map_individual_page_impl(page_index, page);
 }
 
+// Returns the physical address of the large page that backs the pages starting at the given index,
+// if all of them can be mapped by a single page directory entry.
+Optional<PhysicalAddress> Region::large_page_at(size_t page_index) const
+{
+    if constexpr (!large_pages_supported)
+        return {};
+    if (!vmobject().is_anonymous() || !m_cacheable || m_write_combine || (!is_readable() && !is_writable()))
+        return {};
+    if (vaddr_from_page_index(page_index).get() % LARGE_PAGE_SIZE != 0 || page_index + PAGES_PER_LARGE_PAGE > page_count())
+        return {};
+
+    SpinlockLocker vmobject_locker(vmobject().m_lock);
+    auto physical_pages = vmobject().physical_pages().slice(first_page_index() + page_index, PAGES_PER_LARGE_PAGE);
+
+    // NOTE: Pages that don't come from the physical page allocator (e.g. for MMIO ranges)
+    //       may have different memory types within a large page, so we leave those alone.
+    auto const& first_page = physical_pages[0];
+    if (!first_page || !first_page->may_return_to_freelist() || first_page->paddr().get() % LARGE_PAGE_SIZE != 0)
+        return {};
+
+    for (size_t i = 0; i < PAGES_PER_LARGE_PAGE; ++i) {
+        auto const& page = physical_pages[i];
+        if (!page || page->paddr() != first_page->paddr().offset(i * PAGE_SIZE))
+            return {};
+        if (page->is_shared_zero_page() || page->is_lazy_committed_page() || should_cow(page_index + i))
+            return {};
+    }
+    return first_page->paddr();
+}
+
+bool Region::map_large_page_impl(size_t page_index, PhysicalAddress paddr)
+{
+    VERIFY(m_page_directory->get_lock().is_locked_by_current_processor());
+
+    auto page_vaddr = vaddr_from_page_index(page_index);
+
+    bool user_allowed = page_vaddr.get() >= USER_RANGE_BASE && is_user_address(page_vaddr);
+    if (is_mmap() && !user_allowed) {
+        PANIC("About to map mmap'ed page at a kernel address");
+    }
+
+    PageDirectoryEntry pde;
+    pde.clear();
+    pde.set_page_table_base(paddr.get());
+    pde.set_huge(true);
+    pde.set_present(true);
+    pde.set_writable(is_writable());
+    if (Processor::current().has_nx())
+        pde.set_execute_disabled(!is_executable());
+    pde.set_user_allowed(user_allowed);
+
+    return MM.map_large_page(*m_page_directory, page_vaddr, pde);
+}
+
+// Backs the whole large page around a page that is about to be faulted in with physically
+// contiguous memory, and maps it with a single page directory entry. This only happens if
+// the region covers all of it and none of its pages have been touched yet.
+Optional<PageFaultResponse> Region::try_map_large_page_for_fault(size_t page_index)
+{
+    if constexpr (!large_pages_supported)
+        return {};
+    if (!m_cacheable || m_write_combine)
+        return {};
+
+    auto large_page_vaddr = VirtualAddress { vaddr_from_page_index(page_index).get() & ~(LARGE_PAGE_SIZE - 1) };
+    if (large_page_vaddr < vaddr() || large_page_vaddr.offset(LARGE_PAGE_SIZE) > range().end())
+        return {};
+
+    auto first_page_index = page_index_from_address(large_page_vaddr);
+    if (!static_cast<AnonymousVMObject&>(vmobject()).try_allocate_large_page(translate_to_vmobject_page(first_page_index)))
+        return {};
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    if (auto large_page = large_page_at(first_page_index); large_page.has_value() && map_large_page_impl(first_page_index, large_page.value()))
+        return PageFaultResponse::Continue;
+
+    // We did get the memory, but someone changed the region in the meantime. None of the pages
+    // are lazily committed anymore though, so they all have to be remapped either way.
+    for (size_t i = 0; i < PAGES_PER_LARGE_PAGE; ++i) {
+        if (!map_individual_page_impl(first_page_index + i)) {
+            dmesgln("MM: handle_zero_fault was unable to allocate a page table to map {}", vaddr_from_page_index(first_page_index + i));
+            return PageFaultResponse::OutOfMemory;
+        }
+    }
+    MemoryManager::flush_tlb(m_page_directory, large_page_vaddr, PAGES_PER_LARGE_PAGE);
+    return PageFaultResponse::Continue;
+}
+
 bool Region::remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalPage> physical_page)
 {
     SpinlockLocker page_lock(m_page_directory->get_lock());
@@ -310,6 +398,10 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     set_page_directory(page_directory);
     size_t page_index = 0;
     while (page_index < page_count()) {
+        if (auto large_page = large_page_at(page_index); large_page.has_value() && map_large_page_impl(page_index, large_page.value())) {
+            page_index += PAGES_PER_LARGE_PAGE;
+            continue;
+        }
         if (!map_individual_page_impl(page_index))
             break;
         ++page_index;
@@ -317,8 +409,10 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     if (page_index > 0) {
         if (should_flush_tlb == ShouldFlushTLB::Yes)
             MemoryManager::flush_tlb(m_page_directory, vaddr(), page_index);
-        if (page_index == page_count())
+        if (page_index == page_count()) {
+            m_lazily_mapped = false;
             return {};
+        }
     }
     return ENOMEM;
 }
@@ -383,6 +477,15 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
                 return PageFaultResponse::OutOfMemory;
             return PageFaultResponse::Continue;
         }
+        if (is_lazily_mapped() && page_slot) {
+            // The page is there, it just hasn't been mapped into this region yet, as is the case for the anonymous memory
+            // of a forked process. If it's shared copy-on-write (or it's the shared zero page), a write will fault again
+            // and get its own copy then.
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(lazy) fault in Region({})[{}]", this, page_index_in_region);
+            if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region), *page_slot))
+                return PageFaultResponse::OutOfMemory;
+            return PageFaultResponse::Continue;
+        }
         dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
         dbgln("     - Physical page slot pointer: {:p}", page_slot.ptr());
         if (page_slot) {
@@ -420,6 +523,8 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
         VERIFY(m_vmobject->is_anonymous());
+        if (auto response = try_map_large_page_for_fault(page_index_in_region); response.has_value())
+            return response.value();
         new_physical_page = static_cast<AnonymousVMObject&>(*m_vmobject).allocate_committed_page({});
         dbgln_if(PAGE_FAULT_DEBUG, "      >> ALLOCATED COMMITTED {}", new_physical_page->paddr());
     } else {
@@ -476,6 +581,7 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     VERIFY(!g_scheduler_lock.is_locked_by_current_processor());
 
     auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject());
+    inode_vmobject.did_fault();
 
     auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
     auto& vmobject_physical_page_slot = inode_vmobject.physical_pages()[page_index_in_vmobject];
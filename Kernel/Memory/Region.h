@@ -104,6 +104,11 @@ public:
     [[nodiscard]] bool is_write_combine() const { return m_write_combine; }
     ErrorOr<void> set_write_combine(bool);
 
+    // Lazily mapped regions are attached to a page directory without their pages being mapped,
+    // which only happens as they are touched (see handle_fault()).
+    [[nodiscard]] bool is_lazily_mapped() const { return m_lazily_mapped; }
+    void set_lazily_mapped(bool lazily_mapped) { m_lazily_mapped = lazily_mapped; }
+
     [[nodiscard]] bool is_user() const { return !is_kernel(); }
     [[nodiscard]] bool is_kernel() const { return vaddr().get() < USER_RANGE_BASE || vaddr().get() >= kernel_mapping_base; }
 
@@ -231,6 +236,9 @@ private:
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalPage>);
+    [[nodiscard]] Optional<PhysicalAddress> large_page_at(size_t page_index) const;
+    [[nodiscard]] bool map_large_page_impl(size_t page_index, PhysicalAddress);
+    [[nodiscard]] Optional<PageFaultResponse> try_map_large_page_for_fault(size_t page_index);
 
     LockRefPtr<PageDirectory> m_page_directory;
     VirtualRange m_range;
@@ -248,6 +256,7 @@ private:
     bool m_write_combine : 1 { false };
     bool m_mmapped_from_readable : 1 { false };
     bool m_mmapped_from_writable : 1 { false };
+    bool m_lazily_mapped : 1 { false };
 
     IntrusiveRedBlackTreeNode<FlatPtr, Region, RawPtr<Region>> m_tree_node;
     IntrusiveListNode<Region> m_vmobject_list_node;
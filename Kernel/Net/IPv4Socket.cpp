@@ -36,21 +36,21 @@ MutexProtected<IPv4Socket::List>& IPv4Socket::all_sockets()
     return *s_all_sockets;
 }
 
-ErrorOr<NonnullOwnPtr<DoubleBuffer>> IPv4Socket::try_create_receive_buffer()
+ErrorOr<NonnullOwnPtr<StreamReceiveBuffer>> IPv4Socket::try_create_receive_buffer()
 {
-    return DoubleBuffer::try_create("IPv4Socket: Receive buffer"sv, 256 * KiB);
+    return StreamReceiveBuffer::try_create(256 * KiB);
 }
 
 ErrorOr<NonnullRefPtr<Socket>> IPv4Socket::create(int type, int protocol)
 {
-    auto receive_buffer = TRY(IPv4Socket::try_create_receive_buffer());
-
-    if (type == SOCK_STREAM)
+    if (type == SOCK_STREAM) {
+        auto receive_buffer = TRY(IPv4Socket::try_create_receive_buffer());
         return TRY(TCPSocket::try_create(protocol, move(receive_buffer)));
+    }
     if (type == SOCK_DGRAM)
-        return TRY(UDPSocket::try_create(protocol, move(receive_buffer)));
+        return TRY(UDPSocket::try_create(protocol));
     if (type == SOCK_RAW) {
-        auto raw_socket = adopt_ref_if_nonnull(new (nothrow) IPv4Socket(type, protocol, move(receive_buffer), {}));
+        auto raw_socket = adopt_ref_if_nonnull(new (nothrow) IPv4Socket(type, protocol, {}));
         if (raw_socket)
             return raw_socket.release_nonnull();
         return ENOMEM;
@@ -58,15 +58,14 @@ ErrorOr<NonnullRefPtr<Socket>> IPv4Socket::create(int type, int protocol)
     return EINVAL;
 }
 
-IPv4Socket::IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, OwnPtr<KBuffer> optional_scratch_buffer)
+IPv4Socket::IPv4Socket(int type, int protocol, OwnPtr<StreamReceiveBuffer> receive_buffer)
     : Socket(AF_INET, type, protocol)
     , m_receive_buffer(move(receive_buffer))
-    , m_scratch_buffer(move(optional_scratch_buffer))
 {
     dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}) created with type={}, protocol={}", this, type, protocol);
     m_buffer_mode = type == SOCK_STREAM ? BufferMode::Bytes : BufferMode::Packets;
     if (m_buffer_mode == BufferMode::Bytes) {
-        VERIFY(m_scratch_buffer);
+        VERIFY(m_receive_buffer);
     }
 
     all_sockets().with_exclusive([&](auto& table) {
@@ -139,7 +138,7 @@ ErrorOr<void> IPv4Socket::listen(size_t backlog)
     return protocol_listen(result.did_allocate);
 }
 
-ErrorOr<void> IPv4Socket::connect(Credentials const&, OpenFileDescription& description, Userspace<sockaddr const*> address, socklen_t address_size)
+ErrorOr<void> IPv4Socket::connect(Credentials const&, OpenFileDescription& description, Userspace<sockaddr const*> address, socklen_t address_size, bool blocking)
 {
     if (address_size != sizeof(sockaddr_in))
         return set_so_error(EINVAL);
@@ -159,7 +158,7 @@ ErrorOr<void> IPv4Socket::connect(Credentials const&, OpenFileDescription& descr
         m_peer_address = IPv4Address { 127, 0, 0, 1 };
     m_peer_port = ntohs(safe_address.sin_port);
 
-    return protocol_connect(description);
+    return protocol_connect(description, blocking);
 }
 
 bool IPv4Socket::can_read(OpenFileDescription const&, u64) const
@@ -188,7 +187,19 @@ PortAllocationResult IPv4Socket::allocate_local_port_if_needed()
     return { m_local_port, true };
 }
 
-ErrorOr<size_t> IPv4Socket::sendto(OpenFileDescription&, UserOrKernelBuffer const& data, size_t data_length, [[maybe_unused]] int flags, Userspace<sockaddr const*> addr, socklen_t addr_length)
+ErrorOr<size_t> IPv4Socket::sendto(OpenFileDescription&, UserOrKernelBuffer const& data, size_t data_length, int flags, Userspace<sockaddr const*> addr, socklen_t addr_length)
+{
+    return send_impl(UserOrKernelBufferVector::for_buffer(data, data_length), flags, addr, addr_length);
+}
+
+ErrorOr<size_t> IPv4Socket::sendto_vectored(OpenFileDescription& description, UserOrKernelBufferVector const& data, int flags, Userspace<sockaddr const*> addr, socklen_t addr_length)
+{
+    if (buffer_mode() == BufferMode::Bytes)
+        return Socket::sendto_vectored(description, data, flags, addr, addr_length);
+    return send_impl(data, flags, addr, addr_length);
+}
+
+ErrorOr<size_t> IPv4Socket::send_impl(UserOrKernelBufferVector const& data, int flags, Userspace<sockaddr const*> addr, socklen_t addr_length)
 {
     MutexLocker locker(mutex());
 
@@ -227,13 +238,13 @@ ErrorOr<size_t> IPv4Socket::sendto(OpenFileDescription&, UserOrKernelBuffer cons
 
     if (type() == SOCK_RAW) {
         auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-        data_length = min(data_length, routing_decision.adapter->mtu() - ipv4_payload_offset);
+        size_t data_length = min(data.size(), routing_decision.adapter->mtu() - ipv4_payload_offset);
         auto packet = routing_decision.adapter->acquire_packet_buffer(ipv4_payload_offset + data_length);
         if (!packet)
             return set_so_error(ENOMEM);
         routing_decision.adapter->fill_in_ipv4_header(*packet, local_address(), routing_decision.next_hop,
             m_peer_address, (IPv4Protocol)protocol(), data_length, m_type_of_service, m_ttl);
-        if (auto result = data.read(packet->buffer->data() + ipv4_payload_offset, data_length); result.is_error()) {
+        if (auto result = data.read(packet->buffer->data() + ipv4_payload_offset, 0, data_length); result.is_error()) {
             routing_decision.adapter->release_packet_buffer(*packet);
             return set_so_error(result.release_error());
         }
@@ -242,7 +253,7 @@ ErrorOr<size_t> IPv4Socket::sendto(OpenFileDescription&, UserOrKernelBuffer cons
         return data_length;
     }
 
-    auto nsent_or_error = protocol_send(data, data_length);
+    auto nsent_or_error = protocol_send(data);
     if (!nsent_or_error.is_error())
         Thread::current()->did_ipv4_socket_write(nsent_or_error.value());
     return nsent_or_error;
@@ -280,14 +291,16 @@ ErrorOr<size_t> IPv4Socket::receive_byte_buffered(OpenFileDescription& descripti
     else
         nreceived_or_error = m_receive_buffer->read(buffer, buffer_length);
 
-    if (!nreceived_or_error.is_error() && nreceived_or_error.value() > 0 && !(flags & MSG_PEEK))
+    if (!nreceived_or_error.is_error() && nreceived_or_error.value() > 0 && !(flags & MSG_PEEK)) {
         Thread::current()->did_ipv4_socket_read(nreceived_or_error.value());
+        protocol_did_read_from_receive_buffer();
+    }
 
     set_can_read(!m_receive_buffer->is_empty());
     return nreceived_or_error;
 }
 
-ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& description, UserOrKernelBuffer& buffer, size_t buffer_length, int flags, Userspace<sockaddr*> addr, Userspace<socklen_t*> addr_length, UnixDateTime& packet_timestamp, bool blocking)
+ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& description, UserOrKernelBufferVector& data, int flags, Userspace<sockaddr*> addr, Userspace<socklen_t*> addr_length, UnixDateTime& packet_timestamp, bool blocking)
 {
     MutexLocker locker(mutex());
     ReceivedPacket taken_packet;
@@ -314,7 +327,7 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
 
             dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}): recvfrom without blocking {} bytes, packets in queue: {}",
                 this,
-                packet->data->size(),
+                packet->data.size(),
                 m_receive_queue.size());
         }
     }
@@ -351,11 +364,9 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
 
         dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}): recvfrom with blocking {} bytes, packets in queue: {}",
             this,
-            packet->data->size(),
+            packet->data.size(),
             m_receive_queue.size());
     }
-    VERIFY(packet->data);
-
     packet_timestamp = packet->timestamp;
 
     if (addr) {
@@ -374,22 +385,28 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
     }
 
     if (type() == SOCK_RAW) {
-        size_t bytes_written = min(packet->data->size(), buffer_length);
-        SOCKET_TRY(buffer.write(packet->data->data(), bytes_written));
+        size_t bytes_written = min(packet->data.size(), data.size());
+        SOCKET_TRY(data.write(packet->data.slice(0, bytes_written)));
         return bytes_written;
     }
 
-    return protocol_receive(packet->data->bytes(), buffer, buffer_length, flags);
+    return protocol_receive(packet->data, data, flags);
+}
+
+ErrorOr<void> IPv4Socket::check_user_address_length(Userspace<socklen_t*> user_addr_length)
+{
+    if (!user_addr_length)
+        return {};
+    socklen_t addr_length;
+    SOCKET_TRY(copy_from_user(&addr_length, user_addr_length.unsafe_userspace_ptr()));
+    if (addr_length < sizeof(sockaddr_in))
+        return set_so_error(EINVAL);
+    return {};
 }
 
 ErrorOr<size_t> IPv4Socket::recvfrom(OpenFileDescription& description, UserOrKernelBuffer& buffer, size_t buffer_length, int flags, Userspace<sockaddr*> user_addr, Userspace<socklen_t*> user_addr_length, UnixDateTime& packet_timestamp, bool blocking)
 {
-    if (user_addr_length) {
-        socklen_t addr_length;
-        SOCKET_TRY(copy_from_user(&addr_length, user_addr_length.unsafe_userspace_ptr()));
-        if (addr_length < sizeof(sockaddr_in))
-            return set_so_error(EINVAL);
-    }
+    TRY(check_user_address_length(user_addr_length));
 
     dbgln_if(IPV4_SOCKET_DEBUG, "recvfrom: type={}, local_port={}", type(), local_port());
 
@@ -401,8 +418,10 @@ ErrorOr<size_t> IPv4Socket::recvfrom(OpenFileDescription& description, UserOrKer
         ErrorOr<size_t> nreceived = 0;
         if (buffer_mode() == BufferMode::Bytes)
             nreceived = receive_byte_buffered(description, offset_buffer, offset_buffer_length, flags, user_addr, user_addr_length, blocking);
-        else
-            nreceived = receive_packet_buffered(description, offset_buffer, offset_buffer_length, flags, user_addr, user_addr_length, packet_timestamp, blocking);
+        else {
+            auto offset_data = UserOrKernelBufferVector::for_buffer(offset_buffer, offset_buffer_length);
+            nreceived = receive_packet_buffered(description, offset_data, flags, user_addr, user_addr_length, packet_timestamp, blocking);
+        }
 
         if (nreceived.is_error())
             total_nreceived = move(nreceived);
@@ -415,62 +434,94 @@ ErrorOr<size_t> IPv4Socket::recvfrom(OpenFileDescription& description, UserOrKer
     return total_nreceived;
 }
 
-bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port, ReadonlyBytes packet, UnixDateTime const& packet_timestamp)
+ErrorOr<size_t> IPv4Socket::recvfrom_vectored(OpenFileDescription& description, UserOrKernelBufferVector& data, int flags, Userspace<sockaddr*> user_addr, Userspace<socklen_t*> user_addr_length, UnixDateTime& packet_timestamp, bool blocking)
+{
+    if (buffer_mode() == BufferMode::Bytes)
+        return Socket::recvfrom_vectored(description, data, flags, user_addr, user_addr_length, packet_timestamp, blocking);
+
+    TRY(check_user_address_length(user_addr_length));
+    auto nreceived = TRY(receive_packet_buffered(description, data, flags, user_addr, user_addr_length, packet_timestamp, blocking));
+    Thread::current()->did_ipv4_socket_read(nreceived);
+    return nreceived;
+}
+
+bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port, PooledPacket packet, ReadonlyBytes ipv4_packet)
 {
     MutexLocker locker(mutex());
+    VERIFY(buffer_mode() == BufferMode::Packets);
 
     if (is_shut_down_for_reading())
         return false;
 
-    auto packet_size = packet.size();
+    auto timestamp = packet.timestamp();
+    return enqueue_received_packet({ source_address, source_port, timestamp, ipv4_packet, move(packet), {} });
+}
 
-    if (buffer_mode() == BufferMode::Bytes) {
-        VERIFY(m_receive_buffer);
+bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port, ReadonlyBytes ipv4_packet, UnixDateTime const& packet_timestamp)
+{
+    MutexLocker locker(mutex());
+    VERIFY(buffer_mode() == BufferMode::Packets);
 
-        size_t space_in_receive_buffer = m_receive_buffer->space_for_writing();
-        if (packet_size > space_in_receive_buffer) {
-            dbgln("IPv4Socket({}): did_receive refusing packet since buffer is full.", this);
-            VERIFY(m_can_read);
-            return false;
-        }
-        auto scratch_buffer = UserOrKernelBuffer::for_kernel_buffer(m_scratch_buffer->data());
-        auto nreceived_or_error = protocol_receive(packet, scratch_buffer, m_scratch_buffer->size(), 0);
-        if (nreceived_or_error.is_error())
-            return false;
-        auto nwritten_or_error = m_receive_buffer->write(scratch_buffer, nreceived_or_error.value());
-        if (nwritten_or_error.is_error())
-            return false;
-        set_can_read(!m_receive_buffer->is_empty());
-    } else {
-        if (m_receive_queue.size() > 2000) {
-            dbgln("IPv4Socket({}): did_receive refusing packet since queue is full.", this);
-            return false;
-        }
-        auto data_or_error = KBuffer::try_create_with_bytes("IPv4Socket: Packet buffer"sv, packet);
-        if (data_or_error.is_error()) {
-            dbgln("IPv4Socket: did_receive unable to allocate storage for incoming packet.");
-            return false;
-        }
-        auto result = m_receive_queue.try_append({ source_address, source_port, packet_timestamp, data_or_error.release_value() });
-        if (result.is_error()) {
-            dbgln("IPv4Socket: Dropped incoming packet because appending to the receive queue failed.");
-            return false;
-        }
-        set_can_read(true);
+    if (is_shut_down_for_reading())
+        return false;
+
+    auto data_or_error = KBuffer::try_create_with_bytes("IPv4Socket: Packet buffer"sv, ipv4_packet);
+    if (data_or_error.is_error()) {
+        dbgln("IPv4Socket: did_receive unable to allocate storage for incoming packet.");
+        return false;
+    }
+    auto data = data_or_error.release_value();
+    auto bytes = data->bytes();
+    return enqueue_received_packet({ source_address, source_port, packet_timestamp, bytes, {}, move(data) });
+}
+
+bool IPv4Socket::enqueue_received_packet(ReceivedPacket&& received_packet)
+{
+    VERIFY(mutex().is_locked());
+
+    if (m_receive_queue.size() > 2000) {
+        dbgln("IPv4Socket({}): did_receive refusing packet since queue is full.", this);
+        return false;
+    }
+    auto packet_size = received_packet.data.size();
+    auto result = m_receive_queue.try_append(move(received_packet));
+    if (result.is_error()) {
+        dbgln("IPv4Socket: Dropped incoming packet because appending to the receive queue failed.");
+        return false;
     }
+    set_can_read(true);
     m_bytes_received += packet_size;
 
-    if constexpr (IPV4_SOCKET_DEBUG) {
-        if (buffer_mode() == BufferMode::Bytes)
-            dbgln("IPv4Socket({}): did_receive {} bytes, total_received={}", this, packet_size, m_bytes_received);
-        else
-            dbgln("IPv4Socket({}): did_receive {} bytes, total_received={}, packets in queue: {}",
-                this,
-                packet_size,
-                m_bytes_received,
-                m_receive_queue.size());
+    dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}): did_receive {} bytes, total_received={}, packets in queue: {}",
+        this,
+        packet_size,
+        m_bytes_received,
+        m_receive_queue.size());
+    return true;
+}
+
+bool IPv4Socket::did_receive_stream_data(PooledPacket packet, ReadonlyBytes data)
+{
+    MutexLocker locker(mutex());
+    VERIFY(buffer_mode() == BufferMode::Bytes);
+
+    if (is_shut_down_for_reading())
+        return false;
+
+    // Sockets in TIME-WAIT have already let go of their receive buffer.
+    if (!m_receive_buffer)
+        return false;
+    if (data.size() > m_receive_buffer->space_for_writing()) {
+        dbgln("IPv4Socket({}): did_receive refusing packet since buffer is full.", this);
+        VERIFY(m_can_read);
+        return false;
     }
+    if (m_receive_buffer->append(move(packet), data).is_error())
+        return false;
+    set_can_read(!m_receive_buffer->is_empty());
+    m_bytes_received += data.size();
 
+    dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}): did_receive {} bytes, total_received={}", this, data.size(), m_bytes_received);
     return true;
 }
 
@@ -865,7 +916,7 @@ ErrorOr<void> IPv4Socket::ioctl(OpenFileDescription&, unsigned request, Userspac
             readable = static_cast<int>(m_receive_buffer->immediately_readable());
         } else {
             if (m_receive_queue.size() != 0u) {
-                readable = static_cast<int>(TRY(protocol_size(m_receive_queue.first().data->bytes())));
+                readable = static_cast<int>(TRY(protocol_size(m_receive_queue.first().data)));
             }
         }
 
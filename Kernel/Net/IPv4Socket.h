@@ -8,12 +8,12 @@
 
 #include <AK/HashMap.h>
 #include <AK/SinglyLinkedList.h>
-#include <Kernel/Library/DoubleBuffer.h>
 #include <Kernel/Library/KBuffer.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4.h>
 #include <Kernel/Net/IPv4SocketTuple.h>
 #include <Kernel/Net/Socket.h>
+#include <Kernel/Net/StreamReceiveBuffer.h>
 
 namespace Kernel {
 
@@ -33,7 +33,7 @@ public:
 
     virtual ErrorOr<void> close() override;
     virtual ErrorOr<void> bind(Credentials const&, Userspace<sockaddr const*>, socklen_t) override;
-    virtual ErrorOr<void> connect(Credentials const&, OpenFileDescription&, Userspace<sockaddr const*>, socklen_t) override;
+    virtual ErrorOr<void> connect(Credentials const&, OpenFileDescription&, Userspace<sockaddr const*>, socklen_t, bool blocking) override;
     virtual ErrorOr<void> listen(size_t) override;
     virtual void get_local_address(sockaddr*, socklen_t*) override;
     virtual void get_peer_address(sockaddr*, socklen_t*) override;
@@ -41,12 +41,20 @@ public:
     virtual bool can_write(OpenFileDescription const&, u64) const override;
     virtual ErrorOr<size_t> sendto(OpenFileDescription&, UserOrKernelBuffer const&, size_t, int, Userspace<sockaddr const*>, socklen_t) override;
     virtual ErrorOr<size_t> recvfrom(OpenFileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, UnixDateTime&, bool blocking) override;
+    virtual ErrorOr<size_t> sendto_vectored(OpenFileDescription&, UserOrKernelBufferVector const&, int flags, Userspace<sockaddr const*>, socklen_t) override;
+    virtual ErrorOr<size_t> recvfrom_vectored(OpenFileDescription&, UserOrKernelBufferVector&, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, UnixDateTime&, bool blocking) override;
     virtual ErrorOr<void> setsockopt(int level, int option, Userspace<void const*>, socklen_t) override;
     virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
 
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) override;
 
-    bool did_receive(IPv4Address const& peer_address, u16 peer_port, ReadonlyBytes, UnixDateTime const&);
+    // Datagram sockets hold on to the packet until it's read. Raw sockets get a copy of it
+    // instead, as more than one of them may want the same packet.
+    bool did_receive(IPv4Address const& peer_address, u16 peer_port, PooledPacket, ReadonlyBytes ipv4_packet);
+    bool did_receive(IPv4Address const& peer_address, u16 peer_port, ReadonlyBytes ipv4_packet, UnixDateTime const&);
+
+    // Stream sockets only keep the payload, which has to point into the packet.
+    bool did_receive_stream_data(PooledPacket, ReadonlyBytes data);
 
     IPv4Address const& local_address() const { return m_local_address; }
     u16 local_port() const { return m_local_port; }
@@ -73,33 +81,37 @@ public:
     BufferMode buffer_mode() const { return m_buffer_mode; }
 
 protected:
-    IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, OwnPtr<KBuffer> optional_scratch_buffer);
+    IPv4Socket(int type, int protocol, OwnPtr<StreamReceiveBuffer> receive_buffer);
     virtual StringView class_name() const override { return "IPv4Socket"sv; }
 
     PortAllocationResult allocate_local_port_if_needed();
 
     virtual ErrorOr<void> protocol_bind() { return {}; }
     virtual ErrorOr<void> protocol_listen([[maybe_unused]] bool did_allocate_port) { return {}; }
-    virtual ErrorOr<size_t> protocol_receive(ReadonlyBytes /* raw_ipv4_packet */, UserOrKernelBuffer&, size_t, int) { return ENOTIMPL; }
-    virtual ErrorOr<size_t> protocol_send(UserOrKernelBuffer const&, size_t) { return ENOTIMPL; }
-    virtual ErrorOr<void> protocol_connect(OpenFileDescription&) { return {}; }
+    virtual ErrorOr<size_t> protocol_receive(ReadonlyBytes /* raw_ipv4_packet */, UserOrKernelBufferVector&, int) { return ENOTIMPL; }
+    virtual ErrorOr<size_t> protocol_send(UserOrKernelBufferVector const&) { return ENOTIMPL; }
+    virtual ErrorOr<void> protocol_connect(OpenFileDescription&, bool) { return {}; }
     virtual ErrorOr<u16> protocol_allocate_local_port() { return ENOPROTOOPT; }
     virtual ErrorOr<size_t> protocol_size(ReadonlyBytes /* raw_ipv4_packet */) { return ENOTIMPL; }
     virtual bool protocol_is_disconnected() const { return false; }
+    virtual void protocol_did_read_from_receive_buffer() { }
 
     virtual void shut_down_for_reading() override;
 
     void set_local_address(IPv4Address address) { m_local_address = address; }
     void set_peer_address(IPv4Address address) { m_peer_address = address; }
 
-    static ErrorOr<NonnullOwnPtr<DoubleBuffer>> try_create_receive_buffer();
+    static ErrorOr<NonnullOwnPtr<StreamReceiveBuffer>> try_create_receive_buffer();
     void drop_receive_buffer();
+    StreamReceiveBuffer const* receive_buffer() const { return m_receive_buffer.ptr(); }
 
 private:
     virtual bool is_ipv4() const override { return true; }
 
     ErrorOr<size_t> receive_byte_buffered(OpenFileDescription&, UserOrKernelBuffer& buffer, size_t buffer_length, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, bool blocking);
-    ErrorOr<size_t> receive_packet_buffered(OpenFileDescription&, UserOrKernelBuffer& buffer, size_t buffer_length, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, UnixDateTime&, bool blocking);
+    ErrorOr<size_t> receive_packet_buffered(OpenFileDescription&, UserOrKernelBufferVector&, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, UnixDateTime&, bool blocking);
+    ErrorOr<size_t> send_impl(UserOrKernelBufferVector const&, int flags, Userspace<sockaddr const*>, socklen_t);
+    ErrorOr<void> check_user_address_length(Userspace<socklen_t*>);
 
     void set_can_read(bool);
 
@@ -113,12 +125,17 @@ private:
         IPv4Address peer_address;
         u16 peer_port;
         UnixDateTime timestamp;
-        OwnPtr<KBuffer> data;
+        // The IPv4 packet, which lives in either the packet buffer itself or in a copy of it.
+        ReadonlyBytes data;
+        Optional<PooledPacket> packet;
+        OwnPtr<KBuffer> copy;
     };
 
+    bool enqueue_received_packet(ReceivedPacket&&);
+
     SinglyLinkedList<ReceivedPacket, CountingSizeCalculationPolicy> m_receive_queue;
 
-    OwnPtr<DoubleBuffer> m_receive_buffer;
+    OwnPtr<StreamReceiveBuffer> m_receive_buffer;
 
     u16 m_local_port { 0 };
     u16 m_peer_port { 0 };
@@ -132,8 +149,6 @@ private:
 
     BufferMode m_buffer_mode { BufferMode::Packets };
 
-    OwnPtr<KBuffer> m_scratch_buffer;
-
     IntrusiveListNode<IPv4Socket> m_list_node;
 
 public:
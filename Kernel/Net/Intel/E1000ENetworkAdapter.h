@@ -30,7 +30,7 @@ public:
 
 private:
     E1000ENetworkAdapter(PCI::DeviceIdentifier const&, u8 irq,
-        NonnullOwnPtr<IOWindow> registers_io_window, NonnullOwnPtr<Memory::Region> rx_buffer_region,
+        NonnullOwnPtr<IOWindow> registers_io_window,
         NonnullOwnPtr<Memory::Region> tx_buffer_region, NonnullOwnPtr<Memory::Region> rx_descriptors_region,
         NonnullOwnPtr<Memory::Region> tx_descriptors_region, NonnullOwnPtr<KString>);
 
@@ -172,14 +172,12 @@ UNMAP_AFTER_INIT ErrorOr<NonnullRefPtr<NetworkAdapter>> E1000NetworkAdapter::cre
     auto interface_name = TRY(NetworkingManagement::generate_interface_name_from_pci_address(pci_device_identifier));
     auto registers_io_window = TRY(IOWindow::create_for_pci_device_bar(pci_device_identifier, PCI::HeaderType0BaseRegister::BAR0));
 
-    auto rx_buffer_region = TRY(MM.allocate_contiguous_kernel_region(rx_buffer_size * number_of_rx_descriptors, "E1000 RX buffers"sv, Memory::Region::Access::ReadWrite));
     auto tx_buffer_region = MM.allocate_contiguous_kernel_region(tx_buffer_size * number_of_tx_descriptors, "E1000 TX buffers"sv, Memory::Region::Access::ReadWrite).release_value();
     auto rx_descriptors_region = TRY(MM.allocate_contiguous_kernel_region(TRY(Memory::page_round_up(sizeof(e1000_rx_desc) * number_of_rx_descriptors)), "E1000 RX Descriptors"sv, Memory::Region::Access::ReadWrite));
     auto tx_descriptors_region = TRY(MM.allocate_contiguous_kernel_region(TRY(Memory::page_round_up(sizeof(e1000_tx_desc) * number_of_tx_descriptors)), "E1000 TX Descriptors"sv, Memory::Region::Access::ReadWrite));
 
     return TRY(adopt_nonnull_ref_or_enomem(new (nothrow) E1000NetworkAdapter(pci_device_identifier,
         irq, move(registers_io_window),
-        move(rx_buffer_region),
         move(tx_buffer_region),
         move(rx_descriptors_region),
         move(tx_descriptors_region),
@@ -200,7 +198,7 @@ UNMAP_AFTER_INIT ErrorOr<void> E1000NetworkAdapter::initialize(Badge<NetworkingM
     auto const& mac = mac_address();
     dmesgln_pci(*this, "MAC address: {}", mac.to_string());
 
-    initialize_rx_descriptors();
+    TRY(initialize_rx_descriptors());
     initialize_tx_descriptors();
 
     setup_link();
@@ -226,7 +224,7 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_interrupts()
 }
 
 UNMAP_AFTER_INIT E1000NetworkAdapter::E1000NetworkAdapter(PCI::DeviceIdentifier const& device_identifier, u8 irq,
-    NonnullOwnPtr<IOWindow> registers_io_window, NonnullOwnPtr<Memory::Region> rx_buffer_region,
+    NonnullOwnPtr<IOWindow> registers_io_window,
     NonnullOwnPtr<Memory::Region> tx_buffer_region, NonnullOwnPtr<Memory::Region> rx_descriptors_region,
     NonnullOwnPtr<Memory::Region> tx_descriptors_region, NonnullOwnPtr<KString> interface_name)
     : NetworkAdapter(move(interface_name))
@@ -235,7 +233,6 @@ UNMAP_AFTER_INIT E1000NetworkAdapter::E1000NetworkAdapter(PCI::DeviceIdentifier
     , m_registers_io_window(move(registers_io_window))
     , m_rx_descriptors_region(move(rx_descriptors_region))
     , m_tx_descriptors_region(move(tx_descriptors_region))
-    , m_rx_buffer_region(move(rx_buffer_region))
     , m_tx_buffer_region(move(tx_buffer_region))
 {
 }
@@ -322,14 +319,15 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::read_mac_address()
     }
 }
 
-UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_rx_descriptors()
+UNMAP_AFTER_INIT ErrorOr<void> E1000NetworkAdapter::initialize_rx_descriptors()
 {
     auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
-    constexpr auto rx_buffer_page_count = rx_buffer_size / PAGE_SIZE;
     for (size_t i = 0; i < number_of_rx_descriptors; ++i) {
         auto& descriptor = rx_descriptors[i];
-        m_rx_buffers[i] = m_rx_buffer_region->vaddr().as_ptr() + rx_buffer_size * i;
-        descriptor.addr = m_rx_buffer_region->physical_page(rx_buffer_page_count * i)->paddr().get();
+        m_rx_packets[i] = acquire_receive_buffer();
+        if (!m_rx_packets[i])
+            return ENOMEM;
+        descriptor.addr = m_rx_packets[i]->buffer->region().physical_page(0)->paddr().get();
         descriptor.status = 0;
     }
 
@@ -339,7 +337,8 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_rx_descriptors()
     out32(REG_RXDESCHEAD, 0);
     out32(REG_RXDESCTAIL, number_of_rx_descriptors - 1);
 
-    out32(REG_RCTRL, RCTL_EN | RCTL_SBP | RCTL_UPE | RCTL_MPE | RCTL_LBM_NONE | RTCL_RDMTS_HALF | RCTL_BAM | RCTL_SECRC | RCTL_BSIZE_8192);
+    out32(REG_RCTRL, RCTL_EN | RCTL_SBP | RCTL_UPE | RCTL_MPE | RCTL_LBM_NONE | RTCL_RDMTS_HALF | RCTL_BAM | RCTL_SECRC | RCTL_BSIZE_4096);
+    return {};
 }
 
 UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_tx_descriptors()
@@ -432,19 +431,30 @@ void E1000NetworkAdapter::receive()
 {
     auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
     u32 rx_current;
+    bool received_any = false;
     for (;;) {
         rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
         rx_current = (rx_current + 1) % number_of_rx_descriptors;
-        if (!(rx_descriptors[rx_current].status & 1))
+        auto& descriptor = rx_descriptors[rx_current];
+        if (!(descriptor.status & 1))
             break;
-        auto* buffer = m_rx_buffers[rx_current];
-        u16 length = rx_descriptors[rx_current].length;
-        VERIFY(length <= 8192);
-        dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {:p} ({} bytes)", buffer, length);
-        did_receive({ buffer, length });
-        rx_descriptors[rx_current].status = 0;
+        u16 length = descriptor.length;
+        VERIFY(length <= receive_buffer_size);
+        dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {:p} ({} bytes)", m_rx_packets[rx_current]->buffer->data(), length);
+        // The packet is passed on as it is, and the descriptor gets a fresh buffer instead.
+        // If we can't get one, we drop the packet and let the NIC reuse the old buffer.
+        if (auto fresh_packet = acquire_receive_buffer()) {
+            auto packet = m_rx_packets[rx_current].release_nonnull();
+            packet->buffer->set_size(length);
+            m_rx_packets[rx_current] = move(fresh_packet);
+            descriptor.addr = m_rx_packets[rx_current]->buffer->region().physical_page(0)->paddr().get();
+            received_any |= queue_received_packet(move(packet));
+        }
+        descriptor.status = 0;
         out32(REG_RXDESCTAIL, rx_current);
     }
+    if (received_any)
+        did_receive_batch();
 }
 
 i32 E1000NetworkAdapter::link_speed()
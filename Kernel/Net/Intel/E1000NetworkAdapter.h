@@ -36,14 +36,13 @@ public:
     virtual Type adapter_type() const override { return Type::Ethernet; }
 
 protected:
-    static constexpr size_t rx_buffer_size = 8192;
     static constexpr size_t tx_buffer_size = 8192;
 
     void setup_interrupts();
     void setup_link();
 
     E1000NetworkAdapter(PCI::DeviceIdentifier const&, u8 irq,
-        NonnullOwnPtr<IOWindow> registers_io_window, NonnullOwnPtr<Memory::Region> rx_buffer_region,
+        NonnullOwnPtr<IOWindow> registers_io_window,
         NonnullOwnPtr<Memory::Region> tx_buffer_region, NonnullOwnPtr<Memory::Region> rx_descriptors_region,
         NonnullOwnPtr<Memory::Region> tx_descriptors_region, NonnullOwnPtr<KString>);
 
@@ -73,7 +72,7 @@ protected:
     virtual u32 read_eeprom(u8 address);
     void read_mac_address();
 
-    void initialize_rx_descriptors();
+    ErrorOr<void> initialize_rx_descriptors();
     void initialize_tx_descriptors();
 
     void out8(u16 address, u8);
@@ -92,9 +91,8 @@ protected:
 
     NonnullOwnPtr<Memory::Region> m_rx_descriptors_region;
     NonnullOwnPtr<Memory::Region> m_tx_descriptors_region;
-    NonnullOwnPtr<Memory::Region> m_rx_buffer_region;
     NonnullOwnPtr<Memory::Region> m_tx_buffer_region;
-    Array<void*, number_of_rx_descriptors> m_rx_buffers;
+    Array<RefPtr<PacketWithTimestamp>, number_of_rx_descriptors> m_rx_packets;
     Array<void*, number_of_tx_descriptors> m_tx_buffers;
     bool m_has_eeprom { false };
     bool m_link_up { false };
@@ -160,7 +160,8 @@ ErrorOr<void> LocalSocket::bind(Credentials const& credentials, Userspace<sockad
     return {};
 }
 
-ErrorOr<void> LocalSocket::connect(Credentials const& credentials, OpenFileDescription& description, Userspace<sockaddr const*> user_address, socklen_t address_size)
+// NOTE: Connecting a local socket always waits for the connection to be accepted.
+ErrorOr<void> LocalSocket::connect(Credentials const& credentials, OpenFileDescription& description, Userspace<sockaddr const*> user_address, socklen_t address_size, bool)
 {
     VERIFY(!m_bound);
 
@@ -70,6 +70,12 @@ void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Addres
 }
 
 void NetworkAdapter::did_receive(ReadonlyBytes payload)
+{
+    if (queue_received_packet(payload))
+        did_receive_batch();
+}
+
+bool NetworkAdapter::queue_received_packet(ReadonlyBytes payload)
 {
     InterruptDisabler disabler;
     m_packets_in++;
@@ -77,52 +83,73 @@ void NetworkAdapter::did_receive(ReadonlyBytes payload)
 
     if (m_packet_queue_size == max_packet_buffers) {
         // FIXME: Keep track of the number of dropped packets
-        return;
+        return false;
     }
 
     auto packet = acquire_packet_buffer(payload.size());
     if (!packet) {
         dbgln("Discarding packet because we're out of memory");
-        return;
+        return false;
     }
 
     memcpy(packet->buffer->data(), payload.data(), payload.size());
 
     m_packet_queue.append(*packet);
     m_packet_queue_size++;
+    return true;
+}
 
+bool NetworkAdapter::queue_received_packet(NonnullRefPtr<PacketWithTimestamp> packet)
+{
+    InterruptDisabler disabler;
+    m_packets_in++;
+    m_bytes_in += packet->buffer->size();
+
+    if (m_packet_queue_size == max_packet_buffers) {
+        // FIXME: Keep track of the number of dropped packets
+        release_packet_buffer(*packet);
+        return false;
+    }
+
+    packet->timestamp = kgettimeofday();
+    m_packet_queue.append(*packet);
+    m_packet_queue_size++;
+    return true;
+}
+
+void NetworkAdapter::did_receive_batch()
+{
     if (on_receive)
         on_receive();
 }
 
-size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp)
+size_t NetworkAdapter::dequeue_packets(PacketList& packets, size_t budget)
 {
     InterruptDisabler disabler;
-    if (m_packet_queue.is_empty())
-        return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
-    m_packet_queue_size--;
-    packet_timestamp = packet_with_timestamp->timestamp;
-    auto& packet_buffer = packet_with_timestamp->buffer;
-    size_t packet_size = packet_buffer->size();
-    VERIFY(packet_size <= buffer_size);
-    memcpy(buffer, packet_buffer->data(), packet_size);
-    release_packet_buffer(*packet_with_timestamp);
-    return packet_size;
+    size_t count = 0;
+    while (count < budget && !m_packet_queue.is_empty()) {
+        auto packet = m_packet_queue.take_first();
+        packets.append(*packet);
+        ++count;
+    }
+    m_packet_queue_size -= count;
+    return count;
 }
 
 RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
 {
     auto packet = m_unused_packets.with([size](auto& unused_packets) -> RefPtr<PacketWithTimestamp> {
-        if (unused_packets.is_empty())
+        if (unused_packets.list.is_empty())
             return nullptr;
 
-        auto unused_packet = unused_packets.take_first();
+        auto unused_packet = unused_packets.list.take_first();
 
-        if (unused_packet->buffer->capacity() >= size)
+        if (unused_packet->buffer->capacity() >= size) {
+            unused_packets.count--;
             return unused_packet;
+        }
 
-        unused_packets.append(*unused_packet);
+        unused_packets.list.append(*unused_packet);
         return nullptr;
     });
 
@@ -132,20 +159,53 @@ RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
         return packet;
     }
 
+    return allocate_packet_buffer(size);
+}
+
+RefPtr<PacketWithTimestamp> NetworkAdapter::allocate_packet_buffer(size_t size)
+{
     auto buffer_or_error = KBuffer::try_create_with_size("NetworkAdapter: Packet buffer"sv, size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
     if (buffer_or_error.is_error())
         return {};
-    packet = adopt_ref_if_nonnull(new (nothrow) PacketWithTimestamp { buffer_or_error.release_value(), kgettimeofday() });
+    auto packet = adopt_ref_if_nonnull(new (nothrow) PacketWithTimestamp { buffer_or_error.release_value(), kgettimeofday() });
     if (!packet)
         return {};
     packet->buffer->set_size(size);
     return packet;
 }
 
+RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_receive_buffer()
+{
+    auto packet = m_unused_packets.with([](auto& unused_packets) -> RefPtr<PacketWithTimestamp> {
+        if (unused_packets.list.is_empty())
+            return nullptr;
+
+        auto unused_packet = unused_packets.list.take_first();
+
+        if (unused_packet->buffer->capacity() == receive_buffer_size) {
+            unused_packets.count--;
+            return unused_packet;
+        }
+
+        unused_packets.list.append(*unused_packet);
+        return nullptr;
+    });
+
+    if (!packet)
+        return allocate_packet_buffer(receive_buffer_size);
+    packet->buffer->set_size(receive_buffer_size);
+    return packet;
+}
+
 void NetworkAdapter::release_packet_buffer(PacketWithTimestamp& packet)
 {
     m_unused_packets.with([&packet](auto& unused_packets) {
-        unused_packets.append(packet);
+        // Sockets can hold on to lots of received packets for a while. Once they're done with
+        // them, we don't want to keep all of them around.
+        if (unused_packets.count >= max_packet_buffers)
+            return;
+        unused_packets.list.append(packet);
+        unused_packets.count++;
     });
 }
 
@@ -159,4 +219,27 @@ void NetworkAdapter::set_ipv4_netmask(IPv4Address const& netmask)
     m_ipv4_netmask = netmask;
 }
 
+PooledPacket& PooledPacket::operator=(PooledPacket&& other)
+{
+    if (this != &other) {
+        release();
+        m_adapter = move(other.m_adapter);
+        m_packet = move(other.m_packet);
+    }
+    return *this;
+}
+
+PooledPacket::~PooledPacket()
+{
+    release();
+}
+
+void PooledPacket::release()
+{
+    if (m_packet)
+        m_adapter->release_packet_buffer(*m_packet);
+    m_packet = nullptr;
+    m_adapter = nullptr;
+}
+
 }
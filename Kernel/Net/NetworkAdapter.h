@@ -79,7 +79,11 @@ public:
     void send(MACAddress const&, ARPPacket const&);
     void fill_in_ipv4_header(PacketWithTimestamp&, IPv4Address const&, MACAddress const&, IPv4Address const&, IPv4Protocol, size_t, u8 type_of_service, u8 ttl);
 
-    size_t dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp);
+    using PacketList = IntrusiveList<&PacketWithTimestamp::packet_node>;
+
+    // Moves up to `budget` received packets to the end of `packets` and returns how many were moved.
+    // The caller hands each of them back with release_packet_buffer() once it has handled them.
+    size_t dequeue_packets(PacketList& packets, size_t budget);
 
     bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
 
@@ -94,9 +98,15 @@ public:
     RefPtr<PacketWithTimestamp> acquire_packet_buffer(size_t);
     void release_packet_buffer(PacketWithTimestamp&);
 
+    // Receive rings DMA straight into packet buffers from the pool. These are always exactly one
+    // page large, which makes them physically contiguous no matter where their page came from.
+    static constexpr size_t receive_buffer_size = PAGE_SIZE;
+    RefPtr<PacketWithTimestamp> acquire_receive_buffer();
+
     constexpr size_t layer3_payload_offset() const { return sizeof(EthernetFrameHeader); }
     constexpr size_t ipv4_payload_offset() const { return layer3_payload_offset() + sizeof(IPv4Packet); }
 
+    // Called once for every batch of packets a driver has received.
     Function<void()> on_receive;
 
     void send_packet(ReadonlyBytes);
@@ -105,9 +115,19 @@ protected:
     NetworkAdapter(NonnullOwnPtr<KString>);
     void set_mac_address(MACAddress const& mac_address) { m_mac_address = mac_address; }
     void did_receive(ReadonlyBytes);
+
+    // Drivers that drain several frames from their receive ring at once queue each of them with
+    // queue_received_packet() and call did_receive_batch() afterwards, so that the network task
+    // is only woken up once per batch.
+    bool queue_received_packet(ReadonlyBytes);
+    bool queue_received_packet(NonnullRefPtr<PacketWithTimestamp>);
+    void did_receive_batch();
+
     virtual void send_raw(ReadonlyBytes) = 0;
 
 private:
+    RefPtr<PacketWithTimestamp> allocate_packet_buffer(size_t);
+
     MACAddress m_mac_address;
     IPv4Address m_ipv4_address;
     IPv4Address m_ipv4_netmask;
@@ -115,11 +135,14 @@ private:
     // FIXME: Make this configurable
     static constexpr size_t max_packet_buffers = 1024;
 
-    using PacketList = IntrusiveList<&PacketWithTimestamp::packet_node>;
+    struct UnusedPackets {
+        PacketList list;
+        size_t count { 0 };
+    };
 
     PacketList m_packet_queue;
     size_t m_packet_queue_size { 0 };
-    SpinlockProtected<PacketList, LockRank::None> m_unused_packets {};
+    SpinlockProtected<UnusedPackets, LockRank::None> m_unused_packets {};
     NonnullOwnPtr<KString> m_name;
     u32 m_packets_in { 0 };
     u32 m_bytes_in { 0 };
@@ -128,4 +151,31 @@ private:
     u32 m_mtu { 1500 };
 };
 
+// Owns a packet buffer from an adapter's pool, and hands it back to the pool when it goes away.
+// Received packets travel through the network stack in these, and sockets hold on to them until
+// userspace reads their data, so that the data is only ever copied once.
+class PooledPacket {
+    AK_MAKE_NONCOPYABLE(PooledPacket);
+
+public:
+    PooledPacket(NetworkAdapter& adapter, NonnullRefPtr<PacketWithTimestamp> packet)
+        : m_adapter(adapter)
+        , m_packet(move(packet))
+    {
+    }
+
+    PooledPacket(PooledPacket&&) = default;
+    PooledPacket& operator=(PooledPacket&&);
+    ~PooledPacket();
+
+    ReadonlyBytes bytes() const { return m_packet->buffer->bytes(); }
+    UnixDateTime timestamp() const { return m_packet->timestamp; }
+
+private:
+    void release();
+
+    RefPtr<NetworkAdapter> m_adapter;
+    RefPtr<PacketWithTimestamp> m_packet;
+};
+
 }
@@ -4,9 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/Net/ARP.h>
 #include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/EthernetFrameHeader.h>
@@ -22,23 +25,49 @@
 #include <Kernel/Net/UDP.h>
 #include <Kernel/Net/UDPSocket.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WaitQueue.h>
 
 namespace Kernel {
 
+static void handle_frames(Span<PooledPacket> frames);
 static void handle_arp(EthernetFrameHeader const&, size_t frame_size);
-static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, UnixDateTime const& packet_timestamp);
+static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, Span<PooledPacket> frames);
 static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, UnixDateTime const& packet_timestamp);
-static void handle_udp(IPv4Packet const&, UnixDateTime const& packet_timestamp);
-static void handle_tcp(IPv4Packet const&, UnixDateTime const& packet_timestamp);
+static void handle_udp(IPv4Packet const&, PooledPacket&);
+static void handle_tcp(IPv4Packet const&, Span<PooledPacket> segments);
 static void send_delayed_tcp_ack(TCPSocket& socket);
 static void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, RefPtr<NetworkAdapter> adapter);
-static void flush_delayed_tcp_acks();
 static void retransmit_tcp_packets();
 
+// The network task itself only pulls packets off the adapters and retransmits TCP packets.
+// Everything else happens on one worker thread per processor. Packets are spread across
+// the workers by a hash of their flow, so that the packets of a connection are always
+// handled by the same worker, in the order they arrived in.
+struct NetworkWorker {
+    // FIXME: Make this configurable
+    static constexpr size_t max_queued_packets = 1024;
+
+    size_t index { 0 };
+    RefPtr<Thread> thread;
+    WaitQueue wait_queue;
+    SpinlockProtected<Vector<PooledPacket>, LockRank::None> queued_packets {};
+    // Only ever touched by the worker thread itself.
+    HashTable<NonnullRefPtr<TCPSocket>> delayed_ack_sockets;
+};
+
+// How many packets we take from an adapter before moving on to the next one.
+static constexpr size_t adapter_receive_budget = 64;
+static constexpr size_t max_network_workers = 32;
+// Coalesced TCP segments still have to fit into a single IPv4 packet.
+static constexpr size_t max_coalesced_tcp_segment_size = NumericLimits<u16>::max() - sizeof(IPv4Packet);
+
 static Thread* network_task = nullptr;
-static HashTable<NonnullRefPtr<TCPSocket>>* delayed_ack_sockets;
+static Array<NetworkWorker*, max_network_workers> s_workers {};
+static size_t s_worker_count = 0;
 
 [[noreturn]] static void NetworkTask_main(void*);
+[[noreturn]] static void NetworkTask_worker_main(void*);
+static void flush_delayed_tcp_acks(NetworkWorker&);
 
 void NetworkTask::spawn()
 {
@@ -51,15 +80,108 @@ void NetworkTask::spawn()
 
 bool NetworkTask::is_current()
 {
-    return Thread::current() == network_task;
+    auto* current_thread = Thread::current();
+    if (current_thread == network_task)
+        return true;
+    for (size_t i = 0; i < s_worker_count; ++i) {
+        if (s_workers[i]->thread == current_thread)
+            return true;
+    }
+    return false;
 }
 
-void NetworkTask_main(void*)
+static NetworkWorker& current_worker()
 {
-    delayed_ack_sockets = new HashTable<NonnullRefPtr<TCPSocket>>;
+    auto* current_thread = Thread::current();
+    for (size_t i = 0; i < s_worker_count; ++i) {
+        if (s_workers[i]->thread == current_thread)
+            return *s_workers[i];
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static void spawn_workers()
+{
+    s_worker_count = min(static_cast<size_t>(Processor::count()), max_network_workers);
+    for (size_t i = 0; i < s_worker_count; ++i) {
+        auto* worker = new NetworkWorker;
+        worker->index = i;
+        MUST(worker->queued_packets.with([](auto& queued_packets) { return queued_packets.try_ensure_capacity(NetworkWorker::max_queued_packets); }));
+        s_workers[i] = worker;
+    }
+    for (size_t i = 0; i < s_worker_count; ++i) {
+        auto name = MUST(KString::formatted("Network Worker #{}", i));
+        s_workers[i]->thread = MUST(Process::current().create_kernel_thread(NetworkTask_worker_main, s_workers[i], THREAD_PRIORITY_NORMAL, move(name), 1u << i, false));
+    }
+    dmesgln("NetworkTask: Handling packets on {} worker threads", s_worker_count);
+}
+
+// This is what RSS hardware does for us on fancier NICs: TCP and UDP packets are steered
+// by their 4-tuple, everything else by its addresses. Fragments carry no ports (except for
+// the first one), so they are steered by their addresses as well.
+static size_t worker_index_for_frame(ReadonlyBytes frame)
+{
+    if (s_worker_count == 1)
+        return 0;
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet))
+        return 0;
+    auto& eth = *reinterpret_cast<EthernetFrameHeader const*>(frame.data());
+    if (eth.ether_type() != EtherType::IPv4)
+        return 0;
+
+    auto& ipv4_packet = *static_cast<IPv4Packet const*>(eth.payload());
+    u32 hash = pair_int_hash(ipv4_packet.source().to_u32(), ipv4_packet.destination().to_u32());
+
+    auto protocol = static_cast<IPv4Protocol>(ipv4_packet.protocol());
+    bool is_fragment = ipv4_packet.fragment_offset() != 0 || (ipv4_packet.flags() & static_cast<u16>(IPv4PacketFlags::MoreFragments));
+    bool has_ports = protocol == IPv4Protocol::TCP || protocol == IPv4Protocol::UDP;
+    if (has_ports && !is_fragment && frame.size() >= sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + sizeof(u32)) {
+        // Both TCP and UDP headers start with the source and destination port.
+        u32 ports;
+        memcpy(&ports, ipv4_packet.payload(), sizeof(ports));
+        hash = pair_int_hash(hash, ports);
+    }
+    return hash % s_worker_count;
+}
+
+static size_t dispatch_received_packets(NetworkAdapter& adapter, Span<Vector<PooledPacket>> batches)
+{
+    NetworkAdapter::PacketList packets;
+    size_t packet_count = adapter.dequeue_packets(packets, adapter_receive_budget);
+    if (packet_count == 0)
+        return 0;
+    dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued {} packets from {}", packet_count, adapter.name());
+
+    while (auto packet = packets.take_first()) {
+        auto& batch = batches[worker_index_for_frame(packet->bytes())];
+        // The batches have room for a whole adapter budget, so this never allocates.
+        batch.unchecked_append(PooledPacket { adapter, packet.release_nonnull() });
+    }
+
+    for (size_t i = 0; i < s_worker_count; ++i) {
+        auto& batch = batches[i];
+        if (batch.is_empty())
+            continue;
+        auto& worker = *s_workers[i];
+        size_t accepted_packets = worker.queued_packets.with([&](auto& queued_packets) {
+            size_t accepted_packets = min(batch.size(), NetworkWorker::max_queued_packets - queued_packets.size());
+            for (size_t j = 0; j < accepted_packets; ++j)
+                queued_packets.unchecked_append(move(batch[j]));
+            return accepted_packets;
+        });
+        // If the worker is backed up, the rest of the batch goes straight back to the adapter.
+        size_t dropped_packets = batch.size() - accepted_packets;
+        batch.clear_with_capacity();
+        if (dropped_packets)
+            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Worker #{} is backed up, dropped {} packets", i, dropped_packets);
+        worker.wait_queue.wake_all();
+    }
+    return packet_count;
+}
 
+void NetworkTask_main(void*)
+{
     WaitQueue packet_wait_queue;
-    int pending_packets = 0;
     NetworkingManagement::the().for_each([&](auto& adapter) {
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
@@ -69,66 +191,157 @@ void NetworkTask_main(void*)
         }
 
         adapter.on_receive = [&]() {
-            pending_packets++;
             packet_wait_queue.wake_all();
         };
     });
 
-    auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp) -> size_t {
-        if (pending_packets == 0)
-            return 0;
-        size_t packet_size = 0;
-        NetworkingManagement::the().for_each([&](auto& adapter) {
-            if (packet_size || !adapter.has_queued_packets())
-                return;
-            packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
-            pending_packets--;
-            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
-        });
-        return packet_size;
-    };
+    spawn_workers();
 
-    size_t buffer_size = 64 * KiB;
-    auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer"sv, Memory::Region::Access::ReadWrite);
-    if (region_or_error.is_error())
-        TODO();
-    auto buffer_region = region_or_error.release_value();
-    auto buffer = (u8*)buffer_region->vaddr().get();
-    UnixDateTime packet_timestamp;
+    Array<Vector<PooledPacket>, max_network_workers> batches;
+    for (size_t i = 0; i < s_worker_count; ++i)
+        MUST(batches[i].try_ensure_capacity(adapter_receive_budget));
 
     for (;;) {
-        flush_delayed_tcp_acks();
         retransmit_tcp_packets();
-        size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
-        if (!packet_size) {
+
+        size_t packet_count = 0;
+        NetworkingManagement::the().for_each([&](auto& adapter) {
+            packet_count += dispatch_received_packets(adapter, batches.span());
+        });
+        if (packet_count == 0) {
             auto timeout_time = Duration::from_milliseconds(500);
             auto timeout = Thread::BlockTimeout { false, &timeout_time };
             [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
-            continue;
         }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
-            continue;
-        }
-        auto& eth = *(EthernetFrameHeader const*)buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
+    }
+}
+
+// Returns the TCP header of a frame, if it's a TCP segment that may be coalesced with its neighbours.
+static TCPPacket const* coalescable_tcp_segment(ReadonlyBytes frame)
+{
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + sizeof(TCPPacket))
+        return nullptr;
+    auto& eth = *reinterpret_cast<EthernetFrameHeader const*>(frame.data());
+    if (eth.ether_type() != EtherType::IPv4)
+        return nullptr;
+    auto& ipv4_packet = *static_cast<IPv4Packet const*>(eth.payload());
+    if (ipv4_packet.protocol() != static_cast<u8>(IPv4Protocol::TCP))
+        return nullptr;
+    if (ipv4_packet.fragment_offset() != 0 || (ipv4_packet.flags() & static_cast<u16>(IPv4PacketFlags::MoreFragments)))
+        return nullptr;
+    if (ipv4_packet.length() < sizeof(IPv4Packet) + sizeof(TCPPacket) || ipv4_packet.length() > frame.size() - sizeof(EthernetFrameHeader))
+        return nullptr;
+    auto& tcp_packet = *static_cast<TCPPacket const*>(ipv4_packet.payload());
+    if (tcp_packet.header_size() < sizeof(TCPPacket) || tcp_packet.header_size() >= ipv4_packet.payload_size())
+        return nullptr;
+    // Anything but plain data has to go through the state machine on its own.
+    if (tcp_packet.flags() != TCPFlags::ACK && tcp_packet.flags() != (TCPFlags::ACK | TCPFlags::PSH))
+        return nullptr;
+    return &tcp_packet;
+}
 
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size);
+static IPv4Packet const& ipv4_packet_of(TCPPacket const& tcp_packet)
+{
+    return *reinterpret_cast<IPv4Packet const*>(reinterpret_cast<u8 const*>(&tcp_packet) - sizeof(IPv4Packet));
+}
+
+// Like GRO, we hand a run of consecutive data segments of a connection to the TCP code
+// in one go, so that their headers are only processed once. The segments have to continue
+// each other exactly and only differ in their payload, and a PSH ends the run.
+static size_t coalescable_tcp_segment_count(Span<PooledPacket> packets)
+{
+    auto const* first_segment = coalescable_tcp_segment(packets[0].bytes());
+    if (!first_segment)
+        return 1;
+    auto& first_ipv4_packet = ipv4_packet_of(*first_segment);
+    size_t header_size = first_segment->header_size();
+
+    auto const* previous_segment = first_segment;
+    size_t total_size = first_ipv4_packet.payload_size();
+    size_t count = 1;
+    for (; count < packets.size(); ++count) {
+        if (previous_segment->has_psh())
             break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, packet_timestamp);
+        auto const* segment = coalescable_tcp_segment(packets[count].bytes());
+        if (!segment)
             break;
-        case EtherType::IPv6:
-            // ignore
+        auto& ipv4_packet = ipv4_packet_of(*segment);
+        size_t payload_size = ipv4_packet.payload_size() - header_size;
+        if (total_size + payload_size > max_coalesced_tcp_segment_size)
             break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+        if (ipv4_packet.source() != first_ipv4_packet.source() || ipv4_packet.destination() != first_ipv4_packet.destination())
+            break;
+        if (segment->source_port() != first_segment->source_port() || segment->destination_port() != first_segment->destination_port())
+            break;
+        if (segment->header_size() != header_size || segment->ack_number() != first_segment->ack_number() || segment->window_size() != first_segment->window_size())
+            break;
+        auto previous_payload_size = ipv4_packet_of(*previous_segment).payload_size() - header_size;
+        if (segment->sequence_number() != previous_segment->sequence_number() + previous_payload_size)
+            break;
+        if (memcmp(segment + 1, first_segment + 1, header_size - sizeof(TCPPacket)) != 0)
+            break;
+        total_size += payload_size;
+        previous_segment = segment;
+    }
+    return count;
+}
+
+void NetworkTask_worker_main(void* argument)
+{
+    auto& worker = *static_cast<NetworkWorker*>(argument);
+    Vector<PooledPacket> packets;
+    MUST(packets.try_ensure_capacity(NetworkWorker::max_queued_packets));
+
+    for (;;) {
+        worker.queued_packets.with([&](auto& queued_packets) {
+            swap(packets, queued_packets);
+        });
+
+        for (size_t i = 0; i < packets.size();) {
+            auto frames = packets.span().slice(i, coalescable_tcp_segment_count(packets.span().slice(i)));
+            handle_frames(frames);
+            i += frames.size();
+        }
+        bool was_idle = packets.is_empty();
+        // This hands back every packet buffer that wasn't kept by a socket.
+        packets.clear_with_capacity();
+
+        flush_delayed_tcp_acks(worker);
+
+        if (was_idle) {
+            auto timeout_time = Duration::from_milliseconds(500);
+            auto timeout = Thread::BlockTimeout { false, &timeout_time };
+            [[maybe_unused]] auto result = worker.wait_queue.wait_on(timeout, "NetworkWorker"sv);
         }
     }
 }
 
+void handle_frames(Span<PooledPacket> frames)
+{
+    auto frame = frames[0].bytes();
+    size_t packet_size = frame.size();
+    if (packet_size < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
+        return;
+    }
+    auto& eth = *(EthernetFrameHeader const*)frame.data();
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, packet_size);
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(eth, packet_size, frames);
+        break;
+    case EtherType::IPv6:
+        // ignore
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+    }
+}
+
 void handle_arp(EthernetFrameHeader const& eth, size_t frame_size)
 {
     constexpr size_t minimum_arp_frame_size = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -177,7 +390,7 @@ void handle_arp(EthernetFrameHeader const& eth, size_t frame_size)
     }
 }
 
-void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, UnixDateTime const& packet_timestamp)
+void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, Span<PooledPacket> frames)
 {
     constexpr size_t minimum_ipv4_frame_size = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet);
     if (frame_size < minimum_ipv4_frame_size) {
@@ -211,11 +424,11 @@ void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, UnixDateTime
 
     switch ((IPv4Protocol)packet.protocol()) {
     case IPv4Protocol::ICMP:
-        return handle_icmp(eth, packet, packet_timestamp);
+        return handle_icmp(eth, packet, frames[0].timestamp());
     case IPv4Protocol::UDP:
-        return handle_udp(packet, packet_timestamp);
+        return handle_udp(packet, frames[0]);
     case IPv4Protocol::TCP:
-        return handle_tcp(packet, packet_timestamp);
+        return handle_tcp(packet, frames);
     default:
         dbgln_if(IPV4_DEBUG, "handle_ipv4: Unhandled protocol {:#02x}", packet.protocol());
         break;
@@ -273,7 +486,7 @@ void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet,
     }
 }
 
-void handle_udp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timestamp)
+void handle_udp(IPv4Packet const& ipv4_packet, PooledPacket& packet)
 {
     if (ipv4_packet.payload_size() < sizeof(UDPPacket)) {
         dbgln("handle_udp: Packet too small ({}, need {})", ipv4_packet.payload_size(), sizeof(UDPPacket));
@@ -298,7 +511,7 @@ void handle_udp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
     auto& destination = ipv4_packet.destination();
 
     if (destination == IPv4Address(255, 255, 255, 255) || NetworkingManagement::the().from_ipv4_address(destination) || socket->multicast_memberships().contains_slow(destination))
-        socket->did_receive(ipv4_packet.source(), udp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+        socket->did_receive(ipv4_packet.source(), udp_packet.source_port(), move(packet), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() });
 }
 
 void send_delayed_tcp_ack(TCPSocket& socket)
@@ -309,13 +522,14 @@ void send_delayed_tcp_ack(TCPSocket& socket)
         return;
     }
 
-    delayed_ack_sockets->set(move(socket));
+    current_worker().delayed_ack_sockets.set(move(socket));
 }
 
-void flush_delayed_tcp_acks()
+void flush_delayed_tcp_acks(NetworkWorker& worker)
 {
+    auto& delayed_ack_sockets = worker.delayed_ack_sockets;
     Vector<NonnullRefPtr<TCPSocket>, 32> remaining_sockets;
-    for (auto& socket : *delayed_ack_sockets) {
+    for (auto& socket : delayed_ack_sockets) {
         MutexLocker locker(socket->mutex());
         if (socket->should_delay_next_ack()) {
             MUST(remaining_sockets.try_append(*socket));
@@ -324,12 +538,12 @@ void flush_delayed_tcp_acks()
         [[maybe_unused]] auto result = socket->send_ack();
     }
 
-    if (remaining_sockets.size() != delayed_ack_sockets->size()) {
-        delayed_ack_sockets->clear();
+    if (remaining_sockets.size() != delayed_ack_sockets.size()) {
+        delayed_ack_sockets.clear();
         if (remaining_sockets.size() > 0)
             dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
         for (auto&& socket : remaining_sockets)
-            delayed_ack_sockets->set(move(socket));
+            delayed_ack_sockets.set(move(socket));
     }
 }
 
@@ -367,7 +581,16 @@ void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, Re
     routing_decision.adapter->release_packet_buffer(*packet);
 }
 
-void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timestamp)
+static ReadonlyBytes tcp_payload_of(PooledPacket const& packet)
+{
+    auto& eth = *reinterpret_cast<EthernetFrameHeader const*>(packet.bytes().data());
+    auto& ipv4_packet = *static_cast<IPv4Packet const*>(eth.payload());
+    auto& tcp_packet = *static_cast<TCPPacket const*>(ipv4_packet.payload());
+    return { static_cast<u8 const*>(tcp_packet.payload()), ipv4_packet.payload_size() - tcp_packet.header_size() };
+}
+
+// All but the first of the segments have already been checked by coalescable_tcp_segment_count().
+void handle_tcp(IPv4Packet const& ipv4_packet, Span<PooledPacket> segments)
 {
     if (ipv4_packet.payload_size() < sizeof(TCPPacket)) {
         dbgln("handle_tcp: IPv4 payload is too small to be a TCP packet ({}, need {})", ipv4_packet.payload_size(), sizeof(TCPPacket));
@@ -388,6 +611,8 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
     }
 
     size_t payload_size = ipv4_packet.payload_size() - tcp_packet.header_size();
+    for (auto& segment : segments.slice(1))
+        payload_size += tcp_payload_of(segment).size();
 
     dbgln_if(TCP_DEBUG, "handle_tcp: source={}:{}, destination={}:{}, seq_no={}, ack_no={}, flags={:#04x} ({}{}{}{}), window_size={}, payload_size={}",
         ipv4_packet.source().to_string(),
@@ -403,6 +628,8 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         tcp_packet.has_rst() ? "RST " : "",
         tcp_packet.window_size(),
         payload_size);
+    if (segments.size() > 1)
+        dbgln_if(TCP_DEBUG, "handle_tcp: coalesced {} segments", segments.size());
 
     auto adapter = NetworkingManagement::the().from_ipv4_address(ipv4_packet.destination());
     if (!adapter) {
@@ -430,7 +657,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
 
     dbgln_if(TCP_DEBUG, "handle_tcp: got socket {}; state={}", socket->tuple().to_string(), TCPSocket::to_string(socket->state()));
 
-    socket->receive_tcp_packet(tcp_packet, ipv4_packet.payload_size());
+    socket->receive_tcp_packet(tcp_packet, tcp_packet.header_size() + payload_size);
 
     switch (socket->state()) {
     case TCPSocket::State::Closed:
@@ -458,6 +685,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            client->process_syn_options(tcp_packet);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
             return;
@@ -619,6 +847,18 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         }
 
         if (tcp_packet.sequence_number() != socket->ack_number()) {
+            // With SACK, the peer only has to retransmit what's actually missing, so we hold on to
+            // segments that arrive after a gap. Either way, a duplicate ACK tells the peer about it.
+            if (socket->sack_enabled() && !tcp_packet.has_fin()) {
+                dbgln_if(TCP_DEBUG, "Queueing out of order packet: seq {} vs. ack {}", tcp_packet.sequence_number(), socket->ack_number());
+                for (auto& segment : segments) {
+                    auto payload = tcp_payload_of(segment);
+                    auto& segment_header = *reinterpret_cast<TCPPacket const*>(payload.data() - tcp_packet.header_size());
+                    socket->queue_out_of_order_segment(segment_header, move(segment), payload);
+                }
+                [[maybe_unused]] auto result = socket->send_ack(true);
+                return;
+            }
             dbgln_if(TCP_DEBUG, "Discarding out of order packet: seq {} vs. ack {}", tcp_packet.sequence_number(), socket->ack_number());
             if (socket->duplicate_acks() < TCPSocket::maximum_duplicate_acks) {
                 dbgln_if(TCP_DEBUG, "Sending ACK with same ack number to trigger fast retransmission");
@@ -632,8 +872,9 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
 
         if (tcp_packet.has_fin()) {
             if (payload_size != 0)
-                socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+                socket->did_receive_stream_data(move(segments[0]), tcp_payload_of(segments[0]));
 
+            socket->discard_out_of_order_segments();
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
             send_delayed_tcp_ack(*socket);
             socket->set_state(TCPSocket::State::CloseWait);
@@ -642,11 +883,23 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         }
 
         if (payload_size) {
-            if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp)) {
-                socket->set_ack_number(tcp_packet.sequence_number() + payload_size);
+            // If the receive buffer fills up halfway through, we only acknowledge what made it in.
+            size_t delivered_size = 0;
+            for (auto& segment : segments) {
+                auto payload = tcp_payload_of(segment);
+                if (!socket->did_receive_stream_data(move(segment), payload))
+                    break;
+                delivered_size += payload.size();
+            }
+            if (delivered_size) {
+                socket->set_ack_number(tcp_packet.sequence_number() + delivered_size);
                 dbgln_if(TCP_DEBUG, "Got packet with ack_no={}, seq_no={}, payload_size={}, acking it with new ack_no={}, seq_no={}",
-                    tcp_packet.ack_number(), tcp_packet.sequence_number(), payload_size, socket->ack_number(), socket->sequence_number());
-                send_delayed_tcp_ack(*socket);
+                    tcp_packet.ack_number(), tcp_packet.sequence_number(), delivered_size, socket->ack_number(), socket->sequence_number());
+                // If this filled a gap, the peer is waiting to hear about it (RFC 5681, section 4.2).
+                if (socket->deliver_out_of_order_segments())
+                    (void)socket->send_ack();
+                else
+                    send_delayed_tcp_ack(*socket);
             }
         }
     }
@@ -180,7 +180,9 @@ namespace Kernel {
 #define PHYSTATUS_10M 0x04
 
 #define TX_BUFFER_SIZE 0x1FF8
-#define RX_BUFFER_SIZE 0x1FF8 // FIXME: this should be increased (0x3FFF)
+// The NIC receives straight into pooled packet buffers, which are a single page each.
+// FIXME: Support jumbo frames, which would need larger physically contiguous buffers (up to 0x3FFF).
+#define RX_BUFFER_SIZE 0xFF8
 
 UNMAP_AFTER_INIT ErrorOr<bool> RTL8168NetworkAdapter::probe(PCI::DeviceIdentifier const& pci_device_identifier)
 {
@@ -346,14 +348,14 @@ UNMAP_AFTER_INIT ErrorOr<void> RTL8168NetworkAdapter::initialize(Badge<Networkin
         TODO();
     }
 
-    startup();
+    TRY(startup());
     return {};
 }
 
-void RTL8168NetworkAdapter::startup()
+ErrorOr<void> RTL8168NetworkAdapter::startup()
 {
     // initialize descriptors
-    initialize_rx_descriptors();
+    TRY(initialize_rx_descriptors());
     initialize_tx_descriptors();
 
     // register irq
@@ -1092,22 +1094,30 @@ void RTL8168NetworkAdapter::set_phy_speed()
     phy_out(PHY_REG_BMCR, BMCR_AUTO_NEGOTIATE | BMCR_RESTART_AUTO_NEGOTIATE);
 }
 
-UNMAP_AFTER_INIT void RTL8168NetworkAdapter::initialize_rx_descriptors()
+void RTL8168NetworkAdapter::set_rx_descriptor_buffer(RXDescriptor& descriptor, PacketWithTimestamp const& packet)
 {
+    auto physical_address = packet.buffer->region().physical_page(0)->paddr().get();
+    descriptor.buffer_address_low = physical_address & 0xFFFFFFFF;
+    descriptor.buffer_address_high = (u64)physical_address >> 32; // cast to prevent shift count >= with of type warnings in 32 bit systems
+}
+
+UNMAP_AFTER_INIT ErrorOr<void> RTL8168NetworkAdapter::initialize_rx_descriptors()
+{
+    static_assert(RX_BUFFER_SIZE <= receive_buffer_size);
     auto* rx_descriptors = (RXDescriptor*)m_rx_descriptors_region->vaddr().as_ptr();
     for (size_t i = 0; i < number_of_rx_descriptors; ++i) {
         auto& descriptor = rx_descriptors[i];
-        auto region = MM.allocate_contiguous_kernel_region(Memory::page_round_up(RX_BUFFER_SIZE).release_value_but_fixme_should_propagate_errors(), "RTL8168 RX buffer"sv, Memory::Region::Access::ReadWrite).release_value();
-        memset(region->vaddr().as_ptr(), 0, region->size()); // MM already zeros out newly allocated pages, but we do it again in case that ever changes
-        m_rx_buffers_regions.append(move(region));
+        auto packet = acquire_receive_buffer();
+        if (!packet)
+            return ENOMEM;
+        TRY(m_rx_packets.try_append(packet.release_nonnull()));
 
         descriptor.buffer_size = RX_BUFFER_SIZE;
         descriptor.flags = RXDescriptor::Ownership; // let the NIC know it can use this descriptor
-        auto physical_address = m_rx_buffers_regions[i]->physical_page(0)->paddr().get();
-        descriptor.buffer_address_low = physical_address & 0xFFFFFFFF;
-        descriptor.buffer_address_high = (u64)physical_address >> 32; // cast to prevent shift count >= with of type warnings in 32 bit systems
+        set_rx_descriptor_buffer(descriptor, m_rx_packets[i]);
     }
     rx_descriptors[number_of_rx_descriptors - 1].flags = rx_descriptors[number_of_rx_descriptors - 1].flags | RXDescriptor::EndOfRing;
+    return {};
 }
 
 UNMAP_AFTER_INIT void RTL8168NetworkAdapter::initialize_tx_descriptors()
@@ -1226,6 +1236,7 @@ void RTL8168NetworkAdapter::send_raw(ReadonlyBytes payload)
 void RTL8168NetworkAdapter::receive()
 {
     auto* rx_descriptors = (RXDescriptor*)m_rx_descriptors_region->vaddr().as_ptr();
+    bool received_any = false;
     for (u16 i = 0; i < number_of_rx_descriptors; ++i) {
         auto descriptor_index = (m_rx_free_index + i) % number_of_rx_descriptors;
         auto& descriptor = rx_descriptors[descriptor_index];
@@ -1247,7 +1258,15 @@ void RTL8168NetworkAdapter::receive()
             // Our maximum received packet size is smaller than the descriptor buffer size, so packets should never be segmented
             // if this happens on a real NIC it might not respect that, and we will have to support packet segmentation
         } else {
-            did_receive({ m_rx_buffers_regions[descriptor_index]->vaddr().as_ptr(), length });
+            // The packet is passed on as it is, and the descriptor gets a fresh buffer instead.
+            // If we can't get one, we drop the packet and let the NIC reuse the old buffer.
+            if (auto fresh_packet = acquire_receive_buffer()) {
+                auto packet = move(m_rx_packets[descriptor_index]);
+                packet->buffer->set_size(length);
+                m_rx_packets[descriptor_index] = fresh_packet.release_nonnull();
+                set_rx_descriptor_buffer(descriptor, m_rx_packets[descriptor_index]);
+                received_any |= queue_received_packet(move(packet));
+            }
         }
 
         descriptor.buffer_size = RX_BUFFER_SIZE;
@@ -1256,6 +1275,8 @@ void RTL8168NetworkAdapter::receive()
             flags |= RXDescriptor::EndOfRing;
         descriptor.flags = flags; // let the NIC know it can use this descriptor again
     }
+    if (received_any)
+        did_receive_batch();
 }
 
 void RTL8168NetworkAdapter::out8(u16 address, u8 data)
@@ -131,7 +131,7 @@ private:
     void read_mac_address();
     void set_phy_speed();
     void start_hardware();
-    void startup();
+    ErrorOr<void> startup();
 
     void configure_phy();
     void configure_phy_b_1();
@@ -148,7 +148,8 @@ private:
     void hardware_quirks_e_2();
     void hardware_quirks_h();
 
-    void initialize_rx_descriptors();
+    ErrorOr<void> initialize_rx_descriptors();
+    static void set_rx_descriptor_buffer(RXDescriptor&, PacketWithTimestamp const&);
     void initialize_tx_descriptors();
 
     void receive();
@@ -204,7 +205,7 @@ private:
     NonnullOwnPtr<IOWindow> m_registers_io_window;
     u32 m_ocp_base_address { 0 };
     OwnPtr<Memory::Region> m_rx_descriptors_region;
-    Vector<NonnullOwnPtr<Memory::Region>> m_rx_buffers_regions;
+    Vector<NonnullRefPtr<PacketWithTimestamp>> m_rx_packets;
     u16 m_rx_free_index { 0 };
     OwnPtr<Memory::Region> m_tx_descriptors_region;
     Vector<NonnullOwnPtr<Memory::Region>> m_tx_buffers_regions;
@@ -46,7 +46,7 @@ void Socket::set_setup_state(SetupState new_setup_state)
     evaluate_block_conditions();
 }
 
-RefPtr<Socket> Socket::accept()
+RefPtr<Socket> Socket::accept(Process const& acceptor)
 {
     MutexLocker locker(mutex());
     if (m_pending.is_empty())
@@ -54,8 +54,7 @@ RefPtr<Socket> Socket::accept()
     dbgln_if(SOCKET_DEBUG, "Socket({}) de-queueing connection", this);
     auto client = m_pending.take_first();
     VERIFY(!client->is_connected());
-    auto& process = Process::current();
-    client->set_acceptor(process);
+    client->set_acceptor(acceptor);
     client->m_connected = true;
     client->set_role(Role::Accepted);
     if (!m_pending.is_empty())
@@ -256,6 +255,50 @@ ErrorOr<size_t> Socket::write(OpenFileDescription& description, u64, UserOrKerne
     return sendto(description, data, size, 0, {}, 0);
 }
 
+ErrorOr<size_t> Socket::sendto_vectored(OpenFileDescription& description, UserOrKernelBufferVector const& data, int flags, Userspace<sockaddr const*> addr, socklen_t addr_length)
+{
+    size_t total_sent = 0;
+    for (auto& segment : data.segments()) {
+        if (segment.size == 0)
+            continue;
+        if (total_sent > 0 && !description.can_write())
+            break;
+        auto sent_or_error = sendto(description, segment.buffer, segment.size, flags, addr, addr_length);
+        if (sent_or_error.is_error()) {
+            if (total_sent > 0)
+                break;
+            return sent_or_error.release_error();
+        }
+        total_sent += sent_or_error.value();
+        if (sent_or_error.value() < segment.size)
+            break;
+    }
+    return total_sent;
+}
+
+ErrorOr<size_t> Socket::recvfrom_vectored(OpenFileDescription& description, UserOrKernelBufferVector& data, int flags, Userspace<sockaddr*> addr, Userspace<socklen_t*> addr_length, UnixDateTime& timestamp, bool blocking)
+{
+    size_t total_received = 0;
+    for (auto& segment : data.segments()) {
+        if (segment.size == 0)
+            continue;
+        // Only wait for the first bit of data, whatever arrived by then is all the caller gets.
+        if (total_received > 0 && !description.can_read())
+            break;
+        auto buffer = segment.buffer;
+        auto received_or_error = recvfrom(description, buffer, segment.size, flags, addr, addr_length, timestamp, total_received == 0 && blocking);
+        if (received_or_error.is_error()) {
+            if (total_received > 0)
+                break;
+            return received_or_error.release_error();
+        }
+        total_received += received_or_error.value();
+        if (received_or_error.value() < segment.size)
+            break;
+    }
+    return total_received;
+}
+
 ErrorOr<void> Socket::shutdown(int how)
 {
     MutexLocker locker(mutex());
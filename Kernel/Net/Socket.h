@@ -10,6 +10,7 @@
 #include <AK/RefPtr.h>
 #include <AK/Time.h>
 #include <Kernel/FileSystem/File.h>
+#include <Kernel/Library/UserOrKernelBufferVector.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/UnixTypes.h>
@@ -67,12 +68,12 @@ public:
     void set_connected(bool);
 
     bool can_accept() const { return !m_pending.is_empty(); }
-    RefPtr<Socket> accept();
+    RefPtr<Socket> accept(Process const& acceptor);
 
     ErrorOr<void> shutdown(int how);
 
     virtual ErrorOr<void> bind(Credentials const&, Userspace<sockaddr const*>, socklen_t) = 0;
-    virtual ErrorOr<void> connect(Credentials const&, OpenFileDescription&, Userspace<sockaddr const*>, socklen_t) = 0;
+    virtual ErrorOr<void> connect(Credentials const&, OpenFileDescription&, Userspace<sockaddr const*>, socklen_t, bool blocking) = 0;
     virtual ErrorOr<void> listen(size_t) = 0;
     virtual void get_local_address(sockaddr*, socklen_t*) = 0;
     virtual void get_peer_address(sockaddr*, socklen_t*) = 0;
@@ -81,6 +82,12 @@ public:
     virtual ErrorOr<size_t> sendto(OpenFileDescription&, UserOrKernelBuffer const&, size_t, int flags, Userspace<sockaddr const*>, socklen_t) = 0;
     virtual ErrorOr<size_t> recvfrom(OpenFileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, UnixDateTime&, bool blocking) = 0;
 
+    // Scatter-gather versions of sendto() and recvfrom(). By default, every buffer is transferred in
+    // turn, which is fine for streams. Sockets that deal in datagrams have to override these, as the
+    // buffers together hold a single datagram.
+    virtual ErrorOr<size_t> sendto_vectored(OpenFileDescription&, UserOrKernelBufferVector const&, int flags, Userspace<sockaddr const*>, socklen_t);
+    virtual ErrorOr<size_t> recvfrom_vectored(OpenFileDescription&, UserOrKernelBufferVector&, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, UnixDateTime&, bool blocking);
+
     virtual ErrorOr<void> setsockopt(int level, int option, Userspace<void const*>, socklen_t);
     virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>);
 
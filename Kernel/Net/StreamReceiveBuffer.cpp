@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/StreamReceiveBuffer.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullOwnPtr<StreamReceiveBuffer>> StreamReceiveBuffer::try_create(size_t capacity)
+{
+    return adopt_nonnull_own_or_enomem(new (nothrow) StreamReceiveBuffer(capacity));
+}
+
+size_t StreamReceiveBuffer::space_for_writing() const
+{
+    if (m_segments.size() >= max_segments)
+        return 0;
+    return m_capacity - m_size;
+}
+
+ErrorOr<void> StreamReceiveBuffer::append(PooledPacket packet, ReadonlyBytes data)
+{
+    VERIFY(data.data() >= packet.bytes().data() && data.data() + data.size() <= packet.bytes().data() + packet.bytes().size());
+    if (data.is_empty())
+        return {};
+    if (data.size() > space_for_writing())
+        return ENOBUFS;
+    TRY(m_segments.try_append({ move(packet), data }));
+    m_size += data.size();
+    return {};
+}
+
+ErrorOr<size_t> StreamReceiveBuffer::read(UserOrKernelBuffer& buffer, size_t size)
+{
+    size_t nread = 0;
+    while (nread < size && !m_segments.is_empty()) {
+        auto& segment = m_segments.first();
+        size_t chunk_size = min(size - nread, segment.data.size());
+        TRY(buffer.write(segment.data.data(), nread, chunk_size));
+        nread += chunk_size;
+        m_size -= chunk_size;
+        if (chunk_size == segment.data.size())
+            (void)m_segments.take_first();
+        else
+            segment.data = segment.data.slice(chunk_size);
+    }
+    return nread;
+}
+
+ErrorOr<size_t> StreamReceiveBuffer::peek(UserOrKernelBuffer& buffer, size_t size) const
+{
+    size_t nread = 0;
+    for (auto& segment : m_segments) {
+        if (nread == size)
+            break;
+        size_t chunk_size = min(size - nread, segment.data.size());
+        TRY(buffer.write(segment.data.data(), nread, chunk_size));
+        nread += chunk_size;
+    }
+    return nread;
+}
+
+void StreamReceiveBuffer::clear()
+{
+    m_segments.clear();
+    m_size = 0;
+}
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/SinglyLinkedList.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+#include <Kernel/Net/NetworkAdapter.h>
+
+namespace Kernel {
+
+// The receive buffer of stream sockets. Instead of copying received data into a ring buffer,
+// it holds on to the packets that carried it, and the data is copied straight out of them once
+// it's read. It's protected by the mutex of the socket it belongs to.
+class StreamReceiveBuffer {
+    AK_MAKE_NONCOPYABLE(StreamReceiveBuffer);
+    AK_MAKE_NONMOVABLE(StreamReceiveBuffer);
+
+public:
+    static ErrorOr<NonnullOwnPtr<StreamReceiveBuffer>> try_create(size_t capacity);
+
+    // `data` has to point into the packet.
+    ErrorOr<void> append(PooledPacket, ReadonlyBytes data);
+
+    ErrorOr<size_t> read(UserOrKernelBuffer&, size_t);
+    ErrorOr<size_t> peek(UserOrKernelBuffer&, size_t) const;
+
+    bool is_empty() const { return m_size == 0; }
+    size_t immediately_readable() const { return m_size; }
+    size_t space_for_writing() const;
+    size_t segment_count() const { return m_segments.size(); }
+
+    void clear();
+
+private:
+    explicit StreamReceiveBuffer(size_t capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    // Every segment pins a whole packet buffer no matter how little data it holds,
+    // so we have to limit their number as well.
+    static constexpr size_t max_segments = 512;
+
+    struct Segment {
+        PooledPacket packet;
+        ReadonlyBytes data;
+    };
+
+    SinglyLinkedList<Segment, CountingSizeCalculationPolicy> m_segments;
+    size_t m_capacity { 0 };
+    size_t m_size { 0 };
+};
+
+}
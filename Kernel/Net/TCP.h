@@ -6,10 +6,18 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Optional.h>
 #include <Kernel/Net/IPv4.h>
 
 namespace Kernel {
 
+// Sequence numbers wrap around, so they have to be compared modulo 2^32 (RFC 9293, section 3.4).
+constexpr bool tcp_sequence_less_than(u32 a, u32 b) { return static_cast<i32>(a - b) < 0; }
+constexpr bool tcp_sequence_less_than_or_equal(u32 a, u32 b) { return static_cast<i32>(a - b) <= 0; }
+constexpr bool tcp_sequence_greater_than(u32 a, u32 b) { return static_cast<i32>(a - b) > 0; }
+constexpr bool tcp_sequence_greater_than_or_equal(u32 a, u32 b) { return static_cast<i32>(a - b) >= 0; }
+
 struct TCPFlags {
     enum : u16 {
         FIN = 0x01,
@@ -21,6 +29,18 @@ struct TCPFlags {
     };
 };
 
+struct TCPOptionKind {
+    enum : u8 {
+        End = 0,
+        NOP = 1,
+        MSS = 2,
+        WindowScale = 3,
+        SACKPermitted = 4,
+        SACK = 5,
+        Timestamp = 8,
+    };
+};
+
 class [[gnu::packed]] TCPOptionMSS {
 public:
     TCPOptionMSS(u16 value)
@@ -38,6 +58,72 @@ private:
 
 static_assert(AssertSize<TCPOptionMSS, 4>());
 
+// RFC 7323, section 2
+class [[gnu::packed]] TCPOptionWindowScale {
+public:
+    TCPOptionWindowScale(u8 shift_count)
+        : m_shift_count(shift_count)
+    {
+    }
+
+    u8 shift_count() const { return m_shift_count; }
+
+private:
+    u8 m_option_kind { TCPOptionKind::WindowScale };
+    u8 m_option_length { sizeof(TCPOptionWindowScale) };
+    u8 m_shift_count { 0 };
+};
+
+static_assert(AssertSize<TCPOptionWindowScale, 3>());
+
+// RFC 2018, section 2
+class [[gnu::packed]] TCPOptionSACKPermitted {
+private:
+    u8 m_option_kind { TCPOptionKind::SACKPermitted };
+    u8 m_option_length { sizeof(TCPOptionSACKPermitted) };
+};
+
+static_assert(AssertSize<TCPOptionSACKPermitted, 2>());
+
+// RFC 7323, section 3
+class [[gnu::packed]] TCPOptionTimestamp {
+public:
+    TCPOptionTimestamp(u32 value, u32 echo_reply)
+        : m_value(value)
+        , m_echo_reply(echo_reply)
+    {
+    }
+
+    u32 value() const { return m_value; }
+    u32 echo_reply() const { return m_echo_reply; }
+
+private:
+    u8 m_option_kind { TCPOptionKind::Timestamp };
+    u8 m_option_length { sizeof(TCPOptionTimestamp) };
+    NetworkOrdered<u32> m_value;
+    NetworkOrdered<u32> m_echo_reply;
+};
+
+static_assert(AssertSize<TCPOptionTimestamp, 10>());
+
+// A range of sequence numbers the receiver has got, beyond the one it acknowledges.
+struct TCPSACKBlock {
+    u32 left_edge { 0 };
+    u32 right_edge { 0 };
+};
+
+struct TCPOptions {
+    static constexpr size_t max_sack_blocks = 4;
+
+    Optional<u16> mss;
+    Optional<u8> window_scale;
+    bool sack_permitted { false };
+    Optional<u32> timestamp_value;
+    u32 timestamp_echo_reply { 0 };
+    Array<TCPSACKBlock, max_sack_blocks> sack_blocks {};
+    size_t sack_block_count { 0 };
+};
+
 class [[gnu::packed]] TCPPacket {
 public:
     TCPPacket() = default;
@@ -63,6 +149,7 @@ public:
     bool has_syn() const { return flags() & TCPFlags::SYN; }
     bool has_ack() const { return flags() & TCPFlags::ACK; }
     bool has_fin() const { return flags() & TCPFlags::FIN; }
+    bool has_psh() const { return flags() & TCPFlags::PSH; }
     bool has_rst() const { return flags() & TCPFlags::RST; }
 
     u8 data_offset() const { return (m_flags_and_data_offset & 0xf000) >> 12; }
@@ -80,6 +167,61 @@ public:
     void const* payload() const { return ((u8 const*)this) + header_size(); }
     void* payload() { return ((u8*)this) + header_size(); }
 
+    // NOTE: This must only be called after checking that the whole header is present.
+    TCPOptions options() const
+    {
+        TCPOptions options;
+        auto const* option_bytes = reinterpret_cast<u8 const*>(this) + sizeof(TCPPacket);
+        size_t options_size = header_size() - min(header_size(), sizeof(TCPPacket));
+        auto read_u32 = [&](size_t offset) {
+            return static_cast<u32>(option_bytes[offset]) << 24 | option_bytes[offset + 1] << 16 | option_bytes[offset + 2] << 8 | option_bytes[offset + 3];
+        };
+
+        for (size_t offset = 0; offset < options_size;) {
+            u8 kind = option_bytes[offset];
+            if (kind == TCPOptionKind::End)
+                break;
+            if (kind == TCPOptionKind::NOP) {
+                ++offset;
+                continue;
+            }
+            if (offset + 1 >= options_size)
+                break;
+            u8 length = option_bytes[offset + 1];
+            if (length < 2 || offset + length > options_size)
+                break;
+
+            switch (kind) {
+            case TCPOptionKind::MSS:
+                if (length == 4)
+                    options.mss = static_cast<u16>(option_bytes[offset + 2] << 8 | option_bytes[offset + 3]);
+                break;
+            case TCPOptionKind::WindowScale:
+                if (length == 3)
+                    options.window_scale = option_bytes[offset + 2];
+                break;
+            case TCPOptionKind::SACKPermitted:
+                if (length == 2)
+                    options.sack_permitted = true;
+                break;
+            case TCPOptionKind::SACK:
+                for (size_t block_offset = offset + 2; block_offset + 8 <= offset + length && options.sack_block_count < TCPOptions::max_sack_blocks; block_offset += 8)
+                    options.sack_blocks[options.sack_block_count++] = { read_u32(block_offset), read_u32(block_offset + 4) };
+                break;
+            case TCPOptionKind::Timestamp:
+                if (length == 10) {
+                    options.timestamp_value = read_u32(offset + 2);
+                    options.timestamp_echo_reply = read_u32(offset + 6);
+                }
+                break;
+            default:
+                break;
+            }
+            offset += length;
+        }
+        return options;
+    }
+
 private:
     NetworkOrdered<u16> m_source_port;
     NetworkOrdered<u16> m_destination_port;
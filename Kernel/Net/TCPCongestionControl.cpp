@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullOwnPtr<TCPCongestionControl>> TCPCongestionControl::try_create(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Algorithm::NewReno:
+        return adopt_nonnull_own_or_enomem<TCPCongestionControl>(new (nothrow) TCPNewReno);
+    case Algorithm::Cubic:
+        return adopt_nonnull_own_or_enomem<TCPCongestionControl>(new (nothrow) TCPCubic);
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<TCPCongestionControl::Algorithm> TCPCongestionControl::algorithm_from_name(StringView name)
+{
+    if (name == "reno"sv)
+        return Algorithm::NewReno;
+    if (name == "cubic"sv)
+        return Algorithm::Cubic;
+    return {};
+}
+
+void TCPCongestionControl::initialize(TCPCongestionState& state)
+{
+    state.congestion_window = min(4 * state.mss, max(2 * state.mss, 4380u));
+}
+
+void TCPCongestionControl::on_retransmit_timeout(TCPCongestionState& state, u32 bytes_in_flight, MonotonicTime)
+{
+    state.slow_start_threshold = max(bytes_in_flight / 2, 2 * state.mss);
+    state.congestion_window = state.mss;
+}
+
+void TCPCongestionControl::slow_start(TCPCongestionState& state, u32 bytes_acknowledged)
+{
+    state.congestion_window += min(bytes_acknowledged, state.mss);
+}
+
+void TCPNewReno::on_ack(TCPCongestionState& state, u32 bytes_acknowledged, MonotonicTime, Optional<Duration>)
+{
+    if (state.is_in_slow_start()) {
+        slow_start(state, bytes_acknowledged);
+        return;
+    }
+    // Congestion avoidance: grow by about one MSS per round trip.
+    u64 increase = static_cast<u64>(state.mss) * bytes_acknowledged / state.congestion_window;
+    state.congestion_window += max<u64>(1, increase);
+}
+
+void TCPNewReno::on_loss(TCPCongestionState& state, u32 bytes_in_flight, MonotonicTime)
+{
+    state.slow_start_threshold = max(bytes_in_flight / 2, 2 * state.mss);
+    state.congestion_window = state.slow_start_threshold;
+}
+
+// The kernel can't use floating point, so CUBIC's constants are applied as fractions:
+// beta = 0.7 is the multiplicative decrease, C = 0.4 scales the cubic growth function, and
+// alpha = 3 * (1 - beta) / (1 + beta) ~= 0.529 is the growth rate of the Reno-friendly estimate.
+static constexpr u64 cubic_beta_numerator = 7;
+static constexpr u64 cubic_beta_denominator = 10;
+static constexpr u64 cubic_alpha_per_mille = 529;
+
+static u64 integer_cube_root(u64 value)
+{
+    u64 low = 0;
+    u64 high = 2642245; // The largest number whose cube fits in 64 bits.
+    while (low < high) {
+        u64 middle = (low + high + 1) / 2;
+        if (middle * middle * middle <= value)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+void TCPCubic::on_ack(TCPCongestionState& state, u32 bytes_acknowledged, MonotonicTime now, Optional<Duration> smoothed_rtt)
+{
+    if (state.is_in_slow_start()) {
+        slow_start(state, bytes_acknowledged);
+        return;
+    }
+
+    u64 window = state.congestion_window;
+    u64 mss = state.mss;
+
+    if (!m_epoch_start.has_value()) {
+        m_epoch_start = now;
+        if (window < m_window_max) {
+            // K = cbrt((W_max - cwnd) / C), in seconds when the windows are counted in segments.
+            u64 deficit = min<u64>(m_window_max - window, 1 * GiB);
+            m_time_to_origin_point_ms = static_cast<i64>(integer_cube_root(deficit * 2'500'000'000 / mss));
+            m_origin_point = m_window_max;
+        } else {
+            m_time_to_origin_point_ms = 0;
+            m_origin_point = window;
+        }
+        m_window_estimate = window;
+    }
+
+    // W_cubic(t) = C * (t - K)^3 + W_max, evaluated one round trip ahead.
+    i64 rtt_ms = smoothed_rtt.has_value() ? smoothed_rtt->to_milliseconds() : 0;
+    i64 elapsed_ms = (now - m_epoch_start.value()).to_milliseconds() + rtt_ms;
+    i64 offset_ms = clamp<i64>(elapsed_ms - m_time_to_origin_point_ms, -(1 << 20), 1 << 20);
+    i64 cubic_offset = (offset_ms * offset_ms * offset_ms * 4 / 10) / 1000 * static_cast<i64>(mss) / 1'000'000;
+    u64 cubic_target = static_cast<u64>(max<i64>(static_cast<i64>(m_origin_point) + cubic_offset, static_cast<i64>(mss)));
+
+    // Standard TCP would have grown by about alpha segments per round trip since the last loss.
+    m_window_estimate += cubic_alpha_per_mille * mss * bytes_acknowledged / (1000 * window);
+
+    if (cubic_target < m_window_estimate) {
+        state.congestion_window = static_cast<u32>(min<u64>(m_window_estimate, NumericLimits<u32>::max()));
+        return;
+    }
+
+    u64 target = clamp(cubic_target, window, window + window / 2);
+    u64 increase = (target - window) * bytes_acknowledged / window;
+    if (increase == 0)
+        increase = max<u64>(1, mss * bytes_acknowledged / (100 * window));
+    state.congestion_window = static_cast<u32>(min<u64>(window + increase, NumericLimits<u32>::max()));
+}
+
+void TCPCubic::on_loss(TCPCongestionState& state, u32, MonotonicTime)
+{
+    u64 window = state.congestion_window;
+    m_epoch_start.clear();
+
+    // Fast convergence: if we lost before reaching the previous maximum, the available
+    // bandwidth has probably shrunk, so release some of it for other flows.
+    if (window < m_window_max)
+        m_window_max = window * (cubic_beta_denominator + cubic_beta_numerator) / (2 * cubic_beta_denominator);
+    else
+        m_window_max = window;
+
+    state.slow_start_threshold = max(static_cast<u32>(window * cubic_beta_numerator / cubic_beta_denominator), 2 * state.mss);
+    state.congestion_window = state.slow_start_threshold;
+}
+
+void TCPCubic::on_retransmit_timeout(TCPCongestionState& state, u32 bytes_in_flight, MonotonicTime now)
+{
+    on_loss(state, bytes_in_flight, now);
+    state.congestion_window = state.mss;
+}
+
+}
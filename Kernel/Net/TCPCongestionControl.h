@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// The part of a connection's state that congestion control algorithms work on. All sizes are in bytes.
+struct TCPCongestionState {
+    u32 mss { 536 };
+    u32 congestion_window { 0 };
+    u32 slow_start_threshold { NumericLimits<u32>::max() };
+
+    bool is_in_slow_start() const { return congestion_window < slow_start_threshold; }
+};
+
+// Decides how fast a TCP connection may send. TCPSocket takes care of detecting losses and
+// retransmitting; the algorithm only adjusts the congestion window in response.
+class TCPCongestionControl {
+public:
+    enum class Algorithm {
+        NewReno,
+        Cubic,
+    };
+
+    static constexpr Algorithm default_algorithm = Algorithm::Cubic;
+
+    static ErrorOr<NonnullOwnPtr<TCPCongestionControl>> try_create(Algorithm);
+    static Optional<Algorithm> algorithm_from_name(StringView);
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual StringView name() const = 0;
+    virtual Algorithm algorithm() const = 0;
+
+    // Sets up the initial window once the MSS of the connection is known (RFC 5681, section 3.1).
+    virtual void initialize(TCPCongestionState&);
+
+    // New data has been acknowledged outside of loss recovery.
+    virtual void on_ack(TCPCongestionState&, u32 bytes_acknowledged, MonotonicTime now, Optional<Duration> smoothed_rtt) = 0;
+
+    // A loss was detected through duplicate ACKs or SACK information, and fast recovery begins.
+    virtual void on_loss(TCPCongestionState&, u32 bytes_in_flight, MonotonicTime now) = 0;
+
+    // The retransmission timer expired; everything in flight is presumed lost.
+    virtual void on_retransmit_timeout(TCPCongestionState&, u32 bytes_in_flight, MonotonicTime now);
+
+protected:
+    TCPCongestionControl() = default;
+
+    static void slow_start(TCPCongestionState&, u32 bytes_acknowledged);
+};
+
+// RFC 5681 and RFC 6582
+class TCPNewReno final : public TCPCongestionControl {
+public:
+    virtual StringView name() const override { return "reno"sv; }
+    virtual Algorithm algorithm() const override { return Algorithm::NewReno; }
+
+    virtual void on_ack(TCPCongestionState&, u32 bytes_acknowledged, MonotonicTime now, Optional<Duration> smoothed_rtt) override;
+    virtual void on_loss(TCPCongestionState&, u32 bytes_in_flight, MonotonicTime now) override;
+};
+
+// RFC 9438
+class TCPCubic final : public TCPCongestionControl {
+public:
+    virtual StringView name() const override { return "cubic"sv; }
+    virtual Algorithm algorithm() const override { return Algorithm::Cubic; }
+
+    virtual void on_ack(TCPCongestionState&, u32 bytes_acknowledged, MonotonicTime now, Optional<Duration> smoothed_rtt) override;
+    virtual void on_loss(TCPCongestionState&, u32 bytes_in_flight, MonotonicTime now) override;
+    virtual void on_retransmit_timeout(TCPCongestionState&, u32 bytes_in_flight, MonotonicTime now) override;
+
+private:
+    // Window growth after a loss is measured from the start of the current congestion avoidance epoch.
+    Optional<MonotonicTime> m_epoch_start;
+    u64 m_window_max { 0 };
+    u64 m_origin_point { 0 };
+    i64 m_time_to_origin_point_ms { 0 };
+    u64 m_window_estimate { 0 };
+};
+
+}
@@ -6,6 +6,7 @@
 
 #include <AK/Singleton.h>
 #include <AK/Time.h>
+#include <Kernel/API/POSIX/netinet/tcp.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Devices/Generic/RandomDevice.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
@@ -19,6 +20,7 @@
 #include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
@@ -130,7 +132,7 @@ ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create_client(IPv4Address const
             return EEXIST;
 
         auto receive_buffer = TRY(try_create_receive_buffer());
-        auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer)));
+        auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer), m_congestion_control->algorithm()));
 
         client->set_setup_state(SetupState::InProgress);
         client->set_local_address(new_local_address);
@@ -162,10 +164,12 @@ void TCPSocket::release_for_accept(NonnullRefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer)
-    : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<StreamReceiveBuffer> receive_buffer, NonnullOwnPtr<TCPCongestionControl> congestion_control)
+    : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer))
+    , m_congestion_control(move(congestion_control))
 {
     m_last_retransmit_time = kgettimeofday();
+    m_congestion_control->initialize(m_congestion_state);
 }
 
 TCPSocket::~TCPSocket()
@@ -175,41 +179,82 @@ TCPSocket::~TCPSocket()
     dbgln_if(TCP_SOCKET_DEBUG, "~TCPSocket in state {}", to_string(state()));
 }
 
-ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
+ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<StreamReceiveBuffer> receive_buffer, TCPCongestionControl::Algorithm congestion_control_algorithm)
 {
-    // Note: Scratch buffer is only used for SOCK_STREAM sockets.
-    auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
-    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer)));
+    auto congestion_control = TRY(TCPCongestionControl::try_create(congestion_control_algorithm));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(congestion_control)));
 }
 
-ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
+ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBufferVector const& data)
 {
-    auto& ipv4_packet = *reinterpret_cast<IPv4Packet const*>(raw_ipv4_packet.data());
-    auto& tcp_packet = *static_cast<TCPPacket const*>(ipv4_packet.payload());
-    return raw_ipv4_packet.size() - sizeof(IPv4Packet) - tcp_packet.header_size();
+    auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
+    RoutingDecision routing_decision = route_to(peer_address(), local_address(), adapter);
+    if (routing_decision.is_zero())
+        return set_so_error(EHOSTUNREACH);
+    // Streams only ever get one buffer at a time, see Socket::sendto_vectored().
+    auto& segment = data.segments().first();
+    size_t data_length = min(segment.size, maximum_segment_size(*routing_decision.adapter));
+    TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &segment.buffer, data_length, &routing_decision));
+    return data_length;
 }
 
-ErrorOr<size_t> TCPSocket::protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, [[maybe_unused]] int flags)
+size_t TCPSocket::maximum_segment_size(NetworkAdapter const& adapter) const
 {
-    auto& ipv4_packet = *reinterpret_cast<IPv4Packet const*>(raw_ipv4_packet.data());
-    auto& tcp_packet = *static_cast<TCPPacket const*>(ipv4_packet.payload());
-    size_t payload_size = raw_ipv4_packet.size() - sizeof(IPv4Packet) - tcp_packet.header_size();
-    dbgln_if(TCP_SOCKET_DEBUG, "payload_size {}, will it fit in {}?", payload_size, buffer_size);
-    VERIFY(buffer_size >= payload_size);
-    SOCKET_TRY(buffer.write(tcp_packet.payload(), payload_size));
-    return payload_size;
+    size_t mss = adapter.mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    if (m_peer_mss.has_value())
+        mss = min<size_t>(mss, m_peer_mss.value());
+    // Once enabled, every segment carries a timestamp option, padded to a multiple of four bytes.
+    if (m_timestamps_enabled)
+        mss -= sizeof(TCPOptionTimestamp) + 2;
+    return mss;
 }
 
-ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t data_length)
+static u8 window_shift_for(size_t window_size)
 {
-    auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
-    RoutingDecision routing_decision = route_to(peer_address(), local_address(), adapter);
-    if (routing_decision.is_zero())
-        return set_so_error(EHOSTUNREACH);
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-    data_length = min(data_length, mss);
-    TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
-    return data_length;
+    u8 shift = 0;
+    while ((window_size >> shift) > NumericLimits<u16>::max())
+        ++shift;
+    return shift;
+}
+
+static u32 current_tcp_timestamp()
+{
+    return static_cast<u32>(TimeManagement::the().monotonic_time().milliseconds());
+}
+
+size_t TCPSocket::receive_buffer_space() const
+{
+    auto const* buffer = receive_buffer();
+    if (!buffer)
+        return 0;
+    size_t space = buffer->space_for_writing();
+    for (auto& segment : m_out_of_order_segments)
+        space -= min<size_t>(space, segment.payload_size);
+    return space;
+}
+
+u16 TCPSocket::advertised_window(bool is_syn)
+{
+    // The window in a SYN is never scaled (RFC 7323, section 2.2).
+    u8 shift = is_syn ? 0 : m_receive_window_shift;
+    size_t space = receive_buffer_space();
+    size_t window = min<size_t>(space, static_cast<size_t>(NumericLimits<u16>::max()) << shift);
+    m_last_advertised_window = window;
+    return static_cast<u16>(window >> shift);
+}
+
+u32 TCPSocket::send_window() const
+{
+    // Never let the window drop below one segment, so that a zero window from the peer is probed
+    // by the next write instead of stalling the connection until the peer speaks up.
+    return max(min(m_congestion_state.congestion_window, m_peer_window), m_congestion_state.mss);
+}
+
+u32 TCPSocket::bytes_in_flight() const
+{
+    return m_unacked_packets.with_shared([](auto& unacked_packets) -> u32 {
+        return unacked_packets.size;
+    });
 }
 
 ErrorOr<void> TCPSocket::send_ack(bool allow_duplicate)
@@ -228,8 +273,50 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
 
-    bool const has_mss_option = flags == TCPFlags::SYN;
-    const size_t options_size = has_mss_option ? sizeof(TCPOptionMSS) : 0;
+    bool const is_syn = flags & TCPFlags::SYN;
+    // We offer window scaling, SACK and timestamps in our SYN, but only use them if the peer's SYN did as well.
+    bool const is_offering_options = is_syn && !(flags & TCPFlags::ACK);
+
+    Array<u8, 40> options {};
+    size_t options_size = 0;
+    auto append_option = [&](auto const& option) {
+        memcpy(options.data() + options_size, &option, sizeof(option));
+        options_size += sizeof(option);
+    };
+    auto append_nops = [&](size_t count) {
+        for (size_t i = 0; i < count; ++i)
+            options[options_size++] = TCPOptionKind::NOP;
+    };
+
+    if (is_syn) {
+        u16 mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+        append_option(TCPOptionMSS { mss });
+        if (is_offering_options || m_window_scaling_enabled) {
+            append_nops(1);
+            append_option(TCPOptionWindowScale { m_receive_window_shift });
+        }
+        if (is_offering_options || m_sack_enabled) {
+            append_nops(2);
+            append_option(TCPOptionSACKPermitted {});
+        }
+    }
+    if (!(flags & TCPFlags::RST) && (is_offering_options || m_timestamps_enabled)) {
+        append_nops(2);
+        append_option(TCPOptionTimestamp { current_tcp_timestamp(), m_recent_timestamp });
+    }
+    if (m_sack_enabled && !is_syn && payload_size == 0 && !m_out_of_order_segments.is_empty()) {
+        auto sack_blocks = sack_blocks_to_send();
+        append_nops(2);
+        options[options_size++] = TCPOptionKind::SACK;
+        options[options_size++] = 2 + sack_blocks.size() * 2 * sizeof(u32);
+        for (auto& block : sack_blocks) {
+            NetworkOrdered<u32> edges[2] = { block.left_edge, block.right_edge };
+            memcpy(options.data() + options_size, edges, sizeof(edges));
+            options_size += sizeof(edges);
+        }
+    }
+    VERIFY(options_size % sizeof(u32) == 0);
+
     const size_t tcp_header_size = sizeof(TCPPacket) + options_size;
     const size_t buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
@@ -243,7 +330,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     VERIFY(local_port());
     tcp_packet.set_source_port(local_port());
     tcp_packet.set_destination_port(peer_port());
-    tcp_packet.set_window_size(NumericLimits<u16>::max());
+    tcp_packet.set_window_size(advertised_window(is_syn));
     tcp_packet.set_sequence_number(m_sequence_number);
     tcp_packet.set_data_offset(tcp_header_size / sizeof(u32));
     tcp_packet.set_flags(flags);
@@ -261,18 +348,15 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         tcp_packet.set_ack_number(m_ack_number);
     }
 
+    u32 first_sequence_number = m_sequence_number;
     if (flags & TCPFlags::SYN) {
         ++m_sequence_number;
     } else {
         m_sequence_number += payload_size;
     }
 
-    if (has_mss_option) {
-        u16 mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-        TCPOptionMSS mss_option { mss };
-        VERIFY(packet->buffer->size() >= ipv4_payload_offset + sizeof(TCPPacket) + sizeof(mss_option));
-        memcpy(packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket), &mss_option, sizeof(mss_option));
-    }
+    VERIFY(packet->buffer->size() >= ipv4_payload_offset + tcp_header_size);
+    memcpy(packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket), options.data(), options_size);
 
     tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
 
@@ -280,13 +364,22 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     if (expect_ack) {
         bool append_failed { false };
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
+            bool was_empty = unacked_packets.packets.is_empty();
+            auto now = kgettimeofday();
+            OutgoingPacket outgoing_packet { m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter };
+            outgoing_packet.sequence_number = first_sequence_number;
+            outgoing_packet.payload_size = payload_size;
+            outgoing_packet.sent_time = now;
+            auto result = unacked_packets.packets.try_append(move(outgoing_packet));
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
                 append_failed = true;
                 return;
             }
             unacked_packets.size += payload_size;
+            // The retransmission timer starts with the first packet that goes unacknowledged.
+            if (was_empty)
+                m_last_retransmit_time = now;
             enqueue_for_retransmit();
         });
         if (append_failed)
@@ -304,44 +397,251 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
 void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
-    if (packet.has_ack()) {
-        u32 ack_number = packet.ack_number();
+    auto options = packet.options();
+
+    if (packet.has_syn() && m_state == State::SynSent)
+        process_syn_options(packet);
+
+    // Remember the peer's latest timestamp, so that we can echo it back (RFC 7323, section 4.3).
+    if (m_timestamps_enabled && options.timestamp_value.has_value()) {
+        u32 timestamp = options.timestamp_value.value();
+        if (tcp_sequence_greater_than_or_equal(timestamp, m_recent_timestamp) && tcp_sequence_less_than_or_equal(packet.sequence_number(), m_ack_number))
+            m_recent_timestamp = timestamp;
+    }
 
-        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+    if (packet.has_ack())
+        process_ack(packet, options, size > packet.header_size());
 
+    m_packets_in++;
+    m_bytes_in += packet.header_size() + size;
+}
+
+void TCPSocket::process_syn_options(TCPPacket const& packet)
+{
+    auto options = packet.options();
+
+    m_peer_mss = options.mss;
+    m_window_scaling_enabled = options.window_scale.has_value();
+    if (m_window_scaling_enabled) {
+        m_send_window_shift = min(options.window_scale.value(), maximum_window_shift);
+        m_receive_window_shift = window_shift_for(receive_buffer_space());
+    } else {
+        m_send_window_shift = 0;
+        m_receive_window_shift = 0;
+    }
+    m_sack_enabled = options.sack_permitted;
+    m_timestamps_enabled = options.timestamp_value.has_value();
+    if (m_timestamps_enabled)
+        m_recent_timestamp = options.timestamp_value.value();
+    m_peer_window = packet.window_size();
+
+    // Now that we know how large the peer's segments may be, we can pick a proper initial window.
+    m_congestion_state.mss = m_peer_mss.value_or(536);
+    if (m_timestamps_enabled)
+        m_congestion_state.mss -= sizeof(TCPOptionTimestamp) + 2;
+    m_congestion_control->initialize(m_congestion_state);
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) negotiated mss={}, window_scale={}/{}, sack={}, timestamps={}",
+        this, m_congestion_state.mss, m_send_window_shift, m_receive_window_shift, m_sack_enabled, m_timestamps_enabled);
+}
+
+void TCPSocket::process_ack(TCPPacket const& packet, TCPOptions const& options, bool has_payload)
+{
+    u32 ack_number = packet.ack_number();
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+
+    u32 previous_peer_window = m_peer_window;
+    m_peer_window = static_cast<u32>(packet.window_size()) << (packet.has_syn() ? 0 : m_send_window_shift);
+
+    auto now = kgettimeofday();
+
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        u32 bytes_acknowledged = 0;
+        Optional<Duration> rtt_sample;
         int removed = 0;
-        m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            while (!unacked_packets.packets.is_empty()) {
-                auto& packet = unacked_packets.packets.first();
-
-                dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
-
-                if (packet.ack_number <= ack_number) {
-                    auto old_adapter = packet.adapter.strong_ref();
-                    if (old_adapter)
-                        old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
-                    unacked_packets.packets.take_first();
-                    removed++;
-                } else {
-                    break;
+        while (!unacked_packets.packets.is_empty()) {
+            auto& packet = unacked_packets.packets.first();
+
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
+
+            if (!tcp_sequence_less_than_or_equal(packet.ack_number, ack_number))
+                break;
+
+            // Karn's algorithm: we can't tell which transmission an ACK for a retransmitted packet belongs to.
+            if (packet.tx_counter == 0)
+                rtt_sample = now - packet.sent_time;
+
+            auto old_adapter = packet.adapter.strong_ref();
+            if (old_adapter)
+                old_adapter->release_packet_buffer(*packet.buffer);
+            unacked_packets.size -= packet.payload_size;
+            bytes_acknowledged += packet.payload_size;
+            unacked_packets.packets.take_first();
+            removed++;
+        }
+
+        if (removed > 0) {
+            evaluate_block_conditions();
+            m_duplicate_acks_received = 0;
+            m_retransmit_attempts = 0;
+            m_last_retransmit_time = now;
+            if (rtt_sample.has_value())
+                update_rtt(rtt_sample.value());
+        } else if (!unacked_packets.packets.is_empty() && !has_payload && !packet.has_syn() && !packet.has_fin() && m_peer_window == previous_peer_window) {
+            // RFC 5681, section 2
+            ++m_duplicate_acks_received;
+        }
+
+        u32 sacked_bytes = 0;
+        if (m_sack_enabled) {
+            for (size_t i = 0; i < options.sack_block_count; ++i) {
+                auto& block = options.sack_blocks[i];
+                for (auto& outgoing_packet : unacked_packets.packets) {
+                    if (outgoing_packet.payload_size == 0)
+                        continue;
+                    if (tcp_sequence_greater_than_or_equal(outgoing_packet.sequence_number, block.left_edge) && tcp_sequence_less_than_or_equal(outgoing_packet.ack_number, block.right_edge))
+                        outgoing_packet.is_sacked = true;
                 }
             }
+            for (auto& outgoing_packet : unacked_packets.packets) {
+                if (outgoing_packet.is_sacked)
+                    sacked_bytes += outgoing_packet.payload_size;
+            }
+        }
 
-            if (unacked_packets.packets.is_empty()) {
-                m_retransmit_attempts = 0;
-                dequeue_for_retransmit();
+        auto monotonic_now = TimeManagement::the().monotonic_time();
+        if (m_in_loss_recovery) {
+            if (tcp_sequence_greater_than_or_equal(ack_number, m_recovery_point)) {
+                m_in_loss_recovery = false;
+                m_recovering_from_timeout = false;
+            } else if (m_recovering_from_timeout && bytes_acknowledged > 0) {
+                // After a timeout, we slow start back up while retransmitting the rest of the window.
+                m_congestion_control->on_ack(m_congestion_state, bytes_acknowledged, monotonic_now, m_smoothed_rtt);
             }
+        } else if (bytes_acknowledged > 0) {
+            m_congestion_control->on_ack(m_congestion_state, bytes_acknowledged, monotonic_now, m_smoothed_rtt);
+        }
 
-            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
-        });
+        if (!m_in_loss_recovery && !unacked_packets.packets.is_empty()) {
+            if (m_duplicate_acks_received >= duplicate_ack_threshold || sacked_bytes >= duplicate_ack_threshold * m_congestion_state.mss)
+                enter_loss_recovery(unacked_packets, false);
+        }
+        if (m_in_loss_recovery) {
+            mark_lost_packets(unacked_packets);
+            retransmit_lost_packets(unacked_packets);
+        }
+
+        if (unacked_packets.packets.is_empty()) {
+            m_retransmit_attempts = 0;
+            dequeue_for_retransmit();
+        }
+
+        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+    });
+}
+
+void TCPSocket::update_rtt(Duration sample)
+{
+    // RFC 6298, section 2
+    i64 sample_us = sample.to_microseconds();
+    if (!m_smoothed_rtt.has_value()) {
+        m_smoothed_rtt = sample;
+        m_rtt_variance = Duration::from_microseconds(sample_us / 2);
+    } else {
+        i64 smoothed_rtt_us = m_smoothed_rtt->to_microseconds();
+        i64 deviation_us = smoothed_rtt_us > sample_us ? smoothed_rtt_us - sample_us : sample_us - smoothed_rtt_us;
+        m_rtt_variance = Duration::from_microseconds((3 * m_rtt_variance.to_microseconds() + deviation_us) / 4);
+        m_smoothed_rtt = Duration::from_microseconds((7 * smoothed_rtt_us + sample_us) / 8);
     }
 
-    m_packets_in++;
-    m_bytes_in += packet.header_size() + size;
+    // NOTE: RFC 6298 asks for a minimum of one second, but like most stacks we go lower, since
+    //       a whole second of silence after every lost packet on a LAN is excruciating.
+    auto timeout = m_smoothed_rtt.value() + Duration::from_microseconds(4 * m_rtt_variance.to_microseconds());
+    m_retransmission_timeout = clamp(timeout, minimum_retransmission_timeout, maximum_retransmission_timeout);
+}
+
+void TCPSocket::enter_loss_recovery(UnackedPackets& unacked_packets, bool after_timeout)
+{
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) entering loss recovery (timeout: {}), cwnd={}", this, after_timeout, m_congestion_state.congestion_window);
+
+    m_in_loss_recovery = true;
+    m_recovering_from_timeout = after_timeout;
+    m_recovery_point = m_sequence_number;
+    m_duplicate_acks_received = 0;
+
+    auto now = TimeManagement::the().monotonic_time();
+    if (after_timeout)
+        m_congestion_control->on_retransmit_timeout(m_congestion_state, unacked_packets.size, now);
+    else
+        m_congestion_control->on_loss(m_congestion_state, unacked_packets.size, now);
+
+    for (auto& packet : unacked_packets.packets) {
+        packet.was_retransmitted_in_recovery = false;
+        if (after_timeout) {
+            // The peer is allowed to drop data it has SACKed (RFC 2018, section 8), so after a
+            // timeout we can't rely on any of it anymore.
+            packet.is_sacked = false;
+            packet.is_lost = true;
+        }
+    }
+    if (!unacked_packets.packets.is_empty())
+        unacked_packets.packets.first().is_lost = true;
+}
+
+void TCPSocket::mark_lost_packets(UnackedPackets& unacked_packets)
+{
+    if (unacked_packets.packets.is_empty())
+        return;
+
+    // Without SACK, all we learn from an ACK is that the first unacknowledged packet is still missing (RFC 6582).
+    if (!m_sack_enabled) {
+        unacked_packets.packets.first().is_lost = true;
+        return;
+    }
+
+    // With it, a packet is lost once enough packets sent after it have arrived (RFC 6675, section 4).
+    size_t sacked_packets_after = 0;
+    for (auto& packet : unacked_packets.packets) {
+        if (packet.is_sacked)
+            ++sacked_packets_after;
+    }
+    for (auto& packet : unacked_packets.packets) {
+        if (packet.is_sacked) {
+            --sacked_packets_after;
+            continue;
+        }
+        if (sacked_packets_after >= duplicate_ack_threshold)
+            packet.is_lost = true;
+    }
+    unacked_packets.packets.first().is_lost = !unacked_packets.packets.first().is_sacked;
+}
+
+void TCPSocket::retransmit_lost_packets(UnackedPackets& unacked_packets)
+{
+    auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
+    auto routing_decision = route_to(peer_address(), local_address(), adapter);
+    if (routing_decision.is_zero())
+        return;
+
+    // Estimate how much data is still in the network (RFC 6675, section 4) and fill up the
+    // congestion window with retransmissions of the lost packets.
+    u32 pipe = 0;
+    for (auto& packet : unacked_packets.packets) {
+        if (packet.is_sacked || (packet.is_lost && !packet.was_retransmitted_in_recovery))
+            continue;
+        pipe += packet.payload_size;
+    }
+
+    for (auto& packet : unacked_packets.packets) {
+        if (!packet.is_lost || packet.is_sacked || packet.was_retransmitted_in_recovery)
+            continue;
+        if (pipe > 0 && pipe + packet.payload_size > m_congestion_state.congestion_window)
+            break;
+        retransmit_packet(packet, routing_decision);
+        packet.was_retransmitted_in_recovery = true;
+        pipe += packet.payload_size;
+    }
 }
 
 bool TCPSocket::should_delay_next_ack() const
@@ -440,7 +740,7 @@ ErrorOr<void> TCPSocket::protocol_listen(bool did_allocate_port)
     return {};
 }
 
-ErrorOr<void> TCPSocket::protocol_connect(OpenFileDescription& description)
+ErrorOr<void> TCPSocket::protocol_connect(OpenFileDescription& description, bool blocking)
 {
     MutexLocker locker(mutex());
 
@@ -455,6 +755,7 @@ ErrorOr<void> TCPSocket::protocol_connect(OpenFileDescription& description)
 
     m_sequence_number = get_good_random<u32>();
     m_ack_number = 0;
+    m_receive_window_shift = window_shift_for(receive_buffer_space());
 
     set_setup_state(SetupState::InProgress);
     TRY(send_tcp_packet(TCPFlags::SYN));
@@ -464,7 +765,7 @@ ErrorOr<void> TCPSocket::protocol_connect(OpenFileDescription& description)
 
     evaluate_block_conditions();
 
-    if (description.is_blocking()) {
+    if (blocking) {
         locker.unlock();
         auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
         if (Thread::current()->block<Thread::ConnectBlocker>({}, description, unblock_flags).was_interrupted())
@@ -580,13 +881,13 @@ void TCPSocket::retransmit_packets()
 {
     auto now = kgettimeofday();
 
-    // RFC6298 says we should have at least one second between retransmits. According to
-    // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
-    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+    // RFC 6298 says we must back off exponentially for every further retransmission of the same
+    // packet. According to RFC 1122, this applies to SYN packets as well.
+    auto retransmit_interval = m_retransmission_timeout;
+    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts && retransmit_interval < maximum_retransmission_timeout; i++)
+        retransmit_interval = retransmit_interval + retransmit_interval;
 
-    if (m_last_retransmit_time > now - Duration::from_seconds(retransmit_interval))
+    if (m_last_retransmit_time > now - retransmit_interval)
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
@@ -607,41 +908,54 @@ void TCPSocket::retransmit_packets()
         return;
 
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-        for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
+        if (unacked_packets.packets.is_empty())
+            return;
+
+        // Everything in flight is presumed lost, but only the first packet is sent right away.
+        // The rest follows as ACKs for it open the congestion window again.
+        enter_loss_recovery(unacked_packets, true);
+        auto& packet = unacked_packets.packets.first();
+        retransmit_packet(packet, routing_decision);
+        packet.was_retransmitted_in_recovery = true;
+    });
+}
 
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision const& routing_decision)
+{
+    packet.tx_counter++;
+    packet.sent_time = kgettimeofday();
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
 
-            auto packet_buffer = packet.buffer->bytes();
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
-        }
-    });
+    auto packet_buffer = packet.buffer->bytes();
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
+    m_retransmitted_packets++;
 }
 
 bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
@@ -656,7 +970,149 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
         return true;
 
     return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
+        return unacked_packets.size + size <= send_window();
     });
 }
+
+void TCPSocket::protocol_did_read_from_receive_buffer()
+{
+    if (m_state != State::Established && m_state != State::FinWait1 && m_state != State::FinWait2)
+        return;
+
+    // If we told the peer to (nearly) stop sending, let it know as soon as there is room again.
+    // To avoid the silly window syndrome, we wait for at least a full segment's worth of room.
+    size_t window = receive_buffer_space();
+    size_t mss = m_congestion_state.mss;
+    if (m_last_advertised_window < 4 * mss && window >= m_last_advertised_window + mss)
+        (void)send_tcp_packet(TCPFlags::ACK);
+}
+
+void TCPSocket::queue_out_of_order_segment(TCPPacket const& tcp_packet, PooledPacket packet, ReadonlyBytes payload)
+{
+    u32 sequence_number = tcp_packet.sequence_number();
+    size_t payload_size = payload.size();
+    if (payload_size == 0 || !tcp_sequence_greater_than(sequence_number, m_ack_number))
+        return;
+    if (m_out_of_order_segments.size() >= maximum_out_of_order_segments || payload_size > receive_buffer_space())
+        return;
+
+    size_t index = 0;
+    for (; index < m_out_of_order_segments.size(); ++index) {
+        auto& segment = m_out_of_order_segments[index];
+        if (segment.sequence_number == sequence_number)
+            return;
+        if (tcp_sequence_greater_than(segment.sequence_number, sequence_number))
+            break;
+    }
+
+    // The segment keeps its packet buffer until the gap before it is filled.
+    if (m_out_of_order_segments.try_insert(index, { sequence_number, static_cast<u32>(payload_size), move(packet), payload }).is_error())
+        return;
+    m_last_out_of_order_sequence_number = sequence_number;
+}
+
+bool TCPSocket::deliver_out_of_order_segments()
+{
+    bool did_deliver = false;
+    while (!m_out_of_order_segments.is_empty()) {
+        auto& segment = m_out_of_order_segments.first();
+        if (tcp_sequence_greater_than(segment.sequence_number, m_ack_number))
+            break;
+        auto taken_segment = m_out_of_order_segments.take_first();
+        // Segments that overlap data we already have are dropped, the peer will retransmit what's missing.
+        if (taken_segment.sequence_number != m_ack_number)
+            continue;
+        if (!did_receive_stream_data(move(taken_segment.packet), taken_segment.payload))
+            break;
+        m_ack_number += taken_segment.payload_size;
+        did_deliver = true;
+    }
+    return did_deliver;
+}
+
+Vector<TCPSACKBlock, 3> TCPSocket::sack_blocks_to_send() const
+{
+    auto for_each_block = [&](auto callback) {
+        Optional<TCPSACKBlock> current_block;
+        for (auto& segment : m_out_of_order_segments) {
+            u32 right_edge = segment.sequence_number + segment.payload_size;
+            if (current_block.has_value() && tcp_sequence_greater_than_or_equal(current_block->right_edge, segment.sequence_number)) {
+                if (tcp_sequence_greater_than(right_edge, current_block->right_edge))
+                    current_block->right_edge = right_edge;
+                continue;
+            }
+            if (current_block.has_value())
+                callback(current_block.value());
+            current_block = TCPSACKBlock { segment.sequence_number, right_edge };
+        }
+        if (current_block.has_value())
+            callback(current_block.value());
+    };
+    auto contains_latest_segment = [&](TCPSACKBlock const& block) {
+        return tcp_sequence_greater_than_or_equal(m_last_out_of_order_sequence_number, block.left_edge)
+            && tcp_sequence_less_than(m_last_out_of_order_sequence_number, block.right_edge);
+    };
+
+    // The first block has to report the most recently received segment (RFC 2018, section 4).
+    Vector<TCPSACKBlock, 3> blocks;
+    for_each_block([&](auto const& block) {
+        if (contains_latest_segment(block))
+            blocks.append(block);
+    });
+    for_each_block([&](auto const& block) {
+        if (blocks.size() < 3 && !contains_latest_segment(block))
+            blocks.append(block);
+    });
+    return blocks;
+}
+
+ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+{
+    if (level != IPPROTO_TCP)
+        return IPv4Socket::setsockopt(level, option, user_value, user_value_size);
+
+    MutexLocker locker(mutex());
+
+    switch (option) {
+    case TCP_CONGESTION: {
+        if (user_value_size == 0 || user_value_size > TCP_CA_NAME_MAX)
+            return EINVAL;
+        auto name = TRY(try_copy_kstring_from_user(static_ptr_cast<char const*>(user_value), user_value_size));
+        auto name_view = name->view();
+        if (auto terminator = name_view.find('\0'); terminator.has_value())
+            name_view = name_view.substring_view(0, terminator.value());
+        auto algorithm = TCPCongestionControl::algorithm_from_name(name_view);
+        if (!algorithm.has_value())
+            return ENOENT;
+        m_congestion_control = TRY(TCPCongestionControl::try_create(algorithm.value()));
+        return {};
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
+
+ErrorOr<void> TCPSocket::getsockopt(OpenFileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
+{
+    if (level != IPPROTO_TCP)
+        return IPv4Socket::getsockopt(description, level, option, value, value_size);
+
+    MutexLocker locker(mutex());
+
+    socklen_t size;
+    TRY(copy_from_user(&size, value_size.unsafe_userspace_ptr()));
+
+    switch (option) {
+    case TCP_CONGESTION: {
+        char name[TCP_CA_NAME_MAX] {};
+        auto name_view = m_congestion_control->name();
+        memcpy(name, name_view.characters_without_null_termination(), min(name_view.length(), sizeof(name) - 1));
+        size = min<socklen_t>(size, sizeof(name));
+        TRY(copy_to_user(value.unsafe_userspace_ptr(), name, size));
+        return copy_to_user(value_size, &size);
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
 }
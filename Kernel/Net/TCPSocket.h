@@ -13,6 +13,8 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 
 namespace Kernel {
 
@@ -20,7 +22,7 @@ class TCPSocket final : public IPv4Socket {
 public:
     static void for_each(Function<void(TCPSocket const&)>);
     static ErrorOr<void> try_for_each(Function<ErrorOr<void>(TCPSocket const&)>);
-    static ErrorOr<NonnullRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
+    static ErrorOr<NonnullRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<StreamReceiveBuffer> receive_buffer, TCPCongestionControl::Algorithm = TCPCongestionControl::default_algorithm);
     virtual ~TCPSocket() override;
 
     virtual bool unref() const override;
@@ -133,6 +135,21 @@ public:
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
+    u32 retransmitted_packets() const { return m_retransmitted_packets; }
+
+    StringView congestion_control_name() const { return m_congestion_control->name(); }
+    u32 congestion_window() const { return m_congestion_state.congestion_window; }
+    u32 slow_start_threshold() const { return m_congestion_state.slow_start_threshold; }
+    u32 peer_window() const { return m_peer_window; }
+    u32 bytes_in_flight() const;
+    Optional<Duration> smoothed_rtt() const { return m_smoothed_rtt; }
+    Duration rtt_variance() const { return m_rtt_variance; }
+    Duration retransmission_timeout() const { return m_retransmission_timeout; }
+    u8 send_window_shift() const { return m_send_window_shift; }
+    u8 receive_window_shift() const { return m_receive_window_shift; }
+    bool window_scaling_enabled() const { return m_window_scaling_enabled; }
+    bool sack_enabled() const { return m_sack_enabled; }
+    bool timestamps_enabled() const { return m_timestamps_enabled; }
 
     // FIXME: Make this configurable?
     static constexpr u32 maximum_duplicate_acks = 5;
@@ -143,6 +160,14 @@ public:
     ErrorOr<void> send_tcp_packet(u16 flags, UserOrKernelBuffer const* = nullptr, size_t = 0, RoutingDecision* = nullptr);
     void receive_tcp_packet(TCPPacket const&, u16 size);
 
+    // Picks up the options the peer offered in its SYN, and which we will use for the rest of the connection.
+    void process_syn_options(TCPPacket const&);
+
+    // Segments that arrive ahead of a gap are kept until the data before them shows up.
+    void queue_out_of_order_segment(TCPPacket const&, PooledPacket, ReadonlyBytes payload);
+    bool deliver_out_of_order_segments();
+    void discard_out_of_order_segments() { m_out_of_order_segments.clear(); }
+
     bool should_delay_next_ack() const;
 
     static MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& sockets_by_tuple();
@@ -162,29 +187,47 @@ public:
 
     virtual bool can_write(OpenFileDescription const&, u64) const override;
 
+    virtual ErrorOr<void> setsockopt(int level, int option, Userspace<void const*>, socklen_t) override;
+    virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
+
     static NetworkOrdered<u16> compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const&, u16 payload_size);
 
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<StreamReceiveBuffer> receive_buffer, NonnullOwnPtr<TCPCongestionControl>);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
 
-    virtual ErrorOr<size_t> protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, int flags) override;
-    virtual ErrorOr<size_t> protocol_send(UserOrKernelBuffer const&, size_t) override;
-    virtual ErrorOr<void> protocol_connect(OpenFileDescription&) override;
+    virtual ErrorOr<size_t> protocol_send(UserOrKernelBufferVector const&) override;
+    virtual ErrorOr<void> protocol_connect(OpenFileDescription&, bool blocking) override;
     virtual ErrorOr<u16> protocol_allocate_local_port() override;
-    virtual ErrorOr<size_t> protocol_size(ReadonlyBytes raw_ipv4_packet) override;
     virtual bool protocol_is_disconnected() const override;
     virtual ErrorOr<void> protocol_bind() override;
     virtual ErrorOr<void> protocol_listen(bool did_allocate_port) override;
+    virtual void protocol_did_read_from_receive_buffer() override;
 
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    struct OutgoingPacket;
+    struct UnackedPackets;
+
+    void process_ack(TCPPacket const&, TCPOptions const&, bool has_payload);
+    void update_rtt(Duration sample);
+    void enter_loss_recovery(UnackedPackets&, bool after_timeout);
+    void mark_lost_packets(UnackedPackets&);
+    void retransmit_lost_packets(UnackedPackets&);
+    void retransmit_packet(OutgoingPacket&, RoutingDecision const&);
+
+    size_t maximum_segment_size(NetworkAdapter const&) const;
+    u32 send_window() const;
+    u16 advertised_window(bool is_syn);
+    size_t receive_buffer_space() const;
+    Vector<TCPSACKBlock, 3> sack_blocks_to_send() const;
+
     LockWeakPtr<TCPSocket> m_originator;
     HashMap<IPv4SocketTuple, NonnullRefPtr<TCPSocket>> m_pending_release_for_accept;
     Direction m_direction { Direction::Unspecified };
@@ -204,6 +247,14 @@ private:
         size_t ipv4_payload_offset;
         LockWeakPtr<NetworkAdapter> adapter;
         int tx_counter { 0 };
+        u32 sequence_number { 0 };
+        u32 payload_size { 0 };
+        UnixDateTime sent_time {};
+
+        // Loss recovery scoreboard (RFC 6675).
+        bool is_sacked { false };
+        bool is_lost { false };
+        bool was_retransmitted_in_recovery { false };
     };
 
     struct UnackedPackets {
@@ -223,8 +274,46 @@ private:
     UnixDateTime m_last_retransmit_time;
     u32 m_retransmit_attempts { 0 };
 
-    // FIXME: Parse window size TCP option from the peer
-    u32 m_send_window_size { 64 * KiB };
+    u32 m_retransmitted_packets { 0 };
+
+    // RFC 6298
+    static constexpr Duration minimum_retransmission_timeout = Duration::from_milliseconds(200);
+    static constexpr Duration maximum_retransmission_timeout = Duration::from_seconds(60);
+    Optional<Duration> m_smoothed_rtt;
+    Duration m_rtt_variance;
+    Duration m_retransmission_timeout { Duration::from_seconds(1) };
+
+    // Options negotiated during the handshake.
+    static constexpr u8 maximum_window_shift = 14;
+    Optional<u16> m_peer_mss;
+    bool m_window_scaling_enabled { false };
+    u8 m_send_window_shift { 0 };
+    u8 m_receive_window_shift { 0 };
+    bool m_sack_enabled { false };
+    bool m_timestamps_enabled { false };
+    u32 m_recent_timestamp { 0 };
+
+    // The window from the peer's latest ACK, already scaled.
+    u32 m_peer_window { 64 * KiB };
+    u32 m_last_advertised_window { 0 };
+
+    NonnullOwnPtr<TCPCongestionControl> m_congestion_control;
+    TCPCongestionState m_congestion_state;
+    static constexpr u32 duplicate_ack_threshold = 3;
+    u32 m_duplicate_acks_received { 0 };
+    bool m_in_loss_recovery { false };
+    bool m_recovering_from_timeout { false };
+    u32 m_recovery_point { 0 };
+
+    struct OutOfOrderSegment {
+        u32 sequence_number { 0 };
+        u32 payload_size { 0 };
+        PooledPacket packet;
+        ReadonlyBytes payload;
+    };
+    static constexpr size_t maximum_out_of_order_segments = 256;
+    Vector<OutOfOrderSegment> m_out_of_order_segments;
+    u32 m_last_out_of_order_sequence_number { 0 };
 
     IntrusiveListNode<TCPSocket> m_retransmit_list_node;
 
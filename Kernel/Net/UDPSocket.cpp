@@ -48,8 +48,8 @@ RefPtr<UDPSocket> UDPSocket::from_port(u16 port)
     });
 }
 
-UDPSocket::UDPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
-    : IPv4Socket(SOCK_DGRAM, protocol, move(receive_buffer), {})
+UDPSocket::UDPSocket(int protocol)
+    : IPv4Socket(SOCK_DGRAM, protocol, {})
 {
 }
 
@@ -60,9 +60,9 @@ UDPSocket::~UDPSocket()
     });
 }
 
-ErrorOr<NonnullRefPtr<UDPSocket>> UDPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
+ErrorOr<NonnullRefPtr<UDPSocket>> UDPSocket::try_create(int protocol)
 {
-    return adopt_nonnull_ref_or_enomem(new (nothrow) UDPSocket(protocol, move(receive_buffer)));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) UDPSocket(protocol));
 }
 
 ErrorOr<size_t> UDPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -72,24 +72,24 @@ ErrorOr<size_t> UDPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
     return udp_packet.length() - sizeof(UDPPacket);
 }
 
-ErrorOr<size_t> UDPSocket::protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, [[maybe_unused]] int flags)
+ErrorOr<size_t> UDPSocket::protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBufferVector& buffer, [[maybe_unused]] int flags)
 {
     auto& ipv4_packet = *(IPv4Packet const*)(raw_ipv4_packet.data());
     auto& udp_packet = *static_cast<UDPPacket const*>(ipv4_packet.payload());
     VERIFY(udp_packet.length() >= sizeof(UDPPacket)); // FIXME: This should be rejected earlier.
-    size_t read_size = min(buffer_size, udp_packet.length() - sizeof(UDPPacket));
-    SOCKET_TRY(buffer.write(udp_packet.payload(), read_size));
+    size_t read_size = min(buffer.size(), udp_packet.length() - sizeof(UDPPacket));
+    SOCKET_TRY(buffer.write(udp_packet.payload(), 0, read_size));
     return read_size;
 }
 
-ErrorOr<size_t> UDPSocket::protocol_send(UserOrKernelBuffer const& data, size_t data_length)
+ErrorOr<size_t> UDPSocket::protocol_send(UserOrKernelBufferVector const& data)
 {
     auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
     auto routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
     auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-    data_length = min(data_length, routing_decision.adapter->mtu() - ipv4_payload_offset - sizeof(UDPPacket));
+    size_t data_length = min(data.size(), routing_decision.adapter->mtu() - ipv4_payload_offset - sizeof(UDPPacket));
     const size_t udp_buffer_size = sizeof(UDPPacket) + data_length;
     auto packet = routing_decision.adapter->acquire_packet_buffer(ipv4_payload_offset + udp_buffer_size);
     if (!packet)
@@ -99,14 +99,14 @@ ErrorOr<size_t> UDPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     udp_packet.set_source_port(local_port());
     udp_packet.set_destination_port(peer_port());
     udp_packet.set_length(udp_buffer_size);
-    SOCKET_TRY(data.read(udp_packet.payload(), data_length));
+    SOCKET_TRY(data.read(udp_packet.payload(), 0, data_length));
     routing_decision.adapter->fill_in_ipv4_header(*packet, local_address(), routing_decision.next_hop,
         peer_address(), IPv4Protocol::UDP, udp_buffer_size, type_of_service(), ttl());
     routing_decision.adapter->send_packet(packet->bytes());
     return data_length;
 }
 
-ErrorOr<void> UDPSocket::protocol_connect(OpenFileDescription&)
+ErrorOr<void> UDPSocket::protocol_connect(OpenFileDescription&, bool)
 {
     set_role(Role::Connected);
     set_connected(true);
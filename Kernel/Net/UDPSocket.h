@@ -14,7 +14,7 @@ namespace Kernel {
 
 class UDPSocket final : public IPv4Socket {
 public:
-    static ErrorOr<NonnullRefPtr<UDPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
+    static ErrorOr<NonnullRefPtr<UDPSocket>> try_create(int protocol);
     virtual ~UDPSocket() override;
 
     static RefPtr<UDPSocket> from_port(u16);
@@ -22,14 +22,14 @@ public:
     static ErrorOr<void> try_for_each(Function<ErrorOr<void>(UDPSocket const&)>);
 
 private:
-    explicit UDPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
+    explicit UDPSocket(int protocol);
     virtual StringView class_name() const override { return "UDPSocket"sv; }
     static MutexProtected<HashMap<u16, UDPSocket*>>& sockets_by_port();
 
-    virtual ErrorOr<size_t> protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, int flags) override;
-    virtual ErrorOr<size_t> protocol_send(UserOrKernelBuffer const&, size_t) override;
+    virtual ErrorOr<size_t> protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBufferVector&, int flags) override;
+    virtual ErrorOr<size_t> protocol_send(UserOrKernelBufferVector const&) override;
     virtual ErrorOr<size_t> protocol_size(ReadonlyBytes raw_ipv4_packet) override;
-    virtual ErrorOr<void> protocol_connect(OpenFileDescription&) override;
+    virtual ErrorOr<void> protocol_connect(OpenFileDescription&, bool blocking) override;
     virtual ErrorOr<u16> protocol_allocate_local_port() override;
     virtual ErrorOr<void> protocol_bind() override;
 };
@@ -15,28 +15,11 @@
 
 namespace Kernel {
 
-ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
+// Everything a child process inherits from us, whether it has been forked or spawned.
+ErrorOr<void> Process::copy_inheritable_state_into(Process& child)
 {
-    VERIFY_NO_PROCESS_BIG_LOCK(this);
-    TRY(require_promise(Pledge::proc));
-
-    auto child_name = TRY(name().with([](auto& name) { return name->try_clone(); }));
-    auto credentials = this->credentials();
-    auto child_and_first_thread = TRY(Process::create(move(child_name), credentials->uid(), credentials->gid(), pid(), m_is_kernel_process, current_directory(), executable(), tty(), this));
-    auto& child = child_and_first_thread.process;
-    auto& child_first_thread = child_and_first_thread.first_thread;
-
-    ArmedScopeGuard thread_finalizer_guard = [&child_first_thread]() {
-        SpinlockLocker lock(g_scheduler_lock);
-        child_first_thread->detach();
-        child_first_thread->set_state(Thread::State::Dying);
-    };
-
-    // NOTE: All user processes have a leaked ref on them. It's balanced by Thread::WaitBlockerSet::finalize().
-    child->ref();
-
     TRY(m_unveil_data.with([&](auto& parent_unveil_data) -> ErrorOr<void> {
-        return child->m_unveil_data.with([&](auto& child_unveil_data) -> ErrorOr<void> {
+        return child.m_unveil_data.with([&](auto& child_unveil_data) -> ErrorOr<void> {
             child_unveil_data.state = parent_unveil_data.state;
             child_unveil_data.paths = TRY(parent_unveil_data.paths.deep_copy());
             return {};
@@ -44,7 +27,7 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
     }));
 
     TRY(m_exec_unveil_data.with([&](auto& parent_exec_unveil_data) -> ErrorOr<void> {
-        return child->m_exec_unveil_data.with([&](auto& child_exec_unveil_data) -> ErrorOr<void> {
+        return child.m_exec_unveil_data.with([&](auto& child_exec_unveil_data) -> ErrorOr<void> {
             child_exec_unveil_data.state = parent_exec_unveil_data.state;
             child_exec_unveil_data.paths = TRY(parent_exec_unveil_data.paths.deep_copy());
             return {};
@@ -58,7 +41,7 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
     // Process::for_each* methods.
     TRY(Process::all_instances().with([&](auto const&) -> ErrorOr<void> {
         TRY(m_attached_jail.with([&](auto& parent_jail) -> ErrorOr<void> {
-            return child->m_attached_jail.with([&](auto& child_jail) -> ErrorOr<void> {
+            return child.m_attached_jail.with([&](auto& child_jail) -> ErrorOr<void> {
                 child_jail = parent_jail;
                 if (child_jail) {
                     child_jail->attach_count().with([&](auto& attach_count) {
@@ -71,18 +54,9 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
         return {};
     }));
 
-    ArmedScopeGuard remove_from_jail_process_list = [&]() {
-        m_jail_process_list.with([&](auto& list_ptr) {
-            if (list_ptr) {
-                list_ptr->attached_processes().with([&](auto& list) {
-                    list.remove(*child);
-                });
-            }
-        });
-    };
     m_jail_process_list.with([&](auto& list_ptr) {
         if (list_ptr) {
-            child->m_jail_process_list.with([&](auto& child_list_ptr) {
+            child.m_jail_process_list.with([&](auto& child_list_ptr) {
                 child_list_ptr = list_ptr;
             });
             list_ptr->attached_processes().with([&](auto& list) {
@@ -91,14 +65,14 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
         }
     });
 
-    TRY(child->m_fds.with_exclusive([&](auto& child_fds) {
+    TRY(child.m_fds.with_exclusive([&](auto& child_fds) {
         return m_fds.with_exclusive([&](auto& parent_fds) {
             return child_fds.try_clone(parent_fds);
         });
     }));
 
     with_protected_data([&](auto& my_protected_data) {
-        child->with_mutable_protected_data([&](auto& child_protected_data) {
+        child.with_mutable_protected_data([&](auto& child_protected_data) {
             child_protected_data.promises = my_protected_data.promises.load();
             child_protected_data.execpromises = my_protected_data.execpromises.load();
             child_protected_data.has_promises = my_protected_data.has_promises.load();
@@ -111,6 +85,40 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
         });
     });
 
+    return {};
+}
+
+ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::proc));
+
+    auto child_name = TRY(name().with([](auto& name) { return name->try_clone(); }));
+    auto credentials = this->credentials();
+    auto child_and_first_thread = TRY(Process::create(move(child_name), credentials->uid(), credentials->gid(), pid(), m_is_kernel_process, current_directory(), executable(), tty(), this));
+    auto& child = child_and_first_thread.process;
+    auto& child_first_thread = child_and_first_thread.first_thread;
+
+    ArmedScopeGuard thread_finalizer_guard = [&child_first_thread]() {
+        SpinlockLocker lock(g_scheduler_lock);
+        child_first_thread->detach();
+        child_first_thread->set_state(Thread::State::Dying);
+    };
+
+    // NOTE: All user processes have a leaked ref on them. It's balanced by Thread::WaitBlockerSet::finalize().
+    child->ref();
+
+    ArmedScopeGuard remove_from_jail_process_list = [&]() {
+        m_jail_process_list.with([&](auto& list_ptr) {
+            if (list_ptr) {
+                list_ptr->attached_processes().with([&](auto& list) {
+                    list.remove(*child);
+                });
+            }
+        });
+    };
+    TRY(copy_inheritable_state_into(*child));
+
     dbgln_if(FORK_DEBUG, "fork: child={}", child);
 
     // A child created via fork(2) inherits a copy of its parent's signal mask
@@ -161,7 +169,13 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
             for (auto& region : parent_space->region_tree().regions()) {
                 dbgln_if(FORK_DEBUG, "fork: cloning Region '{}' @ {}", region.name(), region.vaddr());
                 auto region_clone = TRY(region.try_clone());
-                TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
+                // Anonymous memory is mapped into the child as it touches it (see Region::handle_fault()), so we don't
+                // have to build page tables for all of it here, most of which an exec() would throw away right after.
+                if (region_clone->vmobject().is_anonymous()) {
+                    region_clone->set_lazily_mapped(true);
+                    region_clone->set_page_directory(child_space->page_directory());
+                } else
+                    TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
                 TRY(child_space->region_tree().place_specifically(*region_clone, region.range()));
                 auto* child_region = region_clone.leak_ptr();
 
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Singleton.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Memory/InodeVMObject.h>
@@ -13,25 +14,93 @@
 
 namespace Kernel {
 
-static Singleton<SpinlockProtected<HashMap<GlobalFutexKey, NonnullLockRefPtr<FutexQueue>>, LockRank::None>> s_global_futex_queues;
+// The futex queues are spread over a number of buckets by the hash of their key, so that threads
+// using unrelated futexes don't all have to take the same lock.
+static constexpr size_t futex_bucket_count = 256;
+using FutexBucket = SpinlockProtected<HashMap<GlobalFutexKey, NonnullLockRefPtr<FutexQueue>>, LockRank::None>;
+static Singleton<Array<FutexBucket, futex_bucket_count>> s_futex_buckets;
 
-void Process::clear_futex_queues_on_exec()
+static FutexBucket& futex_bucket_for(GlobalFutexKey const& futex_key)
+{
+    return s_futex_buckets->at(Traits<GlobalFutexKey>::hash(futex_key) % futex_bucket_count);
+}
+
+// Every thread that waits for a priority-inheriting futex lends its priority to the owner of the futex
+// until it stops waiting, or the owner unlocks the futex. An owner runs with the highest priority of
+// all the threads that are currently lending it theirs.
+struct PriorityInheritingWaiter {
+    Thread* waiter { nullptr };
+    NonnullRefPtr<Thread> owner;
+    GlobalFutexKey futex_key;
+};
+using PriorityInheritingWaiters = Vector<PriorityInheritingWaiter>;
+static Singleton<SpinlockProtected<PriorityInheritingWaiters, LockRank::None>> s_priority_inheriting_waiters;
+
+static void update_inherited_priority(PriorityInheritingWaiters const& waiters, Thread& owner)
+{
+    u32 priority = 0;
+    for (auto const& entry : waiters) {
+        if (entry.owner.ptr() == &owner)
+            priority = max(priority, entry.waiter->priority());
+    }
+    owner.set_inherited_priority(priority);
+}
+
+static ErrorOr<void> start_lending_priority(Thread& waiter, NonnullRefPtr<Thread> owner, GlobalFutexKey const& futex_key)
+{
+    return s_priority_inheriting_waiters->with([&](auto& waiters) -> ErrorOr<void> {
+        TRY(waiters.try_append({ &waiter, owner, futex_key }));
+        update_inherited_priority(waiters, *owner);
+        return {};
+    });
+}
+
+static void stop_lending_priority(Thread& waiter)
+{
+    // NOTE: The owner may be gone by now, so we keep it alive until we no longer hold the lock.
+    RefPtr<Thread> owner;
+    s_priority_inheriting_waiters->with([&](auto& waiters) {
+        for (size_t i = 0; i < waiters.size(); ++i) {
+            if (waiters[i].waiter != &waiter)
+                continue;
+            owner = waiters[i].owner;
+            waiters.remove(i);
+            update_inherited_priority(waiters, *owner);
+            return;
+        }
+    });
+}
+
+// The threads that are still waiting for the futex lend their priority to its next owner instead, once they wake up.
+static void stop_inheriting_priority(Thread& owner, GlobalFutexKey const& futex_key)
 {
-    s_global_futex_queues->with([this](auto& queues) {
-        auto const* address_space = this->address_space().with([](auto& space) { return space.ptr(); });
-        queues.remove_all_matching([address_space](auto& futex_key, auto& futex_queue) {
-            if ((futex_key.raw.offset & futex_key_private_flag) == 0)
-                return false;
-            if (futex_key.private_.address_space != address_space)
-                return false;
-            bool did_wake_all;
-            futex_queue->wake_all(did_wake_all);
-            VERIFY(did_wake_all); // No one should be left behind...
-            return true;
+    s_priority_inheriting_waiters->with([&](auto& waiters) {
+        waiters.remove_all_matching([&](auto const& entry) {
+            return entry.owner.ptr() == &owner && Traits<GlobalFutexKey>::equals(entry.futex_key, futex_key);
         });
+        update_inherited_priority(waiters, owner);
     });
 }
 
+void Process::clear_futex_queues_on_exec()
+{
+    auto const* address_space = this->address_space().with([](auto& space) { return space.ptr(); });
+    for (auto& bucket : *s_futex_buckets) {
+        bucket.with([address_space](auto& queues) {
+            queues.remove_all_matching([address_space](auto& futex_key, auto& futex_queue) {
+                if ((futex_key.raw.offset & futex_key_private_flag) == 0)
+                    return false;
+                if (futex_key.private_.address_space != address_space)
+                    return false;
+                bool did_wake_all;
+                futex_queue->wake_all(did_wake_all);
+                VERIFY(did_wake_all); // No one should be left behind...
+                return true;
+            });
+        });
+    }
+}
+
 ErrorOr<GlobalFutexKey> Process::get_futex_key(FlatPtr user_address, bool shared)
 {
     if (user_address & 0b11) // user_address points to a u32, so must be 4byte aligned
@@ -90,7 +159,7 @@ ErrorOr<GlobalFutexKey> Process::get_futex_key(FlatPtr user_address, bool shared
 
 ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> user_params)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     auto params = TRY(copy_typed_from_user(user_params));
 
     Thread::BlockTimeout timeout;
@@ -100,14 +169,16 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     if (use_realtime_clock && cmd != FUTEX_WAIT && cmd != FUTEX_WAIT_BITSET) {
         return ENOSYS;
     }
+    // The timeout of FUTEX_LOCK_PI is always measured against the realtime clock.
+    if (cmd == FUTEX_LOCK_PI)
+        use_realtime_clock = true;
 
     bool shared = (params.futex_op & FUTEX_PRIVATE_FLAG) == 0;
 
     switch (cmd) {
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
-    case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_LOCK_PI: {
         if (params.timeout) {
             auto timeout_time = TRY(copy_time_from_user(params.timeout));
             bool is_absolute = cmd != FUTEX_WAIT;
@@ -126,7 +197,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
 
     auto find_futex_queue = [&](GlobalFutexKey futex_key, bool create_if_not_found, bool* did_create = nullptr) -> ErrorOr<LockRefPtr<FutexQueue>> {
         VERIFY(!create_if_not_found || did_create != nullptr);
-        return s_global_futex_queues->with([&](auto& queues) -> ErrorOr<LockRefPtr<FutexQueue>> {
+        return futex_bucket_for(futex_key).with([&](auto& queues) -> ErrorOr<LockRefPtr<FutexQueue>> {
             auto it = queues.find(futex_key);
             if (it != queues.end())
                 return it->value;
@@ -141,7 +212,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     };
 
     auto remove_futex_queue = [&](GlobalFutexKey futex_key) {
-        return s_global_futex_queues->with([&](auto& queues) {
+        return futex_bucket_for(futex_key).with([&](auto& queues) {
             auto it = queues.find(futex_key);
             if (it == queues.end())
                 return;
@@ -169,31 +240,47 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     auto user_address = FlatPtr(params.userspace_address);
     auto user_address2 = FlatPtr(params.userspace_address2);
 
-    auto do_wait = [&](u32 bitset) -> ErrorOr<FlatPtr> {
+    // Registers an imminent wait on the queue of the futex, creating the queue if there isn't one yet.
+    auto prepare_to_wait = [&](GlobalFutexKey futex_key) -> ErrorOr<NonnullLockRefPtr<FutexQueue>> {
         bool did_create;
         LockRefPtr<FutexQueue> futex_queue;
-        auto futex_key = TRY(get_futex_key(user_address, shared));
         do {
-            auto user_value = user_atomic_load_relaxed(params.userspace_address);
-            if (!user_value.has_value())
-                return EFAULT;
-            if (user_value.value() != params.val) {
-                dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, params.val);
-                return EAGAIN;
-            }
-            atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
-
             did_create = false;
             futex_queue = TRY(find_futex_queue(futex_key, true, &did_create));
             VERIFY(futex_queue);
             // We need to try again if we didn't create this queue and the existing queue
             // was removed before we were able to queue an imminent wait.
         } while (!did_create && !futex_queue->queue_imminent_wait());
+        return futex_queue.release_nonnull();
+    };
+
+    auto cancel_wait = [&](GlobalFutexKey futex_key, FutexQueue& futex_queue) {
+        futex_queue.cancel_imminent_wait();
+        if (futex_queue.is_empty_and_no_imminent_waits())
+            remove_futex_queue(futex_key);
+    };
+
+    auto do_wait = [&](u32 bitset) -> ErrorOr<FlatPtr> {
+        auto futex_key = TRY(get_futex_key(user_address, shared));
+        auto futex_queue = TRY(prepare_to_wait(futex_key));
+        auto wake_sequence = futex_queue->wake_sequence();
+
+        auto user_value = user_atomic_load_relaxed(params.userspace_address);
+        if (!user_value.has_value()) {
+            cancel_wait(futex_key, *futex_queue);
+            return EFAULT;
+        }
+        if (user_value.value() != params.val) {
+            dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, params.val);
+            cancel_wait(futex_key, *futex_queue);
+            return EAGAIN;
+        }
+        atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
 
         // We must not hold the lock before blocking. But we have a reference
         // to the FutexQueue so that we can keep it alive.
 
-        Thread::BlockResult block_result = futex_queue->wait_on(timeout, bitset);
+        Thread::BlockResult block_result = futex_queue->wait_on(timeout, bitset, wake_sequence);
 
         if (futex_queue->is_empty_and_no_imminent_waits()) {
             // If there are no more waiters, we want to get rid of the futex!
@@ -205,6 +292,93 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         return 0;
     };
 
+    auto do_lock_pi = [&](bool try_only) -> ErrorOr<FlatPtr> {
+        auto* current_thread = Thread::current();
+        u32 tid = current_thread->tid().value();
+        auto futex_key = TRY(get_futex_key(user_address, shared));
+        bool did_wait = false;
+
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            u32 owner_tid = value & FUTEX_TID_MASK;
+
+            if (owner_tid == 0) {
+                // Once we have waited, there may be others still waiting behind us, so our unlock has to come
+                // through the kernel as well.
+                u32 new_value = tid | (did_wait ? FUTEX_WAITERS : (value & FUTEX_WAITERS));
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, value, new_value);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (did_exchange.value()) {
+                    atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                    return 0;
+                }
+                continue;
+            }
+            if (owner_tid == tid)
+                return EDEADLK;
+            if (try_only)
+                return EAGAIN;
+
+            // The TID comes straight from user memory, so don't let it name a thread of some other process.
+            auto owner = Thread::from_tid(owner_tid);
+            if (!owner || &owner->process() != this)
+                return ESRCH;
+
+            auto futex_queue = TRY(prepare_to_wait(futex_key));
+            auto wake_sequence = futex_queue->wake_sequence();
+
+            // Make sure the owner goes through the kernel to unlock the futex, so that it wakes us up. This also
+            // makes sure that the futex hasn't been unlocked since we looked at it, as that wake-up would be lost
+            // on us otherwise, even if FUTEX_WAITERS was already set.
+            auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, value, value | FUTEX_WAITERS);
+            if (!did_exchange.has_value() || !did_exchange.value()) {
+                cancel_wait(futex_key, *futex_queue);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                continue;
+            }
+
+            // FIXME: If the owner is itself waiting for a priority-inheriting futex, pass the priority on to its owner.
+            if (auto result = start_lending_priority(*current_thread, owner.release_nonnull(), futex_key); result.is_error()) {
+                cancel_wait(futex_key, *futex_queue);
+                return result.release_error();
+            }
+
+            auto block_result = futex_queue->wait_on(timeout, FUTEX_BITSET_MATCH_ANY, wake_sequence);
+            did_wait = true;
+            stop_lending_priority(*current_thread);
+
+            if (futex_queue->is_empty_and_no_imminent_waits())
+                remove_futex_queue(futex_key);
+            if (block_result == Thread::BlockResult::InterruptedByTimeout)
+                return ETIMEDOUT;
+            if (block_result.was_interrupted())
+                return EINTR;
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> ErrorOr<FlatPtr> {
+        auto* current_thread = Thread::current();
+        auto user_value = user_atomic_load_relaxed(params.userspace_address);
+        if (!user_value.has_value())
+            return EFAULT;
+        if ((user_value.value() & FUTEX_TID_MASK) != current_thread->tid().value())
+            return EPERM;
+
+        // We keep whatever priority is lent to us for the other futexes we hold.
+        stop_inheriting_priority(*current_thread, TRY(get_futex_key(user_address, shared)));
+
+        atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+        if (!user_atomic_store_relaxed(params.userspace_address, 0))
+            return EFAULT;
+        TRY(do_wake(user_address, 1, {}));
+        return 0;
+    };
+
     auto do_requeue = [&](Optional<u32> val3) -> ErrorOr<FlatPtr> {
         auto user_value = user_atomic_load_relaxed(params.userspace_address);
         if (!user_value.has_value())
@@ -218,24 +392,28 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         if (!futex_queue)
             return 0;
 
+        // NOTE: The target queue has to be looked up before the lock of the source queue is taken, as the lock
+        //       of a bucket is always taken before the locks of the queues in it. Holding an imminent wait
+        //       keeps it from being removed until we are done.
+        auto futex_key2 = TRY(get_futex_key(user_address2, shared));
         LockRefPtr<FutexQueue> target_futex_queue;
+        if (params.val2 > 0)
+            target_futex_queue = TRY(prepare_to_wait(futex_key2));
+
         bool is_empty = false;
         bool is_target_empty = false;
-        auto futex_key2 = TRY(get_futex_key(user_address2, shared));
-        auto woken_or_requeued = TRY(futex_queue->wake_n_requeue(
+        auto woken_or_requeued = futex_queue->wake_n_requeue(
             params.val, [&]() -> ErrorOr<FutexQueue*> {
-                // NOTE: futex_queue's lock is being held while this callback is called
-                // The reason we're doing this in a callback is that we don't want to always
-                // create a target queue, only if we actually have anything to move to it!
-                target_futex_queue = TRY(find_futex_queue(futex_key2, true));
                 return target_futex_queue.ptr();
             },
-            params.val2, is_empty, is_target_empty));
+            params.val2, is_empty, is_target_empty);
         if (is_empty)
             remove_futex_queue(futex_key);
-        if (is_target_empty && target_futex_queue)
-            remove_futex_queue(futex_key2);
-        return woken_or_requeued;
+        if (target_futex_queue)
+            cancel_wait(futex_key2, *target_futex_queue);
+        if (woken_or_requeued.is_error())
+            return woken_or_requeued.release_error();
+        return woken_or_requeued.release_value();
     };
 
     switch (cmd) {
@@ -313,6 +491,15 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     case FUTEX_CMP_REQUEUE:
         return do_requeue(params.val3);
 
+    case FUTEX_LOCK_PI:
+        return do_lock_pi(false);
+
+    case FUTEX_TRYLOCK_PI:
+        return do_lock_pi(true);
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
+
     case FUTEX_WAIT_BITSET:
         VERIFY(params.val3 != FUTEX_BITSET_MATCH_ANY); // we should have turned it into FUTEX_WAIT
         if (params.val3 == 0)
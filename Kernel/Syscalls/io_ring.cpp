@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$io_ring_setup(Userspace<io_ring_params*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.flags & ~IO_RING_CLOEXEC)
+        return EINVAL;
+    if (params.sq_entries == 0 || params.sq_entries > IO_RING_MAX_ENTRIES)
+        return EINVAL;
+
+    auto ring = TRY(IORing::try_create(*this, params.sq_entries));
+    params.sq_entries = ring->sq_entries();
+    params.cq_entries = ring->cq_entries();
+    params.sqes_offset = ring->sqes_offset();
+    params.cqes_offset = ring->cqes_offset();
+    params.mapping_size = ring->mapping_size();
+
+    auto description = TRY(OpenFileDescription::try_create(move(ring)));
+    // NOTE: The ring is mapped shared and writable, which mmap() only allows for readable and writable descriptions.
+    description->set_readable(true);
+    description->set_writable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        // Copy the layout out first, so we don't leave an fd behind if that fails.
+        TRY(copy_to_user(user_params, &params));
+        fds[fd_allocation.fd].set(move(description));
+
+        if (params.flags & IO_RING_CLOEXEC)
+            fds[fd_allocation.fd].set_flags(FD_CLOEXEC);
+
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$io_ring_enter(Userspace<Syscall::SC_io_ring_enter_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    auto description = TRY(open_file_description(params.ring_fd));
+    if (!description->is_io_ring())
+        return EINVAL;
+    auto& ring = *description->io_ring();
+
+    size_t submitted = 0;
+    if (params.to_submit > 0) {
+        auto result = ring.submit(*this, params.to_submit);
+        if (!result.is_error())
+            submitted = result.value();
+        else if (result.error().code() != EBUSY || params.min_complete == 0)
+            return result.release_error();
+        // The completion queue is full, but waiting for completions is exactly what makes room.
+    }
+
+    size_t min_complete = min<size_t>(params.min_complete, ring.cq_entries());
+    if (min_complete == 0)
+        return submitted;
+
+    Thread::BlockTimeout timeout;
+    if (params.timeout) {
+        auto relative_timeout = TRY(copy_time_from_user(params.timeout));
+        auto deadline = TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE) + relative_timeout;
+        timeout = Thread::BlockTimeout(true, &deadline);
+    }
+
+    while (ring.available_completions() < min_complete) {
+        auto block_result = ring.completion_wait_queue().wait_on(timeout, "IORing"sv);
+        if (block_result == Thread::BlockResult::InterruptedByTimeout)
+            break;
+        // Operations that have been submitted can't be taken back, so report them instead of the signal.
+        if (block_result.was_interrupted())
+            return submitted > 0 ? ErrorOr<FlatPtr> { submitted } : EINTR;
+    }
+    return submitted;
+}
+
+}
@@ -202,6 +202,10 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
     if (map_anonymous) {
         auto strategy = map_noreserve ? AllocationStrategy::None : AllocationStrategy::Reserve;
 
+        // Unless asked otherwise, place larger anonymous mappings so that they can be backed by large pages.
+        if (!params.alignment && rounded_size >= Memory::LARGE_PAGE_SIZE)
+            alignment = Memory::LARGE_PAGE_SIZE;
+
         if (flags & MAP_PURGEABLE) {
             vmobject = TRY(Memory::AnonymousVMObject::try_create_purgeable_with_size(rounded_size, strategy));
         } else {
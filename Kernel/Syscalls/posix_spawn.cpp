@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <Kernel/API/POSIX/spawn.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Net/LocalSocket.h>
+#include <Kernel/TTY/TTY.h>
+#include <Kernel/Tasks/PerformanceManager.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/ProcessGroup.h>
+#include <Kernel/Tasks/Scheduler.h>
+
+namespace Kernel {
+
+static constexpr size_t max_spawn_file_actions = 1024;
+
+ErrorOr<void> Process::apply_spawn_attributes(Process& child, Thread& child_thread, Syscall::SC_posix_spawn_params const& params)
+{
+    // NOTE: These are applied in the same order as a forked child would apply them before calling exec().
+    auto credentials = child.credentials();
+    auto euid = credentials->euid();
+    auto egid = credentials->egid();
+    auto sid = credentials->sid();
+    auto pgid = credentials->pgid();
+    RefPtr<ProcessGroup> process_group;
+    bool should_detach_from_tty = false;
+
+    if (params.flags & POSIX_SPAWN_RESETIDS) {
+        euid = credentials->uid();
+        egid = credentials->gid();
+    }
+
+    if (params.flags & POSIX_SPAWN_SETPGROUP) {
+        if (params.pgroup < 0)
+            return EINVAL;
+        auto new_pgid = params.pgroup ? ProcessGroupID(params.pgroup) : ProcessGroupID(child.pid().value());
+        // The child isn't visible to anyone yet, so the group either has to be its own, or an existing one in our session.
+        if (params.pgroup && get_sid_from_pgid(new_pgid) != this->sid())
+            return EPERM;
+        process_group = TRY(ProcessGroup::find_or_create(new_pgid));
+        pgid = new_pgid;
+    }
+
+    if (params.flags & POSIX_SPAWN_SETSID) {
+        // NOTE: This fails with EPERM if the child has already been made the leader of its own process group.
+        process_group = TRY(ProcessGroup::create_if_unused_pgid(ProcessGroupID(child.pid().value())));
+        sid = SessionID(child.pid().value());
+        should_detach_from_tty = true;
+    }
+
+    if (params.flags & (POSIX_SPAWN_RESETIDS | POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSID)) {
+        auto new_credentials = TRY(Credentials::create(
+            credentials->uid(),
+            credentials->gid(),
+            euid,
+            egid,
+            credentials->suid(),
+            credentials->sgid(),
+            credentials->extra_gids(),
+            sid,
+            pgid));
+        child.with_mutable_protected_data([&](auto& protected_data) {
+            protected_data.credentials = move(new_credentials);
+            if (process_group)
+                protected_data.process_group = move(process_group);
+            if (should_detach_from_tty)
+                protected_data.tty = nullptr;
+        });
+    }
+
+    if (params.flags & POSIX_SPAWN_SETSCHEDPARAM) {
+        if (params.schedparam.sched_priority < THREAD_PRIORITY_MIN || params.schedparam.sched_priority > THREAD_PRIORITY_MAX)
+            return EINVAL;
+        SpinlockLocker lock(g_scheduler_lock);
+        child_thread.set_priority((u32)params.schedparam.sched_priority);
+    }
+
+    // FIXME: POSIX_SPAWN_SETSCHEDULER
+
+    if (params.flags & POSIX_SPAWN_SETSIGDEF) {
+        for (size_t signal = 1; signal < child.m_signal_action_data.size(); ++signal) {
+            if (params.sigdefault & (1u << (signal - 1)))
+                child.m_signal_action_data[signal] = {};
+        }
+    }
+
+    if (params.flags & POSIX_SPAWN_SETSIGMASK)
+        child_thread.update_signal_mask(params.sigmask);
+
+    return {};
+}
+
+ErrorOr<void> Process::apply_spawn_file_action(Process& child, Syscall::SC_posix_spawn_file_action const& action, KString const* path)
+{
+    switch (action.type) {
+    case Syscall::SpawnFileActionType::Open: {
+        VERIFY(path);
+        if (action.fd < 0 || static_cast<size_t>(action.fd) >= OpenFileDescriptions::max_open())
+            return EBADF;
+        if (action.flags & O_WRONLY)
+            TRY(require_promise(Pledge::wpath));
+        else if (action.flags & O_RDONLY)
+            TRY(require_promise(Pledge::rpath));
+        if (action.flags & O_CREAT)
+            TRY(require_promise(Pledge::cpath));
+        if (action.flags & (O_NOFOLLOW_NOERROR | O_UNLINK_INTERNAL))
+            return EINVAL;
+
+        auto description = TRY(VirtualFileSystem::the().open(child, child.credentials(), path->view(), action.flags, action.mode & 0777 & ~child.umask(), *child.current_directory()));
+        if (description->inode() && description->inode()->bound_socket())
+            return ENXIO;
+        return child.m_fds.with_exclusive([&](auto& fds) -> ErrorOr<void> {
+            if (!fds.m_fds_metadatas[action.fd].is_allocated())
+                fds.m_fds_metadatas[action.fd].allocate();
+            fds[action.fd].set(move(description), (action.flags & O_CLOEXEC) ? FD_CLOEXEC : 0);
+            return {};
+        });
+    }
+    case Syscall::SpawnFileActionType::Close: {
+        auto description = TRY(child.open_file_description(action.fd));
+        auto result = description->close();
+        child.m_fds.with_exclusive([&](auto& fds) { fds[action.fd] = {}; });
+        return result;
+    }
+    case Syscall::SpawnFileActionType::Dup2:
+        return child.m_fds.with_exclusive([&](auto& fds) -> ErrorOr<void> {
+            auto description = TRY(fds.open_file_description(action.fd));
+            if (action.new_fd < 0 || static_cast<size_t>(action.new_fd) >= OpenFileDescriptions::max_open())
+                return EBADF;
+            // NOTE: Unlike dup2(), duplicating a descriptor onto itself clears its FD_CLOEXEC flag here.
+            if (action.fd == action.new_fd) {
+                fds[action.new_fd].set_flags(fds[action.new_fd].flags() & ~FD_CLOEXEC);
+                return {};
+            }
+            if (!fds.m_fds_metadatas[action.new_fd].is_allocated())
+                fds.m_fds_metadatas[action.new_fd].allocate();
+            fds[action.new_fd].set(move(description));
+            return {};
+        });
+    case Syscall::SpawnFileActionType::Chdir: {
+        VERIFY(path);
+        TRY(require_promise(Pledge::rpath));
+        RefPtr<Custody> new_directory = TRY(VirtualFileSystem::the().open_directory(child.credentials(), path->view(), *child.current_directory()));
+        child.m_current_directory.with([&](auto& current_directory) {
+            swap(current_directory, new_directory);
+        });
+        return {};
+    }
+    case Syscall::SpawnFileActionType::Fchdir: {
+        auto description = TRY(child.open_file_description(action.fd));
+        if (!description->is_directory())
+            return ENOTDIR;
+        if (!description->metadata().may_execute(child.credentials()))
+            return EACCES;
+        child.m_current_directory.with([&](auto& current_directory) {
+            current_directory = description->custody();
+        });
+        return {};
+    }
+    }
+    return EINVAL;
+}
+
+// Unlike fork() followed by exec(), this never duplicates our address space (nor does it even look at it);
+// the child is set up from the outside, and starts out running the new program.
+ErrorOr<FlatPtr> Process::sys$posix_spawn(Userspace<Syscall::SC_posix_spawn_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::proc));
+    TRY(require_promise(Pledge::exec));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.arguments.length > ARG_MAX || params.environment.length > ARG_MAX)
+        return E2BIG;
+
+    // NOTE: The caller is expected to always pass at least one argument by convention,
+    //       the program path that was passed as params.path.
+    if (params.arguments.length == 0)
+        return EINVAL;
+
+    if (params.flags & ~(POSIX_SPAWN_RESETIDS | POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSCHEDPARAM | POSIX_SPAWN_SETSCHEDULER | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSID))
+        return EINVAL;
+
+    if (params.file_action_count > max_spawn_file_actions)
+        return E2BIG;
+
+    auto path = TRY(get_syscall_path_argument(params.path));
+
+    Vector<NonnullOwnPtr<KString>> arguments;
+    TRY(copy_string_list_from_user(params.arguments, arguments));
+
+    Vector<NonnullOwnPtr<KString>> environment;
+    TRY(copy_string_list_from_user(params.environment, environment));
+
+    Vector<Syscall::SC_posix_spawn_file_action> file_actions;
+    Vector<OwnPtr<KString>> file_action_paths;
+    if (params.file_action_count > 0) {
+        TRY(file_actions.try_resize(params.file_action_count));
+        TRY(copy_n_from_user(file_actions.data(), params.file_actions, params.file_action_count));
+        TRY(file_action_paths.try_ensure_capacity(params.file_action_count));
+        for (auto const& action : file_actions) {
+            OwnPtr<KString> action_path;
+            if (action.type == Syscall::SpawnFileActionType::Open || action.type == Syscall::SpawnFileActionType::Chdir)
+                action_path = TRY(get_syscall_path_argument(action.path));
+            file_action_paths.unchecked_append(move(action_path));
+        }
+    }
+
+    auto child_name = TRY(name().with([](auto& name) { return name->try_clone(); }));
+    auto credentials = this->credentials();
+    auto child_and_first_thread = TRY(Process::create(move(child_name), credentials->uid(), credentials->gid(), pid(), false, current_directory(), executable(), tty(), this));
+    auto& child = child_and_first_thread.process;
+    auto& child_first_thread = child_and_first_thread.first_thread;
+
+    ArmedScopeGuard thread_finalizer_guard = [&child_first_thread]() {
+        SpinlockLocker lock(g_scheduler_lock);
+        child_first_thread->detach();
+        child_first_thread->set_state(Thread::State::Dying);
+    };
+
+    // NOTE: All user processes have a leaked ref on them. It's balanced by Thread::WaitBlockerSet::finalize().
+    child->ref();
+
+    ArmedScopeGuard remove_from_jail_process_list = [&]() {
+        m_jail_process_list.with([&](auto& list_ptr) {
+            if (list_ptr) {
+                list_ptr->attached_processes().with([&](auto& list) {
+                    list.remove(*child);
+                });
+            }
+        });
+    };
+    TRY(copy_inheritable_state_into(*child));
+
+    dbgln_if(FORK_DEBUG, "posix_spawn: child={}, path={}", child, path);
+
+    TRY(apply_spawn_attributes(*child, *child_first_thread, params));
+    for (size_t i = 0; i < file_actions.size(); ++i)
+        TRY(apply_spawn_file_action(*child, file_actions[i], file_action_paths[i].ptr()));
+
+    Thread* new_main_thread = nullptr;
+    InterruptsState previous_interrupts_state = InterruptsState::Enabled;
+    {
+        // NOTE: Loading the new program switches us over to the child's address space, so we have to come back
+        //       to our own, whether the exec() worked or not.
+        ScopeGuard enter_our_address_space = [this] {
+            Memory::MemoryManager::enter_process_address_space(*this);
+        };
+        TRY(child->exec(move(path), move(arguments), move(environment), new_main_thread, previous_interrupts_state));
+    }
+
+    // NOTE: exec() leaves us in a critical section with interrupts disabled, since it's usually followed by
+    //       a jump into the new program. That's the child's job here, so we can just carry on.
+    restore_processor_interrupts_state(previous_interrupts_state);
+    Processor::leave_critical();
+
+    VERIFY(new_main_thread == child_first_thread.ptr());
+    thread_finalizer_guard.disarm();
+    remove_from_jail_process_list.disarm();
+
+    Process::register_new(*child);
+
+    PerformanceManager::add_process_created_event(*child);
+
+    SpinlockLocker lock(g_scheduler_lock);
+    new_main_thread->set_affinity(Thread::current()->affinity());
+    new_main_thread->set_state(Thread::State::Runnable);
+
+    return child->pid().value();
+}
+
+}
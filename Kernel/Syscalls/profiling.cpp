@@ -16,6 +16,56 @@ bool g_profiling_all_threads;
 PerformanceEventBuffer* g_global_perf_events;
 u64 g_profiling_event_mask;
 
+// Each processor gets a ring of this size while streaming.
+static constexpr size_t streaming_ring_size = 1 * MiB;
+
+enum class Streaming {
+    No,
+    Yes,
+};
+
+static ErrorOr<void> profile_all_threads(Process& process, u64 event_mask, Streaming streaming)
+{
+    auto credentials = process.credentials();
+    if (!credentials->is_superuser())
+        return EPERM;
+    ScopedCritical critical;
+    bool should_stream = streaming == Streaming::Yes;
+    if (g_global_perf_events && g_global_perf_events->is_streaming() != should_stream) {
+        // Other processors may still be appending to the current buffer, so it can't be replaced until profiling has stopped.
+        if (g_profiling_all_threads)
+            return EBUSY;
+        delete g_global_perf_events;
+        g_global_perf_events = nullptr;
+    }
+
+    g_profiling_event_mask = PERF_EVENT_PROCESS_CREATE | PERF_EVENT_THREAD_CREATE | PERF_EVENT_MMAP;
+    if (g_global_perf_events) {
+        g_global_perf_events->clear();
+    } else {
+        if (should_stream)
+            g_global_perf_events = PerformanceEventBuffer::try_create_for_streaming(streaming_ring_size).leak_ptr();
+        else
+            g_global_perf_events = PerformanceEventBuffer::try_create_with_size(32 * MiB).leak_ptr();
+        if (!g_global_perf_events) {
+            g_profiling_event_mask = 0;
+            return ENOMEM;
+        }
+    }
+
+    SpinlockLocker lock(g_profiling_lock);
+    if (!TimeManagement::the().enable_profile_timer())
+        return ENOTSUP;
+    g_profiling_all_threads = true;
+    PerformanceManager::add_process_created_event(*Scheduler::colonel());
+    TRY(Process::for_each_in_same_jail([](auto& process) -> ErrorOr<void> {
+        PerformanceManager::add_process_created_event(process);
+        return {};
+    }));
+    g_profiling_event_mask = event_mask;
+    return {};
+}
+
 // NOTE: event_mask needs to be passed as a pointer as u64
 //       does not fit into a register on 32bit architectures.
 ErrorOr<FlatPtr> Process::sys$profiling_enable(pid_t pid, Userspace<u64 const*> userspace_event_mask)
@@ -33,31 +83,7 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
 
     if (pid == -1) {
-        auto credentials = this->credentials();
-        if (!credentials->is_superuser())
-            return EPERM;
-        ScopedCritical critical;
-        g_profiling_event_mask = PERF_EVENT_PROCESS_CREATE | PERF_EVENT_THREAD_CREATE | PERF_EVENT_MMAP;
-        if (g_global_perf_events) {
-            g_global_perf_events->clear();
-        } else {
-            g_global_perf_events = PerformanceEventBuffer::try_create_with_size(32 * MiB).leak_ptr();
-            if (!g_global_perf_events) {
-                g_profiling_event_mask = 0;
-                return ENOMEM;
-            }
-        }
-
-        SpinlockLocker lock(g_profiling_lock);
-        if (!TimeManagement::the().enable_profile_timer())
-            return ENOTSUP;
-        g_profiling_all_threads = true;
-        PerformanceManager::add_process_created_event(*Scheduler::colonel());
-        TRY(Process::for_each_in_same_jail([](auto& process) -> ErrorOr<void> {
-            PerformanceManager::add_process_created_event(process);
-            return {};
-        }));
-        g_profiling_event_mask = event_mask;
+        TRY(profile_all_threads(*this, event_mask, Streaming::No));
         return 0;
     }
 
@@ -85,19 +111,20 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
     return 0;
 }
 
+// NOTE: This is how /dev/perf_events starts streaming performance events of the whole system.
+ErrorOr<void> Process::profiling_enable_streaming(u64 event_mask)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    return profile_all_threads(*this, event_mask, Streaming::Yes);
+}
+
 ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
     TRY(require_no_promises());
 
     if (pid == -1) {
-        auto credentials = this->credentials();
-        if (!credentials->is_superuser())
-            return EPERM;
-        ScopedCritical critical;
-        if (!TimeManagement::the().disable_profile_timer())
-            return ENOTSUP;
-        g_profiling_all_threads = false;
+        TRY(profiling_disable_all_threads());
         return 0;
     }
 
@@ -118,6 +145,19 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
     return 0;
 }
 
+ErrorOr<void> Process::profiling_disable_all_threads()
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    auto credentials = this->credentials();
+    if (!credentials->is_superuser())
+        return EPERM;
+    ScopedCritical critical;
+    if (!TimeManagement::the().disable_profile_timer())
+        return ENOTSUP;
+    g_profiling_all_threads = false;
+    return {};
+}
+
 ErrorOr<FlatPtr> Process::sys$profiling_free_buffer(pid_t pid)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
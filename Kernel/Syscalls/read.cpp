@@ -6,6 +6,8 @@
 
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/UserOrKernelBufferVector.h>
+#include <Kernel/Net/Socket.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Process.h>
 
@@ -42,30 +44,60 @@ ErrorOr<FlatPtr> Process::sys$readv(int fd, Userspace<const struct iovec*> iov,
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
     TRY(require_promise(Pledge::stdio));
-    if (iov_count < 0)
-        return EINVAL;
+    auto data = TRY(UserOrKernelBufferVector::for_user_iovecs(iov, iov_count));
+    return readv_impl(fd, data, {});
+}
 
-    if (iov_count > IOV_MAX)
-        return EFAULT;
-
-    u64 total_length = 0;
-    Vector<iovec, 32> vecs;
-    TRY(vecs.try_resize(iov_count));
-    TRY(copy_n_from_user(vecs.data(), iov, iov_count));
-    for (auto& vec : vecs) {
-        total_length += vec.iov_len;
-        if (total_length > NumericLimits<i32>::max())
-            return EINVAL;
-    }
+// NOTE: The offset is passed by pointer because off_t is 64bit,
+// hence it can't be passed by register on 32bit platforms.
+ErrorOr<FlatPtr> Process::sys$preadv(int fd, Userspace<const struct iovec*> iov, int iov_count, Userspace<off_t const*> userspace_offset)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto data = TRY(UserOrKernelBufferVector::for_user_iovecs(iov, iov_count));
+    // NOTE: Negative offset means "operate like readv" which seeks the file.
+    auto offset = TRY(copy_typed_from_user(userspace_offset));
+    return readv_impl(fd, data, offset >= 0 ? offset : Optional<off_t> {});
+}
 
+ErrorOr<FlatPtr> Process::readv_impl(int fd, UserOrKernelBufferVector& data, Optional<off_t> offset)
+{
     auto description = TRY(open_readable_file_description(fds(), fd));
+    if (offset.has_value() && !description->file().is_seekable())
+        return EINVAL;
+    if (data.size() == 0)
+        return 0;
+
+    // A datagram has to be scattered across all of the buffers at once.
+    if (description->is_socket()) {
+        auto& socket = *description->socket();
+        if (socket.is_shut_down_for_reading())
+            return 0;
+        UnixDateTime timestamp {};
+        return TRY(socket.recvfrom_vectored(*description, data, 0, {}, {}, timestamp, description->is_blocking()));
+    }
 
-    int nread = 0;
-    for (auto& vec : vecs) {
-        TRY(check_blocked_read(description));
-        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len));
-        auto nread_here = TRY(description->read(buffer, vec.iov_len));
-        nread += nread_here;
+    size_t nread = 0;
+    for (auto& segment : data.segments()) {
+        if (segment.size == 0)
+            continue;
+        // We only block until some data is available, just like read().
+        if (nread == 0)
+            TRY(check_blocked_read(description));
+        else if (!description->can_read())
+            break;
+        auto buffer = segment.buffer;
+        auto nread_here_or_error = offset.has_value()
+            ? description->read(buffer, offset.value() + nread, segment.size)
+            : description->read(buffer, segment.size);
+        if (nread_here_or_error.is_error()) {
+            if (nread > 0)
+                break;
+            return nread_here_or_error.release_error();
+        }
+        nread += nread_here_or_error.value();
+        if (nread_here_or_error.value() < segment.size)
+            break;
     }
 
     return nread;
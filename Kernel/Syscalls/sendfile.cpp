@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static constexpr size_t transfer_buffer_size = 64 * KiB;
+
+static ErrorOr<NonnullRefPtr<OpenFileDescription>> open_description_for_transfer(Process& process, int fd, bool for_writing)
+{
+    auto description = TRY(process.open_file_description(fd));
+    if (for_writing ? !description->is_writable() : !description->is_readable())
+        return EBADF;
+    if (description->is_directory())
+        return EISDIR;
+    return description;
+}
+
+static ErrorOr<Optional<off_t>> copy_offset_from_user(off_t* user_offset)
+{
+    if (!user_offset)
+        return Optional<off_t> {};
+    off_t offset = 0;
+    TRY(copy_from_user(&offset, user_offset));
+    if (offset < 0)
+        return EINVAL;
+    return Optional<off_t> { offset };
+}
+
+// Moves data from one open file description to another through a kernel buffer, so that it
+// never has to be copied out to userspace and back. Reading from inodes goes through the
+// filesystem's block cache (and read-ahead), writing to sockets goes straight into their
+// send buffers.
+ErrorOr<FlatPtr> Process::do_transfer(OpenFileDescription& source, Optional<off_t> source_offset, OpenFileDescription& destination, Optional<off_t> destination_offset, size_t count, bool nonblocking)
+{
+    if (count == 0)
+        return 0;
+    if (count > NumericLimits<ssize_t>::max())
+        count = NumericLimits<ssize_t>::max();
+
+    auto buffer = TRY(KBuffer::try_create_with_size("Transfer buffer"sv, min(count, transfer_buffer_size)));
+    auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+
+    size_t total_transferred = 0;
+    while (total_transferred < count) {
+        // We only ever wait for the first chunk of data; after that, we return what we have.
+        if (!source.can_read()) {
+            if (total_transferred > 0)
+                break;
+            if (nonblocking || !source.is_blocking())
+                return EAGAIN;
+            auto unblock_flags = BlockFlags::None;
+            if (Thread::current()->block<Thread::ReadBlocker>({}, source, unblock_flags).was_interrupted())
+                return EINTR;
+            if (!has_flag(unblock_flags, BlockFlags::Read))
+                return EAGAIN;
+        }
+
+        size_t chunk_size = min(count - total_transferred, buffer->size());
+        auto nread_or_error = source_offset.has_value()
+            ? source.read(kernel_buffer, source_offset.value() + total_transferred, chunk_size)
+            : source.read(kernel_buffer, chunk_size);
+        if (nread_or_error.is_error()) {
+            if (total_transferred > 0)
+                break;
+            return nread_or_error.release_error();
+        }
+        auto nread = nread_or_error.release_value();
+        if (nread == 0)
+            break;
+
+        auto write_offset = destination_offset.has_value() ? destination_offset.value() + total_transferred : Optional<off_t> {};
+        auto nwritten_or_error = do_write(destination, kernel_buffer, nread, write_offset);
+        if (nwritten_or_error.is_error()) {
+            if (total_transferred > 0)
+                break;
+            return nwritten_or_error.release_error();
+        }
+        size_t nwritten = nwritten_or_error.release_value();
+
+        if (nwritten < nread && !source_offset.has_value()) {
+            if (source.file().is_seekable()) {
+                // Give back what the destination didn't take, so that it can be read again later.
+                TRY(source.seek(-static_cast<off_t>(nread - nwritten), SEEK_CUR));
+            } else {
+                // FIXME: Data from pipes and sockets can't be put back, so we have to wait for the
+                //        destination to take the rest, even if it is non-blocking. If we're interrupted
+                //        by a signal while doing so, the remaining data is lost.
+                while (nwritten < nread) {
+                    auto unblock_flags = BlockFlags::None;
+                    if (Thread::current()->block<Thread::WriteBlocker>({}, destination, unblock_flags).was_interrupted())
+                        break;
+                    auto result = do_write(destination, kernel_buffer.offset(nwritten), nread - nwritten, write_offset.has_value() ? write_offset.value() + nwritten : Optional<off_t> {});
+                    if (result.is_error()) {
+                        if (result.error().code() == EAGAIN)
+                            continue;
+                        break;
+                    }
+                    nwritten += result.value();
+                }
+            }
+        }
+
+        total_transferred += nwritten;
+        if (nwritten < nread)
+            break;
+    }
+
+    return total_transferred;
+}
+
+ErrorOr<FlatPtr> Process::sys$sendfile(Userspace<Syscall::SC_sendfile_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    auto source = TRY(open_description_for_transfer(*this, params.in_fd, false));
+    auto destination = TRY(open_description_for_transfer(*this, params.out_fd, true));
+
+    // The source has to be something we can read at arbitrary offsets, like a regular file.
+    if (!source->file().is_seekable())
+        return EINVAL;
+
+    auto offset = TRY(copy_offset_from_user(params.offset));
+    auto ntransferred = TRY(do_transfer(*source, offset, *destination, {}, params.count, false));
+
+    if (offset.has_value()) {
+        off_t new_offset = offset.value() + static_cast<off_t>(ntransferred);
+        TRY(copy_to_user(params.offset, &new_offset));
+    }
+    return ntransferred;
+}
+
+ErrorOr<FlatPtr> Process::sys$splice(Userspace<Syscall::SC_splice_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.flags & ~(SPLICE_F_MOVE | SPLICE_F_NONBLOCK | SPLICE_F_MORE | SPLICE_F_GIFT))
+        return EINVAL;
+
+    auto source = TRY(open_description_for_transfer(*this, params.in_fd, false));
+    auto destination = TRY(open_description_for_transfer(*this, params.out_fd, true));
+
+    // One of the two ends has to be a pipe, and pipes can't be read or written at an offset.
+    if (!source->is_fifo() && !destination->is_fifo())
+        return EINVAL;
+    if ((source->is_fifo() && params.in_offset) || (destination->is_fifo() && params.out_offset))
+        return ESPIPE;
+    if ((params.in_offset && !source->file().is_seekable()) || (params.out_offset && !destination->file().is_seekable()))
+        return ESPIPE;
+
+    auto source_offset = TRY(copy_offset_from_user(params.in_offset));
+    auto destination_offset = TRY(copy_offset_from_user(params.out_offset));
+
+    // NOTE: SPLICE_F_NONBLOCK only affects waiting for data on the source.
+    auto ntransferred = TRY(do_transfer(*source, source_offset, *destination, destination_offset, params.length, params.flags & SPLICE_F_NONBLOCK));
+
+    if (source_offset.has_value()) {
+        off_t new_offset = source_offset.value() + static_cast<off_t>(ntransferred);
+        TRY(copy_to_user(params.in_offset, &new_offset));
+    }
+    if (destination_offset.has_value()) {
+        off_t new_offset = destination_offset.value() + static_cast<off_t>(ntransferred);
+        TRY(copy_to_user(params.out_offset, &new_offset));
+    }
+    return ntransferred;
+}
+
+ErrorOr<FlatPtr> Process::sys$copy_file_range(Userspace<Syscall::SC_copy_file_range_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.flags != 0)
+        return EINVAL;
+
+    auto source = TRY(open_description_for_transfer(*this, params.in_fd, false));
+    auto destination = TRY(open_description_for_transfer(*this, params.out_fd, true));
+    if (!source->file().is_regular_file() || !destination->file().is_regular_file())
+        return EINVAL;
+    if (destination->should_append())
+        return EBADF;
+
+    auto source_offset = TRY(copy_offset_from_user(params.in_offset));
+    auto destination_offset = TRY(copy_offset_from_user(params.out_offset));
+
+    // Copying a range of a file onto an overlapping range of the same file is not allowed.
+    if (source->inode() == destination->inode()) {
+        u64 source_start = source_offset.value_or(source->offset());
+        u64 destination_start = destination_offset.value_or(destination->offset());
+        if (source_start < destination_start + params.length && destination_start < source_start + params.length)
+            return EINVAL;
+    }
+
+    auto ntransferred = TRY(do_transfer(*source, source_offset, *destination, destination_offset, params.length, false));
+
+    if (source_offset.has_value()) {
+        off_t new_offset = source_offset.value() + static_cast<off_t>(ntransferred);
+        TRY(copy_to_user(params.in_offset, &new_offset));
+    }
+    if (destination_offset.has_value()) {
+        off_t new_offset = destination_offset.value() + static_cast<off_t>(ntransferred);
+        TRY(copy_to_user(params.out_offset, &new_offset));
+    }
+    return ntransferred;
+}
+
+}
@@ -6,8 +6,10 @@
 
 #include <AK/ByteBuffer.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/UserOrKernelBufferVector.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Time/TimeManagement.h>
 #include <Kernel/UnixTypes.h>
 
 namespace Kernel {
@@ -107,7 +109,7 @@ ErrorOr<FlatPtr> Process::sys$accept4(Userspace<Syscall::SC_accept4_params const
 
     LockRefPtr<Socket> accepted_socket;
     for (;;) {
-        accepted_socket = socket.accept();
+        accepted_socket = socket.accept(*this);
         if (accepted_socket)
             break;
         if (!accepting_socket_description->is_blocking())
@@ -154,7 +156,7 @@ ErrorOr<FlatPtr> Process::sys$connect(int sockfd, Userspace<sockaddr const*> use
         return ENOTSOCK;
     auto& socket = *description->socket();
     REQUIRE_PROMISE_FOR_SOCKET_DOMAIN(socket.domain());
-    TRY(socket.connect(credentials(), *description, user_address, user_address_size));
+    TRY(socket.connect(credentials(), *description, user_address, user_address_size, description->is_blocking()));
     return 0;
 }
 
@@ -179,22 +181,51 @@ ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*
     TRY(require_promise(Pledge::stdio));
     auto msg = TRY(copy_typed_from_user(user_msg));
 
-    if (msg.msg_iovlen != 1)
-        return ENOTSUP; // FIXME: Support this :)
-    Vector<iovec, 1> iovs;
-    TRY(iovs.try_resize(msg.msg_iovlen));
-    TRY(copy_n_from_user(iovs.data(), msg.msg_iov, msg.msg_iovlen));
-    if (iovs[0].iov_len > NumericLimits<ssize_t>::max())
-        return EINVAL;
+    auto description = TRY(open_file_description(sockfd));
+    if (!description->is_socket())
+        return ENOTSOCK;
+    return TRY(sendmsg_impl(*description, *description->socket(), msg, flags));
+}
 
-    Userspace<sockaddr const*> user_addr((FlatPtr)msg.msg_name);
-    socklen_t addr_length = msg.msg_namelen;
+ErrorOr<FlatPtr> Process::sys$sendmmsg(int sockfd, Userspace<struct mmsghdr*> user_msgvec, unsigned vlen, int flags)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    vlen = min(vlen, static_cast<unsigned>(IOV_MAX));
 
     auto description = TRY(open_file_description(sockfd));
     if (!description->is_socket())
         return ENOTSOCK;
-
     auto& socket = *description->socket();
+
+    auto send_message = [&](mmsghdr* user_message) -> ErrorOr<void> {
+        mmsghdr message;
+        TRY(copy_from_user(&message, user_message));
+        unsigned bytes_sent = TRY(sendmsg_impl(*description, socket, message.msg_hdr, flags));
+        TRY(copy_to_user(&user_message->msg_len, &bytes_sent));
+        return {};
+    };
+
+    unsigned sent_messages = 0;
+    for (; sent_messages < vlen; ++sent_messages) {
+        // Like on Linux, an error (including a fault on the message vector) is only reported
+        // if it happens on the first message. Otherwise we report what has been sent so far.
+        if (auto result = send_message(user_msgvec.unsafe_userspace_ptr() + sent_messages); result.is_error()) {
+            if (sent_messages > 0)
+                break;
+            return result.release_error();
+        }
+    }
+    return sent_messages;
+}
+
+ErrorOr<size_t> Process::sendmsg_impl(OpenFileDescription& description, Socket& socket, struct msghdr& msg, int flags)
+{
+    auto data = TRY(UserOrKernelBufferVector::for_user_iovecs(Userspace<iovec const*>((FlatPtr)msg.msg_iov), msg.msg_iovlen));
+
+    Userspace<sockaddr const*> user_addr((FlatPtr)msg.msg_name);
+    socklen_t addr_length = msg.msg_namelen;
+
     if (socket.is_shut_down_for_writing()) {
         if ((flags & MSG_NOSIGNAL) == 0)
             Thread::current()->send_signal(SIGPIPE, &Process::current());
@@ -212,28 +243,32 @@ ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*
                 int* fds = (int*)CMSG_DATA(cmsg);
                 size_t nfds = (cmsg->cmsg_len - CMSG_ALIGN(sizeof(struct cmsghdr))) / sizeof(int);
                 for (size_t i = 0; i < nfds; ++i) {
-                    TRY(local_socket.sendfd(*description, TRY(open_file_description(fds[i]))));
+                    TRY(local_socket.sendfd(description, TRY(open_file_description(fds[i]))));
                 }
             }
         }
     }
 
-    auto data_buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len));
+    return do_sendto(description, data, flags, user_addr, addr_length);
+}
 
+ErrorOr<FlatPtr> Process::do_sendto(OpenFileDescription& description, UserOrKernelBufferVector const& data, int flags, Userspace<sockaddr const*> user_addr, socklen_t addr_length)
+{
+    auto& socket = *description.socket();
     while (true) {
-        while (!description->can_write()) {
-            if (!description->is_blocking()) {
+        while (!description.can_write()) {
+            if (!description.is_blocking()) {
                 return EAGAIN;
             }
 
             auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
-            if (Thread::current()->block<Thread::WriteBlocker>({}, *description, unblock_flags).was_interrupted()) {
+            if (Thread::current()->block<Thread::WriteBlocker>({}, description, unblock_flags).was_interrupted()) {
                 return EINTR;
             }
             // TODO: handle exceptions in unblock_flags
         }
 
-        auto bytes_sent_or_error = socket.sendto(*description, data_buffer, iovs[0].iov_len, flags, user_addr, addr_length);
+        auto bytes_sent_or_error = socket.sendto_vectored(description, data, flags, user_addr, addr_length);
         if (bytes_sent_or_error.is_error()) {
             if ((flags & MSG_NOSIGNAL) == 0 && bytes_sent_or_error.error().code() == EPIPE)
                 Thread::current()->send_signal(SIGPIPE, &Process::current());
@@ -241,7 +276,8 @@ ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*
         }
 
         auto bytes_sent = bytes_sent_or_error.release_value();
-        if (bytes_sent > 0)
+        // Empty datagrams are perfectly fine to send.
+        if (bytes_sent > 0 || data.size() == 0)
             return bytes_sent;
     }
 }
@@ -251,37 +287,88 @@ ErrorOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> user
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
     TRY(require_promise(Pledge::stdio));
 
-    struct msghdr msg;
-    TRY(copy_from_user(&msg, user_msg));
+    auto description = TRY(open_file_description(sockfd));
+    if (!description->is_socket())
+        return ENOTSOCK;
 
-    if (msg.msg_iovlen != 1)
-        return ENOTSUP; // FIXME: Support this :)
-    Vector<iovec, 1> iovs;
-    TRY(iovs.try_resize(msg.msg_iovlen));
-    TRY(copy_n_from_user(iovs.data(), msg.msg_iov, msg.msg_iovlen));
+    bool blocking = (flags & MSG_DONTWAIT) ? false : description->is_blocking();
+    return TRY(recvmsg_impl(*description, *description->socket(), user_msg, flags, blocking));
+}
 
-    Userspace<sockaddr*> user_addr((FlatPtr)msg.msg_name);
-    Userspace<socklen_t*> user_addr_length(msg.msg_name ? (FlatPtr)&user_msg.unsafe_userspace_ptr()->msg_namelen : 0);
+ErrorOr<FlatPtr> Process::sys$recvmmsg(Userspace<Syscall::SC_recvmmsg_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+    auto vlen = min(params.vlen, static_cast<unsigned>(IOV_MAX));
 
-    auto description = TRY(open_file_description(sockfd));
+    // Like on Linux, the timeout is only checked after each message, so it doesn't bound the wait for the first one.
+    Optional<MonotonicTime> deadline;
+    if (params.timeout) {
+        auto timeout = TRY(copy_time_from_user(params.timeout));
+        deadline = TimeManagement::the().monotonic_time() + timeout;
+    }
+
+    auto description = TRY(open_file_description(params.sockfd));
     if (!description->is_socket())
         return ENOTSOCK;
     auto& socket = *description->socket();
+    if (socket.is_shut_down_for_reading())
+        return 0;
+
+    bool blocking = (params.flags & MSG_DONTWAIT) ? false : description->is_blocking();
+    int flags = params.flags & ~MSG_WAITFORONE;
+
+    unsigned received_messages = 0;
+    for (; received_messages < vlen; ++received_messages) {
+        if (received_messages > 0) {
+            if (params.flags & MSG_WAITFORONE)
+                blocking = false;
+            if (deadline.has_value() && TimeManagement::the().monotonic_time() >= deadline.value())
+                break;
+            if (!blocking && !description->can_read())
+                break;
+        }
+        auto* user_message = params.msgvec + received_messages;
+        // Like on Linux, an error is only reported if it happens on the first message.
+        auto bytes_received_or_error = recvmsg_impl(*description, socket, Userspace<struct msghdr*>((FlatPtr)&user_message->msg_hdr), flags, blocking);
+        if (bytes_received_or_error.is_error()) {
+            if (received_messages > 0)
+                break;
+            return bytes_received_or_error.release_error();
+        }
+        unsigned bytes_received = bytes_received_or_error.release_value();
+        if (auto result = copy_to_user(&user_message->msg_len, &bytes_received); result.is_error()) {
+            if (received_messages > 0)
+                break;
+            return result.release_error();
+        }
+    }
+    return received_messages;
+}
+
+ErrorOr<size_t> Process::recvmsg_impl(OpenFileDescription& description, Socket& socket, Userspace<struct msghdr*> user_msg, int flags, bool blocking)
+{
+    struct msghdr msg;
+    TRY(copy_from_user(&msg, user_msg));
+
+    auto data = TRY(UserOrKernelBufferVector::for_user_iovecs(Userspace<iovec const*>((FlatPtr)msg.msg_iov), msg.msg_iovlen));
+
+    Userspace<sockaddr*> user_addr((FlatPtr)msg.msg_name);
+    Userspace<socklen_t*> user_addr_length(msg.msg_name ? (FlatPtr)&user_msg.unsafe_userspace_ptr()->msg_namelen : 0);
 
     if (socket.is_shut_down_for_reading())
         return 0;
 
-    auto data_buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len));
     UnixDateTime timestamp {};
-    bool blocking = (flags & MSG_DONTWAIT) ? false : description->is_blocking();
-    auto result = socket.recvfrom(*description, data_buffer, iovs[0].iov_len, flags, user_addr, user_addr_length, timestamp, blocking);
+    auto result = socket.recvfrom_vectored(description, data, flags, user_addr, user_addr_length, timestamp, blocking);
 
     if (result.is_error())
         return result.release_error();
 
     int msg_flags = 0;
 
-    if (result.value() > iovs[0].iov_len) {
+    if (result.value() > data.size()) {
         VERIFY(socket.type() != SOCK_STREAM);
         msg_flags |= MSG_TRUNC;
     }
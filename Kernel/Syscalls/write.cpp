@@ -7,6 +7,8 @@
 #include <AK/NumericLimits.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/UserOrKernelBufferVector.h>
+#include <Kernel/Net/Socket.h>
 #include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
@@ -17,21 +19,7 @@ ErrorOr<FlatPtr> Process::sys$pwritev(int fd, Userspace<const struct iovec*> iov
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
     TRY(require_promise(Pledge::stdio));
-    if (iov_count < 0)
-        return EINVAL;
-
-    if (iov_count > IOV_MAX)
-        return EFAULT;
-
-    u64 total_length = 0;
-    Vector<iovec, 32> vecs;
-    TRY(vecs.try_resize(iov_count));
-    TRY(copy_n_from_user(vecs.data(), iov, iov_count));
-    for (auto& vec : vecs) {
-        total_length += vec.iov_len;
-        if (total_length > NumericLimits<i32>::max())
-            return EINVAL;
-    }
+    auto data = TRY(UserOrKernelBufferVector::for_user_iovecs(iov, iov_count));
 
     // NOTE: Negative offset means "operate like writev" which seeks the file.
     auto base_offset = TRY(copy_typed_from_user(userspace_offset));
@@ -41,18 +29,34 @@ ErrorOr<FlatPtr> Process::sys$pwritev(int fd, Userspace<const struct iovec*> iov
     if (base_offset >= 0 && !description->file().is_seekable())
         return EINVAL;
 
-    int nwritten = 0;
-    off_t current_offset = base_offset;
-    for (auto& vec : vecs) {
-        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len));
-        auto result = do_write(*description, buffer, vec.iov_len, base_offset >= 0 ? current_offset : Optional<off_t> {});
+    return do_writev(*description, data, base_offset >= 0 ? base_offset : Optional<off_t> {});
+}
+
+ErrorOr<FlatPtr> Process::do_writev(OpenFileDescription& description, UserOrKernelBufferVector const& data, Optional<off_t> offset)
+{
+    // A datagram has to be gathered from all of the buffers at once.
+    if (description.is_socket()) {
+        if (description.socket()->is_shut_down_for_writing()) {
+            Thread::current()->send_signal(SIGPIPE, &Process::current());
+            return EPIPE;
+        }
+        return do_sendto(description, data, 0, {}, 0);
+    }
+
+    size_t nwritten = 0;
+    for (auto& segment : data.segments()) {
+        if (segment.size == 0)
+            continue;
+        auto result = do_write(description, segment.buffer, segment.size, offset.has_value() ? offset.value() + nwritten : Optional<off_t> {});
         if (result.is_error()) {
             if (nwritten == 0)
                 return result.release_error();
             return nwritten;
         }
         nwritten += result.value();
-        current_offset += result.value();
+        // Don't leave a gap in the data if a non-blocking write came up short.
+        if (result.value() < segment.size)
+            break;
     }
 
     return nwritten;
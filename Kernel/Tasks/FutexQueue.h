@@ -23,13 +23,21 @@ public:
     u32 wake_n(u32, Optional<u32> const&, bool&);
     u32 wake_all(bool&);
 
-    template<class... Args>
-    Thread::BlockResult wait_on(Thread::BlockTimeout const& timeout, Args&&... args)
+    // NOTE: The wake sequence has to be read before checking the value of the futex. If anyone tried to
+    //       wake the queue since then, the wait ends right away, so that the wake-up can't get lost.
+    Thread::BlockResult wait_on(Thread::BlockTimeout const& timeout, u32 bitset, u32 wake_sequence)
     {
-        return Thread::current()->block<Thread::FutexBlocker>(timeout, *this, forward<Args>(args)...);
+        return Thread::current()->block<Thread::FutexBlocker>(timeout, *this, bitset, wake_sequence);
+    }
+
+    u32 wake_sequence()
+    {
+        SpinlockLocker lock(m_lock);
+        return m_wake_sequence;
     }
 
     bool queue_imminent_wait();
+    void cancel_imminent_wait();
     bool try_remove();
 
     bool is_empty_and_no_imminent_waits()
@@ -44,6 +52,7 @@ protected:
 
 private:
     size_t m_imminent_waits { 1 }; // We only create this object if we're going to be waiting, so start out with 1
+    u32 m_wake_sequence { 0 };
     bool m_was_removed { false };
 };
 
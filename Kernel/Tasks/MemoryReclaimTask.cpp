@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/Devices/Generic/MemoryPressureDevice.h>
+#include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/MemoryReclaimTask.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WaitQueue.h>
+
+namespace Kernel {
+
+static Singleton<WaitQueue> s_reclaim_wait_queue;
+static Atomic<bool> s_reclaim_requested { false };
+
+// Memory that its owner has said it can do without goes first, then the disk caches, and finally clean
+// pages of mapped files, since those will most likely have to be read back in from disk at some point.
+static size_t reclaim_pages(size_t page_count)
+{
+    auto released = MM.purge_volatile_pages(page_count);
+    if (released < page_count)
+        released += VirtualFileSystem::the().release_cached_memory((page_count - released) * PAGE_SIZE) / PAGE_SIZE;
+    if (released < page_count)
+        released += MM.release_clean_inode_pages(page_count - released);
+    return released;
+}
+
+static void reclaim_memory_if_needed()
+{
+    if (MM.memory_pressure_level() == MEMORY_PRESSURE_NORMAL)
+        return;
+    auto memory_info = MM.get_system_memory_info();
+    auto high_watermark = MM.watermarks().high;
+    if (memory_info.physical_pages_uncommitted >= high_watermark)
+        return;
+    auto pages_to_release = static_cast<size_t>(high_watermark - memory_info.physical_pages_uncommitted);
+    auto released = reclaim_pages(pages_to_release);
+    dbgln("MemoryReclaimTask: Low on memory, released {} of {} pages", released, pages_to_release);
+}
+
+UNMAP_AFTER_INIT void MemoryReclaimTask::spawn()
+{
+    MUST(Process::create_kernel_process(KString::must_create("Memory Reclaim Task"sv), [] {
+        dbgln("MemoryReclaimTask is running");
+        u64 last_notified_sequence = 0;
+        for (;;) {
+            s_reclaim_requested.store(false, AK::MemoryOrder::memory_order_release);
+            reclaim_memory_if_needed();
+
+            // NOTE: The level may well have changed back while we were reclaiming, in which case
+            //       userspace only hears about the level we ended up at.
+            if (auto sequence = MM.memory_pressure_sequence(); sequence != last_notified_sequence) {
+                last_notified_sequence = sequence;
+                MemoryPressureDevice::notify_level_changed();
+            }
+
+            auto timeout = Duration::from_seconds(1);
+            (void)s_reclaim_wait_queue->wait_on(Thread::BlockTimeout(false, &timeout), "MemoryReclaimTask"sv);
+        }
+    }));
+}
+
+void MemoryReclaimTask::request_reclaim()
+{
+    if (!s_reclaim_requested.exchange(true, AK::MemoryOrder::memory_order_acq_rel))
+        s_reclaim_wait_queue->wake_all();
+}
+
+}
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+namespace Kernel {
+
+class MemoryReclaimTask {
+public:
+    static void spawn();
+
+    // Wakes up the reclaim task after the memory pressure level has changed, before its next periodic check.
+    static void request_reclaim();
+};
+
+}
@@ -11,6 +11,7 @@
 #include <Kernel/Arch/SafeMem.h>
 #include <Kernel/Arch/SmapDisabler.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Library/KBufferBuilder.h>
 #include <Kernel/Tasks/PerformanceEventBuffer.h>
 #include <Kernel/Tasks/Process.h>
@@ -18,7 +19,7 @@
 
 namespace Kernel {
 
-PerformanceEventBuffer::PerformanceEventBuffer(NonnullOwnPtr<KBuffer> buffer)
+PerformanceEventBuffer::PerformanceEventBuffer(OwnPtr<KBuffer> buffer)
     : m_buffer(move(buffer))
 {
 }
@@ -75,7 +76,7 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
 ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, ThreadID tid,
     FlatPtr ip, FlatPtr bp, int type, u32 lost_samples, FlatPtr arg1, FlatPtr arg2, StringView arg3, FlatPtr arg4, u64 arg5, ErrorOr<FlatPtr> const& arg6)
 {
-    if (count() >= capacity())
+    if (!is_streaming() && count() >= capacity())
         return ENOBUFS;
 
     if ((g_profiling_event_mask & type) == 0)
@@ -177,6 +178,14 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
     event.pid = pid.value();
     event.tid = tid.value();
     event.timestamp = TimeManagement::the().uptime_ms();
+
+    if (is_streaming()) {
+        // NOTE: Nothing else can append to this processor's ring while interrupts are disabled.
+        InterruptDisabler disabler;
+        m_rings[Processor::current_id()]->append(event);
+        return {};
+    }
+
     at(m_count++) = event;
     return {};
 }
@@ -333,6 +342,21 @@ OwnPtr<PerformanceEventBuffer> PerformanceEventBuffer::try_create_with_size(size
     return adopt_own_if_nonnull(new (nothrow) PerformanceEventBuffer(buffer_or_error.release_value()));
 }
 
+OwnPtr<PerformanceEventBuffer> PerformanceEventBuffer::try_create_for_streaming(size_t ring_size)
+{
+    auto buffer = adopt_own_if_nonnull(new (nothrow) PerformanceEventBuffer(nullptr));
+    if (!buffer)
+        return {};
+    for (u32 processor_id = 0; processor_id < Processor::count(); ++processor_id) {
+        auto ring_or_error = PerformanceEventRing::try_create(processor_id, ring_size);
+        if (ring_or_error.is_error())
+            return {};
+        if (buffer->m_rings.try_append(ring_or_error.release_value()).is_error())
+            return {};
+    }
+    return buffer;
+}
+
 ErrorOr<void> PerformanceEventBuffer::add_process(Process const& process, ProcessEventType event_type)
 {
     OwnPtr<KString> executable;
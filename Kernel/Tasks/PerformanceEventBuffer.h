@@ -7,7 +7,9 @@
 #pragma once
 
 #include <AK/Error.h>
+#include <AK/Vector.h>
 #include <Kernel/Library/KBuffer.h>
+#include <Kernel/Tasks/PerformanceEventRing.h>
 
 namespace Kernel {
 
@@ -109,6 +111,9 @@ enum class ProcessEventType {
 class PerformanceEventBuffer {
 public:
     static OwnPtr<PerformanceEventBuffer> try_create_with_size(size_t buffer_size);
+    // Instead of keeping events until someone asks for all of them, a streaming buffer hands them
+    // to a reader in userspace as they happen, through a ring per processor.
+    static OwnPtr<PerformanceEventBuffer> try_create_for_streaming(size_t ring_size);
 
     ErrorOr<void> append(int type, FlatPtr arg1, FlatPtr arg2, StringView arg3, Thread* current_thread = Thread::current(), FlatPtr arg4 = 0, u64 arg5 = 0, ErrorOr<FlatPtr> const& arg6 = 0);
     ErrorOr<void> append_with_ip_and_bp(ProcessID pid, ThreadID tid, FlatPtr eip, FlatPtr ebp,
@@ -121,7 +126,7 @@ public:
         m_count = 0;
     }
 
-    size_t capacity() const { return m_buffer->size() / sizeof(PerformanceEvent); }
+    size_t capacity() const { return m_buffer ? m_buffer->size() / sizeof(PerformanceEvent) : 0; }
     size_t count() const { return m_count; }
     PerformanceEvent const& at(size_t index) const
     {
@@ -130,12 +135,15 @@ public:
 
     ErrorOr<void> to_json(KBufferBuilder&) const;
 
+    bool is_streaming() const { return !m_rings.is_empty(); }
+    Vector<NonnullOwnPtr<PerformanceEventRing>> const& rings() const { return m_rings; }
+
     ErrorOr<void> add_process(Process const&, ProcessEventType event_type);
 
     ErrorOr<FlatPtr> register_string(NonnullOwnPtr<KString>);
 
 private:
-    explicit PerformanceEventBuffer(NonnullOwnPtr<KBuffer>);
+    explicit PerformanceEventBuffer(OwnPtr<KBuffer>);
 
     template<typename Serializer>
     ErrorOr<void> to_json_impl(Serializer&) const;
@@ -143,7 +151,8 @@ private:
     PerformanceEvent& at(size_t index);
 
     size_t m_count { 0 };
-    NonnullOwnPtr<KBuffer> m_buffer;
+    OwnPtr<KBuffer> m_buffer;
+    Vector<NonnullOwnPtr<PerformanceEventRing>> m_rings;
 
     HashMap<NonnullOwnPtr<KString>, size_t> m_strings;
 };
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/API/POSIX/serenity.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Tasks/PerformanceEventBuffer.h>
+#include <Kernel/Tasks/PerformanceEventRing.h>
+
+namespace Kernel {
+
+// Keep the records off the cache line that the reader keeps writing its tail to.
+static constexpr u32 data_offset = 64;
+static_assert(sizeof(PerformanceEventRingHeader) <= data_offset);
+static_assert(sizeof(PerformanceEventRecord) % 8 == 0);
+
+ErrorOr<NonnullOwnPtr<PerformanceEventRing>> PerformanceEventRing::try_create(u32 processor_id, size_t data_size)
+{
+    VERIFY(is_power_of_two(data_size));
+    auto size = TRY(Memory::page_round_up(data_offset + data_size));
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "Performance event ring"sv, Memory::Region::Access::ReadWrite));
+    memset(region->vaddr().as_ptr(), 0, size);
+
+    auto ring = TRY(adopt_nonnull_own_or_enomem(new (nothrow) PerformanceEventRing(move(vmobject), move(region), data_size)));
+    auto& header = ring->header();
+    header.data_offset = data_offset;
+    header.data_size = data_size;
+    header.processor_id = processor_id;
+    return ring;
+}
+
+PerformanceEventRing::PerformanceEventRing(NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region, size_t data_size)
+    : m_vmobject(move(vmobject))
+    , m_region(move(region))
+    , m_data_size(data_size)
+{
+}
+
+u8* PerformanceEventRing::data()
+{
+    return m_region->vaddr().offset(data_offset).as_ptr();
+}
+
+static StringView name_of(PerformanceEvent const& event)
+{
+    auto view = [](auto const& buffer) {
+        return StringView { buffer, strnlen(buffer, sizeof(buffer)) };
+    };
+    switch (event.type) {
+    case PERF_EVENT_MMAP:
+        return view(event.data.mmap.name);
+    case PERF_EVENT_PROCESS_CREATE:
+        return view(event.data.process_create.executable);
+    case PERF_EVENT_PROCESS_EXEC:
+        return view(event.data.process_exec.executable);
+    default:
+        return {};
+    }
+}
+
+static void fill_arguments(PerformanceEventRecord& record, PerformanceEvent const& event)
+{
+    switch (event.type) {
+    case PERF_EVENT_MALLOC:
+        record.arg1 = event.data.malloc.size;
+        record.arg2 = event.data.malloc.ptr;
+        break;
+    case PERF_EVENT_FREE:
+        record.arg1 = event.data.free.ptr;
+        break;
+    case PERF_EVENT_MMAP:
+        record.arg1 = event.data.mmap.ptr;
+        record.arg2 = event.data.mmap.size;
+        break;
+    case PERF_EVENT_MUNMAP:
+        record.arg1 = event.data.munmap.ptr;
+        record.arg2 = event.data.munmap.size;
+        break;
+    case PERF_EVENT_PROCESS_CREATE:
+        record.arg1 = event.data.process_create.parent_pid;
+        break;
+    case PERF_EVENT_THREAD_CREATE:
+        record.arg1 = event.data.thread_create.parent_tid;
+        break;
+    case PERF_EVENT_CONTEXT_SWITCH:
+        record.arg1 = event.data.context_switch.next_pid;
+        record.arg2 = event.data.context_switch.next_tid;
+        break;
+    case PERF_EVENT_KMALLOC:
+        record.arg1 = event.data.kmalloc.size;
+        record.arg2 = event.data.kmalloc.ptr;
+        break;
+    case PERF_EVENT_KFREE:
+        record.arg1 = event.data.kfree.size;
+        record.arg2 = event.data.kfree.ptr;
+        break;
+    case PERF_EVENT_SIGNPOST:
+        record.arg1 = event.data.signpost.arg1;
+        record.arg2 = event.data.signpost.arg2;
+        break;
+    case PERF_EVENT_READ:
+        record.arg1 = event.data.read.fd;
+        record.arg2 = event.data.read.size;
+        record.arg3 = event.data.read.start_timestamp;
+        record.arg4 = event.data.read.success;
+        record.arg5 = event.data.read.filename_index;
+        break;
+    default:
+        break;
+    }
+}
+
+void PerformanceEventRing::append(PerformanceEvent const& event)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+
+    auto name = name_of(event);
+    size_t record_size = align_up_to(sizeof(PerformanceEventRecord) + event.stack_size * sizeof(u64) + name.length(), 8);
+
+    u64 tail = AK::atomic_load(&header().tail, AK::MemoryOrder::memory_order_acquire);
+    size_t offset = m_head & (m_data_size - 1);
+    size_t space_until_end = m_data_size - offset;
+    size_t padding_size = record_size > space_until_end ? space_until_end : 0;
+
+    // A tail that is ahead of us, or too far behind, means the reader is confused; we'll just wait for it to sort itself out.
+    bool has_room = tail <= m_head && m_head - tail <= m_data_size && m_data_size - (m_head - tail) >= padding_size + record_size;
+    if (!has_room) {
+        ++m_lost_events;
+        AK::atomic_store(&header().lost_events, m_lost_events, AK::MemoryOrder::memory_order_relaxed);
+        return;
+    }
+
+    if (padding_size > 0) {
+        auto& padding = *reinterpret_cast<PerformanceEventRecord*>(data() + offset);
+        padding.size = padding_size;
+        padding.type = 0;
+        m_head += padding_size;
+        offset = 0;
+    }
+
+    auto* destination = data() + offset;
+    PerformanceEventRecord record {};
+    record.size = record_size;
+    record.type = event.type;
+    record.pid = event.pid;
+    record.tid = event.tid;
+    record.timestamp = event.timestamp;
+    record.lost_samples = event.lost_samples;
+    record.stack_size = event.stack_size;
+    record.name_length = name.length();
+    fill_arguments(record, event);
+    memcpy(destination, &record, sizeof(record));
+    destination += sizeof(record);
+    for (size_t i = 0; i < event.stack_size; ++i) {
+        u64 address = event.stack[i];
+        memcpy(destination, &address, sizeof(address));
+        destination += sizeof(address);
+    }
+    memcpy(destination, name.characters_without_null_termination(), name.length());
+
+    m_head += record_size;
+    AK::atomic_store(&header().head, m_head, AK::MemoryOrder::memory_order_release);
+}
+
+}
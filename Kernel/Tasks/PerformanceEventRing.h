@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/PerformanceEventRing.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/Region.h>
+
+namespace Kernel {
+
+struct PerformanceEvent;
+
+// The ring that one processor streams its performance events into, for a reader in userspace to
+// drain through a shared mapping. See Kernel/API/PerformanceEventRing.h for the layout.
+class PerformanceEventRing {
+public:
+    static ErrorOr<NonnullOwnPtr<PerformanceEventRing>> try_create(u32 processor_id, size_t data_size);
+
+    // NOTE: This must only be called on the processor that owns the ring, with interrupts disabled.
+    //       That makes the kernel a single producer, so the ring doesn't need a lock.
+    void append(PerformanceEvent const&);
+
+    NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject() const { return m_vmobject; }
+    size_t mapping_size() const { return m_vmobject->size(); }
+
+private:
+    PerformanceEventRing(NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>, size_t data_size);
+
+    PerformanceEventRingHeader& header() { return *reinterpret_cast<PerformanceEventRingHeader*>(m_region->vaddr().as_ptr()); }
+    u8* data();
+
+    NonnullLockRefPtr<Memory::AnonymousVMObject> const m_vmobject;
+    NonnullOwnPtr<Memory::Region> const m_region;
+    size_t const m_data_size { 0 };
+
+    // Our own copies of what we write to the header, as the reader can write whatever it wants there.
+    u64 m_head { 0 };
+    u64 m_lost_events { 0 };
+};
+
+}
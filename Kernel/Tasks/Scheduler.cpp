@@ -44,9 +44,32 @@ struct ThreadReadyQueues {
     u32 mask {};
     static constexpr size_t count = sizeof(mask) * 8;
     Array<ThreadReadyQueue, count> queues;
+
+    u32 ticks_until_balance { 0 };
+    u64 steals { 0 };
+    u64 stolen { 0 };
+    u64 balance_migrations { 0 };
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+// Every processor owns its own set of ready queues. Threads are queued on the
+// processor they last ran on (or the least loaded one they may run on), idle
+// processors steal work from busier ones, and every processor periodically
+// pulls a thread over from the busiest processor if the load is unbalanced.
+// Each set of ready queues is protected by its own lock alone. Queueing,
+// picking and moving threads never needs g_scheduler_lock, which is only
+// held for thread state changes and the context switch itself.
+static Singleton<Array<SpinlockProtected<ThreadReadyQueues, LockRank::None>, MAX_CPU_COUNT>> g_ready_queues;
+
+// The number of threads queued on each processor. This is kept outside of the
+// ready queue locks so that other processors can cheaply pick a target.
+static Array<Atomic<u32>, MAX_CPU_COUNT> s_ready_thread_counts;
+
+// How many timer ticks pass between load balancing attempts (~100ms).
+static constexpr u32 load_balance_interval_ticks = 25;
+
+// How many more threads the busiest processor needs to have queued than the
+// current one before load balancing (or enqueueing) moves a thread over.
+static constexpr u32 load_imbalance_threshold = 2;
 
 static SpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
@@ -55,7 +78,7 @@ static void dump_thread_list(bool = false);
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into ThreadReadyQueues::queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -64,73 +87,191 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static inline SpinlockProtected<ThreadReadyQueues, LockRank::None>& ready_queues_for(u32 cpu)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
+    VERIFY(cpu < MAX_CPU_COUNT);
+    return (*g_ready_queues)[cpu];
+}
+
+static inline u32 ready_thread_count(u32 cpu)
+{
+    return s_ready_thread_counts[cpu].load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+Thread* Scheduler::find_runnable_thread(ThreadReadyQueues& ready_queues, u32 affinity_mask)
+{
+    auto priority_mask = ready_queues.mask;
+    while (priority_mask != 0) {
+        auto priority = bit_scan_forward(priority_mask);
+        VERIFY(priority > 0);
+        auto& ready_queue = ready_queues.queues[--priority];
+        for (auto& thread : ready_queue.thread_list) {
+            VERIFY(thread.m_runnable_priority == (int)priority);
+            if (thread.is_active())
+                continue;
+            if (!(thread.affinity() & affinity_mask))
+                continue;
+            return &thread;
         }
+        priority_mask &= ~(1u << priority);
+    }
+    return nullptr;
+}
 
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
-    });
+void Scheduler::add_to_ready_queues(ThreadReadyQueues& ready_queues, u32 cpu, Thread& thread)
+{
+    auto priority = thread_priority_to_priority_index(thread.priority());
+    VERIFY(thread.m_runnable_priority < 0);
+    thread.m_runnable_cpu = cpu;
+    thread.m_runnable_priority = (int)priority;
+    VERIFY(!thread.m_ready_queue_node.is_in_list());
+    auto& ready_queue = ready_queues.queues[priority];
+    bool was_empty = ready_queue.thread_list.is_empty();
+    ready_queue.thread_list.append(thread);
+    if (was_empty)
+        ready_queues.mask |= (1u << priority);
+    s_ready_thread_counts[cpu].fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+void Scheduler::remove_from_ready_queues(ThreadReadyQueues& ready_queues, Thread& thread)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
-            }
-            priority_mask &= ~(1u << priority);
+    int priority = thread.m_runnable_priority;
+    VERIFY(priority >= 0);
+    VERIFY(ready_queues.mask & (1u << priority));
+    auto& ready_queue = ready_queues.queues[priority];
+    thread.m_runnable_priority = -1;
+    ready_queue.thread_list.remove(thread);
+    if (ready_queue.thread_list.is_empty())
+        ready_queues.mask &= ~(1u << priority);
+    s_ready_thread_counts[thread.m_runnable_cpu].fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
+u32 Scheduler::select_processor_for(Thread const& thread)
+{
+    auto processor_count = Processor::count();
+    if (processor_count <= 1)
+        return Processor::current_id();
+
+    auto affinity = thread.affinity();
+    Optional<u32> least_loaded_cpu;
+    u32 least_load = NumericLimits<u32>::max();
+    for (u32 cpu = 0; cpu < processor_count; cpu++) {
+        if (!(affinity & (1u << cpu)))
+            continue;
+        auto load = ready_thread_count(cpu);
+        if (load < least_load) {
+            least_loaded_cpu = cpu;
+            least_load = load;
         }
+    }
+    if (!least_loaded_cpu.has_value())
+        return Processor::current_id();
+
+    // Prefer the processor the thread last ran on, its caches are most likely
+    // still warm. Only move it if that processor is noticeably busier.
+    auto last_cpu = thread.cpu();
+    if (last_cpu < processor_count && (affinity & (1u << last_cpu)) && ready_thread_count(last_cpu) < least_load + load_imbalance_threshold)
+        return last_cpu;
+    return least_loaded_cpu.value();
+}
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
-        return nullptr;
+// Returns the processor with the most threads queued (and at least minimum_load
+// of them), ignoring the processors in excluded_mask.
+Optional<u32> Scheduler::find_busiest_processor(u64 excluded_mask, u32 minimum_load)
+{
+    Optional<u32> busiest_cpu;
+    u32 busiest_load = 0;
+    for (u32 cpu = 0; cpu < Processor::count(); cpu++) {
+        if (excluded_mask & (1ull << cpu))
+            continue;
+        auto load = ready_thread_count(cpu);
+        if (load >= max(minimum_load, 1u) && load > busiest_load) {
+            busiest_cpu = cpu;
+            busiest_load = load;
+        }
+    }
+    return busiest_cpu;
+}
+
+// Tries to take a thread that may run on thief_cpu from the busiest other
+// processor that has any threads queued. The thread is no longer on any ready
+// queue afterwards, so the caller must run it right away.
+Thread* Scheduler::steal_runnable_thread(u32 thief_cpu)
+{
+    u64 tried_mask = 1ull << thief_cpu;
+    auto affinity_mask = 1u << thief_cpu;
+
+    for (;;) {
+        auto victim_cpu = find_busiest_processor(tried_mask, 1);
+        if (!victim_cpu.has_value())
+            return nullptr;
+        tried_mask |= 1ull << victim_cpu.value();
+
+        auto* thread = ready_queues_for(victim_cpu.value()).with([&](auto& ready_queues) -> Thread* {
+            auto* thread = find_runnable_thread(ready_queues, affinity_mask);
+            if (!thread)
+                return nullptr;
+            remove_from_ready_queues(ready_queues, *thread);
+            ready_queues.stolen++;
+            // Claim it while we still hold the lock, so nobody else picks it up.
+            thread->set_active(true);
+            return thread;
+        });
+        if (thread) {
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", thief_cpu, *thread, victim_cpu.value());
+            return thread;
+        }
+    }
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto current_cpu = Processor::current_id();
+    auto affinity_mask = 1u << current_cpu;
+
+    auto* thread = ready_queues_for(current_cpu).with([&](auto& ready_queues) -> Thread* {
+        auto* thread = find_runnable_thread(ready_queues, affinity_mask);
+        if (thread) {
+            remove_from_ready_queues(ready_queues, *thread);
+            thread->set_active(true);
+        }
+        return thread;
+    });
+
+    if (!thread) {
+        // Nothing to do locally, see if a busier processor has work for us
+        // before falling back to the idle thread.
+        thread = steal_runnable_thread(current_cpu);
+        if (thread)
+            ready_queues_for(current_cpu).with([](auto& ready_queues) { ready_queues.steals++; });
+    }
+
+    if (!thread) {
+        thread = Processor::idle_thread();
+        thread->set_active(true);
+    }
+
+    // NOTE: The thread was marked as active above, while we still held the
+    // lock of the queue it came from. This is similar to comparing it with
+    // Processor::current_thread, but when there are multiple processors
+    // there's no easy way to check whether the thread is actually still
+    // needed. This prevents accidental finalization when a thread is no
+    // longer in Running state, but running on another core, and it keeps
+    // other processors from scheduling it if it were to be queued again
+    // before we actually switch to it.
+    return *thread;
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    auto current_cpu = Processor::current_id();
+    auto affinity_mask = 1u << current_cpu;
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread, nor steal from other processors. We just want to see
+    // if we have any other thread ready to be scheduled on this processor.
+    return ready_queues_for(current_cpu).with([&](auto& ready_queues) -> Thread* {
+        return find_runnable_thread(ready_queues, affinity_mask);
     });
 }
 
@@ -139,42 +280,91 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
-        auto priority = thread.m_runnable_priority;
-        if (priority < 0) {
-            VERIFY(!thread.m_ready_queue_node.is_in_list());
+    // Threads only move between ready queues while both queues are locked, so
+    // once we hold the lock of the queue the thread claims to be on, it stays put.
+    for (;;) {
+        if (thread.m_runnable_priority < 0)
             return false;
-        }
 
-        if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
-            return false;
+        auto cpu = thread.m_runnable_cpu.load();
+        auto removed = ready_queues_for(cpu).with([&](auto& ready_queues) -> Optional<bool> {
+            if (thread.m_runnable_priority < 0) {
+                VERIFY(!thread.m_ready_queue_node.is_in_list());
+                return false;
+            }
 
-        VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
-        thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
-        return true;
-    });
+            if (thread.m_runnable_cpu != cpu)
+                return {};
+
+            if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
+                return false;
+
+            remove_from_ready_queues(ready_queues, thread);
+            return true;
+        });
+        if (removed.has_value())
+            return removed.value();
+    }
 }
 
 void Scheduler::enqueue_runnable_thread(Thread& thread)
 {
-    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
-    auto priority = thread_priority_to_priority_index(thread.priority());
 
-    g_ready_queues->with([&](auto& ready_queues) {
-        VERIFY(thread.m_runnable_priority < 0);
-        thread.m_runnable_priority = (int)priority;
-        VERIFY(!thread.m_ready_queue_node.is_in_list());
-        auto& ready_queue = ready_queues.queues[priority];
-        bool was_empty = ready_queue.thread_list.is_empty();
-        ready_queue.thread_list.append(thread);
-        if (was_empty)
-            ready_queues.mask |= (1u << priority);
+    auto cpu = select_processor_for(thread);
+    ready_queues_for(cpu).with([&](auto& ready_queues) {
+        add_to_ready_queues(ready_queues, cpu, thread);
+    });
+}
+
+void Scheduler::balance_ready_queues()
+{
+    auto current_cpu = Processor::current_id();
+    bool should_balance = ready_queues_for(current_cpu).with([](auto& ready_queues) {
+        if (ready_queues.ticks_until_balance > 0) {
+            ready_queues.ticks_until_balance--;
+            return false;
+        }
+        ready_queues.ticks_until_balance = load_balance_interval_ticks;
+        return true;
+    });
+    if (!should_balance || Processor::count() <= 1)
+        return;
+
+    auto victim_cpu = find_busiest_processor(1ull << current_cpu, ready_thread_count(current_cpu) + load_imbalance_threshold);
+    if (!victim_cpu.has_value())
+        return;
+
+    // Hold both locks while moving the thread, so that it's always on a ready queue
+    // that dequeue_runnable_thread() can find. Always lock the lower processor first.
+    auto& first_ready_queues = ready_queues_for(min(current_cpu, victim_cpu.value()));
+    auto& second_ready_queues = ready_queues_for(max(current_cpu, victim_cpu.value()));
+    first_ready_queues.with([&](auto& first) {
+        second_ready_queues.with([&](auto& second) {
+            auto& victim = victim_cpu.value() < current_cpu ? first : second;
+            auto& ours = victim_cpu.value() < current_cpu ? second : first;
+            auto* thread = find_runnable_thread(victim, 1u << current_cpu);
+            if (!thread)
+                return;
+            remove_from_ready_queues(victim, *thread);
+            add_to_ready_queues(ours, current_cpu, *thread);
+            victim.stolen++;
+            ours.balance_migrations++;
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Pulled {} over from processor {}", current_cpu, *thread, victim_cpu.value());
+        });
+    });
+}
+
+ReadyQueueStatistics Scheduler::ready_queue_statistics(u32 cpu)
+{
+    return ready_queues_for(cpu).with([&](auto& ready_queues) {
+        return ReadyQueueStatistics {
+            .runnable_threads = ready_thread_count(cpu),
+            .steals = ready_queues.steals,
+            .stolen = ready_queues.stolen,
+            .balance_migrations = ready_queues.balance_migrations,
+        };
     });
 }
 
@@ -217,13 +407,26 @@ void Scheduler::pick_next()
             Processor::set_current_in_scheduler(false);
         });
 
+    // Picking the next thread only needs the ready queue locks, so do that
+    // before taking the scheduler lock, which we need for the state changes.
+    auto* next_thread = &pull_next_runnable_thread();
+
     SpinlockLocker lock(g_scheduler_lock);
 
     if constexpr (SCHEDULER_RUNNABLE_DEBUG) {
         dump_thread_list();
     }
 
-    auto& thread_to_schedule = pull_next_runnable_thread();
+    // The thread may have been blocked, stopped or killed by another processor
+    // after we took it off the ready queue. If so, it's not ours to run anymore.
+    while (!next_thread->is_idle_thread() && next_thread->state() != Thread::State::Runnable) {
+        next_thread->set_active(false);
+        if (next_thread->state() == Thread::State::Dying)
+            notify_finalizer();
+        next_thread = &pull_next_runnable_thread();
+    }
+
+    auto& thread_to_schedule = *next_thread;
     if constexpr (SCHEDULER_DEBUG) {
         dbgln("Scheduler[{}]: Switch to {} @ {:p}",
             Processor::current_id(),
@@ -436,6 +639,8 @@ void Scheduler::timer_tick(RegisterState const& regs)
         return;
     }
 
+    balance_ready_queues();
+
     if (current_thread->tick())
         return;
 
@@ -18,6 +18,7 @@
 namespace Kernel {
 
 struct RegisterState;
+struct ThreadReadyQueues;
 
 extern Thread* g_finalizer;
 extern WaitQueue* g_finalizer_wait_queue;
@@ -29,6 +30,13 @@ struct TotalTimeScheduled {
     u64 total_kernel { 0 };
 };
 
+struct ReadyQueueStatistics {
+    u32 runnable_threads { 0 };
+    u64 steals { 0 };
+    u64 stolen { 0 };
+    u64 balance_migrations { 0 };
+};
+
 class Scheduler {
 public:
     static void initialize();
@@ -51,10 +59,20 @@ public:
     static Thread* peek_next_runnable_thread();
     static bool dequeue_runnable_thread(Thread&, bool = false);
     static void enqueue_runnable_thread(Thread&);
+    static void balance_ready_queues();
+    static ReadyQueueStatistics ready_queue_statistics(u32 cpu);
     static void dump_scheduler_state(bool = false);
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+
+private:
+    static Thread* find_runnable_thread(ThreadReadyQueues&, u32 affinity_mask);
+    static void add_to_ready_queues(ThreadReadyQueues&, u32 cpu, Thread&);
+    static void remove_from_ready_queues(ThreadReadyQueues&, Thread&);
+    static u32 select_processor_for(Thread const&);
+    static Optional<u32> find_busiest_processor(u64 excluded_mask, u32 minimum_load);
+    static Thread* steal_runnable_thread(u32 thief_cpu);
 };
 
 }
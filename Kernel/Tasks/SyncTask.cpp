@@ -4,23 +4,36 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Singleton.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Sections.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/SyncTask.h>
+#include <Kernel/Tasks/WaitQueue.h>
 #include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
+static Singleton<WaitQueue> s_sync_wait_queue;
+static Atomic<bool> s_writeback_requested { false };
+
 UNMAP_AFTER_INIT void SyncTask::spawn()
 {
     MUST(Process::create_kernel_process(KString::must_create("VFS Sync Task"sv), [] {
         dbgln("VFS SyncTask is running");
         for (;;) {
+            s_writeback_requested.store(false, AK::MemoryOrder::memory_order_release);
             VirtualFileSystem::sync();
-            (void)Thread::current()->sleep(Duration::from_seconds(1));
+            auto timeout = Duration::from_seconds(1);
+            (void)s_sync_wait_queue->wait_on(Thread::BlockTimeout(false, &timeout), "SyncTask"sv);
         }
     }));
 }
 
+void SyncTask::request_writeback()
+{
+    if (!s_writeback_requested.exchange(true, AK::MemoryOrder::memory_order_acq_rel))
+        s_sync_wait_queue->wake_all();
+}
+
 }
@@ -10,5 +10,8 @@ namespace Kernel {
 class SyncTask {
 public:
     static void spawn();
+
+    // Wakes up the sync task to write back dirty data before its next periodic sync.
+    static void request_writeback();
 };
 }
@@ -77,7 +77,12 @@ public:
     ProcessID pid() const;
 
     void set_priority(u32 p) { m_priority = p; }
-    u32 priority() const { return m_priority; }
+    u32 priority() const { return max(m_priority, m_inherited_priority.load(AK::MemoryOrder::memory_order_relaxed)); }
+
+    // A thread that holds a priority-inheriting futex runs with the priority of the most important
+    // thread waiting for it, so that threads of a lower priority can't hold up the waiter indefinitely.
+    // This is kept up to date by sys$futex() as threads start and stop waiting.
+    void set_inherited_priority(u32 priority) { m_inherited_priority.store(priority, AK::MemoryOrder::memory_order_relaxed); }
 
     void detach()
     {
@@ -383,14 +388,20 @@ public:
             if (m_blockers.size() <= count)
                 return move(m_blockers);
 
-            size_t move_count = (count <= m_blockers.size()) ? count : m_blockers.size();
-            VERIFY(move_count > 0);
+            VERIFY(count > 0);
 
+            // Split the list in two, taking the first `count` blockers and leaving the rest in place.
             Vector<BlockerInfo, 4> taken_blockers;
-            taken_blockers.ensure_capacity(move_count);
-            for (size_t i = 0; i < move_count; i++)
-                taken_blockers.append(m_blockers.take(i));
-            m_blockers.remove(0, move_count);
+            Vector<BlockerInfo, 4> remaining_blockers;
+            taken_blockers.ensure_capacity(count);
+            remaining_blockers.ensure_capacity(m_blockers.size() - count);
+            for (size_t i = 0; i < m_blockers.size(); i++) {
+                if (i < count)
+                    taken_blockers.unchecked_append(m_blockers[i]);
+                else
+                    remaining_blockers.unchecked_append(m_blockers[i]);
+            }
+            m_blockers = move(remaining_blockers);
             return taken_blockers;
         }
 
@@ -403,8 +414,8 @@ public:
                 return;
             }
             m_blockers.ensure_capacity(m_blockers.size() + blockers_to_append.size());
-            for (size_t i = 0; i < blockers_to_append.size(); i++)
-                m_blockers.append(blockers_to_append.take(i));
+            for (auto& info : blockers_to_append)
+                m_blockers.unchecked_append(info);
             blockers_to_append.clear();
         }
 
@@ -455,7 +466,7 @@ public:
 
     class FutexBlocker final : public Blocker {
     public:
-        explicit FutexBlocker(FutexQueue&, u32);
+        FutexBlocker(FutexQueue&, u32 bitset, u32 wake_sequence);
         virtual ~FutexBlocker();
 
         virtual Type blocker_type() const override { return Type::Futex; }
@@ -464,6 +475,7 @@ public:
         virtual bool setup_blocker() override;
 
         u32 bitset() const { return m_bitset; }
+        u32 wake_sequence() const { return m_wake_sequence; }
 
         void begin_requeue()
         {
@@ -478,6 +490,7 @@ public:
     protected:
         FutexQueue& m_futex_queue;
         u32 m_bitset { 0 };
+        u32 m_wake_sequence { 0 };
         InterruptsState m_previous_interrupts_state { InterruptsState::Disabled };
         bool m_did_unblock { false };
     };
@@ -1088,7 +1101,10 @@ private:
     BlockResult block_impl(BlockTimeout const&, Blocker&);
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
-    int m_runnable_priority { -1 };
+    // These are only changed while holding the lock of the ready queue the thread is on,
+    // but dequeue_runnable_thread() peeks at them to find out which lock that is.
+    Atomic<int, AK::MemoryOrder::memory_order_relaxed> m_runnable_priority { -1 };
+    Atomic<u32, AK::MemoryOrder::memory_order_relaxed> m_runnable_cpu { 0 };
 
     friend class WaitQueue;
 
@@ -1223,6 +1239,7 @@ private:
     State m_state { Thread::State::Invalid };
     SpinlockProtected<NonnullOwnPtr<KString>, LockRank::None> m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    Atomic<u32> m_inherited_priority { 0 };
 
     State m_stop_state { Thread::State::Invalid };
 
@@ -146,9 +146,10 @@ bool Thread::WaitQueueBlocker::unblock()
     return true;
 }
 
-Thread::FutexBlocker::FutexBlocker(FutexQueue& futex_queue, u32 bitset)
+Thread::FutexBlocker::FutexBlocker(FutexQueue& futex_queue, u32 bitset, u32 wake_sequence)
     : m_futex_queue(futex_queue)
     , m_bitset(bitset)
+    , m_wake_sequence(wake_sequence)
 {
 }
 
@@ -15,37 +15,55 @@ namespace Kernel {
 
 WorkQueue* g_io_work;
 WorkQueue* g_ata_work;
+WorkQueue* g_io_ring_work;
+
+// Operations submitted through an IORing may block for a long time (e.g. on disk I/O), so they get
+// a few threads of their own to keep one slow operation from holding up all the others.
+static constexpr size_t io_ring_work_thread_count = 4;
 
 UNMAP_AFTER_INIT void WorkQueue::initialize()
 {
     g_io_work = new WorkQueue("IO WorkQueue Task"sv);
     g_ata_work = new WorkQueue("ATA WorkQueue Task"sv);
+    g_io_ring_work = new WorkQueue("IORing WorkQueue Task"sv, io_ring_work_thread_count);
 }
 
-UNMAP_AFTER_INIT WorkQueue::WorkQueue(StringView name)
+UNMAP_AFTER_INIT WorkQueue::WorkQueue(StringView name, size_t thread_count)
 {
+    VERIFY(thread_count > 0);
     auto name_kstring = KString::try_create(name);
     if (name_kstring.is_error())
         TODO();
-    auto [_, thread] = Process::create_kernel_process(name_kstring.release_value(), [this] {
-        for (;;) {
-            WorkItem* item;
-            bool have_more;
-            m_items.with([&](auto& items) {
-                item = items.take_first();
-                have_more = !items.is_empty();
-            });
-            if (item) {
-                item->function();
-                delete item;
-
-                if (have_more)
-                    continue;
-            }
-            [[maybe_unused]] auto result = m_wait_queue.wait_on({});
+    auto [process, thread] = Process::create_kernel_process(name_kstring.release_value(), thread_main, this).release_value_but_fixme_should_propagate_errors();
+    m_threads.append(move(thread));
+
+    for (size_t i = 1; i < thread_count; ++i) {
+        auto thread_name = KString::formatted("{} #{}", name, i);
+        if (thread_name.is_error())
+            TODO();
+        m_threads.append(process->create_kernel_thread(thread_main, this, THREAD_PRIORITY_NORMAL, thread_name.release_value(), THREAD_AFFINITY_DEFAULT, false).release_value_but_fixme_should_propagate_errors());
+    }
+}
+
+void WorkQueue::thread_main(void* data)
+{
+    auto& queue = *static_cast<WorkQueue*>(data);
+    for (;;) {
+        WorkItem* item;
+        bool have_more;
+        queue.m_items.with([&](auto& items) {
+            item = items.take_first();
+            have_more = !items.is_empty();
+        });
+        if (item) {
+            item->function();
+            delete item;
+
+            if (have_more)
+                continue;
         }
-    }).release_value_but_fixme_should_propagate_errors();
-    m_thread = move(thread);
+        [[maybe_unused]] auto result = queue.m_wait_queue.wait_on({});
+    }
 }
 
 void WorkQueue::do_queue(WorkItem& item)
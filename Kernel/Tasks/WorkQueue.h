@@ -9,6 +9,7 @@
 
 #include <AK/Error.h>
 #include <AK/IntrusiveList.h>
+#include <AK/Vector.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/Tasks/WaitQueue.h>
@@ -17,6 +18,7 @@ namespace Kernel {
 
 extern WorkQueue* g_io_work;
 extern WorkQueue* g_ata_work;
+extern WorkQueue* g_io_ring_work;
 
 class WorkQueue {
     AK_MAKE_NONCOPYABLE(WorkQueue);
@@ -51,7 +53,9 @@ public:
     }
 
 private:
-    explicit WorkQueue(StringView);
+    explicit WorkQueue(StringView, size_t thread_count = 1);
+
+    static void thread_main(void*);
 
     struct WorkItem {
     public:
@@ -61,7 +65,7 @@ private:
 
     void do_queue(WorkItem&);
 
-    RefPtr<Thread> m_thread;
+    Vector<NonnullRefPtr<Thread>> m_threads;
     WaitQueue m_wait_queue;
     SpinlockProtected<IntrusiveList<&WorkItem::m_node>, LockRank::None> m_items {};
 };
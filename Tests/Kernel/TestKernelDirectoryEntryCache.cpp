@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/DeprecatedString.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static bool exists(char const* path)
+{
+    struct stat st;
+    return lstat(path, &st) == 0;
+}
+
+TEST_CASE(lookups_see_created_and_removed_files)
+{
+    char directory[] = "/tmp/dentry_cache.XXXXXX";
+    EXPECT_NE(mkdtemp(directory), nullptr);
+    auto file = DeprecatedString::formatted("{}/file", directory);
+    auto other_file = DeprecatedString::formatted("{}/other_file", directory);
+
+    // Look up the missing file a few times, so that the kernel remembers it doesn't exist.
+    for (int i = 0; i < 3; ++i)
+        EXPECT(!exists(file.characters()));
+
+    int fd = open(file.characters(), O_CREAT | O_WRONLY, 0644);
+    EXPECT(fd >= 0);
+    close(fd);
+    EXPECT(exists(file.characters()));
+
+    EXPECT_EQ(rename(file.characters(), other_file.characters()), 0);
+    EXPECT(!exists(file.characters()));
+    EXPECT(exists(other_file.characters()));
+
+    EXPECT_EQ(link(other_file.characters(), file.characters()), 0);
+    EXPECT(exists(file.characters()));
+
+    EXPECT_EQ(unlink(file.characters()), 0);
+    EXPECT_EQ(unlink(other_file.characters()), 0);
+    EXPECT(!exists(file.characters()));
+    EXPECT(!exists(other_file.characters()));
+
+    EXPECT_EQ(rmdir(directory), 0);
+    EXPECT(!exists(directory));
+}
+
+TEST_CASE(lookups_see_recreated_directories)
+{
+    char directory[] = "/tmp/dentry_cache.XXXXXX";
+    EXPECT_NE(mkdtemp(directory), nullptr);
+    auto subdirectory = DeprecatedString::formatted("{}/subdirectory", directory);
+    auto file = DeprecatedString::formatted("{}/subdirectory/file", directory);
+
+    EXPECT_EQ(mkdir(subdirectory.characters(), 0755), 0);
+    EXPECT(!exists(file.characters()));
+    EXPECT_EQ(rmdir(subdirectory.characters()), 0);
+
+    // The new directory may reuse the inode of the old one, but must not inherit what was cached about it.
+    EXPECT_EQ(mkdir(subdirectory.characters(), 0755), 0);
+    int fd = open(file.characters(), O_CREAT | O_WRONLY, 0644);
+    EXPECT(fd >= 0);
+    close(fd);
+    EXPECT(exists(file.characters()));
+
+    EXPECT_EQ(unlink(file.characters()), 0);
+    EXPECT_EQ(rmdir(subdirectory.characters()), 0);
+    EXPECT_EQ(rmdir(directory), 0);
+}
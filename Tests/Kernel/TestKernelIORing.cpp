@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/io_ring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+struct Ring {
+    int fd { -1 };
+    io_ring_params params {};
+    u8* memory { nullptr };
+    u32 sq_tail { 0 };
+    u32 cq_head { 0 };
+
+    ~Ring()
+    {
+        munmap(memory, params.mapping_size);
+        close(fd);
+    }
+
+    io_ring_header& header() { return *reinterpret_cast<io_ring_header*>(memory); }
+
+    void push(io_ring_sqe const& sqe)
+    {
+        reinterpret_cast<io_ring_sqe*>(memory + params.sqes_offset)[sq_tail & (params.sq_entries - 1)] = sqe;
+        AK::atomic_store(&header().sq_tail, ++sq_tail, AK::MemoryOrder::memory_order_release);
+    }
+
+    io_ring_cqe pop()
+    {
+        VERIFY(AK::atomic_load(&header().cq_tail, AK::MemoryOrder::memory_order_acquire) != cq_head);
+        auto cqe = reinterpret_cast<io_ring_cqe*>(memory + params.cqes_offset)[cq_head & (params.cq_entries - 1)];
+        AK::atomic_store(&header().cq_head, ++cq_head, AK::MemoryOrder::memory_order_release);
+        return cqe;
+    }
+
+    u32 available() { return AK::atomic_load(&header().cq_tail, AK::MemoryOrder::memory_order_acquire) - cq_head; }
+};
+
+static void create_ring(Ring& ring, u32 entries)
+{
+    ring.params.sq_entries = entries;
+    ring.params.flags = IO_RING_CLOEXEC;
+    ring.fd = io_ring_setup(&ring.params);
+    VERIFY(ring.fd >= 0);
+    auto* memory = mmap(nullptr, ring.params.mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring.fd, 0);
+    VERIFY(memory != MAP_FAILED);
+    ring.memory = static_cast<u8*>(memory);
+}
+
+TEST_CASE(setup_rounds_up_and_rejects_bad_sizes)
+{
+    Ring ring;
+    create_ring(ring, 5);
+    EXPECT_EQ(ring.params.sq_entries, 8u);
+    EXPECT_EQ(ring.params.cq_entries, 16u);
+    EXPECT(ring.params.cqes_offset >= ring.params.sqes_offset + 8 * sizeof(io_ring_sqe));
+
+    io_ring_params params {};
+    EXPECT_EQ(io_ring_setup(&params), -1);
+    EXPECT_EQ(errno, EINVAL);
+    params.sq_entries = IO_RING_MAX_ENTRIES + 1;
+    EXPECT_EQ(io_ring_setup(&params), -1);
+    EXPECT_EQ(errno, EINVAL);
+}
+
+TEST_CASE(nop_and_bad_fd_complete_in_order)
+{
+    Ring ring;
+    create_ring(ring, 4);
+
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_NOP;
+    sqe.user_data = 1;
+    ring.push(sqe);
+    sqe.opcode = IO_RING_OP_READ;
+    sqe.fd = 12345;
+    sqe.user_data = 2;
+    ring.push(sqe);
+
+    EXPECT_EQ(io_ring_enter(ring.fd, 2, 2, nullptr), 2);
+    auto first = ring.pop();
+    EXPECT_EQ(first.user_data, 1u);
+    EXPECT_EQ(first.result, 0);
+    auto second = ring.pop();
+    EXPECT_EQ(second.user_data, 2u);
+    EXPECT_EQ(second.result, -EBADF);
+}
+
+TEST_CASE(positional_write_fsync_and_read)
+{
+    Ring ring;
+    create_ring(ring, 4);
+
+    char path[] = "/tmp/io_ring.XXXXXX";
+    int fd = mkstemp(path);
+    EXPECT(fd >= 0);
+    unlink(path);
+
+    char const* message = "Well hello friends!";
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_WRITE;
+    sqe.fd = fd;
+    sqe.offset = 4;
+    sqe.address = reinterpret_cast<FlatPtr>(message);
+    sqe.length = strlen(message);
+    sqe.user_data = 1;
+    ring.push(sqe);
+    EXPECT_EQ(io_ring_enter(ring.fd, 1, 1, nullptr), 1);
+    EXPECT_EQ(ring.pop().result, static_cast<i32>(strlen(message)));
+
+    sqe = {};
+    sqe.opcode = IO_RING_OP_FSYNC;
+    sqe.fd = fd;
+    ring.push(sqe);
+    EXPECT_EQ(io_ring_enter(ring.fd, 1, 1, nullptr), 1);
+    EXPECT_EQ(ring.pop().result, 0);
+
+    char buffer[32] {};
+    sqe = {};
+    sqe.opcode = IO_RING_OP_READ;
+    sqe.fd = fd;
+    sqe.offset = 9;
+    sqe.address = reinterpret_cast<FlatPtr>(buffer);
+    sqe.length = sizeof(buffer);
+    ring.push(sqe);
+    EXPECT_EQ(io_ring_enter(ring.fd, 1, 1, nullptr), 1);
+    EXPECT_EQ(ring.pop().result, 14);
+    EXPECT_EQ(StringView(buffer, 14), "hello friends!"sv);
+
+    // Positional I/O leaves the file offset alone.
+    EXPECT_EQ(lseek(fd, 0, SEEK_CUR), 0);
+    close(fd);
+}
+
+TEST_CASE(operations_wait_for_readiness_without_blocking_the_submitter)
+{
+    Ring ring;
+    create_ring(ring, 4);
+
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    char buffer[8] {};
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_READ;
+    sqe.fd = pipe_fds[0];
+    sqe.offset = -1;
+    sqe.address = reinterpret_cast<FlatPtr>(buffer);
+    sqe.length = sizeof(buffer);
+    sqe.user_data = 1;
+    ring.push(sqe);
+    sqe = {};
+    sqe.opcode = IO_RING_OP_POLL_ADD;
+    sqe.fd = pipe_fds[0];
+    sqe.op_flags = POLLIN;
+    sqe.user_data = 2;
+    ring.push(sqe);
+    EXPECT_EQ(io_ring_enter(ring.fd, 2, 0, nullptr), 2);
+
+    timespec timeout { 0, 50'000'000 };
+    EXPECT_EQ(io_ring_enter(ring.fd, 0, 1, &timeout), 0);
+    EXPECT_EQ(ring.available(), 0u);
+
+    EXPECT_EQ(write(pipe_fds[1], "ring", 4), 4);
+    EXPECT_EQ(io_ring_enter(ring.fd, 0, 2, nullptr), 0);
+
+    // The read and the poll may complete in either order.
+    for (int i = 0; i < 2; ++i) {
+        auto cqe = ring.pop();
+        if (cqe.user_data == 1) {
+            EXPECT_EQ(cqe.result, 4);
+            EXPECT_EQ(StringView(buffer, 4), "ring"sv);
+        } else {
+            EXPECT_EQ(cqe.user_data, 2u);
+            EXPECT(cqe.result & POLLIN);
+        }
+    }
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+TEST_CASE(closing_the_ring_cancels_waiting_operations)
+{
+    Ring ring;
+    create_ring(ring, 4);
+
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    char buffer[8] {};
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_READ;
+    sqe.fd = pipe_fds[0];
+    sqe.offset = -1;
+    sqe.address = reinterpret_cast<FlatPtr>(buffer);
+    sqe.length = sizeof(buffer);
+    sqe.user_data = 7;
+    ring.push(sqe);
+    EXPECT_EQ(io_ring_enter(ring.fd, 1, 0, nullptr), 1);
+
+    // The mapping outlives the fd, so the cancellation can still be seen there.
+    close(ring.fd);
+    ring.fd = -1;
+    for (int attempts = 0; attempts < 100 && ring.available() == 0; ++attempts)
+        usleep(10'000);
+    EXPECT_EQ(ring.available(), 1u);
+    auto cqe = ring.pop();
+    EXPECT_EQ(cqe.user_data, 7u);
+    EXPECT_EQ(cqe.result, -ECANCELED);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+TEST_CASE(connecting_local_sockets_is_not_supported)
+{
+    Ring ring;
+    create_ring(ring, 4);
+
+    int fd = socket(AF_LOCAL, SOCK_STREAM, 0);
+    VERIFY(fd >= 0);
+    sockaddr_un address {};
+    address.sun_family = AF_LOCAL;
+    strlcpy(address.sun_path, "/tmp/portal/does-not-matter", sizeof(address.sun_path));
+
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_CONNECT;
+    sqe.fd = fd;
+    sqe.address = reinterpret_cast<FlatPtr>(&address);
+    sqe.length = sizeof(address);
+    sqe.user_data = 3;
+    ring.push(sqe);
+
+    EXPECT_EQ(io_ring_enter(ring.fd, 1, 1, nullptr), 1);
+    auto cqe = ring.pop();
+    EXPECT_EQ(cqe.user_data, 3u);
+    EXPECT_EQ(cqe.result, -EOPNOTSUPP);
+
+    close(fd);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+
+static constexpr char test_data[] = "Hello, friends! This is some data to be moved around by the kernel.";
+static constexpr size_t test_data_size = sizeof(test_data) - 1;
+
+static int create_temporary_file(char const* data, size_t size)
+{
+    char path[] = "/tmp/sendfile.XXXXXX";
+    int fd = mkstemp(path);
+    VERIFY(fd >= 0);
+    VERIFY(unlink(path) == 0);
+    if (size > 0)
+        VERIFY(write(fd, data, size) == static_cast<ssize_t>(size));
+    VERIFY(lseek(fd, 0, SEEK_SET) == 0);
+    return fd;
+}
+
+TEST_CASE(sendfile_file_to_pipe)
+{
+    int file_fd = create_temporary_file(test_data, test_data_size);
+
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    // With an explicit offset, the file offset stays where it is.
+    off_t offset = 7;
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, &offset, 8), 8);
+    EXPECT_EQ(offset, 15);
+    EXPECT_EQ(lseek(file_fd, 0, SEEK_CUR), 0);
+
+    char buffer[sizeof(test_data)] {};
+    EXPECT_EQ(read(pipe_fds[0], buffer, sizeof(buffer)), 8);
+    EXPECT_EQ(memcmp(buffer, "friends!", 8), 0);
+
+    // Without one, the file offset is advanced, and sending stops at the end of the file.
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, nullptr, 4096), static_cast<ssize_t>(test_data_size));
+    EXPECT_EQ(lseek(file_fd, 0, SEEK_CUR), static_cast<off_t>(test_data_size));
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, nullptr, 4096), 0);
+
+    EXPECT_EQ(read(pipe_fds[0], buffer, sizeof(buffer)), static_cast<ssize_t>(test_data_size));
+    EXPECT_EQ(memcmp(buffer, test_data, test_data_size), 0);
+
+    // The source has to be seekable.
+    EXPECT_EQ(sendfile(file_fd, pipe_fds[0], nullptr, 1), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(file_fd);
+}
+
+TEST_CASE(splice_pipe_to_file)
+{
+    int file_fd = create_temporary_file(nullptr, 0);
+
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    EXPECT_EQ(write(pipe_fds[1], test_data, test_data_size), static_cast<ssize_t>(test_data_size));
+
+    off_t offset = 4;
+    EXPECT_EQ(splice(pipe_fds[0], nullptr, file_fd, &offset, test_data_size, 0), static_cast<ssize_t>(test_data_size));
+    EXPECT_EQ(offset, static_cast<off_t>(4 + test_data_size));
+
+    char buffer[sizeof(test_data) + 4] {};
+    EXPECT_EQ(pread(file_fd, buffer, sizeof(buffer), 4), static_cast<ssize_t>(test_data_size));
+    EXPECT_EQ(memcmp(buffer, test_data, test_data_size), 0);
+
+    // The pipe is empty now, so a non-blocking splice has nothing to move.
+    EXPECT_EQ(splice(pipe_fds[0], nullptr, file_fd, nullptr, 1, SPLICE_F_NONBLOCK), -1);
+    EXPECT_EQ(errno, EAGAIN);
+
+    // Pipes can't be accessed at an offset, and one of the ends has to be a pipe.
+    EXPECT_EQ(splice(pipe_fds[0], &offset, file_fd, nullptr, 1, 0), -1);
+    EXPECT_EQ(errno, ESPIPE);
+    EXPECT_EQ(splice(file_fd, nullptr, file_fd, nullptr, 1, 0), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(file_fd);
+}
+
+TEST_CASE(copy_file_range_between_files)
+{
+    int source_fd = create_temporary_file(test_data, test_data_size);
+    int destination_fd = create_temporary_file(nullptr, 0);
+
+    EXPECT_EQ(copy_file_range(source_fd, nullptr, destination_fd, nullptr, 4096, 0), static_cast<ssize_t>(test_data_size));
+    EXPECT_EQ(copy_file_range(source_fd, nullptr, destination_fd, nullptr, 4096, 0), 0);
+
+    char buffer[sizeof(test_data)] {};
+    EXPECT_EQ(pread(destination_fd, buffer, sizeof(buffer), 0), static_cast<ssize_t>(test_data_size));
+    EXPECT_EQ(memcmp(buffer, test_data, test_data_size), 0);
+
+    // Overlapping ranges within the same file are rejected.
+    off_t source_offset = 0;
+    off_t destination_offset = 4;
+    EXPECT_EQ(copy_file_range(source_fd, &source_offset, source_fd, &destination_offset, 8, 0), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    // There are no flags yet.
+    EXPECT_EQ(copy_file_range(source_fd, &source_offset, destination_fd, &destination_offset, 8, 1), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(source_fd);
+    close(destination_fd);
+}
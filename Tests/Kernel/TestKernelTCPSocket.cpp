@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+TEST_CASE(tcp_congestion_control_option)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(fd >= 0);
+
+    char name[TCP_CA_NAME_MAX] {};
+    socklen_t name_size = sizeof(name);
+    EXPECT_EQ(getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &name_size), 0);
+    EXPECT_EQ(StringView(name, strlen(name)), "cubic"sv);
+
+    EXPECT_EQ(setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, "reno", 4), 0);
+    name_size = sizeof(name);
+    EXPECT_EQ(getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &name_size), 0);
+    EXPECT_EQ(StringView(name, strlen(name)), "reno"sv);
+
+    EXPECT_EQ(setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, "vegas", 5), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    close(fd);
+}
+
+static constexpr size_t transfer_size = 4 * MiB;
+
+static void* send_data(void* argument)
+{
+    int fd = *static_cast<int*>(argument);
+    Vector<u8> data;
+    data.resize(transfer_size);
+    for (size_t i = 0; i < transfer_size; ++i)
+        data[i] = static_cast<u8>(i * 7);
+
+    size_t total_sent = 0;
+    while (total_sent < transfer_size) {
+        auto nsent = send(fd, data.data() + total_sent, transfer_size - total_sent, 0);
+        if (nsent <= 0)
+            return reinterpret_cast<void*>(1);
+        total_sent += nsent;
+    }
+    close(fd);
+    return nullptr;
+}
+
+TEST_CASE(tcp_loopback_transfer_beyond_64k_window)
+{
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(listen_fd >= 0);
+
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    EXPECT_EQ(bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    socklen_t address_size = sizeof(address);
+    EXPECT_EQ(getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_size), 0);
+    EXPECT_EQ(listen(listen_fd, 1), 0);
+
+    int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(client_fd >= 0);
+    EXPECT_EQ(connect(client_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    int server_fd = accept(listen_fd, nullptr, nullptr);
+    EXPECT(server_fd >= 0);
+
+    pthread_t sender;
+    EXPECT_EQ(pthread_create(&sender, nullptr, send_data, &client_fd), 0);
+
+    size_t total_received = 0;
+    bool data_matches = true;
+    u8 buffer[16 * KiB];
+    while (total_received < transfer_size) {
+        auto nreceived = recv(server_fd, buffer, sizeof(buffer), 0);
+        if (nreceived <= 0)
+            break;
+        for (ssize_t i = 0; i < nreceived; ++i) {
+            if (buffer[i] != static_cast<u8>((total_received + i) * 7))
+                data_matches = false;
+        }
+        total_received += nreceived;
+    }
+
+    void* sender_result = nullptr;
+    EXPECT_EQ(pthread_join(sender, &sender_result), 0);
+    EXPECT_EQ(sender_result, nullptr);
+    EXPECT_EQ(total_received, transfer_size);
+    EXPECT(data_matches);
+
+    close(server_fd);
+    close(listen_fd);
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibTest/TestCase.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+struct SocketPair {
+    int sender { -1 };
+    int receiver { -1 };
+
+    ~SocketPair()
+    {
+        close(sender);
+        close(receiver);
+    }
+};
+
+static SocketPair connected_loopback_sockets()
+{
+    SocketPair sockets;
+    sockets.receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    VERIFY(sockets.receiver >= 0);
+
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    VERIFY(bind(sockets.receiver, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    socklen_t address_size = sizeof(address);
+    VERIFY(getsockname(sockets.receiver, reinterpret_cast<sockaddr*>(&address), &address_size) == 0);
+
+    sockets.sender = socket(AF_INET, SOCK_DGRAM, 0);
+    VERIFY(sockets.sender >= 0);
+    VERIFY(connect(sockets.sender, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    return sockets;
+}
+
+TEST_CASE(writev_and_readv_gather_and_scatter_one_datagram)
+{
+    auto sockets = connected_loopback_sockets();
+
+    char first[] = "Well ";
+    char second[] = "hello ";
+    char third[] = "friends!";
+    Array<iovec, 3> send_iov { iovec { first, 5 }, iovec { second, 6 }, iovec { third, 8 } };
+    EXPECT_EQ(writev(sockets.sender, send_iov.data(), send_iov.size()), 19);
+
+    char head[7] {};
+    char tail[32] {};
+    Array<iovec, 2> receive_iov { iovec { head, sizeof(head) }, iovec { tail, sizeof(tail) } };
+    EXPECT_EQ(readv(sockets.receiver, receive_iov.data(), receive_iov.size()), 19);
+    EXPECT_EQ(StringView(head, sizeof(head)), "Well he"sv);
+    EXPECT_EQ(StringView(tail, strlen(tail)), "llo friends!"sv);
+}
+
+TEST_CASE(sendmmsg_and_recvmmsg_transfer_a_batch)
+{
+    auto sockets = connected_loopback_sockets();
+
+    Array<char const*, 3> payloads { "one", "three", "twelve" };
+    Array<iovec, 3> send_iov;
+    Array<mmsghdr, 3> send_messages {};
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        send_iov[i] = { const_cast<char*>(payloads[i]), strlen(payloads[i]) };
+        send_messages[i].msg_hdr.msg_iov = &send_iov[i];
+        send_messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    EXPECT_EQ(sendmmsg(sockets.sender, send_messages.data(), send_messages.size(), 0), 3);
+    for (size_t i = 0; i < payloads.size(); ++i)
+        EXPECT_EQ(send_messages[i].msg_len, strlen(payloads[i]));
+
+    Array<Array<char, 16>, 4> buffers {};
+    Array<iovec, 4> receive_iov;
+    Array<mmsghdr, 4> receive_messages {};
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        receive_iov[i] = { buffers[i].data(), buffers[i].size() };
+        receive_messages[i].msg_hdr.msg_iov = &receive_iov[i];
+        receive_messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    // Only three datagrams are sent, so this must never wait for a fourth one. They may not all
+    // have made it through the loopback adapter by the time we get the first one, though.
+    size_t received = 0;
+    while (received < payloads.size()) {
+        int count = recvmmsg(sockets.receiver, receive_messages.data() + received, receive_messages.size() - received, MSG_WAITFORONE, nullptr);
+        EXPECT(count > 0);
+        if (count <= 0)
+            return;
+        received += count;
+    }
+    EXPECT_EQ(received, payloads.size());
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        EXPECT_EQ(receive_messages[i].msg_len, strlen(payloads[i]));
+        EXPECT_EQ(StringView(buffers[i].data(), receive_messages[i].msg_len), StringView(payloads[i], strlen(payloads[i])));
+    }
+
+    EXPECT_EQ(recvmmsg(sockets.receiver, receive_messages.data(), receive_messages.size(), MSG_DONTWAIT, nullptr), -1);
+    EXPECT_EQ(errno, EAGAIN);
+}
+
+TEST_CASE(sendmmsg_reports_partial_success_when_a_later_message_faults)
+{
+    auto sockets = connected_loopback_sockets();
+
+    // Put the first message right at the end of a page, so that the second one starts on an inaccessible page.
+    auto page_size = sysconf(_SC_PAGESIZE);
+    auto* pages = static_cast<u8*>(mmap(nullptr, 2 * page_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
+    VERIFY(pages != MAP_FAILED);
+    VERIFY(mprotect(pages + page_size, page_size, PROT_NONE) == 0);
+    auto* messages = reinterpret_cast<mmsghdr*>(pages + page_size - sizeof(mmsghdr));
+
+    char payload[] = "sent";
+    iovec iov { payload, 4 };
+    *messages = {};
+    messages[0].msg_hdr.msg_iov = &iov;
+    messages[0].msg_hdr.msg_iovlen = 1;
+
+    EXPECT_EQ(sendmmsg(sockets.sender, messages, 2, 0), 1);
+    EXPECT_EQ(messages[0].msg_len, 4u);
+
+    // If the very first message faults, that's an error.
+    EXPECT_EQ(sendmmsg(sockets.sender, messages + 1, 1, 0), -1);
+    EXPECT_EQ(errno, EFAULT);
+
+    char buffer[16] {};
+    EXPECT_EQ(recv(sockets.receiver, buffer, sizeof(buffer), 0), 4);
+    EXPECT_EQ(StringView(buffer, 4), "sent"sv);
+
+    munmap(pages, 2 * page_size);
+}
+
+// The benchmarks below move the same number of datagrams through the loopback adapter, once with a
+// system call per datagram and once in batches, to show how much of the cost is per system call.
+static constexpr size_t benchmark_datagram_count = 64 * KiB;
+static constexpr size_t benchmark_batch_size = 32;
+static constexpr size_t benchmark_datagram_size = 64;
+
+BENCHMARK_CASE(udp_loopback_throughput_sendto_recvfrom)
+{
+    auto sockets = connected_loopback_sockets();
+    Array<u8, benchmark_datagram_size> datagram {};
+
+    size_t received = 0;
+    for (size_t sent = 0; sent < benchmark_datagram_count; sent += benchmark_batch_size) {
+        for (size_t i = 0; i < benchmark_batch_size; ++i)
+            VERIFY(sendto(sockets.sender, datagram.data(), datagram.size(), 0, nullptr, 0) == benchmark_datagram_size);
+        for (size_t i = 0; i < benchmark_batch_size; ++i) {
+            if (recvfrom(sockets.receiver, datagram.data(), datagram.size(), 0, nullptr, nullptr) == benchmark_datagram_size)
+                ++received;
+        }
+    }
+    EXPECT_EQ(received, benchmark_datagram_count);
+}
+
+BENCHMARK_CASE(udp_loopback_throughput_sendmmsg_recvmmsg)
+{
+    auto sockets = connected_loopback_sockets();
+    Array<Array<u8, benchmark_datagram_size>, benchmark_batch_size> datagrams {};
+    Array<iovec, benchmark_batch_size> iovecs;
+    Array<mmsghdr, benchmark_batch_size> messages {};
+    for (size_t i = 0; i < benchmark_batch_size; ++i) {
+        iovecs[i] = { datagrams[i].data(), datagrams[i].size() };
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t received = 0;
+    for (size_t sent = 0; sent < benchmark_datagram_count; sent += benchmark_batch_size) {
+        VERIFY(sendmmsg(sockets.sender, messages.data(), messages.size(), 0) == benchmark_batch_size);
+        size_t received_in_batch = 0;
+        while (received_in_batch < benchmark_batch_size) {
+            int count = recvmmsg(sockets.receiver, messages.data(), benchmark_batch_size - received_in_batch, MSG_WAITFORONE, nullptr);
+            VERIFY(count > 0);
+            received_in_batch += count;
+        }
+        received += received_in_batch;
+    }
+    EXPECT_EQ(received, benchmark_datagram_count);
+}
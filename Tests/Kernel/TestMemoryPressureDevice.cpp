@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/API/MemoryPressure.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static MemoryPressureEvent read_event(int fd)
+{
+    MemoryPressureEvent event {};
+    VERIFY(read(fd, &event, sizeof(event)) == sizeof(event));
+    return event;
+}
+
+TEST_CASE(first_read_does_not_block)
+{
+    int fd = open("/dev/memory_pressure", O_RDONLY);
+    VERIFY(fd >= 0);
+
+    auto event = read_event(fd);
+    EXPECT(event.level == MEMORY_PRESSURE_NORMAL || event.level == MEMORY_PRESSURE_LOW || event.level == MEMORY_PRESSURE_CRITICAL);
+    EXPECT(event.total_pages > 0);
+    EXPECT(event.uncommitted_pages <= event.total_pages);
+
+    close(fd);
+}
+
+TEST_CASE(nonblocking_read_fails_until_the_level_changes)
+{
+    int fd = open("/dev/memory_pressure", O_RDONLY | O_NONBLOCK);
+    VERIFY(fd >= 0);
+
+    (void)read_event(fd);
+
+    MemoryPressureEvent event {};
+    EXPECT_EQ(read(fd, &event, sizeof(event)), -1);
+    EXPECT_EQ(errno, EAGAIN);
+
+    close(fd);
+}
+
+TEST_CASE(short_reads_are_rejected)
+{
+    int fd = open("/dev/memory_pressure", O_RDONLY);
+    VERIFY(fd >= 0);
+
+    u32 level = 0;
+    EXPECT_EQ(read(fd, &level, sizeof(level)), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(fd);
+}
+
+struct Commitment {
+    size_t size { 0 };
+    void* memory { MAP_FAILED };
+};
+
+TEST_CASE(blocking_read_wakes_up_when_the_level_changes)
+{
+    int fd = open("/dev/memory_pressure", O_RDONLY);
+    VERIFY(fd >= 0);
+
+    auto initial_event = read_event(fd);
+    if (initial_event.level == MEMORY_PRESSURE_CRITICAL) {
+        warnln("Memory pressure is critical already, skipping");
+        close(fd);
+        return;
+    }
+
+    // Commit just enough memory to push us past the next watermark, see MemoryManager::update_memory_pressure_level().
+    auto watermark = initial_event.level == MEMORY_PRESSURE_NORMAL ? initial_event.total_pages / 32 : initial_event.total_pages / 128;
+    Commitment commitment;
+    commitment.size = (initial_event.uncommitted_pages - watermark + 16) * PAGE_SIZE;
+
+    // Commit the memory only once we're blocked in read().
+    pthread_t thread;
+    pthread_create(
+        &thread, nullptr, [](void* argument) -> void* {
+            auto& commitment = *static_cast<Commitment*>(argument);
+            usleep(100000);
+            commitment.memory = mmap(nullptr, commitment.size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+            VERIFY(commitment.memory != MAP_FAILED);
+            return nullptr;
+        },
+        &commitment);
+
+    auto event = read_event(fd);
+    EXPECT(event.level > initial_event.level);
+    EXPECT(event.sequence != initial_event.sequence);
+
+    pthread_join(thread, nullptr);
+    munmap(commitment.memory, commitment.size);
+    close(fd);
+}
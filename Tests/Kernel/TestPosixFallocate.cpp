@@ -6,6 +6,8 @@
 
 #include <LibCore/System.h>
 #include <LibTest/TestCase.h>
+#include <string.h>
+#include <unistd.h>
 
 TEST_CASE(posix_fallocate_basics)
 {
@@ -53,6 +55,35 @@ TEST_CASE(posix_fallocate_basics)
     MUST(Core::System::close(fd));
 }
 
+TEST_CASE(posix_fallocate_keeps_contents_and_allocates_blocks)
+{
+    char pattern[] = "/tmp/posix_fallocate.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    VERIFY(fd >= 0);
+
+    EXPECT_EQ(MUST(Core::System::write(fd, "well hello friends"sv.bytes())), 18);
+
+    // A range that's inside the file already doesn't change its size.
+    MUST(Core::System::posix_fallocate(fd, 0, 10));
+    EXPECT_EQ(MUST(Core::System::fstat(fd)).st_size, 18);
+
+    // Growing the file keeps what was there, and the new space reads back as zeroes.
+    MUST(Core::System::posix_fallocate(fd, 4096, 1024 * 1024));
+    auto stat = MUST(Core::System::fstat(fd));
+    EXPECT_EQ(stat.st_size, 4096 + 1024 * 1024);
+    EXPECT(stat.st_blocks * 512 >= stat.st_size);
+
+    char buffer[32] {};
+    EXPECT_EQ(pread(fd, buffer, 18, 0), 18);
+    EXPECT_EQ(StringView(buffer, 18), "well hello friends"sv);
+    EXPECT_EQ(pread(fd, buffer, sizeof(buffer), 1024 * 1024), static_cast<ssize_t>(sizeof(buffer)));
+    for (auto byte : buffer)
+        EXPECT_EQ(byte, 0);
+
+    MUST(Core::System::close(fd));
+    MUST(Core::System::unlink({ pattern, strlen(pattern) }));
+}
+
 TEST_CASE(posix_fallocate_on_device_file)
 {
     auto fd = MUST(Core::System::open("/dev/zero"sv, O_RDWR));
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+
+static constexpr size_t operations_per_thread = 1'000'000;
+static constexpr size_t live_allocations_per_thread = 64;
+static constexpr Array allocation_sizes { 16, 24, 48, 100, 200, 500, 1000, 3000 };
+
+static Duration monotonic_now()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return Duration::from_timespec(now);
+}
+
+static void* malloc_free_loop(void*)
+{
+    Array<void*, live_allocations_per_thread> allocations {};
+    for (size_t i = 0; i < operations_per_thread; ++i) {
+        auto& slot = allocations[i % live_allocations_per_thread];
+        free(slot);
+        slot = malloc(allocation_sizes[i % allocation_sizes.size()]);
+        VERIFY(slot);
+    }
+    for (auto* allocation : allocations)
+        free(allocation);
+    return nullptr;
+}
+
+static void run_with_threads(StringView name, size_t thread_count, void* (*routine)(void*))
+{
+    Vector<pthread_t> threads;
+    threads.resize(thread_count);
+
+    auto start = monotonic_now();
+    for (auto& thread : threads)
+        VERIFY(pthread_create(&thread, nullptr, routine, nullptr) == 0);
+    for (auto& thread : threads)
+        VERIFY(pthread_join(thread, nullptr) == 0);
+    auto elapsed = monotonic_now() - start;
+
+    auto total_operations = thread_count * operations_per_thread;
+    auto ops_per_second = total_operations * 1'000'000 / max<i64>(elapsed.to_microseconds(), 1);
+    outln("{} x{}: {} ops/sec ({} ops/sec each)", name, thread_count, ops_per_second, ops_per_second / thread_count);
+}
+
+BENCHMARK_CASE(malloc_free_per_thread)
+{
+    for (size_t thread_count : Array { 1, 2, 4, 8 })
+        run_with_threads("malloc/free, threads"sv, thread_count, malloc_free_loop);
+}
+
+// Every pair of threads passes its allocations through a ring, so that all chunks are freed
+// by a different thread than the one that allocated them.
+struct Handoff {
+    static constexpr size_t capacity = 1024;
+    Array<Atomic<void*>, capacity> slots {};
+};
+
+static void* producer_loop(void* argument)
+{
+    auto& handoff = *static_cast<Handoff*>(argument);
+    for (size_t i = 0; i < operations_per_thread; ++i) {
+        void* allocation = malloc(allocation_sizes[i % allocation_sizes.size()]);
+        VERIFY(allocation);
+        auto& slot = handoff.slots[i % Handoff::capacity];
+        while (slot.load() != nullptr)
+            sched_yield();
+        slot.store(allocation);
+    }
+    return nullptr;
+}
+
+static void* consumer_loop(void* argument)
+{
+    auto& handoff = *static_cast<Handoff*>(argument);
+    for (size_t i = 0; i < operations_per_thread; ++i) {
+        auto& slot = handoff.slots[i % Handoff::capacity];
+        void* allocation;
+        while ((allocation = slot.exchange(nullptr)) == nullptr)
+            sched_yield();
+        free(allocation);
+    }
+    return nullptr;
+}
+
+static void* producer_consumer_pair(void*)
+{
+    Handoff handoff;
+    pthread_t producer;
+    pthread_t consumer;
+    VERIFY(pthread_create(&producer, nullptr, producer_loop, &handoff) == 0);
+    VERIFY(pthread_create(&consumer, nullptr, consumer_loop, &handoff) == 0);
+    VERIFY(pthread_join(producer, nullptr) == 0);
+    VERIFY(pthread_join(consumer, nullptr) == 0);
+    return nullptr;
+}
+
+BENCHMARK_CASE(malloc_free_cross_thread)
+{
+    for (size_t pair_count : Array { 1, 2, 4 })
+        run_with_threads("cross-thread malloc/free, thread pairs"sv, pair_count, producer_consumer_pair);
+}
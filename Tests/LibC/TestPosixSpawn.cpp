@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/DeprecatedString.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <spawn.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int wait_for_exit_status(pid_t pid)
+{
+    int status = 0;
+    VERIFY(waitpid(pid, &status, 0) == pid);
+    VERIFY(WIFEXITED(status));
+    return WEXITSTATUS(status);
+}
+
+TEST_CASE(spawn_and_wait)
+{
+    pid_t pid = -1;
+    char const* argv[] = { "/bin/true", nullptr };
+    EXPECT_EQ(posix_spawn(&pid, "/bin/true", nullptr, nullptr, const_cast<char**>(argv), environ), 0);
+    EXPECT(pid > 0);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+}
+
+TEST_CASE(spawn_reports_exec_failure_to_the_caller)
+{
+    pid_t pid = -1;
+    char const* argv[] = { "/bin/does-not-exist", nullptr };
+    EXPECT_EQ(posix_spawn(&pid, "/bin/does-not-exist", nullptr, nullptr, const_cast<char**>(argv), environ), ENOENT);
+    EXPECT_EQ(pid, -1);
+}
+
+TEST_CASE(spawnp_searches_path)
+{
+    pid_t pid = -1;
+    char const* argv[] = { "false", nullptr };
+    EXPECT_EQ(posix_spawnp(&pid, "false", nullptr, nullptr, const_cast<char**>(argv), environ), 0);
+    EXPECT_EQ(wait_for_exit_status(pid), 1);
+}
+
+TEST_CASE(spawnp_runs_file_actions_once)
+{
+    char path[] = "/tmp/posix_spawnp.XXXXXX";
+    int fd = mkstemp(path);
+    VERIFY(fd >= 0);
+    close(fd);
+    unlink(path);
+
+    // If the file actions ran for every PATH entry, creating the file a second time would fail.
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    EXPECT_EQ(posix_spawn_file_actions_addopen(&actions, 3, path, O_WRONLY | O_CREAT | O_EXCL, 0600), 0);
+
+    DeprecatedString original_path = getenv("PATH");
+    VERIFY(setenv("PATH", "/does-not-exist:/also-does-not-exist:/bin", 1) == 0);
+
+    pid_t pid = -1;
+    char const* argv[] = { "true", nullptr };
+    EXPECT_EQ(posix_spawnp(&pid, "true", &actions, nullptr, const_cast<char**>(argv), environ), 0);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+
+    VERIFY(setenv("PATH", original_path.characters(), 1) == 0);
+    posix_spawn_file_actions_destroy(&actions);
+    unlink(path);
+}
+
+TEST_CASE(file_actions_apply_to_the_child_only)
+{
+    char path[] = "/tmp/posix_spawn.XXXXXX";
+    int fd = mkstemp(path);
+    VERIFY(fd >= 0);
+    close(fd);
+
+    char our_directory[PATH_MAX] {};
+    VERIFY(getcwd(our_directory, sizeof(our_directory)));
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    EXPECT_EQ(posix_spawn_file_actions_addopen(&actions, 3, path, O_WRONLY | O_TRUNC, 0), 0);
+    EXPECT_EQ(posix_spawn_file_actions_adddup2(&actions, 3, STDOUT_FILENO), 0);
+    EXPECT_EQ(posix_spawn_file_actions_addclose(&actions, 3), 0);
+    EXPECT_EQ(posix_spawn_file_actions_addchdir(&actions, "/tmp"), 0);
+
+    pid_t pid = -1;
+    char const* argv[] = { "/bin/pwd", nullptr };
+    EXPECT_EQ(posix_spawn(&pid, "/bin/pwd", &actions, nullptr, const_cast<char**>(argv), environ), 0);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+    posix_spawn_file_actions_destroy(&actions);
+
+    // Our own working directory shouldn't have changed.
+    char directory_after_spawn[PATH_MAX] {};
+    VERIFY(getcwd(directory_after_spawn, sizeof(directory_after_spawn)));
+    EXPECT_EQ(StringView(directory_after_spawn, strlen(directory_after_spawn)), StringView(our_directory, strlen(our_directory)));
+
+    fd = open(path, O_RDONLY);
+    VERIFY(fd >= 0);
+    char buffer[16] {};
+    auto nread = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    unlink(path);
+
+    EXPECT_EQ(nread, 5);
+    EXPECT_EQ(StringView(buffer, strlen(buffer)), "/tmp\n"sv);
+}
+
+TEST_CASE(attributes_are_applied)
+{
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    EXPECT_EQ(posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP), 0);
+    EXPECT_EQ(posix_spawnattr_setpgroup(&attr, 0), 0);
+
+    pid_t pid = -1;
+    char const* argv[] = { "/bin/sleep", "1", nullptr };
+    EXPECT_EQ(posix_spawn(&pid, "/bin/sleep", nullptr, &attr, const_cast<char**>(argv), environ), 0);
+    EXPECT_EQ(getpgid(pid), pid);
+    EXPECT_NE(getpgid(pid), getpgrp());
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+    posix_spawnattr_destroy(&attr);
+}
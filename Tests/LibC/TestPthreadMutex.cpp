@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+static constexpr size_t thread_count = 8;
+static constexpr size_t increments_per_thread = 10000;
+
+struct SharedCounter {
+    pthread_mutex_t mutex;
+    size_t value { 0 };
+};
+
+static void* increment_counter(void* argument)
+{
+    auto& counter = *static_cast<SharedCounter*>(argument);
+    for (size_t i = 0; i < increments_per_thread; ++i) {
+        VERIFY(pthread_mutex_lock(&counter.mutex) == 0);
+        ++counter.value;
+        VERIFY(pthread_mutex_unlock(&counter.mutex) == 0);
+    }
+    return nullptr;
+}
+
+static void run_contended_counter(pthread_mutexattr_t const* attributes)
+{
+    SharedCounter counter;
+    EXPECT_EQ(pthread_mutex_init(&counter.mutex, attributes), 0);
+
+    Array<pthread_t, thread_count> threads;
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, increment_counter, &counter), 0);
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    EXPECT_EQ(counter.value, thread_count * increments_per_thread);
+}
+
+TEST_CASE(contended_mutex)
+{
+    run_contended_counter(nullptr);
+}
+
+TEST_CASE(priority_inheriting_mutex_protocol)
+{
+    pthread_mutexattr_t attributes;
+    EXPECT_EQ(pthread_mutexattr_init(&attributes), 0);
+    int protocol = -1;
+    EXPECT_EQ(pthread_mutexattr_getprotocol(&attributes, &protocol), 0);
+    EXPECT_EQ(protocol, PTHREAD_PRIO_NONE);
+
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT), 0);
+    EXPECT_EQ(pthread_mutexattr_getprotocol(&attributes, &protocol), 0);
+    EXPECT_EQ(protocol, PTHREAD_PRIO_INHERIT);
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attributes, 1234), ENOTSUP);
+}
+
+TEST_CASE(contended_priority_inheriting_mutex)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT);
+    run_contended_counter(&attributes);
+}
+
+TEST_CASE(priority_inheriting_mutex_trylock)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT);
+    pthread_mutex_t mutex;
+    pthread_mutex_init(&mutex, &attributes);
+
+    EXPECT_EQ(pthread_mutex_trylock(&mutex), 0);
+
+    pthread_t thread;
+    pthread_create(
+        &thread, nullptr, [](void* argument) -> void* {
+            auto* mutex = static_cast<pthread_mutex_t*>(argument);
+            return reinterpret_cast<void*>(static_cast<FlatPtr>(pthread_mutex_trylock(mutex)));
+        },
+        &mutex);
+    void* result = nullptr;
+    pthread_join(thread, &result);
+    EXPECT_EQ(reinterpret_cast<FlatPtr>(result), static_cast<FlatPtr>(EBUSY));
+
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+}
+
+TEST_CASE(priority_inheriting_mutex_lends_priority_to_owner)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT);
+    pthread_mutex_t mutex;
+    pthread_mutex_init(&mutex, &attributes);
+
+    sched_param original_parameter;
+    EXPECT_EQ(pthread_getschedparam(0, 0, &original_parameter), 0);
+    sched_param const min_priority_parameter { .sched_priority = sched_get_priority_min(0) };
+    EXPECT_EQ(pthread_setschedparam(0, 0, &min_priority_parameter), 0);
+
+    EXPECT_EQ(pthread_mutex_lock(&mutex), 0);
+
+    pthread_t thread;
+    pthread_create(
+        &thread, nullptr, [](void* argument) -> void* {
+            auto* mutex = static_cast<pthread_mutex_t*>(argument);
+            sched_param const max_priority_parameter { .sched_priority = sched_get_priority_max(0) };
+            VERIFY(pthread_setschedparam(0, 0, &max_priority_parameter) == 0);
+            VERIFY(pthread_mutex_lock(mutex) == 0);
+            VERIFY(pthread_mutex_unlock(mutex) == 0);
+            return nullptr;
+        },
+        &mutex);
+
+    // Wait for the other thread to block on the mutex, which should lend us its priority.
+    sched_param output_parameter;
+    for (size_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(pthread_getschedparam(0, 0, &output_parameter), 0);
+        if (output_parameter.sched_priority == sched_get_priority_max(0))
+            break;
+        usleep(1000);
+    }
+    EXPECT_EQ(output_parameter.sched_priority, sched_get_priority_max(0));
+
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(pthread_getschedparam(0, 0, &output_parameter), 0);
+    EXPECT_EQ(output_parameter.sched_priority, sched_get_priority_min(0));
+
+    pthread_join(thread, nullptr);
+    EXPECT_EQ(pthread_setschedparam(0, 0, &original_parameter), 0);
+}
+
+struct Barrier {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    size_t waiting { 0 };
+    size_t woken { 0 };
+    bool released { false };
+};
+
+TEST_CASE(cond_broadcast_wakes_every_waiter)
+{
+    Barrier barrier;
+    pthread_mutex_init(&barrier.mutex, nullptr);
+    pthread_cond_init(&barrier.cond, nullptr);
+
+    Array<pthread_t, thread_count> threads;
+    for (auto& thread : threads) {
+        pthread_create(
+            &thread, nullptr, [](void* argument) -> void* {
+                auto& barrier = *static_cast<Barrier*>(argument);
+                pthread_mutex_lock(&barrier.mutex);
+                ++barrier.waiting;
+                while (!barrier.released)
+                    pthread_cond_wait(&barrier.cond, &barrier.mutex);
+                ++barrier.woken;
+                pthread_mutex_unlock(&barrier.mutex);
+                return nullptr;
+            },
+            &barrier);
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&barrier.mutex);
+        bool everyone_is_waiting = barrier.waiting == thread_count;
+        if (everyone_is_waiting) {
+            barrier.released = true;
+            pthread_cond_broadcast(&barrier.cond);
+        }
+        pthread_mutex_unlock(&barrier.mutex);
+        if (everyone_is_waiting)
+            break;
+        sched_yield();
+    }
+
+    for (auto& thread : threads)
+        pthread_join(thread, nullptr);
+    EXPECT_EQ(barrier.woken, thread_count);
+}
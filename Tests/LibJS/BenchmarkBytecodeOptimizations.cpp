@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TemporaryChange.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+using OptimizationLevel = JS::Bytecode::Interpreter::OptimizationLevel;
+
+// Runs the script once per optimization level, and reports how big the top-level executable ended up, and how long it took to run.
+// Functions called by the script are optimized at the same level, but their bytecode isn't counted.
+static void run_at_every_optimization_level(StringView name, StringView source)
+{
+    for (auto level : { OptimizationLevel::None, OptimizationLevel::Optimize, OptimizationLevel::OptimizeAggressively }) {
+        auto vm = MUST(JS::VM::create());
+        auto ast_interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+        auto script = MUST(JS::Script::parse(source, ast_interpreter->realm()));
+        JS::Bytecode::Interpreter bytecode_interpreter(ast_interpreter->realm());
+        TemporaryChange function_optimization_level { JS::Bytecode::g_function_optimization_level, level };
+
+        auto executable = MUST(JS::Bytecode::Generator::generate(script->parse_node()));
+        auto& passes = JS::Bytecode::Interpreter::optimization_pipeline(level);
+        passes.perform(*executable);
+
+        auto timer = Core::ElapsedTimer::start_new();
+        auto result = bytecode_interpreter.run(*executable);
+        auto elapsed = timer.elapsed_time();
+        EXPECT(!result.is_error());
+
+        outln("{} -O{}: {} bytes of bytecode, {} registers, optimized in {}us, ran in {}ms",
+            name, to_underlying(level), executable->bytecode_size(), executable->number_of_registers, passes.elapsed(), elapsed.to_milliseconds());
+    }
+}
+
+BENCHMARK_CASE(arithmetic)
+{
+    run_at_every_optimization_level("arithmetic"sv, R"(
+        let sum = 0;
+        for (let i = 0; i < 200000; ++i) {
+            sum += (i * 3 + 1) % 7 - (2 * 4 + 1) * (10 / 5);
+            sum ^= (i << 2) | (1 << 4);
+            if (-(3 - 1) !== -2 || !(1 < 2))
+                throw new Error("bad constant folding");
+        }
+    )"sv);
+}
+
+BENCHMARK_CASE(function_calls)
+{
+    run_at_every_optimization_level("function_calls"sv, R"(
+        function distance(a, b, c, d) {
+            const dx = a - c;
+            const dy = b - d;
+            return Math.sqrt(dx * dx + dy * dy) + (1 + 2) * 0;
+        }
+        let total = 0;
+        for (let i = 0; i < 100000; ++i)
+            total += distance(i, i + 1, i * 2, 3 - i);
+    )"sv);
+}
+
+BENCHMARK_CASE(arrays_and_objects)
+{
+    run_at_every_optimization_level("arrays_and_objects"sv, R"(
+        function make(i) {
+            const point = { x: i, y: i * 2, z: [i, i + 1, i + 2, ...[i + 3]] };
+            return point.x + point.y + point.z[3];
+        }
+        let total = 0;
+        for (let i = 0; i < 50000; ++i)
+            total += make(i);
+    )"sv);
+}
+
+BENCHMARK_CASE(exceptions)
+{
+    run_at_every_optimization_level("exceptions"sv, R"(
+        function may_throw(i) {
+            const value = i * 2 + 1;
+            if (i % 3 === 0)
+                throw value;
+            return value;
+        }
+        let caught = 0;
+        for (let i = 0; i < 50000; ++i) {
+            let temporary = i + 1;
+            try {
+                temporary = may_throw(i);
+            } catch (e) {
+                caught += e + temporary;
+            } finally {
+                caught += 1;
+            }
+        }
+    )"sv);
+}
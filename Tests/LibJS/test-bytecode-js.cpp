@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/TemporaryChange.h>
 #include <LibJS/AST.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Interpreter.h>
@@ -137,3 +138,139 @@ TEST_CASE(catch_exception)
                             "if (hitCatch !== true) throw new Exception('failed');\n"
                             "if (hitFinally !== true) throw new Exception('failed');");
 }
+
+TEST_CASE(jit_int32_fast_paths)
+{
+    TemporaryChange enable_jit { JS::Bytecode::g_jit_enabled, true };
+    EXPECT_NO_EXCEPTION_ALL("var sum = 0;\n"
+                            "for (var i = 0; i < 1000; ++i) sum = sum + (i & 7) * 3 - 1;\n"
+                            "if (sum !== 9500) throw new Exception('failed');\n"
+                            "var big = 2147483647;\n"
+                            "if (big + 1 !== 2147483648) throw new Exception('failed');\n"
+                            "if (!Object.is(-1 * 0, -0)) throw new Exception('failed');\n"
+                            "if (('1' == 1) !== true || (null ?? 5) !== 5) throw new Exception('failed');");
+}
+
+TEST_CASE(jit_exceptions_and_returns)
+{
+    TemporaryChange enable_jit { JS::Bytecode::g_jit_enabled, true };
+    EXPECT_NO_EXCEPTION_ALL("function f(x) { if (x > 10) return x - 10; return x + 10; }\n"
+                            "if (f(5) !== 15 || f(15) !== 5) throw new Exception('failed');\n"
+                            "var caught = 0;\n"
+                            "for (var i = 0; i < 3; ++i) {\n"
+                            "    try { if (i === 1) throw i; } catch (e) { caught = caught + e; } finally { caught = caught + 10; }\n"
+                            "}\n"
+                            "if (caught !== 31) throw new Exception('failed');");
+}
+
+TEST_CASE(incremental_marking)
+{
+    SETUP_AND_PARSE("(() => {\n"
+                    "var holder = { list: [], map: {} };\n"
+                    "for (var i = 0; i < 400000; ++i) {\n"
+                    "    var o = { i: i, s: 'v' + i };\n"
+                    "    if (i % 100 !== 0) continue;\n"
+                    "    holder.list.push(o);\n"
+                    "    holder.map['k' + (i % 1000)] = o;\n"
+                    "    var key = 'k' + ((i + 500) % 1000);\n"
+                    "    var moved = holder.map[key];\n"
+                    "    if (moved === undefined) continue;\n"
+                    "    delete holder.map[key];\n"
+                    "    holder.last = moved;\n"
+                    "}\n"
+                    "if (holder.list.length !== 4000) throw new Exception('failed');\n"
+                    "for (var j = 0; j < holder.list.length; ++j) {\n"
+                    "    if (holder.list[j].i !== j * 100 || holder.list[j].s !== 'v' + j * 100) throw new Exception('failed');\n"
+                    "}\n"
+                    "if (holder.last.s !== 'v' + holder.last.i) throw new Exception('failed');\n"
+                    "})()");
+
+    vm->heap().set_incremental_marking_slice_budget(Duration::from_microseconds(50));
+    EXPECT_NO_EXCEPTION(executable);
+    EXPECT(vm->heap().statistics().incremental_marking_slices.count > 0);
+}
+
+TEST_CASE(aggressive_optimizations_fold_constants)
+{
+    TemporaryChange optimization_level { JS::Bytecode::g_function_optimization_level, JS::Bytecode::Interpreter::OptimizationLevel::OptimizeAggressively };
+    EXPECT_NO_EXCEPTION_ALL("if (1 + 2 * 3 - 4 / 2 !== 5) throw new Exception('failed');\n"
+                            "if (!Object.is(-(1 - 1), -0) || !Object.is(0 * -1, -0)) throw new Exception('failed');\n"
+                            "if (!isNaN(0 / 0) || 1 / 0 !== Infinity || -7 % 3 !== -1) throw new Exception('failed');\n"
+                            "if ((1 << 31) !== -2147483648 || (-1 >>> 0) !== 4294967295 || (-8 >> 1) !== -4) throw new Exception('failed');\n"
+                            "if ((5 & 3) !== 1 || (5 | 3) !== 7 || (5 ^ 3) !== 6 || ~5 !== -6 || ~2.5 !== -3) throw new Exception('failed');\n"
+                            "if (!(1 < 2) || 2 <= 1 || NaN >= NaN || !(null == undefined) || 1 === '1' || !(0 === -0)) throw new Exception('failed');\n"
+                            "var x = true ? 1 : 2;\n"
+                            "if (x !== 1 || (null ?? 3) !== 3 || (undefined?.foo) !== undefined) throw new Exception('failed');\n"
+                            "var count = 0;\n"
+                            "while (false) count = count + 1;\n"
+                            "if (count !== 0) throw new Exception('failed');");
+}
+
+TEST_CASE(aggressive_optimizations_copies_and_dead_stores)
+{
+    TemporaryChange optimization_level { JS::Bytecode::g_function_optimization_level, JS::Bytecode::Interpreter::OptimizationLevel::OptimizeAggressively };
+    EXPECT_NO_EXCEPTION_ALL("var o = { a: 1, b: 2, c: 3, f() { return this.a; } };\n"
+                            "var { a, ...rest } = o;\n"
+                            "if (a !== 1 || rest.b !== 2 || rest.a !== undefined) throw new Exception('failed');\n"
+                            "if (o.f() !== 1 || o['f']() !== 1) throw new Exception('failed');\n"
+                            "var inner = [4, 5];\n"
+                            "var array = [1, 2, 3, ...inner, 6, [7, 8][1]];\n"
+                            "if (array.length !== 7 || array[3] !== 4 || array[6] !== 8) throw new Exception('failed');\n"
+                            "var s = `${a}-${o.b}-${array[2]}`;\n"
+                            "if (s !== '1-2-3') throw new Exception('failed');\n"
+                            "var sum = 0;\n"
+                            "for (var i = 0; i < 10; ++i) { var t = i * 2; sum = sum + t + (t - i); }\n"
+                            "if (sum !== 135) throw new Exception('failed');\n"
+                            "o[s] = sum;\n"
+                            "if (o['1-2-3'] !== 135) throw new Exception('failed');");
+}
+
+TEST_CASE(aggressive_optimizations_exceptions)
+{
+    TemporaryChange optimization_level { JS::Bytecode::g_function_optimization_level, JS::Bytecode::Interpreter::OptimizationLevel::OptimizeAggressively };
+    EXPECT_NO_EXCEPTION_ALL("function thrower(x) { if (x % 2) throw x; return x; }\n"
+                            "var log = [];\n"
+                            "for (var i = 0; i < 4; ++i) {\n"
+                            "    var before = [i, i + 1];\n"
+                            "    try {\n"
+                            "        before = [thrower(i), -1];\n"
+                            "        if (i === 2) break;\n"
+                            "    } catch (e) {\n"
+                            "        log.push(before[0] + before[1] + e);\n"
+                            "    } finally {\n"
+                            "        log.push(before[0]);\n"
+                            "    }\n"
+                            "}\n"
+                            "if (log.join() !== '0,4,1,2') throw new Exception('failed');");
+}
+
+TEST_CASE(aggressive_optimizations_generators)
+{
+    TemporaryChange optimization_level { JS::Bytecode::g_function_optimization_level, JS::Bytecode::Interpreter::OptimizationLevel::OptimizeAggressively };
+    EXPECT_NO_EXCEPTION_ALL("function* g(a) { var b = [a, a + 1]; var c = yield b[0]; yield [b[1], c, ...b][2]; return a * 2; }\n"
+                            "var gen = g(5);\n"
+                            "if (gen.next().value !== 5) throw new Exception('failed');\n"
+                            "if (gen.next(7).value !== 5) throw new Exception('failed');\n"
+                            "var last = gen.next();\n"
+                            "if (last.value !== 10 || !last.done) throw new Exception('failed');");
+}
+
+TEST_CASE(aggressive_optimizations_coalesce_registers)
+{
+    SETUP_AND_PARSE("var o = { a: 1 };\n"
+                    "var total = o.a + o.a * 2 + [o.a, 2, 3][1] + (1 + 2);\n"
+                    "for (var i = 0; i < 3; ++i) total = total + o.a + i;\n"
+                    "if (total !== 14) throw new Exception('failed');");
+
+    auto executable = MUST(JS::Bytecode::Generator::generate(program));
+    auto registers_before = executable->number_of_registers;
+    auto bytecode_size_before = executable->bytecode_size();
+
+    auto& passes = JS::Bytecode::Interpreter::optimization_pipeline(JS::Bytecode::Interpreter::OptimizationLevel::OptimizeAggressively);
+    passes.perform(*executable);
+    EXPECT(executable->number_of_registers < registers_before);
+    EXPECT(executable->bytecode_size() < bytecode_size_before);
+
+    auto result = bytecode_interpreter.run(*executable);
+    EXPECT(!result.is_error());
+}
@@ -240,8 +240,11 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
     if (json.is_error() || !json.value().is_object())
         return Error::from_string_literal("Invalid perfcore format (not a JSON object)");
 
-    auto const& object = json.value().as_object();
+    return load_from_perfcore_object(json.value().as_object());
+}
 
+ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_object(JsonObject const& object)
+{
     if (!g_kernel_debuginfo_object.has_value()) {
         auto debuginfo_file_or_error = Core::MappedFile::map("/boot/Kernel.debug"sv);
         if (!debuginfo_file_or_error.is_error()) {
@@ -349,10 +352,11 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
                 .executable = executable,
             };
 
-            auto* old_process = current_processes.get(event.pid).value();
-            old_process->end_valid = event.serial;
-
-            current_processes.remove(event.pid);
+            // NOTE: A live profile may start after the process was created.
+            if (auto old_process = current_processes.get(event.pid); old_process.has_value()) {
+                old_process.value()->end_valid = event.serial;
+                current_processes.remove(event.pid);
+            }
 
             auto sampled_process = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Process {
                 .pid = event.pid,
@@ -366,10 +370,10 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
             all_processes.append(move(sampled_process));
             continue;
         } else if (type_string == "process_exit"sv) {
-            auto* old_process = current_processes.get(event.pid).value();
-            old_process->end_valid = event.serial;
-
-            current_processes.remove(event.pid);
+            if (auto old_process = current_processes.get(event.pid); old_process.has_value()) {
+                old_process.value()->end_valid = event.serial;
+                current_processes.remove(event.pid);
+            }
             continue;
         } else if (type_string == "thread_create"sv) {
             auto parent_tid = perf_event.get_integer<pid_t>("parent_tid"sv).value_or(0);
@@ -143,6 +143,7 @@ struct ProcessFilter {
 class Profile {
 public:
     static ErrorOr<NonnullOwnPtr<Profile>> load_from_perfcore_file(StringView path);
+    static ErrorOr<NonnullOwnPtr<Profile>> load_from_perfcore_object(JsonObject const&);
 
     GUI::Model& model();
     GUI::Model& samples_model();
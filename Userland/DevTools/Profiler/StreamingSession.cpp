@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "StreamingSession.h"
+#include <AK/Atomic.h>
+#include <AK/JsonArray.h>
+#include <AK/QuickSort.h>
+#include <Kernel/API/Ioctl.h>
+#include <LibCore/System.h>
+#include <serenity.h>
+#include <sys/mman.h>
+
+namespace Profiler {
+
+ErrorOr<NonnullOwnPtr<StreamingSession>> StreamingSession::start(u64 event_mask, Optional<u64> window_ms)
+{
+    auto device = TRY(Core::File::open("/dev/perf_events"sv, Core::File::OpenMode::ReadWrite));
+    auto session = TRY(adopt_nonnull_own_or_enomem(new (nothrow) StreamingSession(move(device), window_ms)));
+
+    auto fd = session->m_device->fd();
+    TRY(Core::System::ioctl(fd, PERF_EVENTS_IOCTL_START_STREAMING, &event_mask));
+    session->m_is_streaming = true;
+
+    PerformanceEventRingInfo info {};
+    TRY(Core::System::ioctl(fd, PERF_EVENTS_IOCTL_GET_RING_INFO, &info));
+    for (u32 i = 0; i < info.ring_count; ++i) {
+        auto* mapping = TRY(Core::System::mmap(nullptr, info.mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(i) * info.mapping_size, 0, "Performance event ring"sv));
+        TRY(session->m_rings.try_append({ static_cast<PerformanceEventRingHeader*>(mapping), info.mapping_size }));
+    }
+    return session;
+}
+
+StreamingSession::StreamingSession(NonnullOwnPtr<Core::File> device, Optional<u64> window_ms)
+    : m_device(move(device))
+    , m_window_ms(window_ms)
+{
+}
+
+StreamingSession::~StreamingSession()
+{
+    if (m_is_streaming)
+        (void)Core::System::ioctl(m_device->fd(), PERF_EVENTS_IOCTL_STOP_STREAMING);
+    for (auto& ring : m_rings)
+        (void)Core::System::munmap(ring.header, ring.mapping_size);
+}
+
+u64 StreamingSession::lost_event_count() const
+{
+    u64 count = 0;
+    for (auto const& ring : m_rings)
+        count += AK::atomic_load(&ring.header->lost_events, AK::MemoryOrder::memory_order_relaxed);
+    return count;
+}
+
+void StreamingSession::drain()
+{
+    for (auto& ring : m_rings)
+        drain_ring(ring);
+    if (m_window_ms.has_value())
+        discard_samples_outside_window();
+}
+
+void StreamingSession::drain_ring(Ring& ring)
+{
+    auto& header = *ring.header;
+    auto const* data = reinterpret_cast<u8 const*>(ring.header) + header.data_offset;
+    auto data_size = header.data_size;
+
+    u64 head = AK::atomic_load(&header.head, AK::MemoryOrder::memory_order_acquire);
+    u64 tail = header.tail;
+    while (tail < head) {
+        auto const* bytes = data + (tail & (data_size - 1));
+        PerformanceEventRecord record;
+        memcpy(&record, bytes, sizeof(record));
+        VERIFY(record.size != 0);
+        tail += record.size;
+
+        // Padding at the end of the ring.
+        if (record.type == 0)
+            continue;
+
+        Event event;
+        event.type = record.type;
+        event.pid = record.pid;
+        event.tid = record.tid;
+        event.timestamp = record.timestamp;
+        event.lost_samples = record.lost_samples;
+        event.arg1 = record.arg1;
+        event.arg2 = record.arg2;
+
+        auto const* stack = bytes + sizeof(record);
+        event.stack.ensure_capacity(record.stack_size);
+        for (size_t i = 0; i < record.stack_size; ++i) {
+            u64 address;
+            memcpy(&address, stack + i * sizeof(address), sizeof(address));
+            event.stack.unchecked_append(address);
+        }
+        event.name = DeprecatedString { reinterpret_cast<char const*>(stack + record.stack_size * sizeof(u64)), record.name_length };
+
+        m_newest_timestamp = max(m_newest_timestamp, event.timestamp);
+        m_events.append(move(event));
+    }
+
+    // Let the kernel reuse the space only after we're done copying the records out of it.
+    AK::atomic_store(&header.tail, tail, AK::MemoryOrder::memory_order_release);
+}
+
+void StreamingSession::discard_samples_outside_window()
+{
+    if (m_newest_timestamp < m_window_ms.value())
+        return;
+    auto oldest_timestamp = m_newest_timestamp - m_window_ms.value();
+
+    // Events that describe processes, threads and their memory are kept, as later samples need them to be symbolicated.
+    m_events.remove_all_matching([&](auto const& event) {
+        if (event.timestamp >= oldest_timestamp)
+            return false;
+        return event.type == PERF_EVENT_SAMPLE || event.type == PERF_EVENT_MALLOC || event.type == PERF_EVENT_FREE || event.type == PERF_EVENT_SIGNPOST;
+    });
+}
+
+static StringView type_name(u32 type)
+{
+    switch (type) {
+    case PERF_EVENT_SAMPLE:
+        return "sample"sv;
+    case PERF_EVENT_MALLOC:
+        return "malloc"sv;
+    case PERF_EVENT_FREE:
+        return "free"sv;
+    case PERF_EVENT_MMAP:
+        return "mmap"sv;
+    case PERF_EVENT_MUNMAP:
+        return "munmap"sv;
+    case PERF_EVENT_PROCESS_CREATE:
+        return "process_create"sv;
+    case PERF_EVENT_PROCESS_EXEC:
+        return "process_exec"sv;
+    case PERF_EVENT_PROCESS_EXIT:
+        return "process_exit"sv;
+    case PERF_EVENT_THREAD_CREATE:
+        return "thread_create"sv;
+    case PERF_EVENT_THREAD_EXIT:
+        return "thread_exit"sv;
+    case PERF_EVENT_SIGNPOST:
+        return "signpost"sv;
+    default:
+        // The rest aren't understood by Profile, and the profiler doesn't ask for them anyway.
+        return {};
+    }
+}
+
+JsonObject StreamingSession::to_perfcore_object() const
+{
+    // Every processor has a ring of its own, so the events have to be put back in order. Events with
+    // the same timestamp stay in the order we received them, so that e.g. a process is still created
+    // before its first sample.
+    Vector<Event const*> sorted_events;
+    sorted_events.ensure_capacity(m_events.size());
+    for (auto const& event : m_events)
+        sorted_events.unchecked_append(&event);
+    quick_sort(sorted_events, [](auto const* a, auto const* b) {
+        if (a->timestamp != b->timestamp)
+            return a->timestamp < b->timestamp;
+        return a < b;
+    });
+
+    JsonArray events;
+    for (auto const* event : sorted_events) {
+        auto name = type_name(event->type);
+        if (name.is_null())
+            continue;
+
+        JsonObject object;
+        object.set("type", name);
+        switch (event->type) {
+        case PERF_EVENT_MALLOC:
+            object.set("size", event->arg1);
+            object.set("ptr", event->arg2);
+            break;
+        case PERF_EVENT_FREE:
+            object.set("ptr", event->arg1);
+            break;
+        case PERF_EVENT_MMAP:
+            object.set("ptr", event->arg1);
+            object.set("size", event->arg2);
+            object.set("name", event->name);
+            break;
+        case PERF_EVENT_MUNMAP:
+            object.set("ptr", event->arg1);
+            object.set("size", event->arg2);
+            break;
+        case PERF_EVENT_PROCESS_CREATE:
+            object.set("parent_pid", event->arg1);
+            object.set("executable", event->name);
+            break;
+        case PERF_EVENT_PROCESS_EXEC:
+            object.set("executable", event->name);
+            break;
+        case PERF_EVENT_THREAD_CREATE:
+            object.set("parent_tid", event->arg1);
+            break;
+        case PERF_EVENT_SIGNPOST:
+            object.set("arg1", event->arg1);
+            object.set("arg2", event->arg2);
+            break;
+        default:
+            break;
+        }
+        object.set("pid", event->pid);
+        object.set("tid", event->tid);
+        object.set("timestamp", event->timestamp);
+        object.set("lost_samples", event->lost_samples);
+
+        JsonArray stack;
+        for (auto address : event->stack)
+            stack.must_append(address);
+        object.set("stack", move(stack));
+        events.must_append(move(object));
+    }
+
+    JsonObject perfcore;
+    perfcore.set("strings", JsonArray {});
+    perfcore.set("events", move(events));
+    return perfcore;
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/JsonObject.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <Kernel/API/PerformanceEventRing.h>
+#include <LibCore/File.h>
+
+namespace Profiler {
+
+// Profiles the whole system by reading performance events from the per-processor rings of
+// /dev/perf_events while they are being recorded, instead of collecting them all at the end.
+class StreamingSession {
+public:
+    // If a window is given, only the samples taken during the last `window_ms` milliseconds are kept.
+    static ErrorOr<NonnullOwnPtr<StreamingSession>> start(u64 event_mask, Optional<u64> window_ms = {});
+    ~StreamingSession();
+
+    // Takes all new events off the rings.
+    void drain();
+
+    size_t event_count() const { return m_events.size(); }
+    u64 lost_event_count() const;
+
+    // Returns the events received so far, in the same format as /sys/kernel/profile.
+    JsonObject to_perfcore_object() const;
+
+private:
+    struct Ring {
+        PerformanceEventRingHeader* header { nullptr };
+        size_t mapping_size { 0 };
+    };
+
+    struct Event {
+        u32 type { 0 };
+        pid_t pid { 0 };
+        pid_t tid { 0 };
+        u64 timestamp { 0 };
+        u32 lost_samples { 0 };
+        u64 arg1 { 0 };
+        u64 arg2 { 0 };
+        DeprecatedString name;
+        Vector<FlatPtr> stack;
+    };
+
+    StreamingSession(NonnullOwnPtr<Core::File>, Optional<u64> window_ms);
+
+    void drain_ring(Ring&);
+    void discard_samples_outside_window();
+
+    NonnullOwnPtr<Core::File> m_device;
+    Vector<Ring> m_rings;
+    Vector<Event> m_events;
+    Optional<u64> m_window_ms;
+    u64 m_newest_timestamp { 0 };
+    bool m_is_streaming { false };
+};
+
+}
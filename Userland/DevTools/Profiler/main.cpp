@@ -10,6 +10,7 @@
 #include "IndividualSampleModel.h"
 #include "Profile.h"
 #include "ProfileModel.h"
+#include "StreamingSession.h"
 #include "TimelineContainer.h"
 #include "TimelineHeader.h"
 #include "TimelineTrack.h"
@@ -42,14 +43,22 @@
 
 using namespace Profiler;
 
+static constexpr u64 profiling_event_mask = PERF_EVENT_SAMPLE | PERF_EVENT_MMAP | PERF_EVENT_MUNMAP | PERF_EVENT_PROCESS_CREATE
+    | PERF_EVENT_PROCESS_EXEC | PERF_EVENT_PROCESS_EXIT | PERF_EVENT_THREAD_CREATE | PERF_EVENT_THREAD_EXIT;
+
 static bool generate_profile(pid_t& pid);
+static ErrorOr<NonnullOwnPtr<Profile>> record_live_profile(unsigned window_seconds);
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     int pid = 0;
+    bool live = false;
+    unsigned window_seconds = 0;
     StringView perfcore_file_arg;
     Core::ArgsParser args_parser;
     args_parser.add_option(pid, "PID to profile", "pid", 'p', "PID");
+    args_parser.add_option(live, "Profile the whole system while it is running", "live", 'l');
+    args_parser.add_option(window_seconds, "Only keep the samples of the last SECONDS seconds of a live profile", "window", 'w', "SECONDS");
     args_parser.add_positional_argument(perfcore_file_arg, "Path of perfcore file", "perfcore-file", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -58,19 +67,30 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
+    if (live && (pid || !perfcore_file_arg.is_empty())) {
+        warnln("-l/--live option must not be used together with -p/--pid or a perfcore-file argument!");
+        return 1;
+    }
+
     auto app = TRY(GUI::Application::create(arguments));
     auto app_icon = TRY(GUI::Icon::try_create_default_icon("app-profiler"sv));
 
-    DeprecatedString perfcore_file;
-    if (perfcore_file_arg.is_empty()) {
-        if (!generate_profile(pid))
-            return 0;
-        perfcore_file = DeprecatedString::formatted("/proc/{}/perf_events", pid);
-    } else {
-        perfcore_file = perfcore_file_arg;
-    }
+    auto profile_or_error = [&]() -> ErrorOr<NonnullOwnPtr<Profile>> {
+        if (live)
+            return record_live_profile(window_seconds);
 
-    auto profile_or_error = Profile::load_from_perfcore_file(perfcore_file);
+        DeprecatedString perfcore_file;
+        if (perfcore_file_arg.is_empty()) {
+            if (!generate_profile(pid))
+                return Error::from_errno(ECANCELED);
+            perfcore_file = DeprecatedString::formatted("/proc/{}/perf_events", pid);
+        } else {
+            perfcore_file = perfcore_file_arg;
+        }
+        return Profile::load_from_perfcore_file(perfcore_file);
+    }();
+    if (profile_or_error.is_error() && profile_or_error.error().code() == ECANCELED)
+        return 0;
     if (profile_or_error.is_error()) {
         GUI::MessageBox::show(nullptr, DeprecatedString::formatted("{}", profile_or_error.error()), "Profiler"sv, GUI::MessageBox::Type::Error);
         return 0;
@@ -357,10 +377,7 @@ bool generate_profile(pid_t& pid)
         process_name = "(unknown)";
     }
 
-    static constexpr u64 event_mask = PERF_EVENT_SAMPLE | PERF_EVENT_MMAP | PERF_EVENT_MUNMAP | PERF_EVENT_PROCESS_CREATE
-        | PERF_EVENT_PROCESS_EXEC | PERF_EVENT_PROCESS_EXIT | PERF_EVENT_THREAD_CREATE | PERF_EVENT_THREAD_EXIT;
-
-    if (profiling_enable(pid, event_mask) < 0) {
+    if (profiling_enable(pid, profiling_event_mask) < 0) {
         int saved_errno = errno;
         GUI::MessageBox::show(nullptr, DeprecatedString::formatted("Unable to profile process {}({}): {}", process_name, pid, strerror(saved_errno)), "Profiler"sv, GUI::MessageBox::Type::Error);
         return false;
@@ -375,3 +392,49 @@ bool generate_profile(pid_t& pid)
 
     return true;
 }
+
+ErrorOr<NonnullOwnPtr<Profile>> record_live_profile(unsigned window_seconds)
+{
+    Optional<u64> window_ms;
+    if (window_seconds > 0)
+        window_ms = static_cast<u64>(window_seconds) * 1000;
+
+    JsonObject perfcore;
+    {
+        auto session = TRY(StreamingSession::start(profiling_event_mask, window_ms));
+
+        auto window = TRY(GUI::Window::try_create());
+        window->set_title("Profiling the system");
+        window->resize(240, 100);
+        window->set_icon(TRY(Gfx::Bitmap::load_from_file("/res/icons/16x16/app-profiler.png"sv)));
+        window->center_on_screen();
+
+        auto widget = TRY(window->set_main_widget<GUI::Widget>());
+        widget->set_fill_with_background_color(true);
+        widget->set_layout<GUI::VerticalBoxLayout>(GUI::Margins { 0, 0, 16 });
+
+        auto& events_label = widget->add<GUI::Label>("..."_short_string);
+        // Drain the rings while profiling, so that they don't fill up and the kernel doesn't have to drop events.
+        auto drain_timer = TRY(Core::Timer::create_repeating(100, [&] {
+            session->drain();
+            events_label.set_text(String::formatted("{} events, {} lost", session->event_count(), session->lost_event_count()).release_value_but_fixme_should_propagate_errors());
+        }));
+        drain_timer->start();
+
+        auto& stop_button = widget->add<GUI::Button>("Stop"_short_string);
+        stop_button.set_fixed_size(140, 22);
+        stop_button.on_click = [&](auto) {
+            GUI::Application::the()->quit();
+        };
+
+        window->show();
+        if (GUI::Application::the()->exec() != 0)
+            return Error::from_errno(ECANCELED);
+
+        drain_timer->stop();
+        session->drain();
+        perfcore = session->to_perfcore_object();
+    }
+
+    return Profile::load_from_perfcore_object(perfcore);
+}
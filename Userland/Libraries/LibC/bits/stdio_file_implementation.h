@@ -21,7 +21,7 @@ public:
         : m_fd(fd)
         , m_mode(mode)
     {
-        pthread_mutexattr_t attr = { __PTHREAD_MUTEX_RECURSIVE };
+        pthread_mutexattr_t attr = { __PTHREAD_MUTEX_RECURSIVE, __PTHREAD_PRIO_NONE };
         pthread_mutex_init(&m_mutex, &attr);
     }
     ~FILE();
@@ -115,6 +115,10 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_caches;
+    size_t number_of_thread_cache_block_takes;
+    size_t number_of_thread_cache_block_returns;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -284,6 +288,240 @@ static void* try_allocate_chunk_aligned(size_t align, ChunkedBlock& block)
     return nullptr;
 }
 
+// Returns an empty block for the given size class, preferably one that we kept around after it was last
+// freed. The caller has to hold the malloc lock.
+static ErrorOr<ChunkedBlock*> take_empty_block(Allocator& allocator, size_t good_size)
+{
+    if (s_hot_empty_block_count) {
+        g_malloc_stats.number_of_hot_empty_block_hits++;
+        auto* block = s_hot_empty_blocks[--s_hot_empty_block_count];
+        if (block->m_size != good_size) {
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+            set_mmap_name(block, ChunkedBlock::block_size, buffer);
+        }
+        return block;
+    }
+
+    if (s_cold_empty_block_count) {
+        g_malloc_stats.number_of_cold_empty_block_hits++;
+        auto* block = s_cold_empty_blocks[--s_cold_empty_block_count];
+        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
+        bool this_block_was_purged = rc == 1;
+        if (rc < 0) {
+            perror("madvise");
+            VERIFY_NOT_REACHED();
+        }
+        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
+        if (rc < 0) {
+            perror("mprotect");
+            VERIFY_NOT_REACHED();
+        }
+        if (this_block_was_purged || block->m_size != good_size) {
+            if (this_block_was_purged)
+                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+        }
+        return block;
+    }
+
+    g_malloc_stats.number_of_block_allocs++;
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+    auto* block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
+    new (block) ChunkedBlock(good_size);
+    ++allocator.block_count;
+    return block;
+}
+
+// Keeps a block that no longer has any chunks in use around for later, or gives it back to the system.
+// The caller has to hold the malloc lock and must have removed the block from its list.
+static void release_empty_block(Allocator& allocator, ChunkedBlock& block)
+{
+    if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+        dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", &block);
+        g_malloc_stats.number_of_hot_keeps++;
+        s_hot_empty_blocks[s_hot_empty_block_count++] = &block;
+        return;
+    }
+    if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+        dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", &block);
+        g_malloc_stats.number_of_cold_keeps++;
+        s_cold_empty_blocks[s_cold_empty_block_count++] = &block;
+        mprotect(&block, ChunkedBlock::block_size, PROT_NONE);
+        madvise(&block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+        return;
+    }
+    dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", &block, allocator.size);
+    g_malloc_stats.number_of_frees++;
+    --allocator.block_count;
+    os_free(&block, ChunkedBlock::block_size);
+}
+
+#ifndef NO_TLS
+// Every thread allocates chunks from a set of blocks of its own, without taking the malloc lock.
+// Chunks that are freed by other threads are pushed onto the remote freelist of their block, and
+// picked up by the owning thread once it runs out of chunks in that size class.
+//
+// A block goes back to the global allocator when it becomes empty (unless it's the last block the
+// thread has in that size class). The caches of exited threads are handed to the next new thread
+// along with all blocks that still have chunks in use, since other threads may still free into them.
+// NOTE: This also means that a cache is never unmapped, so the remote free path can always set its flag.
+struct ThreadCache {
+    struct SizeClass {
+        ChunkedBlock::List usable_blocks;
+        ChunkedBlock::List full_blocks;
+        size_t block_count { 0 };
+        Atomic<bool> has_remote_frees { false };
+    };
+
+    SizeClass size_class[num_size_classes];
+    ThreadCache* next_unused { nullptr };
+};
+
+static __thread ThreadCache* s_thread_cache;
+
+// Protected by s_malloc_mutex.
+static ThreadCache* s_unused_thread_caches;
+
+static size_t size_class_index(size_t chunk_size)
+{
+    for (size_t i = 0; i < num_size_classes; ++i) {
+        if (size_classes[i] == chunk_size)
+            return i;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static ErrorOr<ThreadCache*> thread_cache()
+{
+    if (s_thread_cache) [[likely]]
+        return s_thread_cache;
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+    auto* cache = s_unused_thread_caches;
+    if (cache) {
+        s_unused_thread_caches = cache->next_unused;
+        cache->next_unused = nullptr;
+    } else {
+        g_malloc_stats.number_of_thread_caches++;
+        cache = new (TRY(os_alloc(PAGE_ROUND_UP(sizeof(ThreadCache)), "malloc: ThreadCache"))) ThreadCache;
+    }
+    s_thread_cache = cache;
+    return cache;
+}
+
+// Moves all chunks that other threads have freed into the block back onto its regular freelist.
+// Only the owner of the block (or whoever holds the malloc lock, for blocks without an owner) may do this.
+static size_t reclaim_remote_frees(ChunkedBlock& block)
+{
+    auto* entry = block.m_remote_freelist.exchange(nullptr, AK::memory_order_acquire);
+    size_t count = 0;
+    while (entry) {
+        auto* next = entry->next;
+        entry->next = block.m_freelist;
+        block.m_freelist = entry;
+        entry = next;
+        ++count;
+    }
+    block.m_free_chunks += count;
+    return count;
+}
+
+static void push_remote_free(ThreadCache& owner, ChunkedBlock& block, FreelistEntry* entry)
+{
+    // NOTE: Once the chunk is on the remote freelist, the owner may reclaim it and give the block away,
+    //       so we must not touch the block afterwards.
+    auto& size_class = owner.size_class[size_class_index(block.m_size)];
+    auto* head = block.m_remote_freelist.load(AK::memory_order_relaxed);
+    do {
+        entry->next = head;
+    } while (!block.m_remote_freelist.compare_exchange_strong(head, entry, AK::memory_order_acq_rel));
+    size_class.has_remote_frees.store(true, AK::memory_order_release);
+}
+
+static ErrorOr<ChunkedBlock*> take_block_for_thread_cache(ThreadCache& cache, Allocator& allocator, size_t good_size)
+{
+    PthreadMutexLocker locker(s_malloc_mutex);
+
+    // Prefer blocks that already have chunks in use, e.g. from aligned allocations.
+    auto* block = allocator.usable_blocks.first();
+    if (!block)
+        block = TRY(take_empty_block(allocator, good_size));
+
+    g_malloc_stats.number_of_thread_cache_block_takes++;
+    block->m_owner.store(&cache, AK::memory_order_release);
+    auto& size_class = cache.size_class[size_class_index(good_size)];
+    size_class.usable_blocks.append(*block);
+    ++size_class.block_count;
+    return block;
+}
+
+static void release_thread_cache_block(ThreadCache::SizeClass& size_class, ChunkedBlock& block)
+{
+    size_class.usable_blocks.remove(block);
+    --size_class.block_count;
+
+    size_t good_size;
+    auto* allocator = allocator_for_size(block.m_size, good_size);
+    PthreadMutexLocker locker(s_malloc_mutex);
+    g_malloc_stats.number_of_thread_cache_block_returns++;
+    block.m_owner.store(nullptr, AK::memory_order_release);
+    release_empty_block(*allocator, block);
+}
+
+static ErrorOr<void*> malloc_from_thread_cache(Allocator& allocator, size_t good_size)
+{
+    auto* cache = TRY(thread_cache());
+    auto& size_class = cache->size_class[size_class_index(good_size)];
+
+    auto* block = size_class.usable_blocks.first();
+    if (!block && size_class.has_remote_frees.exchange(false, AK::memory_order_acquire)) {
+        for (auto it = size_class.full_blocks.begin(); it != size_class.full_blocks.end();) {
+            auto& full_block = *it;
+            ++it;
+            if (reclaim_remote_frees(full_block))
+                size_class.usable_blocks.append(full_block);
+        }
+        block = size_class.usable_blocks.first();
+    }
+    if (!block)
+        block = TRY(take_block_for_thread_cache(*cache, allocator, good_size));
+
+    void* ptr = try_allocate_chunk_aligned(16, *block);
+    VERIFY(ptr);
+    if (block->is_full())
+        size_class.full_blocks.append(*block);
+    return ptr;
+}
+
+static void free_to_thread_cache(ThreadCache& owner, ChunkedBlock& block, void* ptr)
+{
+    auto* entry = (FreelistEntry*)ptr;
+    if (&owner != s_thread_cache) {
+        push_remote_free(owner, block, entry);
+        return;
+    }
+
+    auto& size_class = owner.size_class[size_class_index(block.m_size)];
+    entry->next = block.m_freelist;
+    block.m_freelist = entry;
+
+    if (block.is_full())
+        size_class.usable_blocks.prepend(block);
+
+    ++block.m_free_chunks;
+
+    // Keep the last block of each size class, so that a single malloc()/free() pair doesn't
+    // bounce it between us and the global allocator every time.
+    if (!block.used_chunks() && size_class.block_count > 1)
+        release_thread_cache_block(size_class, block);
+}
+#endif
+
 enum class CallerWillInitializeMemory {
     No,
     Yes,
@@ -321,6 +559,16 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size, align);
 
+#ifndef NO_TLS
+    if (allocator && align <= 16) {
+        void* ptr = TRY(malloc_from_thread_cache(*allocator, good_size));
+        if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+            memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+        ue_notify_malloc(ptr, size);
+        return ptr;
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (!allocator) {
@@ -377,53 +625,9 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         }
     }
 
-    if (!block && s_hot_empty_block_count) {
-        g_malloc_stats.number_of_hot_empty_block_hits++;
-        block = s_hot_empty_blocks[--s_hot_empty_block_count];
-        if (block->m_size != good_size) {
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-            char buffer[64];
-            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-            set_mmap_name(block, ChunkedBlock::block_size, buffer);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block && s_cold_empty_block_count) {
-        g_malloc_stats.number_of_cold_empty_block_hits++;
-        block = s_cold_empty_blocks[--s_cold_empty_block_count];
-        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
-        bool this_block_was_purged = rc == 1;
-        if (rc < 0) {
-            perror("madvise");
-            VERIFY_NOT_REACHED();
-        }
-        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
-        if (rc < 0) {
-            perror("mprotect");
-            VERIFY_NOT_REACHED();
-        }
-        if (this_block_was_purged || block->m_size != good_size) {
-            if (this_block_was_purged)
-                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
     if (!block) {
-        g_malloc_stats.number_of_block_allocs++;
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
-        new (block) ChunkedBlock(good_size);
+        block = TRY(take_empty_block(*allocator, good_size));
         allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
-    }
-
-    if (!ptr) {
         ptr = try_allocate_chunk_aligned(align, *block);
     }
 
@@ -459,9 +663,8 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
-    PthreadMutexLocker locker(s_malloc_mutex);
-
     if (magic == MAGIC_BIGALLOC_HEADER) {
+        PthreadMutexLocker locker(s_malloc_mutex);
         auto* block = (BigAllocationBlock*)block_base;
 #ifdef RECYCLE_BIG_ALLOCATIONS
         if (auto* allocator = big_allocator_for_size(block->m_size)) {
@@ -494,6 +697,23 @@ static void free_impl(void* ptr)
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
+#ifndef NO_TLS
+    if (auto* owner = block->m_owner.load(AK::memory_order_acquire)) {
+        free_to_thread_cache(*owner, *block, ptr);
+        return;
+    }
+#endif
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+
+#ifndef NO_TLS
+    // The block may have been handed to a thread while we were waiting for the lock.
+    if (auto* owner = block->m_owner.load(AK::memory_order_acquire)) {
+        push_remote_free(*owner, *block, (FreelistEntry*)ptr);
+        return;
+    }
+#endif
+
     auto* entry = (FreelistEntry*)ptr;
     entry->next = block->m_freelist;
     block->m_freelist = entry;
@@ -512,27 +732,8 @@ static void free_impl(void* ptr)
     if (!block->used_chunks()) {
         size_t good_size;
         auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
         allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
+        release_empty_block(*allocator, *block);
     }
 }
 
@@ -682,6 +883,43 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void __malloc_thread_exit()
+{
+#ifndef NO_TLS
+    auto* cache = s_thread_cache;
+    if (!cache)
+        return;
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+    for (auto& size_class : cache->size_class) {
+        size_class.has_remote_frees.store(false, AK::memory_order_relaxed);
+        for (auto it = size_class.full_blocks.begin(); it != size_class.full_blocks.end();) {
+            auto& block = *it;
+            ++it;
+            if (reclaim_remote_frees(block))
+                size_class.usable_blocks.append(block);
+        }
+        for (auto it = size_class.usable_blocks.begin(); it != size_class.usable_blocks.end();) {
+            auto& block = *it;
+            ++it;
+            reclaim_remote_frees(block);
+            if (block.used_chunks())
+                continue;
+            size_class.usable_blocks.remove(block);
+            --size_class.block_count;
+            g_malloc_stats.number_of_thread_cache_block_returns++;
+            block.m_owner.store(nullptr, AK::memory_order_release);
+            size_t good_size;
+            release_empty_block(*allocator_for_size(block.m_size, good_size), block);
+        }
+    }
+
+    cache->next_unused = s_unused_thread_caches;
+    s_unused_thread_caches = cache;
+    s_thread_cache = nullptr;
+#endif
+}
+
 void serenity_dump_malloc_stats()
 {
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
@@ -705,5 +943,9 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    dbgln("thread caches: {}", g_malloc_stats.number_of_thread_caches);
+    dbgln("blocks taken by thread caches: {}", g_malloc_stats.number_of_thread_cache_block_takes);
+    dbgln("blocks returned by thread caches: {}", g_malloc_stats.number_of_thread_cache_block_returns);
 }
 }
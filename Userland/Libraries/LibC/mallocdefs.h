@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Types.h>
 
@@ -53,6 +54,8 @@ struct FreelistEntry {
     FreelistEntry* next;
 };
 
+struct ThreadCache;
+
 struct ChunkedBlock : public CommonHeader {
 
     static constexpr size_t block_size = 64 * KiB;
@@ -66,6 +69,10 @@ struct ChunkedBlock : public CommonHeader {
     }
 
     IntrusiveListNode<ChunkedBlock> m_list_node;
+    // The thread that allocates from this block without taking the malloc lock, if any.
+    // Other threads hand chunks back to it through the remote freelist.
+    Atomic<ThreadCache*> m_owner { nullptr };
+    Atomic<FreelistEntry*> m_remote_freelist { nullptr };
     size_t m_next_lazy_freelist_index { 0 };
     FreelistEntry* m_freelist { nullptr };
     size_t m_free_chunks { 0 };
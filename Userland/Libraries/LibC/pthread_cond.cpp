@@ -155,7 +155,16 @@ int pthread_cond_broadcast(pthread_cond_t* cond)
     pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
     VERIFY(mutex);
 
-    int rc = futex(&cond->value, FUTEX_REQUEUE | FUTEX_PRIVATE_FLAG, 1, nullptr, &mutex->lock, INT_MAX);
+    // Waking everyone up would only make them all fight over the mutex, so wake one of them, and
+    // move the rest over to wait for the mutex instead. As the one we wake up takes the mutex the
+    // pessimistic way, it will wake up the next one when it unlocks it, and so on.
+    // NOTE: The waiters of a priority-inheriting mutex have to be known to the kernel as such, so
+    //       those can't simply be moved over.
+    int rc;
+    if (mutex->protocol == PTHREAD_PRIO_INHERIT)
+        rc = futex_wake(&cond->value, INT_MAX, false);
+    else
+        rc = futex(&cond->value, FUTEX_REQUEUE | FUTEX_PRIVATE_FLAG, 1, reinterpret_cast<timespec const*>(static_cast<FlatPtr>(INT_MAX)), &mutex->lock, 0);
     VERIFY(rc >= 0);
     return 0;
 }
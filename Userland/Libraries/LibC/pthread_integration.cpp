@@ -97,6 +97,29 @@ static constexpr u32 MUTEX_UNLOCKED = 0;
 static constexpr u32 MUTEX_LOCKED_NO_NEED_TO_WAKE = 1;
 static constexpr u32 MUTEX_LOCKED_NEED_TO_WAKE = 2;
 
+// A mutex with the PTHREAD_PRIO_INHERIT protocol holds the TID of its owner instead, and leaves all the
+// waiting to the kernel, which lends the owner the priority of the threads waiting for it.
+static bool is_priority_inheriting(pthread_mutex_t const* mutex)
+{
+    return mutex->protocol == __PTHREAD_PRIO_INHERIT;
+}
+
+static u32 locked_value_for(pthread_mutex_t const* mutex)
+{
+    return is_priority_inheriting(mutex) ? static_cast<u32>(pthread_self()) : MUTEX_LOCKED_NO_NEED_TO_WAKE;
+}
+
+static int lock_priority_inheriting_mutex_slow(pthread_mutex_t* mutex)
+{
+    for (;;) {
+        int rc = futex(&mutex->lock, FUTEX_LOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0);
+        if (rc == 0)
+            return 0;
+        if (errno != EINTR)
+            return errno;
+    }
+}
+
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_init.html
 int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attributes)
 {
@@ -104,6 +127,7 @@ int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attrib
     mutex->owner = 0;
     mutex->level = 0;
     mutex->type = attributes ? attributes->type : __PTHREAD_MUTEX_NORMAL;
+    mutex->protocol = attributes ? attributes->protocol : __PTHREAD_PRIO_NONE;
     return 0;
 }
 
@@ -111,7 +135,7 @@ int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attrib
 int pthread_mutex_trylock(pthread_mutex_t* mutex)
 {
     u32 expected = MUTEX_UNLOCKED;
-    bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
+    bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, locked_value_for(mutex), AK::memory_order_acquire);
 
     if (exchanged) [[likely]] {
         if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
@@ -134,7 +158,7 @@ int pthread_mutex_lock(pthread_mutex_t* mutex)
 {
     // Fast path: attempt to claim the mutex without waiting.
     u32 value = MUTEX_UNLOCKED;
-    bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
+    bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, value, locked_value_for(mutex), AK::memory_order_acquire);
     if (exchanged) [[likely]] {
         if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
             AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
@@ -149,14 +173,19 @@ int pthread_mutex_lock(pthread_mutex_t* mutex)
         }
     }
 
-    // Slow path: wait, record the fact that we're going to wait, and always
-    // remember to wake the next thread up once we release the mutex.
-    if (value != MUTEX_LOCKED_NEED_TO_WAKE)
-        value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
-
-    while (value != MUTEX_UNLOCKED) {
-        futex_wait(&mutex->lock, value, nullptr, 0, false);
-        value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
+    if (is_priority_inheriting(mutex)) {
+        if (int rc = lock_priority_inheriting_mutex_slow(mutex); rc != 0)
+            return rc;
+    } else {
+        // Slow path: wait, record the fact that we're going to wait, and always
+        // remember to wake the next thread up once we release the mutex.
+        if (value != MUTEX_LOCKED_NEED_TO_WAKE)
+            value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
+
+        while (value != MUTEX_UNLOCKED) {
+            futex_wait(&mutex->lock, value, nullptr, 0, false);
+            value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
+        }
     }
 
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
@@ -170,10 +199,18 @@ int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
     // Same as pthread_mutex_lock(), but always set MUTEX_LOCKED_NEED_TO_WAKE,
     // and also don't bother checking for already owning the mutex recursively,
     // because we know we don't. Used in the condition variable implementation.
-    u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
-    while (value != MUTEX_UNLOCKED) {
-        futex_wait(&mutex->lock, value, nullptr, 0, false);
-        value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
+    if (is_priority_inheriting(mutex)) {
+        u32 expected = MUTEX_UNLOCKED;
+        if (!AK::atomic_compare_exchange_strong(&mutex->lock, expected, locked_value_for(mutex), AK::memory_order_acquire)) {
+            if (int rc = lock_priority_inheriting_mutex_slow(mutex); rc != 0)
+                return rc;
+        }
+    } else {
+        u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
+        while (value != MUTEX_UNLOCKED) {
+            futex_wait(&mutex->lock, value, nullptr, 0, false);
+            value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
+        }
     }
 
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
@@ -193,6 +230,16 @@ int pthread_mutex_unlock(pthread_mutex_t* mutex)
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
         AK::atomic_store(&mutex->owner, 0, AK::memory_order_relaxed);
 
+    if (is_priority_inheriting(mutex)) {
+        // If anyone is waiting, FUTEX_WAITERS is set, and the kernel has to pick who gets the mutex next.
+        u32 expected = pthread_self();
+        if (!AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_UNLOCKED, AK::memory_order_release)) {
+            int rc = futex(&mutex->lock, FUTEX_UNLOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0);
+            VERIFY(rc >= 0);
+        }
+        return 0;
+    }
+
     u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_UNLOCKED, AK::memory_order_release);
     if (value == MUTEX_LOCKED_NEED_TO_WAKE) [[unlikely]] {
         int rc = futex_wake(&mutex->lock, 1, false);
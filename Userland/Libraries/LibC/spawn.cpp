@@ -13,160 +13,147 @@
 
 #include <spawn.h>
 
-#include <AK/Function.h>
+#include <AK/DeprecatedString.h>
 #include <AK/Vector.h>
+#include <LibFileSystem/FileSystem.h>
+#include <alloca.h>
 #include <errno.h>
 #include <fcntl.h>
-#include <stdio.h>
-#include <sys/stat.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
+#include <syscall.h>
 #include <unistd.h>
 
 struct posix_spawn_file_actions_state {
-    Vector<Function<int()>, 4> actions;
+    Vector<Syscall::SC_posix_spawn_file_action, 4> actions;
+    // The actions point into these, so they have to stay around until the actions are destroyed.
+    Vector<DeprecatedString, 4> paths;
 };
 
 extern "C" {
 
-[[noreturn]] static void posix_spawn_child(char const* path, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[], int (*exec)(char const*, char* const[], char* const[]))
+static int spawn(pid_t* out_pid, char const* path, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[])
 {
-    if (attr) {
-        short flags = attr->flags;
-        if (flags & POSIX_SPAWN_RESETIDS) {
-            if (seteuid(getuid()) < 0) {
-                perror("posix_spawn seteuid");
-                _exit(127);
-            }
-            if (setegid(getgid()) < 0) {
-                perror("posix_spawn setegid");
-                _exit(127);
-            }
-        }
-        if (flags & POSIX_SPAWN_SETPGROUP) {
-            if (setpgid(0, attr->pgroup) < 0) {
-                perror("posix_spawn setpgid");
-                _exit(127);
-            }
-        }
-        if (flags & POSIX_SPAWN_SETSCHEDPARAM) {
-            if (sched_setparam(0, &attr->schedparam) < 0) {
-                perror("posix_spawn sched_setparam");
-                _exit(127);
-            }
-        }
-        if (flags & POSIX_SPAWN_SETSIGDEF) {
-            struct sigaction default_action;
-            default_action.sa_flags = 0;
-            sigemptyset(&default_action.sa_mask);
-            default_action.sa_handler = SIG_DFL;
-
-            sigset_t sigdefault = attr->sigdefault;
-            for (int i = 0; i < NSIG; ++i) {
-                if (sigismember(&sigdefault, i) && sigaction(i, &default_action, nullptr) < 0) {
-                    perror("posix_spawn sigaction");
-                    _exit(127);
-                }
-            }
-        }
-        if (flags & POSIX_SPAWN_SETSIGMASK) {
-            if (sigprocmask(SIG_SETMASK, &attr->sigmask, nullptr) < 0) {
-                perror("posix_spawn sigprocmask");
-                _exit(127);
-            }
-        }
-        if (flags & POSIX_SPAWN_SETSID) {
-            if (setsid() < 0) {
-                perror("posix_spawn setsid");
-                _exit(127);
-            }
+    size_t arg_count = 0;
+    for (size_t i = 0; argv[i]; ++i)
+        ++arg_count;
+
+    size_t env_count = 0;
+    for (size_t i = 0; envp[i]; ++i)
+        ++env_count;
+
+    auto copy_strings = [&](auto& vec, size_t count, auto& output) {
+        output.length = count;
+        for (size_t i = 0; vec[i]; ++i) {
+            output.strings[i].characters = vec[i];
+            output.strings[i].length = strlen(vec[i]);
         }
+    };
 
-        // FIXME: POSIX_SPAWN_SETSCHEDULER
-    }
+    Syscall::SC_posix_spawn_params params {};
+    params.arguments.strings = (Syscall::StringArgument*)alloca(arg_count * sizeof(Syscall::StringArgument));
+    params.environment.strings = (Syscall::StringArgument*)alloca(env_count * sizeof(Syscall::StringArgument));
+
+    params.path = { path, strlen(path) };
+    copy_strings(argv, arg_count, params.arguments);
+    copy_strings(envp, env_count, params.environment);
 
     if (file_actions) {
-        for (auto const& action : file_actions->state->actions) {
-            if (action() < 0) {
-                perror("posix_spawn file action");
-                _exit(127);
-            }
-        }
+        params.file_actions = file_actions->state->actions.data();
+        params.file_action_count = file_actions->state->actions.size();
+    }
+
+    if (attr) {
+        params.flags = attr->flags;
+        params.pgroup = attr->pgroup;
+        params.schedparam = attr->schedparam;
+        params.sigdefault = attr->sigdefault;
+        params.sigmask = attr->sigmask;
     }
 
-    exec(path, argv, envp);
-    perror("posix_spawn exec");
-    _exit(127);
+    int rc = syscall(SC_posix_spawn, &params);
+    if (rc < 0)
+        return -rc;
+    *out_pid = rc;
+    return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn.html
 int posix_spawn(pid_t* out_pid, char const* path, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[])
 {
-    pid_t child_pid = fork();
-    if (child_pid < 0)
-        return errno;
-
-    if (child_pid != 0) {
-        *out_pid = child_pid;
-        return 0;
-    }
-
-    posix_spawn_child(path, file_actions, attr, argv, envp, execve);
+    return spawn(out_pid, path, file_actions, attr, argv, envp);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawnp.html
 int posix_spawnp(pid_t* out_pid, char const* file, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[])
 {
-    pid_t child_pid = fork();
-    if (child_pid < 0)
-        return errno;
-
-    if (child_pid != 0) {
-        *out_pid = child_pid;
-        return 0;
+    if (strchr(file, '/'))
+        return spawn(out_pid, file, file_actions, attr, argv, envp);
+
+    // NOTE: We look for the executable before spawning anything, so that the file actions only run once.
+    DeprecatedString path = getenv("PATH");
+    if (path.is_empty())
+        path = DEFAULT_PATH;
+    int error = ENOENT;
+    for (auto& part : path.split(':')) {
+        auto candidate = DeprecatedString::formatted("{}/{}", part, file);
+        if (access(candidate.characters(), X_OK) == 0)
+            return spawn(out_pid, candidate.characters(), file_actions, attr, argv, envp);
+        // Like execvp(), report that we found the file but couldn't execute it if there's nothing better.
+        if (errno == EACCES)
+            error = EACCES;
     }
+    return error;
+}
 
-    posix_spawn_child(file, file_actions, attr, argv, envp, execvpe);
+static int append_file_action(posix_spawn_file_actions_t* actions, Syscall::SC_posix_spawn_file_action action, char const* path = nullptr)
+{
+    auto& state = *actions->state;
+    if (path) {
+        DeprecatedString path_string = path;
+        action.path = { path_string.characters(), path_string.length() };
+        state.paths.append(move(path_string));
+    }
+    state.actions.append(action);
+    return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn_file_actions_addchdir.html
 int posix_spawn_file_actions_addchdir(posix_spawn_file_actions_t* actions, char const* path)
 {
-    actions->state->actions.append([path]() { return chdir(path); });
-    return 0;
+    return append_file_action(actions, { .type = Syscall::SpawnFileActionType::Chdir, .fd = -1, .new_fd = -1, .flags = 0, .mode = 0, .path = {} }, path);
 }
 
 int posix_spawn_file_actions_addfchdir(posix_spawn_file_actions_t* actions, int fd)
 {
-    actions->state->actions.append([fd]() { return fchdir(fd); });
-    return 0;
+    if (fd < 0)
+        return EBADF;
+    return append_file_action(actions, { .type = Syscall::SpawnFileActionType::Fchdir, .fd = fd, .new_fd = -1, .flags = 0, .mode = 0, .path = {} });
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn_file_actions_addclose.html
 int posix_spawn_file_actions_addclose(posix_spawn_file_actions_t* actions, int fd)
 {
-    actions->state->actions.append([fd]() { return close(fd); });
-    return 0;
+    if (fd < 0)
+        return EBADF;
+    return append_file_action(actions, { .type = Syscall::SpawnFileActionType::Close, .fd = fd, .new_fd = -1, .flags = 0, .mode = 0, .path = {} });
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn_file_actions_adddup2.html
 int posix_spawn_file_actions_adddup2(posix_spawn_file_actions_t* actions, int old_fd, int new_fd)
 {
-    actions->state->actions.append([old_fd, new_fd]() { return dup2(old_fd, new_fd); });
-    return 0;
+    if (old_fd < 0 || new_fd < 0)
+        return EBADF;
+    return append_file_action(actions, { .type = Syscall::SpawnFileActionType::Dup2, .fd = old_fd, .new_fd = new_fd, .flags = 0, .mode = 0, .path = {} });
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn_file_actions_addopen.html
 int posix_spawn_file_actions_addopen(posix_spawn_file_actions_t* actions, int want_fd, char const* path, int flags, mode_t mode)
 {
-    actions->state->actions.append([want_fd, path, flags, mode]() {
-        int opened_fd = open(path, flags, mode);
-        if (opened_fd < 0 || opened_fd == want_fd)
-            return opened_fd;
-        if (int rc = dup2(opened_fd, want_fd); rc < 0)
-            return rc;
-        return close(opened_fd);
-    });
-    return 0;
+    if (want_fd < 0)
+        return EBADF;
+    return append_file_action(actions, { .type = Syscall::SpawnFileActionType::Open, .fd = want_fd, .new_fd = -1, .flags = flags, .mode = mode, .path = {} }, path);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn_file_actions_destroy.html
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <Kernel/API/POSIX/spawn.h>
 #include <sched.h>
 #include <signal.h>
 #include <sys/cdefs.h>
@@ -20,21 +21,6 @@
 
 __BEGIN_DECLS
 
-enum {
-    POSIX_SPAWN_RESETIDS = 1 << 0,
-    POSIX_SPAWN_SETPGROUP = 1 << 1,
-
-    POSIX_SPAWN_SETSCHEDPARAM = 1 << 2,
-    POSIX_SPAWN_SETSCHEDULER = 1 << 3,
-
-    POSIX_SPAWN_SETSIGDEF = 1 << 4,
-    POSIX_SPAWN_SETSIGMASK = 1 << 5,
-
-    POSIX_SPAWN_SETSID = 1 << 6,
-};
-
-#define POSIX_SPAWN_SETSID POSIX_SPAWN_SETSID
-
 struct posix_spawn_file_actions_state;
 typedef struct {
     struct posix_spawn_file_actions_state* state;
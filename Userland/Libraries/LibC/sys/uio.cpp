@@ -31,4 +31,12 @@ ssize_t pwritev(int fd, struct iovec const* iov, int iov_count, off_t offset)
     int rc = syscall(SC_pwritev, fd, iov, iov_count, &offset);
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
+
+ssize_t preadv(int fd, struct iovec const* iov, int iov_count, off_t offset)
+{
+    __pthread_maybe_cancel();
+
+    int rc = syscall(SC_preadv, fd, iov, iov_count, &offset);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
 }
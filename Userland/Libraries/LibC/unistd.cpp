@@ -418,6 +418,15 @@ ssize_t pwrite(int fd, void const* buf, size_t count, off_t offset)
     return nwritten;
 }
 
+ssize_t copy_file_range(int in_fd, off_t* in_offset, int out_fd, off_t* out_offset, size_t length, unsigned flags)
+{
+    __pthread_maybe_cancel();
+
+    Syscall::SC_copy_file_range_params params { in_fd, in_offset, out_fd, out_offset, length, flags };
+    int rc = syscall(SC_copy_file_range, &params);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 // Note: Be sure to send to directory_name parameter a directory name ended with trailing slash.
 static int ttyname_r_for_directory(char const* directory_name, dev_t device_mode, ino_t inode_number, char* buffer, size_t size)
 {
@@ -79,6 +79,7 @@ ssize_t read(int fd, void* buf, size_t count);
 ssize_t pread(int fd, void* buf, size_t count, off_t);
 ssize_t write(int fd, void const* buf, size_t count);
 ssize_t pwrite(int fd, void const* buf, size_t count, off_t);
+ssize_t copy_file_range(int in_fd, off_t* in_offset, int out_fd, off_t* out_offset, size_t length, unsigned flags);
 int close(int fd);
 int chdir(char const* path);
 int fchdir(int fd);
@@ -19,6 +19,10 @@
 #include <sys/select.h>
 #include <unistd.h>
 
+#ifdef AK_OS_SERENITY
+#    include <sys/epoll.h>
+#endif
+
 namespace Core {
 
 struct ThreadData;
@@ -53,6 +57,9 @@ struct ThreadData {
     {
         pid = getpid();
         initialize_wake_pipe();
+#ifdef AK_OS_SERENITY
+        initialize_epoll();
+#endif
     }
 
     void initialize_wake_pipe()
@@ -73,10 +80,86 @@ struct ThreadData {
         VERIFY(rc == 0);
     }
 
+#ifdef AK_OS_SERENITY
+    void initialize_epoll()
+    {
+        if (epoll_fd != -1)
+            close(epoll_fd);
+        notifiers_by_fd.clear();
+
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        VERIFY(epoll_fd >= 0);
+
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = wake_pipe_fds[0];
+        int rc = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_pipe_fds[0], &event);
+        VERIFY(rc == 0);
+    }
+
+    static u32 epoll_events_for(Notifier::Type type)
+    {
+        switch (type) {
+        case Notifier::Type::Read:
+            return EPOLLIN;
+        case Notifier::Type::Write:
+            return EPOLLOUT;
+        case Notifier::Type::Exceptional:
+            return EPOLLPRI;
+        case Notifier::Type::None:
+            return 0;
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    void update_epoll_interest(int fd)
+    {
+        auto it = notifiers_by_fd.find(fd);
+        if (it == notifiers_by_fd.end()) {
+            // NOTE: The fd may already have been closed, in which case the kernel has dropped it from the interest set.
+            (void)epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+            return;
+        }
+
+        auto& entry = it->value;
+        u32 events = 0;
+        for (auto* notifier : entry.notifiers)
+            events |= epoll_events_for(notifier->type());
+        if (entry.is_registered && entry.registered_events == events)
+            return;
+
+        epoll_event event {};
+        event.events = events;
+        event.data.fd = fd;
+        int rc = epoll_ctl(epoll_fd, entry.is_registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event);
+        if (rc < 0 && errno == EEXIST)
+            rc = epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+        if (rc < 0) {
+            dbgln("EventLoopImplementationUnix: Failed to watch fd {}: {}", fd, strerror(errno));
+            return;
+        }
+        entry.is_registered = true;
+        entry.registered_events = events;
+    }
+#endif
+
     // Each thread has its own timers, notifiers and a wake pipe.
     HashMap<int, NonnullOwnPtr<EventLoopTimer>> timers;
     HashTable<Notifier*> notifiers;
 
+#ifdef AK_OS_SERENITY
+    // The notifiers are also kept in a persistent epoll interest set, so that waiting for events doesn't
+    // have to pass every single one of them to the kernel again. Interests are keyed by fd, so all
+    // notifiers for the same fd share one.
+    struct FDNotifiers {
+        Vector<Notifier*, 2> notifiers;
+        u32 registered_events { 0 };
+        bool is_registered { false };
+    };
+    HashMap<int, FDNotifiers> notifiers_by_fd;
+    int epoll_fd { -1 };
+#endif
+
     // The wake pipe is used to notify another event loop that someone has called wake(), or a signal has been received.
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
     int wake_pipe_fds[2] { -1, -1 };
@@ -143,9 +226,14 @@ void EventLoopManagerUnix::wait_for_events(EventLoopImplementation::PumpMode mod
 {
     auto& thread_data = ThreadData::the();
 
+#ifdef AK_OS_SERENITY
+    Array<epoll_event, 32> epoll_events;
+#else
     fd_set read_fds {};
     fd_set write_fds {};
+#endif
 retry:
+#ifndef AK_OS_SERENITY
     int max_fd = 0;
     auto add_fd_to_set = [&max_fd](int fd, fd_set& set) {
         FD_SET(fd, &set);
@@ -166,13 +254,14 @@ retry:
         if (notifier->type() == Notifier::Type::Exceptional)
             TODO();
     }
+#endif
 
     bool has_pending_events = ThreadEventQueue::current().has_pending_events();
 
     // Figure out how long to wait at maximum.
     // This mainly depends on the PumpMode and whether we have pending events, but also the next expiring timer.
     MonotonicTime now = MonotonicTime::now_coarse();
-    struct timeval timeout = { 0, 0 };
+    Duration timeout = Duration::zero();
     bool should_wait_forever = false;
     if (mode == EventLoopImplementation::PumpMode::WaitForEvents && !has_pending_events) {
         auto next_timer_expiration = get_next_timer_expiration();
@@ -181,15 +270,35 @@ retry:
             auto computed_timeout = next_timer_expiration.value() - now;
             if (computed_timeout.is_negative())
                 computed_timeout = Duration::zero();
-            timeout = computed_timeout.to_timeval();
+            timeout = computed_timeout;
         } else {
             should_wait_forever = true;
         }
     }
 
+#ifdef AK_OS_SERENITY
+    auto timeout_spec = timeout.to_timespec();
+try_epoll_again:
+    // Wait for file system events, calls to wake(), POSIX signals, or timer expirations.
+    int marked_fd_count = epoll_pwait2(thread_data.epoll_fd, epoll_events.data(), epoll_events.size(), should_wait_forever ? nullptr : &timeout_spec, nullptr);
+    if (marked_fd_count < 0) {
+        int saved_errno = errno;
+        if (saved_errno == EINTR)
+            goto try_epoll_again;
+        dbgln("EventLoopImplementationUnix::wait_for_events: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
+        VERIFY_NOT_REACHED();
+    }
+
+    bool wake_pipe_is_readable = false;
+    for (int i = 0; i < marked_fd_count; ++i) {
+        if (epoll_events[i].data.fd == thread_data.wake_pipe_fds[0])
+            wake_pipe_is_readable = true;
+    }
+#else
+    auto timeout_val = timeout.to_timeval();
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
-    int marked_fd_count = select(max_fd + 1, &read_fds, &write_fds, nullptr, should_wait_forever ? nullptr : &timeout);
+    int marked_fd_count = select(max_fd + 1, &read_fds, &write_fds, nullptr, should_wait_forever ? nullptr : &timeout_val);
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (marked_fd_count < 0) {
         int saved_errno = errno;
@@ -199,9 +308,12 @@ try_select_again:
         VERIFY_NOT_REACHED();
     }
 
+    bool wake_pipe_is_readable = FD_ISSET(thread_data.wake_pipe_fds[0], &read_fds);
+#endif
+
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (FD_ISSET(thread_data.wake_pipe_fds[0], &read_fds)) {
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -259,6 +371,20 @@ try_select_again:
         return;
 
     // Handle file system notifiers by making them normal events.
+#ifdef AK_OS_SERENITY
+    for (int i = 0; i < marked_fd_count; ++i) {
+        auto& event = epoll_events[i];
+        auto it = thread_data.notifiers_by_fd.find(event.data.fd);
+        if (it == thread_data.notifiers_by_fd.end())
+            continue;
+        // NOTE: A notifier's type may have changed since it was registered, so check it against what it wants now.
+        for (auto* notifier : it->value.notifiers) {
+            auto wanted_events = ThreadData::epoll_events_for(notifier->type());
+            if (wanted_events != 0 && (event.events & (wanted_events | EPOLLERR | EPOLLHUP)))
+                ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd()));
+        }
+    }
+#else
     for (auto& notifier : thread_data.notifiers) {
         if (notifier->type() == Notifier::Type::Read && FD_ISSET(notifier->fd(), &read_fds)) {
             ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd()));
@@ -267,6 +393,7 @@ try_select_again:
             ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd()));
         }
     }
+#endif
 }
 
 class SignalHandlers : public RefCounted<SignalHandlers> {
@@ -342,6 +469,9 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
     thread_data.timers.clear();
     thread_data.notifiers.clear();
     thread_data.initialize_wake_pipe();
+#ifdef AK_OS_SERENITY
+    thread_data.initialize_epoll();
+#endif
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
         info->next_signal_id = 0;
@@ -508,12 +638,28 @@ bool EventLoopManagerUnix::unregister_timer(int timer_id)
 
 void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
-    ThreadData::the().notifiers.set(&notifier);
+    auto& thread_data = ThreadData::the();
+    if (thread_data.notifiers.set(&notifier) != AK::HashSetResult::InsertedNewEntry)
+        return;
+#ifdef AK_OS_SERENITY
+    thread_data.notifiers_by_fd.ensure(notifier.fd()).notifiers.append(&notifier);
+    thread_data.update_epoll_interest(notifier.fd());
+#endif
 }
 
 void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
 {
-    ThreadData::the().notifiers.remove(&notifier);
+    auto& thread_data = ThreadData::the();
+    if (!thread_data.notifiers.remove(&notifier))
+        return;
+#ifdef AK_OS_SERENITY
+    if (auto it = thread_data.notifiers_by_fd.find(notifier.fd()); it != thread_data.notifiers_by_fd.end()) {
+        it->value.notifiers.remove_first_matching([&](auto* entry) { return entry == &notifier; });
+        if (it->value.notifiers.is_empty())
+            thread_data.notifiers_by_fd.remove(it);
+    }
+    thread_data.update_epoll_interest(notifier.fd());
+#endif
 }
 
 void EventLoopManagerUnix::did_post_event()
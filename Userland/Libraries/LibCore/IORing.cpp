@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <poll.h>
+#include <sys/mman.h>
+
+#if !defined(AK_OS_SERENITY)
+static_assert(false, "This file must only be used for SerenityOS");
+#endif
+
+namespace Core {
+
+ErrorOr<NonnullRefPtr<IORing>> IORing::try_create(u32 entries)
+{
+    io_ring_params params {};
+    params.sq_entries = entries;
+    params.flags = IO_RING_CLOEXEC;
+    int fd = TRY(System::io_ring_setup(params));
+
+    auto ring_or_error = System::mmap(nullptr, params.mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "IORing"sv);
+    if (ring_or_error.is_error()) {
+        (void)System::close(fd);
+        return ring_or_error.release_error();
+    }
+    auto* ring = static_cast<u8*>(ring_or_error.value());
+
+    auto io_ring = adopt_ref_if_nonnull(new (nothrow) IORing(fd, params, ring));
+    if (!io_ring) {
+        (void)System::munmap(ring, params.mapping_size);
+        (void)System::close(fd);
+        return Error::from_errno(ENOMEM);
+    }
+    io_ring->m_notifier = TRY(Notifier::try_create(fd, Notifier::Type::Read));
+    io_ring->m_notifier->on_activation = [io_ring = io_ring.ptr()] {
+        io_ring->process_completions();
+    };
+    return io_ring.release_nonnull();
+}
+
+IORing::IORing(int fd, io_ring_params const& params, u8* ring)
+    : m_fd(fd)
+    , m_params(params)
+    , m_ring(ring)
+{
+}
+
+IORing::~IORing()
+{
+    if (m_notifier)
+        m_notifier->close();
+    // NOTE: Closing the ring cancels everything that is still waiting for a file to become ready.
+    (void)System::close(m_fd);
+    (void)System::munmap(m_ring, m_params.mapping_size);
+}
+
+ErrorOr<void> IORing::read(int fd, Bytes buffer, Optional<off_t> offset, Callback callback)
+{
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_READ;
+    sqe.fd = fd;
+    sqe.offset = offset.value_or(-1);
+    sqe.address = reinterpret_cast<FlatPtr>(buffer.data());
+    sqe.length = buffer.size();
+    return queue(sqe, move(callback));
+}
+
+ErrorOr<void> IORing::write(int fd, ReadonlyBytes buffer, Optional<off_t> offset, Callback callback)
+{
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_WRITE;
+    sqe.fd = fd;
+    sqe.offset = offset.value_or(-1);
+    sqe.address = reinterpret_cast<FlatPtr>(buffer.data());
+    sqe.length = buffer.size();
+    return queue(sqe, move(callback));
+}
+
+ErrorOr<void> IORing::fsync(int fd, Callback callback)
+{
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_FSYNC;
+    sqe.fd = fd;
+    return queue(sqe, move(callback));
+}
+
+ErrorOr<void> IORing::accept(int fd, int flags, Callback callback)
+{
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_ACCEPT;
+    sqe.fd = fd;
+    sqe.op_flags = flags;
+    return queue(sqe, move(callback));
+}
+
+ErrorOr<void> IORing::connect(int fd, sockaddr const* address, socklen_t address_length, Callback callback)
+{
+    if (address_length > sizeof(sockaddr_storage))
+        return Error::from_errno(EINVAL);
+    auto address_copy = TRY(adopt_nonnull_own_or_enomem(new (nothrow) sockaddr_storage {}));
+    memcpy(address_copy.ptr(), address, address_length);
+
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_CONNECT;
+    sqe.fd = fd;
+    sqe.address = reinterpret_cast<FlatPtr>(address_copy.ptr());
+    sqe.length = address_length;
+    return queue(sqe, move(callback), move(address_copy));
+}
+
+ErrorOr<void> IORing::send(int fd, ReadonlyBytes buffer, int flags, Callback callback)
+{
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_SEND;
+    sqe.fd = fd;
+    sqe.address = reinterpret_cast<FlatPtr>(buffer.data());
+    sqe.length = buffer.size();
+    sqe.op_flags = flags;
+    return queue(sqe, move(callback));
+}
+
+ErrorOr<void> IORing::recv(int fd, Bytes buffer, int flags, Callback callback)
+{
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_RECV;
+    sqe.fd = fd;
+    sqe.address = reinterpret_cast<FlatPtr>(buffer.data());
+    sqe.length = buffer.size();
+    sqe.op_flags = flags;
+    return queue(sqe, move(callback));
+}
+
+ErrorOr<void> IORing::poll_add(int fd, short events, Callback callback)
+{
+    io_ring_sqe sqe {};
+    sqe.opcode = IO_RING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.op_flags = static_cast<u16>(events);
+    return queue(sqe, move(callback));
+}
+
+ErrorOr<void> IORing::queue(io_ring_sqe sqe, Callback callback, OwnPtr<sockaddr_storage> address)
+{
+    auto unsubmitted = [this] { return m_sq_tail - AK::atomic_load(&header().sq_head, AK::MemoryOrder::memory_order_acquire); };
+    if (unsubmitted() >= m_params.sq_entries) {
+        TRY(flush());
+        if (unsubmitted() >= m_params.sq_entries)
+            return Error::from_errno(EBUSY);
+    }
+
+    sqe.user_data = m_next_user_data++;
+    TRY(m_pending_operations.try_set(sqe.user_data, PendingOperation { move(callback), move(address) }));
+    sqe_at(m_sq_tail) = sqe;
+    ++m_sq_tail;
+    AK::atomic_store(&header().sq_tail, m_sq_tail, AK::MemoryOrder::memory_order_release);
+
+    // Everything that is queued during this event loop iteration goes to the kernel in one go.
+    if (!m_flush_scheduled) {
+        m_flush_scheduled = true;
+        Core::deferred_invoke([self = NonnullRefPtr(*this)] {
+            self->m_flush_scheduled = false;
+            if (auto result = self->flush(); result.is_error())
+                dbgln("IORing: Failed to submit operations: {}", result.error());
+        });
+    }
+    return {};
+}
+
+ErrorOr<void> IORing::flush()
+{
+    auto unsubmitted = m_sq_tail - AK::atomic_load(&header().sq_head, AK::MemoryOrder::memory_order_acquire);
+    if (unsubmitted == 0)
+        return {};
+
+    auto result = System::io_ring_enter(m_fd, unsubmitted, 0);
+    // The completion queue has no room for more operations right now. Whatever is left is submitted
+    // once we have picked up some completions.
+    if (result.is_error() && result.error().code() == EBUSY)
+        return {};
+    return result.is_error() ? result.release_error() : ErrorOr<void> {};
+}
+
+void IORing::process_completions()
+{
+    // A callback may well drop the last reference to us.
+    NonnullRefPtr protector = *this;
+
+    auto tail = AK::atomic_load(&header().cq_tail, AK::MemoryOrder::memory_order_acquire);
+    while (m_cq_head != tail) {
+        auto cqe = cqe_at(m_cq_head);
+        ++m_cq_head;
+        AK::atomic_store(&header().cq_head, m_cq_head, AK::MemoryOrder::memory_order_release);
+
+        auto operation = m_pending_operations.take(cqe.user_data);
+        if (!operation.has_value())
+            continue;
+        if (cqe.result < 0)
+            operation->callback(Error::from_errno(-cqe.result));
+        else
+            operation->callback(static_cast<size_t>(cqe.result));
+    }
+
+    if (auto result = flush(); result.is_error())
+        dbgln("IORing: Failed to submit operations: {}", result.error());
+}
+
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <LibCore/Notifier.h>
+#include <sys/io_ring.h>
+#include <sys/socket.h>
+
+namespace Core {
+
+// Queues up I/O operations on a kernel I/O ring and delivers their results on the event loop.
+//
+// Operations are collected while the current event loop iteration runs, and submitted to the
+// kernel together with a single system call once it is done. Completions wake up the event loop
+// through the ring fd, just like any other notifier.
+//
+// NOTE: Buffers passed to an operation must stay valid until its callback has been invoked.
+class IORing : public RefCounted<IORing> {
+public:
+    // The result of an operation is what the equivalent system call would have returned.
+    using Callback = Function<void(ErrorOr<size_t>)>;
+
+    static ErrorOr<NonnullRefPtr<IORing>> try_create(u32 entries = 256);
+    ~IORing();
+
+    int fd() const { return m_fd; }
+
+    // An empty offset reads or writes at (and advances) the file offset, like read() and write() do.
+    ErrorOr<void> read(int fd, Bytes, Optional<off_t> offset, Callback);
+    ErrorOr<void> write(int fd, ReadonlyBytes, Optional<off_t> offset, Callback);
+    ErrorOr<void> fsync(int fd, Callback);
+    // The callback receives the accepted fd.
+    ErrorOr<void> accept(int fd, int flags, Callback);
+    ErrorOr<void> connect(int fd, sockaddr const*, socklen_t, Callback);
+    ErrorOr<void> send(int fd, ReadonlyBytes, int flags, Callback);
+    ErrorOr<void> recv(int fd, Bytes, int flags, Callback);
+    // The callback receives the POLL* events that happened.
+    ErrorOr<void> poll_add(int fd, short events, Callback);
+
+    // Hands everything that has been queued so far to the kernel right away.
+    ErrorOr<void> flush();
+
+    // Invokes the callbacks of all operations that have completed.
+    void process_completions();
+
+private:
+    struct PendingOperation {
+        Callback callback;
+        // The kernel reads the address when the operation runs, so it has to stay where it is until then.
+        OwnPtr<sockaddr_storage> address;
+    };
+
+    IORing(int fd, io_ring_params const&, u8* ring);
+
+    io_ring_header& header() { return *reinterpret_cast<io_ring_header*>(m_ring); }
+    io_ring_sqe& sqe_at(u32 index) { return reinterpret_cast<io_ring_sqe*>(m_ring + m_params.sqes_offset)[index & (m_params.sq_entries - 1)]; }
+    io_ring_cqe const& cqe_at(u32 index) const { return reinterpret_cast<io_ring_cqe const*>(m_ring + m_params.cqes_offset)[index & (m_params.cq_entries - 1)]; }
+
+    ErrorOr<void> queue(io_ring_sqe, Callback, OwnPtr<sockaddr_storage> = {});
+
+    int m_fd { -1 };
+    io_ring_params m_params {};
+    u8* m_ring { nullptr };
+    RefPtr<Notifier> m_notifier;
+
+    u32 m_sq_tail { 0 };
+    u32 m_cq_head { 0 };
+    u64 m_next_user_data { 1 };
+    HashMap<u64, PendingOperation> m_pending_operations;
+    bool m_flush_scheduled { false };
+};
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/MemoryPressureNotifier.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+
+#if !defined(AK_OS_SERENITY)
+static_assert(false, "This file must only be used for SerenityOS");
+#endif
+
+namespace Core {
+
+ErrorOr<NonnullRefPtr<MemoryPressureNotifier>> MemoryPressureNotifier::try_create()
+{
+    int fd = TRY(System::open("/dev/memory_pressure"sv, O_RDONLY | O_NONBLOCK | O_CLOEXEC));
+    auto notifier = adopt_ref_if_nonnull(new (nothrow) MemoryPressureNotifier(fd));
+    if (!notifier) {
+        (void)System::close(fd);
+        return Error::from_errno(ENOMEM);
+    }
+
+    // The first read never blocks, and tells us where we are starting out.
+    notifier->read_event();
+
+    notifier->m_notifier = TRY(Notifier::try_create(fd, Notifier::Type::Read));
+    notifier->m_notifier->on_activation = [notifier = notifier.ptr()] {
+        notifier->read_event();
+    };
+    return notifier.release_nonnull();
+}
+
+MemoryPressureNotifier::MemoryPressureNotifier(int fd)
+    : m_fd(fd)
+{
+}
+
+MemoryPressureNotifier::~MemoryPressureNotifier()
+{
+    if (m_notifier)
+        m_notifier->close();
+    (void)System::close(m_fd);
+}
+
+void MemoryPressureNotifier::read_event()
+{
+    MemoryPressureEvent event {};
+    auto nread_or_error = System::read(m_fd, { &event, sizeof(event) });
+    if (nread_or_error.is_error()) {
+        // EAGAIN just means that nothing has changed since our last read.
+        if (nread_or_error.error().code() != EAGAIN)
+            dbgln("MemoryPressureNotifier: Failed to read event: {}", nread_or_error.error());
+        return;
+    }
+    if (nread_or_error.value() != sizeof(event))
+        return;
+
+    auto new_level = static_cast<MemoryPressureLevel>(event.level);
+    if (new_level == m_level)
+        return;
+    m_level = new_level;
+    if (on_level_change)
+        on_level_change(m_level);
+}
+
+}
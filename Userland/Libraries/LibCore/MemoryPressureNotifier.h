@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <Kernel/API/MemoryPressure.h>
+#include <LibCore/Notifier.h>
+
+namespace Core {
+
+// Tells the event loop when the system is running low on memory, so a process can give
+// back memory it only uses as a cache before the kernel starts failing allocations.
+//
+// NOTE: This opens /dev/memory_pressure, so it has to be created before unveil() locks
+//       down the filesystem.
+class MemoryPressureNotifier : public RefCounted<MemoryPressureNotifier> {
+public:
+    static ErrorOr<NonnullRefPtr<MemoryPressureNotifier>> try_create();
+    ~MemoryPressureNotifier();
+
+    MemoryPressureLevel level() const { return m_level; }
+
+    // Invoked on the event loop whenever the level changes.
+    Function<void(MemoryPressureLevel)> on_level_change;
+
+private:
+    explicit MemoryPressureNotifier(int fd);
+
+    void read_event();
+
+    int m_fd { -1 };
+    MemoryPressureLevel m_level { MEMORY_PRESSURE_NORMAL };
+    RefPtr<Notifier> m_notifier;
+};
+
+}
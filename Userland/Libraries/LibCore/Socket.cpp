@@ -220,6 +220,13 @@ ErrorOr<NonnullOwnPtr<TCPSocket>> TCPSocket::adopt_fd(int fd)
     return socket;
 }
 
+Optional<int> TCPSocket::fd() const
+{
+    if (!is_open())
+        return {};
+    return m_helper.fd();
+}
+
 ErrorOr<size_t> PosixSocketHelper::pending_bytes() const
 {
     if (!is_open()) {
@@ -253,6 +260,56 @@ ErrorOr<NonnullOwnPtr<UDPSocket>> UDPSocket::connect(SocketAddress const& addres
     return socket;
 }
 
+ErrorOr<size_t> UDPSocket::write_datagrams(ReadonlySpan<ReadonlyBytes> datagrams)
+{
+    if (!is_open())
+        return Error::from_errno(ENOTCONN);
+
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    Vector<iovec, 32> iovecs;
+    Vector<mmsghdr, 32> messages;
+    TRY(iovecs.try_resize(datagrams.size()));
+    TRY(messages.try_resize(datagrams.size()));
+    for (size_t i = 0; i < datagrams.size(); ++i) {
+        iovecs[i] = { const_cast<u8*>(datagrams[i].data()), datagrams[i].size() };
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    return System::sendmmsg(m_helper.fd(), messages.data(), messages.size(), default_flags());
+#else
+    for (auto datagram : datagrams)
+        TRY(m_helper.write(datagram, default_flags()));
+    return datagrams.size();
+#endif
+}
+
+ErrorOr<size_t> UDPSocket::read_datagrams(Span<Bytes> buffers)
+{
+    if (!is_open())
+        return Error::from_errno(ENOTCONN);
+
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    Vector<iovec, 32> iovecs;
+    Vector<mmsghdr, 32> messages;
+    TRY(iovecs.try_resize(buffers.size()));
+    TRY(messages.try_resize(buffers.size()));
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        iovecs[i] = { buffers[i].data(), buffers[i].size() };
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    auto received = TRY(System::recvmmsg(m_helper.fd(), messages.data(), messages.size(), default_flags() | MSG_WAITFORONE, nullptr));
+    for (size_t i = 0; i < received; ++i)
+        buffers[i] = buffers[i].trim(messages[i].msg_len);
+    return received;
+#else
+    if (buffers.is_empty())
+        return 0;
+    buffers[0] = TRY(m_helper.read(buffers[0], default_flags()));
+    return 1;
+#endif
+}
+
 ErrorOr<NonnullOwnPtr<LocalSocket>> LocalSocket::connect(DeprecatedString const& path, PreventSIGPIPE prevent_sigpipe)
 {
     auto socket = TRY(adopt_nonnull_own_or_enomem(new (nothrow) LocalSocket(prevent_sigpipe)));
@@ -191,6 +191,8 @@ public:
     ErrorOr<void> set_blocking(bool enabled) override { return m_helper.set_blocking(enabled); }
     ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.set_close_on_exec(enabled); }
 
+    Optional<int> fd() const;
+
     virtual ~TCPSocket() override { close(); }
 
 private:
@@ -252,6 +254,15 @@ public:
     }
 
     virtual ErrorOr<size_t> write_some(ReadonlyBytes buffer) override { return m_helper.write(buffer, default_flags()); }
+
+    /// Sends each of the buffers as a datagram of its own, with as few
+    /// system calls as possible. Returns how many datagrams were sent.
+    ErrorOr<size_t> write_datagrams(ReadonlySpan<ReadonlyBytes> datagrams);
+    /// Receives up to one datagram into each of the buffers, and trims them
+    /// to the size of the datagram they received. Only waits for the first
+    /// datagram to arrive. Returns how many datagrams were received.
+    ErrorOr<size_t> read_datagrams(Span<Bytes> buffers);
+
     virtual bool is_eof() const override { return m_helper.is_eof(); }
     virtual bool is_open() const override { return m_helper.is_open(); }
     virtual void close() override { m_helper.close(); }
@@ -420,6 +431,9 @@ public:
 
     virtual size_t buffer_size() const override { return m_helper.buffer_size(); }
 
+    // NOTE: Anything written directly to the fd bypasses the buffer; this is only safe to use for writing.
+    Optional<int> fd() const { return m_helper.stream().fd(); }
+
     virtual ~BufferedSocket() override = default;
 
 private:
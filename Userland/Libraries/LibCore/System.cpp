@@ -30,6 +30,7 @@
 #    include <LibSystem/syscall.h>
 #    include <serenity.h>
 #    include <sys/ptrace.h>
+#    include <sys/sendfile.h>
 #endif
 
 #if defined(AK_OS_LINUX) && !defined(MFD_CLOEXEC)
@@ -1220,6 +1221,19 @@ ErrorOr<u64> create_jail(StringView jail_name, JailIsolationFlags flags)
     int rc = syscall(SC_jail_create, &params);
     HANDLE_SYSCALL_RETURN_VALUE("jail_create", rc, static_cast<u64>(params.index));
 }
+
+ErrorOr<int> io_ring_setup(struct io_ring_params& params)
+{
+    int rc = syscall(SC_io_ring_setup, &params);
+    HANDLE_SYSCALL_RETURN_VALUE("io_ring_setup", rc, rc);
+}
+
+ErrorOr<size_t> io_ring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, struct timespec const* timeout)
+{
+    Syscall::SC_io_ring_enter_params params { ring_fd, to_submit, min_complete, timeout };
+    int rc = syscall(SC_io_ring_enter, &params);
+    HANDLE_SYSCALL_RETURN_VALUE("io_ring_enter", rc, static_cast<size_t>(rc));
+}
 #endif
 
 ErrorOr<void> exec(StringView filename, ReadonlySpan<StringView> arguments, SearchInPath search_in_path, Optional<ReadonlySpan<StringView>> environment)
@@ -1426,6 +1440,24 @@ ErrorOr<ssize_t> recvfrom(int sockfd, void* buffer, size_t buffer_length, int fl
     return received;
 }
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<size_t> sendmmsg(int sockfd, struct mmsghdr* messages, unsigned int vlen, int flags)
+{
+    auto sent = ::sendmmsg(sockfd, messages, vlen, flags);
+    if (sent < 0)
+        return Error::from_syscall("sendmmsg"sv, -errno);
+    return sent;
+}
+
+ErrorOr<size_t> recvmmsg(int sockfd, struct mmsghdr* messages, unsigned int vlen, int flags, struct timespec* timeout)
+{
+    auto received = ::recvmmsg(sockfd, messages, vlen, flags, timeout);
+    if (received < 0)
+        return Error::from_syscall("recvmmsg"sv, -errno);
+    return received;
+}
+#endif
+
 ErrorOr<AddressInfoVector> getaddrinfo(char const* nodename, char const* servname, struct addrinfo const& hints)
 {
     struct addrinfo* results = nullptr;
@@ -1654,6 +1686,30 @@ ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length)
         return Error::from_syscall("posix_fallocate"sv, -rc);
     return {};
 }
+
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    ssize_t rc = ::sendfile(out_fd, in_fd, offset, count);
+    if (rc < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return rc;
+}
+
+ErrorOr<size_t> splice(int in_fd, off_t* in_offset, int out_fd, off_t* out_offset, size_t length, unsigned flags)
+{
+    ssize_t rc = ::splice(in_fd, in_offset, out_fd, out_offset, length, flags);
+    if (rc < 0)
+        return Error::from_syscall("splice"sv, -errno);
+    return rc;
+}
+
+ErrorOr<size_t> copy_file_range(int in_fd, off_t* in_offset, int out_fd, off_t* out_offset, size_t length)
+{
+    ssize_t rc = ::copy_file_range(in_fd, in_offset, out_fd, out_offset, length, 0);
+    if (rc < 0)
+        return Error::from_syscall("copy_file_range"sv, -errno);
+    return rc;
+}
 #endif
 
 // This constant is copied from LibFileSystem. We cannot use or even include it directly,
@@ -33,6 +33,7 @@
 
 #ifdef AK_OS_SERENITY
 #    include <Kernel/API/Jail.h>
+#    include <sys/io_ring.h>
 #endif
 
 #if !defined(AK_OS_BSD_GENERIC) && !defined(AK_OS_ANDROID)
@@ -203,6 +204,8 @@ ErrorOr<void> exec(StringView filename, ReadonlySpan<StringView> arguments, Sear
 #ifdef AK_OS_SERENITY
 ErrorOr<void> join_jail(u64 jail_index);
 ErrorOr<u64> create_jail(StringView jail_name, JailIsolationFlags);
+ErrorOr<int> io_ring_setup(struct io_ring_params&);
+ErrorOr<size_t> io_ring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, struct timespec const* timeout = nullptr);
 #endif
 
 ErrorOr<int> socket(int domain, int type, int protocol);
@@ -217,6 +220,10 @@ ErrorOr<ssize_t> sendto(int sockfd, void const*, size_t, int flags, struct socka
 ErrorOr<ssize_t> recv(int sockfd, void*, size_t, int flags);
 ErrorOr<ssize_t> recvmsg(int sockfd, struct msghdr*, int flags);
 ErrorOr<ssize_t> recvfrom(int sockfd, void*, size_t, int flags, struct sockaddr*, socklen_t*);
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<size_t> sendmmsg(int sockfd, struct mmsghdr*, unsigned int vlen, int flags);
+ErrorOr<size_t> recvmmsg(int sockfd, struct mmsghdr*, unsigned int vlen, int flags, struct timespec* timeout);
+#endif
 ErrorOr<void> getsockopt(int sockfd, int level, int option, void* value, socklen_t* value_size);
 ErrorOr<void> setsockopt(int sockfd, int level, int option, void const* value, socklen_t value_size);
 ErrorOr<void> getsockname(int sockfd, struct sockaddr*, socklen_t*);
@@ -265,6 +272,9 @@ ErrorOr<AddressInfoVector> getaddrinfo(char const* nodename, char const* servnam
 
 #ifdef AK_OS_SERENITY
 ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length);
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+ErrorOr<size_t> splice(int in_fd, off_t* in_offset, int out_fd, off_t* out_offset, size_t length, unsigned flags = 0);
+ErrorOr<size_t> copy_file_range(int in_fd, off_t* in_offset, int out_fd, off_t* out_offset, size_t length);
 #endif
 
 ErrorOr<String> resolve_executable_from_environment(StringView filename, int flags = 0);
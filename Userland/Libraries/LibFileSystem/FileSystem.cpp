@@ -188,6 +188,16 @@ ErrorOr<void> copy_file(StringView destination_path, StringView source_path, str
     if (source_stat.st_size > 0)
         TRY(destination->truncate(source_stat.st_size));
 
+#ifdef AK_OS_SERENITY
+    // Let the kernel copy the data directly between the two files, so that it doesn't have to
+    // come out to userspace and back. Anything it can't copy is handled by the loop below.
+    while (true) {
+        auto bytes_copied_or_error = Core::System::copy_file_range(source.fd(), nullptr, destination->fd(), nullptr, 1 * MiB);
+        if (bytes_copied_or_error.is_error() || bytes_copied_or_error.value() == 0)
+            break;
+    }
+#endif
+
     while (true) {
         auto bytes_read = TRY(source.read_until_eof());
 
@@ -64,4 +64,39 @@ void BasicBlock::grow(size_t additional_size)
     VERIFY(m_buffer_size <= m_buffer_capacity);
 }
 
+void BasicBlock::remove_instructions(ReadonlySpan<size_t> offsets)
+{
+    if (offsets.is_empty())
+        return;
+
+    size_t read_offset = 0;
+    size_t write_offset = 0;
+    size_t next_removed_offset = 0;
+    Instruction const* new_terminator = nullptr;
+
+    while (read_offset < m_buffer_size) {
+        auto& instruction = *reinterpret_cast<Instruction*>(m_buffer + read_offset);
+        auto length = instruction.length();
+
+        if (next_removed_offset < offsets.size() && offsets[next_removed_offset] == read_offset) {
+            VERIFY(&instruction != m_terminator);
+            Instruction::destroy(instruction);
+            ++next_removed_offset;
+        } else {
+            if (&instruction == m_terminator)
+                new_terminator = reinterpret_cast<Instruction const*>(m_buffer + write_offset);
+            // NOTE: Instructions are only relocated here, never duplicated, so this is fine for NewBigInt as well.
+            if (write_offset != read_offset)
+                memmove(m_buffer + write_offset, m_buffer + read_offset, length);
+            write_offset += length;
+        }
+
+        read_offset += length;
+    }
+
+    VERIFY(next_removed_offset == offsets.size());
+    m_buffer_size = write_offset;
+    m_terminator = new_terminator;
+}
+
 }
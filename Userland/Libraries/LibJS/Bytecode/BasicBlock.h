@@ -39,6 +39,9 @@ public:
     bool can_grow(size_t additional_size) const { return m_buffer_size + additional_size <= m_buffer_capacity; }
     void grow(size_t additional_size);
 
+    // Destroys the instructions at the given (ascending) offsets and moves everything after them up to close the gaps.
+    void remove_instructions(ReadonlySpan<size_t> offsets);
+
     void terminate(Badge<Generator>, Instruction const* terminator) { m_terminator = terminator; }
     bool is_terminated() const { return m_terminator != nullptr; }
     Instruction const* terminator() const { return m_terminator; }
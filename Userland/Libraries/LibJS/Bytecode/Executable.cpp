@@ -5,6 +5,7 @@
  */
 
 #include <LibJS/Bytecode/Executable.h>
+#include <LibJS/JIT/Compiler.h>
 
 namespace JS::Bytecode {
 
@@ -23,4 +24,21 @@ void Executable::dump() const
     }
 }
 
+size_t Executable::bytecode_size() const
+{
+    size_t size = 0;
+    for (auto& block : basic_blocks)
+        size += block->size();
+    return size;
+}
+
+JIT::NativeExecutable const* Executable::get_or_create_native_executable() const
+{
+    if (!did_try_jit_compile) {
+        did_try_jit_compile = true;
+        native_executable = JIT::Compiler::compile(*this);
+    }
+    return native_executable;
+}
+
 }
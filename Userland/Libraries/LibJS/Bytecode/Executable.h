@@ -10,7 +10,9 @@
 #include <AK/NonnullOwnPtr.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/IdentifierTable.h>
+#include <LibJS/Bytecode/InlineCache.h>
 #include <LibJS/Bytecode/StringTable.h>
+#include <LibJS/JIT/NativeExecutable.h>
 
 namespace JS::Bytecode {
 
@@ -22,9 +24,22 @@ struct Executable {
     size_t number_of_registers { 0 };
     bool is_strict_mode { false };
 
+    // NOTE: These are filled in while the executable runs, so they're mutable like the rest of our per-instruction caches.
+    mutable Vector<PropertyLookupCache> property_lookup_caches;
+    mutable Vector<GlobalVariableCache> global_variable_caches;
+
+    // Compiled lazily the first time the executable runs with the JIT enabled.
+    mutable OwnPtr<JIT::NativeExecutable> native_executable;
+    mutable bool did_try_jit_compile { false };
+
+    JIT::NativeExecutable const* get_or_create_native_executable() const;
+
     DeprecatedString const& get_string(StringTableIndex index) const { return string_table->get(index); }
     DeprecatedFlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
 
+    // The combined size of the instruction streams of all basic blocks, in bytes.
+    size_t bytecode_size() const;
+
     void dump() const;
 };
 
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Format.h>
+#include <LibJS/Bytecode/InlineCache.h>
+
+namespace JS::Bytecode {
+
+InlineCacheStatistics g_inline_cache_statistics;
+
+void PropertyLookupCache::update(Shape& shape, u32 property_offset)
+{
+    Entry* entry_to_use = nullptr;
+    for (auto& entry : m_entries) {
+        if (entry.shape.ptr() == &shape) {
+            entry_to_use = &entry;
+            break;
+        }
+        // Shapes that have been garbage collected leave their entry free for the taking.
+        if (!entry_to_use && !entry.shape)
+            entry_to_use = &entry;
+    }
+
+    if (!entry_to_use) {
+        entry_to_use = &m_entries[m_next_entry_to_replace];
+        m_next_entry_to_replace = (m_next_entry_to_replace + 1) % max_shapes;
+    }
+
+    entry_to_use->shape = shape.make_weak_ptr<Shape>();
+    entry_to_use->shape_serial_number = shape.serial_number();
+    entry_to_use->property_offset = property_offset;
+}
+
+static void dump_counters(StringView name, InlineCacheStatistics::Counters const& counters)
+{
+    auto total = counters.hits + counters.misses;
+    auto hit_rate = total ? static_cast<double>(counters.hits) * 100 / total : 0;
+    outln("{:>10}: {:>12} hits, {:>12} misses ({:.1}% hit rate)", name, counters.hits, counters.misses, hit_rate);
+}
+
+void dump_inline_cache_statistics()
+{
+    outln("Inline cache statistics:");
+    dump_counters("GetById"sv, g_inline_cache_statistics.get_by_id);
+    dump_counters("PutById"sv, g_inline_cache_statistics.put_by_id);
+    dump_counters("GetGlobal"sv, g_inline_cache_statistics.get_global);
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Optional.h>
+#include <AK/WeakPtr.h>
+#include <LibJS/Runtime/Shape.h>
+
+namespace JS::Bytecode {
+
+// Remembers where a property was found in the storage of the last few shapes a GetById/PutById
+// instruction has seen. A single shape makes it monomorphic, up to max_shapes makes it polymorphic,
+// and beyond that the oldest entries get replaced round-robin.
+class PropertyLookupCache {
+public:
+    static constexpr size_t max_shapes = 4;
+
+    Optional<u32> lookup(Shape const& shape) const
+    {
+        for (auto const& entry : m_entries) {
+            if (entry.shape.ptr() == &shape && entry.shape_serial_number == shape.serial_number())
+                return entry.property_offset;
+        }
+        return {};
+    }
+
+    void update(Shape& shape, u32 property_offset);
+    void clear() { m_entries = {}; }
+
+private:
+    struct Entry {
+        WeakPtr<Shape> shape;
+        u64 shape_serial_number { 0 };
+        u32 property_offset { 0 };
+    };
+
+    AK::Array<Entry, max_shapes> m_entries;
+    u8 m_next_entry_to_replace { 0 };
+};
+
+// Global variable lookups that end up on the global object can only be cached as long as no
+// lexical declaration with the same name has been added to the global environment since.
+struct GlobalVariableCache : public PropertyLookupCache {
+    u64 environment_serial_number { 0 };
+};
+
+struct InlineCacheStatistics {
+    struct Counters {
+        u64 hits { 0 };
+        u64 misses { 0 };
+    };
+
+    Counters get_by_id;
+    Counters put_by_id;
+    Counters get_global;
+};
+
+extern InlineCacheStatistics g_inline_cache_statistics;
+
+void dump_inline_cache_statistics();
+
+}
@@ -117,6 +117,22 @@ public:
     void replace_references(Register, Register);
     static void destroy(Instruction&);
 
+    enum class RegisterAccess {
+        Read,
+        Write,
+        ReadWrite,
+    };
+
+    // Calls `callback(Register&, RegisterAccess)` for every register operand of this instruction.
+    // The accumulator is implicit and never visited.
+    // NOTE: NewArray reports the first and last register of its element range, but reads every register in between.
+    template<typename Callback>
+    void for_each_register_operand(Callback);
+
+    // Instructions without register operands inherit this, the others shadow it.
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback&) { }
+
 protected:
     explicit Instruction(Type type)
         : m_type(type)
@@ -19,6 +19,8 @@ namespace JS::Bytecode {
 
 static Interpreter* s_current;
 bool g_dump_bytecode = false;
+bool g_jit_enabled = getenv("LIBJS_JIT") != nullptr;
+Interpreter::OptimizationLevel g_function_optimization_level = Interpreter::OptimizationLevel::Default;
 
 Interpreter* Interpreter::current()
 {
@@ -71,17 +73,28 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
 
     registers().resize(executable.number_of_registers);
 
+    auto const* native_executable = g_jit_enabled ? executable.get_or_create_native_executable() : nullptr;
+
     for (;;) {
         Bytecode::InstructionStreamIterator pc(m_current_block->instruction_stream());
         TemporaryChange temp_change { m_pc, &pc };
 
+        if (native_executable && native_executable->has_code_for(*m_current_block)) {
+            // Native code runs until it needs us to deal with something, and tells us where that happened.
+            // If the instruction there already ran, its result is waiting in m_pending_jit_result.
+            auto exit = native_executable->run(*this, registers().data(), *m_current_block);
+            m_current_block = exit.block;
+            pc = Bytecode::InstructionStreamIterator(m_current_block->instruction_stream());
+            pc.jump(exit.offset);
+        }
+
         // FIXME: This is getting kinda spaghetti-y
         bool will_jump = false;
         bool will_return = false;
         bool will_yield = false;
         while (!pc.at_end()) {
             auto& instruction = *pc;
-            auto ran_or_error = instruction.execute(*this);
+            auto ran_or_error = m_pending_jit_result.has_value() ? m_pending_jit_result.release_value() : instruction.execute(*this);
             if (ran_or_error.is_error()) {
                 auto exception_value = *ran_or_error.throw_completion().value();
                 m_saved_exception = make_handle(exception_value);
@@ -205,6 +218,20 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
     return { return_value, nullptr };
 }
 
+bool Interpreter::run_instruction_for_jit(Instruction const& instruction, BasicBlock const& block)
+{
+    m_current_block = &block;
+    *m_pc = InstructionStreamIterator(block.instruction_stream());
+    m_pc->jump(reinterpret_cast<u8 const*>(&instruction) - block.instruction_stream().data());
+
+    auto result = instruction.execute(*this);
+    if (result.is_error() || m_pending_jump.has_value() || !m_return_value.is_empty()) {
+        m_pending_jit_result = move(result);
+        return true;
+    }
+    return false;
+}
+
 void Interpreter::enter_unwind_context(Optional<Label> handler_target, Optional<Label> finalizer_target)
 {
     unwind_contexts().empend(
@@ -279,6 +306,24 @@ Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::Optimizat
         pm->add<Passes::GenerateCFG>();
         pm->add<Passes::PlaceBlocks>();
         pm->add<Passes::EliminateLoads>();
+    } else if (level == OptimizationLevel::OptimizeAggressively) {
+        pm->add<Passes::GenerateCFG>();
+        pm->add<Passes::UnifySameBlocks>();
+        pm->add<Passes::GenerateCFG>();
+        pm->add<Passes::MergeBlocks>();
+        pm->add<Passes::GenerateCFG>();
+        pm->add<Passes::UnifySameBlocks>();
+        pm->add<Passes::GenerateCFG>();
+        pm->add<Passes::MergeBlocks>();
+        pm->add<Passes::GenerateCFG>();
+        pm->add<Passes::PlaceBlocks>();
+        pm->add<Passes::EliminateLoads>();
+        pm->add<Passes::PropagateConstants>();
+        pm->add<Passes::PropagateCopies>();
+        pm->add<Passes::AnalyzeRegisterLiveness>();
+        pm->add<Passes::EliminateDeadStores>();
+        pm->add<Passes::AnalyzeRegisterLiveness>();
+        pm->add<Passes::CoalesceRegisters>();
     } else {
         VERIFY_NOT_REACHED();
     }
@@ -75,6 +75,10 @@ public:
     void leave_unwind_context();
     ThrowCompletionOr<void> continue_pending_unwind(Label const& resume_label);
 
+    // Runs a single instruction on behalf of JIT-compiled code. Returns true if native code has to hand
+    // control back to us, because the instruction threw, jumped, or returned.
+    bool run_instruction_for_jit(Instruction const&, BasicBlock const&);
+
     Executable const& current_executable() { return *m_current_executable; }
     BasicBlock const& current_block() const { return *m_current_block; }
     size_t pc() const { return m_pc ? m_pc->offset() : 0; }
@@ -86,6 +90,8 @@ public:
     enum class OptimizationLevel {
         None,
         Optimize,
+        // Also runs the dataflow passes and packs the temporaries into as few registers as possible.
+        OptimizeAggressively,
         __Count,
         Default = None,
     };
@@ -120,8 +126,12 @@ private:
     OwnPtr<JS::Interpreter> m_ast_interpreter;
     BasicBlock const* m_current_block { nullptr };
     InstructionStreamIterator* m_pc { nullptr };
+    Optional<ThrowCompletionOr<void>> m_pending_jit_result;
 };
 
 extern bool g_dump_bytecode;
+extern bool g_jit_enabled;
+// Used for the executables of functions, which are generated when the function is first called.
+extern Interpreter::OptimizationLevel g_function_optimization_level;
 
 }
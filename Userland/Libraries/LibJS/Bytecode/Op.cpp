@@ -48,7 +48,14 @@ DeprecatedString Instruction::to_deprecated_string(Bytecode::Executable const& e
 
 namespace JS::Bytecode::Op {
 
-static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value, PropertyKey name, Bytecode::Interpreter& interpreter, PropertyKind kind)
+// Empty slots belong to intrinsics that haven't been materialized yet, and accessors have to be called,
+// so neither can be read or written through an inline cache.
+static bool can_access_storage_slot_directly(Value value)
+{
+    return !value.is_empty() && !value.is_accessor();
+}
+
+static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value, PropertyKey name, Bytecode::Interpreter& interpreter, PropertyKind kind, CacheablePropertyMetadata* cacheable_metadata = nullptr)
 {
     auto& vm = interpreter.vm();
 
@@ -72,7 +79,7 @@ static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value,
         break;
     }
     case PropertyKind::KeyValue: {
-        bool succeeded = TRY(object->internal_set(name, interpreter.accumulator(), object));
+        bool succeeded = TRY(object->internal_set(name, interpreter.accumulator(), object, cacheable_metadata));
         if (!succeeded && vm.in_strict_mode())
             return vm.throw_completion<TypeError>(ErrorType::ReferenceNullishSetProperty, name, TRY_OR_THROW_OOM(vm, interpreter.accumulator().to_string_without_side_effects()));
         break;
@@ -369,10 +376,57 @@ ThrowCompletionOr<void> ConcatString::execute_impl(Bytecode::Interpreter& interp
     return {};
 }
 
+// This is GlobalEnvironment::get_binding_value() with the object record part spelled out, so we can
+// find out where on the global object the value lives and go straight there next time.
+static ThrowCompletionOr<Value> get_global_variable(Bytecode::Interpreter& interpreter, GlobalEnvironment& global_environment, DeprecatedFlyString const& name, GlobalVariableCache& cache)
+{
+    auto& vm = interpreter.vm();
+    auto& declarative_record = global_environment.declarative_record();
+    auto& binding_object = global_environment.object_record().binding_object();
+
+    if (cache.environment_serial_number == declarative_record.environment_serial_number()) {
+        if (auto offset = cache.lookup(binding_object.shape()); offset.has_value()) {
+            auto value = binding_object.get_direct(*offset);
+            if (can_access_storage_slot_directly(value)) {
+                ++g_inline_cache_statistics.get_global.hits;
+                return value;
+            }
+        }
+    }
+    ++g_inline_cache_statistics.get_global.misses;
+
+    if (MUST(declarative_record.has_binding(name)))
+        return declarative_record.get_binding_value(vm, name, vm.in_strict_mode());
+
+    if (vm.in_strict_mode() && !TRY(binding_object.has_property(name)))
+        return vm.throw_completion<ReferenceError>(ErrorType::UnknownIdentifier, name);
+
+    CacheablePropertyMetadata cacheable_metadata;
+    auto value = TRY(binding_object.internal_get(name, &binding_object, &cacheable_metadata));
+    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
+        if (cache.environment_serial_number != declarative_record.environment_serial_number()) {
+            cache.clear();
+            cache.environment_serial_number = declarative_record.environment_serial_number();
+        }
+        cache.update(binding_object.shape(), *cacheable_metadata.property_offset);
+    }
+    return value;
+}
+
 ThrowCompletionOr<void> GetVariable::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
 
+    if (m_cached_environment_coordinate.has_value() && m_cached_environment_coordinate->index == EnvironmentCoordinate::global_marker) {
+        auto& global_environment = vm.current_realm()->global_environment();
+        if (!global_environment.is_permanently_screwed_by_eval()) {
+            auto const& string = interpreter.current_executable().get_identifier(m_identifier);
+            auto& cache = interpreter.current_executable().global_variable_caches[m_cache_index];
+            interpreter.accumulator() = TRY(get_global_variable(interpreter, global_environment, string, cache));
+            return {};
+        }
+    }
+
     auto get_reference = [&]() -> ThrowCompletionOr<Reference> {
         auto const& string = interpreter.current_executable().get_identifier(m_identifier);
         if (m_cached_environment_coordinate.has_value()) {
@@ -493,7 +547,22 @@ ThrowCompletionOr<void> GetById::execute_impl(Bytecode::Interpreter& interpreter
 {
     auto& vm = interpreter.vm();
     auto object = TRY(interpreter.accumulator().to_object(vm));
-    interpreter.accumulator() = TRY(object->get(interpreter.current_executable().get_identifier(m_property)));
+
+    auto& cache = interpreter.current_executable().property_lookup_caches[m_cache_index];
+    if (auto offset = cache.lookup(object->shape()); offset.has_value()) {
+        auto value = object->get_direct(*offset);
+        if (can_access_storage_slot_directly(value)) {
+            ++g_inline_cache_statistics.get_by_id.hits;
+            interpreter.accumulator() = value;
+            return {};
+        }
+    }
+    ++g_inline_cache_statistics.get_by_id.misses;
+
+    CacheablePropertyMetadata cacheable_metadata;
+    interpreter.accumulator() = TRY(object->internal_get(interpreter.current_executable().get_identifier(m_property), object.ptr(), &cacheable_metadata));
+    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty)
+        cache.update(object->shape(), *cacheable_metadata.property_offset);
     return {};
 }
 
@@ -503,7 +572,22 @@ ThrowCompletionOr<void> PutById::execute_impl(Bytecode::Interpreter& interpreter
     auto object = TRY(interpreter.reg(m_base).to_object(vm));
     PropertyKey name = interpreter.current_executable().get_identifier(m_property);
     auto value = interpreter.accumulator();
-    return put_by_property_key(object, value, name, interpreter, m_kind);
+    if (m_kind != PropertyKind::KeyValue)
+        return put_by_property_key(object, value, name, interpreter, m_kind);
+
+    auto& cache = interpreter.current_executable().property_lookup_caches[m_cache_index];
+    if (auto offset = cache.lookup(object->shape()); offset.has_value() && can_access_storage_slot_directly(object->get_direct(*offset))) {
+        ++g_inline_cache_statistics.put_by_id.hits;
+        object->put_direct(*offset, value);
+        return {};
+    }
+    ++g_inline_cache_statistics.put_by_id.misses;
+
+    CacheablePropertyMetadata cacheable_metadata;
+    TRY(put_by_property_key(object, value, name, interpreter, m_kind, &cacheable_metadata));
+    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty)
+        cache.update(object->shape(), *cacheable_metadata.property_offset);
+    return {};
 }
 
 ThrowCompletionOr<void> DeleteById::execute_impl(Bytecode::Interpreter& interpreter) const
@@ -39,6 +39,10 @@ public:
         if (m_src == from)
             m_src = to;
     }
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback) { callback(m_src, RegisterAccess::Read); }
+
+    Register src() const { return m_src; }
 
 private:
     Register m_src;
@@ -57,6 +61,8 @@ public:
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     void replace_references_impl(Register, Register) { }
 
+    Value value() const { return m_value; }
+
 private:
     Value m_value;
 };
@@ -73,6 +79,8 @@ public:
     DeprecatedString to_deprecated_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     void replace_references_impl(Register, Register) { }
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback) { callback(m_dst, RegisterAccess::Write); }
 
     Register dst() const { return m_dst; }
 
@@ -122,8 +130,15 @@ private:
         {                                                                              \
             if (m_lhs_reg == from)                                                     \
                 m_lhs_reg = to;                                                        \
+        }                                                                              \
+        template<typename Callback>                                                    \
+        void for_each_register_operand_impl(Callback& callback)                        \
+        {                                                                              \
+            callback(m_lhs_reg, RegisterAccess::Read);                                 \
         }                                                                              \
                                                                                        \
+        Register lhs() const { return m_lhs_reg; }                                     \
+                                                                                       \
     private:                                                                           \
         Register m_lhs_reg;                                                            \
     };
@@ -252,6 +267,13 @@ public:
     DeprecatedString to_deprecated_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     void replace_references_impl(Register from, Register to);
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback)
+    {
+        callback(m_from_object, RegisterAccess::Read);
+        for (size_t i = 0; i < m_excluded_names_count; ++i)
+            callback(m_excluded_names[i], RegisterAccess::Read);
+    }
 
     size_t length_impl() const { return sizeof(*this) + sizeof(Register) * m_excluded_names_count; }
 
@@ -301,6 +323,15 @@ public:
     // Note: The underlying element range shall never be changed item, by item
     //       shifting it may be done in the future
     void replace_references_impl(Register from, Register) { VERIFY(!m_element_count || from.index() < start().index() || from.index() > end().index()); }
+    // Note: Only the ends of the range are visited, anything renaming them has to keep the range contiguous.
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback)
+    {
+        if (!m_element_count)
+            return;
+        callback(m_elements[0], RegisterAccess::Read);
+        callback(m_elements[1], RegisterAccess::Read);
+    }
 
     size_t length_impl() const
     {
@@ -341,6 +372,8 @@ public:
 
     // Note: This should never do anything, the lhs should always be an array, that is currently being constructed
     void replace_references_impl(Register from, Register) { VERIFY(from != m_lhs); }
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback) { callback(m_lhs, RegisterAccess::Read); }
 
 private:
     Register m_lhs;
@@ -373,6 +406,8 @@ public:
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     // Note: lhs should always be a string in construction, so this should never do anything
     void replace_references_impl(Register from, Register) { VERIFY(from != m_lhs); }
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback) { callback(m_lhs, RegisterAccess::ReadWrite); }
 
 private:
     Register m_lhs;
@@ -466,9 +501,10 @@ private:
 
 class GetVariable final : public Instruction {
 public:
-    explicit GetVariable(IdentifierTableIndex identifier)
+    GetVariable(IdentifierTableIndex identifier, u32 cache_index)
         : Instruction(Type::GetVariable)
         , m_identifier(identifier)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -478,9 +514,11 @@ public:
     void replace_references_impl(Register, Register) { }
 
     IdentifierTableIndex identifier() const { return m_identifier; }
+    u32 cache_index() const { return m_cache_index; }
 
 private:
     IdentifierTableIndex m_identifier;
+    u32 m_cache_index { 0 };
 
     Optional<EnvironmentCoordinate> mutable m_cached_environment_coordinate;
 };
@@ -506,9 +544,10 @@ private:
 
 class GetById final : public Instruction {
 public:
-    explicit GetById(IdentifierTableIndex property)
+    GetById(IdentifierTableIndex property, u32 cache_index)
         : Instruction(Type::GetById)
         , m_property(property)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -519,6 +558,7 @@ public:
 
 private:
     IdentifierTableIndex m_property;
+    u32 m_cache_index { 0 };
 };
 
 enum class PropertyKind {
@@ -531,11 +571,12 @@ enum class PropertyKind {
 
 class PutById final : public Instruction {
 public:
-    explicit PutById(Register base, IdentifierTableIndex property, PropertyKind kind = PropertyKind::KeyValue)
+    PutById(Register base, IdentifierTableIndex property, u32 cache_index, PropertyKind kind = PropertyKind::KeyValue)
         : Instruction(Type::PutById)
         , m_base(base)
         , m_property(property)
         , m_kind(kind)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -547,11 +588,14 @@ public:
         if (m_base == from)
             m_base = to;
     }
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback) { callback(m_base, RegisterAccess::Read); }
 
 private:
     Register m_base;
     IdentifierTableIndex m_property;
     PropertyKind m_kind;
+    u32 m_cache_index { 0 };
 };
 
 class DeleteById final : public Instruction {
@@ -587,6 +631,8 @@ public:
         if (m_base == from)
             m_base = to;
     }
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback) { callback(m_base, RegisterAccess::Read); }
 
 private:
     Register m_base;
@@ -610,6 +656,12 @@ public:
         if (m_base == from)
             m_base = to;
     }
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback)
+    {
+        callback(m_base, RegisterAccess::Read);
+        callback(m_property, RegisterAccess::Read);
+    }
 
 private:
     Register m_base;
@@ -633,6 +685,8 @@ public:
         if (m_base == from)
             m_base = to;
     }
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback) { callback(m_base, RegisterAccess::Read); }
 
 private:
     Register m_base;
@@ -729,6 +783,12 @@ public:
     DeprecatedString to_deprecated_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     void replace_references_impl(Register, Register);
+    template<typename Callback>
+    void for_each_register_operand_impl(Callback& callback)
+    {
+        callback(m_callee, RegisterAccess::Read);
+        callback(m_this_value, RegisterAccess::Read);
+    }
 
     Completion throw_type_error_for_callee(Bytecode::Interpreter&, StringView callee_type) const;
 
@@ -1222,6 +1282,22 @@ ALWAYS_INLINE void Instruction::replace_references(Register from, Register to)
 #undef __BYTECODE_OP
 }
 
+template<typename Callback>
+ALWAYS_INLINE void Instruction::for_each_register_operand(Callback callback)
+{
+#define __BYTECODE_OP(op)       \
+    case Instruction::Type::op: \
+        return static_cast<Bytecode::Op::op&>(*this).for_each_register_operand_impl(callback);
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
 ALWAYS_INLINE size_t Instruction::length() const
 {
     if (type() == Type::NewArray)
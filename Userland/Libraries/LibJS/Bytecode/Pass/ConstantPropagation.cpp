@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Math.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static_assert(sizeof(Op::Jump) == sizeof(Op::JumpConditional));
+static_assert(sizeof(Op::Jump) == sizeof(Op::JumpNullish));
+static_assert(sizeof(Op::Jump) == sizeof(Op::JumpUndefined));
+
+// Bitwise operators convert their operands with ToInt32(), which we only bother doing for numbers that are already integers in range.
+static Optional<i32> as_exact_i32(Value value)
+{
+    auto number = value.as_double();
+    if (number < NumericLimits<i32>::min() || number > NumericLimits<i32>::max() || trunc(number) != number)
+        return {};
+    return static_cast<i32>(number);
+}
+
+// NOTE: Only primitives that aren't cells are ever tracked, so none of this can end up calling into user code or allocating.
+static Optional<Value> fold_binary_operation(Instruction::Type type, Value lhs, Value rhs)
+{
+    using enum Instruction::Type;
+
+    switch (type) {
+    case StrictlyEquals:
+        return Value(is_strictly_equal(lhs, rhs));
+    case StrictlyInequals:
+        return Value(!is_strictly_equal(lhs, rhs));
+    case LooselyEquals:
+    case LooselyInequals: {
+        bool equal;
+        if (lhs.is_nullish() && rhs.is_nullish())
+            equal = true;
+        else if ((lhs.is_number() && rhs.is_number()) || (lhs.is_boolean() && rhs.is_boolean()))
+            equal = is_strictly_equal(lhs, rhs);
+        else
+            return {};
+        return Value(type == LooselyEquals ? equal : !equal);
+    }
+    default:
+        break;
+    }
+
+    if (!lhs.is_number() || !rhs.is_number())
+        return {};
+
+    if (auto a = as_exact_i32(lhs), b = as_exact_i32(rhs); a.has_value() && b.has_value()) {
+        auto shift_count = static_cast<u32>(*b) & 0x1f;
+        switch (type) {
+        case BitwiseAnd:
+            return Value(*a & *b);
+        case BitwiseOr:
+            return Value(*a | *b);
+        case BitwiseXor:
+            return Value(*a ^ *b);
+        case LeftShift:
+            return Value(static_cast<i32>(static_cast<u32>(*a) << shift_count));
+        case RightShift:
+            return Value(*a >> shift_count);
+        case UnsignedRightShift:
+            return Value(static_cast<double>(static_cast<u32>(*a) >> shift_count));
+        default:
+            break;
+        }
+    }
+
+    auto a = lhs.as_double();
+    auto b = rhs.as_double();
+    switch (type) {
+    case Add:
+        return Value(a + b);
+    case Sub:
+        return Value(a - b);
+    case Mul:
+        return Value(a * b);
+    case Div:
+        return Value(a / b);
+    case Mod:
+        return Value(fmod(a, b));
+    case LessThan:
+        return Value(a < b);
+    case LessThanEquals:
+        return Value(a <= b);
+    case GreaterThan:
+        return Value(a > b);
+    case GreaterThanEquals:
+        return Value(a >= b);
+    default:
+        return {};
+    }
+}
+
+static Optional<Value> fold_unary_operation(Instruction::Type type, Value value)
+{
+    using enum Instruction::Type;
+
+    if (type == Not)
+        return Value(!value.to_boolean());
+
+    if (!value.is_number())
+        return {};
+
+    switch (type) {
+    case UnaryPlus:
+        return value;
+    case UnaryMinus:
+        return Value(-value.as_double());
+    case BitwiseNot:
+        if (auto integer = as_exact_i32(value); integer.has_value())
+            return Value(~*integer);
+        return {};
+    case Increment:
+        return Value(value.as_double() + 1);
+    case Decrement:
+        return Value(value.as_double() - 1);
+    default:
+        return {};
+    }
+}
+
+static void propagate_constants(BasicBlock& block)
+{
+    Vector<size_t> removed_offsets;
+
+    // Constants are only tracked within the block, as we know nothing about registers when entering it.
+    Optional<Value> accumulator;
+    HashMap<u32, Value> registers;
+
+    // The LoadImmediate right before the current instruction, which is where the accumulator came from.
+    // If the current instruction just computes a new constant from the accumulator, we can rewrite that
+    // LoadImmediate to produce the result directly, and drop the instruction.
+    Optional<size_t> previous_load_immediate_offset;
+
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+        auto offset = it.offset();
+        auto& instruction = const_cast<Instruction&>(*it);
+        auto load_immediate_offset = exchange(previous_load_immediate_offset, {});
+
+        auto replace_with_constant = [&](Optional<Value> result) {
+            accumulator = result;
+            if (!result.has_value() || !load_immediate_offset.has_value())
+                return;
+
+            auto& load_immediate = *reinterpret_cast<Instruction*>(const_cast<u8*>(block.instruction_stream().offset(*load_immediate_offset)));
+            Instruction::destroy(load_immediate);
+            new (&load_immediate) Op::LoadImmediate(*result);
+
+            removed_offsets.append(offset);
+            previous_load_immediate_offset = load_immediate_offset;
+        };
+
+        using enum Instruction::Type;
+        switch (instruction.type()) {
+        case LoadImmediate: {
+            auto value = static_cast<Op::LoadImmediate const&>(instruction).value();
+            accumulator = value.is_cell() ? Optional<Value> {} : value;
+            previous_load_immediate_offset = offset;
+            break;
+        }
+        case Load:
+            accumulator = registers.get(static_cast<Op::Load const&>(instruction).src().index());
+            break;
+        case Store: {
+            auto dst = static_cast<Op::Store const&>(instruction).dst().index();
+            if (accumulator.has_value())
+                registers.set(dst, *accumulator);
+            else
+                registers.remove(dst);
+            break;
+        }
+#define __BYTECODE_OP(OpTitleCase, ...) case OpTitleCase:
+            JS_ENUMERATE_COMMON_BINARY_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+            {
+                Optional<Value> lhs;
+                instruction.for_each_register_operand([&](Register& reg, Instruction::RegisterAccess) {
+                    lhs = registers.get(reg.index());
+                });
+                if (lhs.has_value() && accumulator.has_value())
+                    replace_with_constant(fold_binary_operation(instruction.type(), *lhs, *accumulator));
+                else
+                    accumulator = {};
+                break;
+            }
+        case Not:
+        case UnaryPlus:
+        case UnaryMinus:
+        case BitwiseNot:
+        case Increment:
+        case Decrement:
+            if (accumulator.has_value())
+                replace_with_constant(fold_unary_operation(instruction.type(), *accumulator));
+            break;
+        case JumpConditional:
+        case JumpNullish:
+        case JumpUndefined: {
+            if (!accumulator.has_value())
+                break;
+
+            auto const& jump = static_cast<Op::Jump const&>(instruction);
+            bool taken;
+            if (instruction.type() == JumpConditional)
+                taken = accumulator->to_boolean();
+            else if (instruction.type() == JumpNullish)
+                taken = accumulator->is_nullish();
+            else
+                taken = accumulator->is_undefined();
+
+            auto target = taken ? *jump.true_target() : *jump.false_target();
+            Instruction::destroy(instruction);
+            new (&instruction) Op::Jump(target);
+            break;
+        }
+        default:
+            accumulator = {};
+            instruction.for_each_register_operand([&](Register& reg, Instruction::RegisterAccess access) {
+                if (access != Instruction::RegisterAccess::Read)
+                    registers.remove(reg.index());
+            });
+            break;
+        }
+    }
+
+    block.remove_instructions(removed_offsets);
+}
+
+void PropagateConstants::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks)
+        propagate_constants(*block);
+
+    finished();
+}
+
+}
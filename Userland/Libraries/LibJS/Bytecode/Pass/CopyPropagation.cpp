@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static void propagate_copies(BasicBlock& block)
+{
+    Vector<size_t> removed_offsets;
+
+    // Maps registers to the register they were copied from, which always is the original value, never another copy.
+    HashMap<u32, u32> copy_of;
+    // The register that currently holds the same value as the accumulator, if any.
+    Optional<u32> accumulator_copy_of;
+
+    auto original_of = [&](u32 index) {
+        return copy_of.get(index).value_or(index);
+    };
+
+    auto invalidate = [&](u32 index) {
+        copy_of.remove(index);
+        copy_of.remove_all_matching([&](u32, u32 original) { return original == index; });
+        if (accumulator_copy_of == index)
+            accumulator_copy_of = {};
+    };
+
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+        auto& instruction = const_cast<Instruction&>(*it);
+
+        switch (instruction.type()) {
+        case Instruction::Type::Load: {
+            auto& load = static_cast<Op::Load&>(instruction);
+            auto src = original_of(load.src().index());
+            if (accumulator_copy_of == src) {
+                removed_offsets.append(it.offset());
+                continue;
+            }
+            load.replace_references(load.src(), Register { src });
+            accumulator_copy_of = src;
+            continue;
+        }
+        case Instruction::Type::Store: {
+            auto dst = static_cast<Op::Store const&>(instruction).dst().index();
+            if (accumulator_copy_of.has_value() && original_of(dst) == *accumulator_copy_of) {
+                // The register already holds this value.
+                removed_offsets.append(it.offset());
+                continue;
+            }
+            invalidate(dst);
+            if (accumulator_copy_of.has_value())
+                copy_of.set(dst, *accumulator_copy_of);
+            else
+                accumulator_copy_of = dst;
+            continue;
+        }
+        case Instruction::Type::NewArray:
+            // The element range has to stay in one piece, so we can't point it anywhere else.
+            break;
+        default:
+            instruction.for_each_register_operand([&](Register& reg, Instruction::RegisterAccess access) {
+                if (access == Instruction::RegisterAccess::Read)
+                    reg = Register { original_of(reg.index()) };
+            });
+            break;
+        }
+
+        instruction.for_each_register_operand([&](Register& reg, Instruction::RegisterAccess access) {
+            if (access != Instruction::RegisterAccess::Read)
+                invalidate(reg.index());
+        });
+        accumulator_copy_of = {};
+    }
+
+    block.remove_instructions(removed_offsets);
+}
+
+void PropagateCopies::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks)
+        propagate_copies(*block);
+
+    finished();
+}
+
+}
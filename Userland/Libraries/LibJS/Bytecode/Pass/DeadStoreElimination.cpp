@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Bitmap.h>
+#include <AK/QuickSort.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static bool only_writes_accumulator(Instruction const& instruction)
+{
+    return instruction.type() == Instruction::Type::Load || instruction.type() == Instruction::Type::LoadImmediate;
+}
+
+static void eliminate_dead_stores(BasicBlock& block, RegisterLiveness const& liveness)
+{
+    Vector<size_t> instruction_offsets;
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it)
+        instruction_offsets.append(it.offset());
+
+    auto const& live_out = *liveness.live_out.get(&block);
+    auto live = Bitmap::create(live_out.size(), false).release_value_but_fixme_should_propagate_errors();
+    memcpy(live.data(), live_out.view().data(), live_out.size_in_bytes());
+
+    HashTable<size_t> removed_offsets;
+
+    // A Store to a register that nobody reads afterwards is dead, unless an exception handler might still look at it.
+    for (size_t i = instruction_offsets.size(); i > 0; --i) {
+        auto offset = instruction_offsets[i - 1];
+        auto const& instruction = *reinterpret_cast<Instruction const*>(block.instruction_stream().offset(offset));
+
+        if (instruction.type() == Instruction::Type::Store) {
+            auto dst = static_cast<Op::Store const&>(instruction).dst().index();
+            if (dst > 1 && !live.get(dst) && !liveness.live_into_handlers.get(dst)) {
+                removed_offsets.set(offset);
+                continue;
+            }
+        }
+
+        RegisterLiveness::step_backwards(instruction, live);
+    }
+
+    // Loading something into the accumulator is pointless if the next instruction replaces it right away.
+    Optional<size_t> previous_load_offset;
+    for (auto offset : instruction_offsets) {
+        if (removed_offsets.contains(offset))
+            continue;
+
+        auto const& instruction = *reinterpret_cast<Instruction const*>(block.instruction_stream().offset(offset));
+        if (!only_writes_accumulator(instruction)) {
+            previous_load_offset = {};
+            continue;
+        }
+
+        if (previous_load_offset.has_value())
+            removed_offsets.set(*previous_load_offset);
+        previous_load_offset = offset;
+    }
+
+    Vector<size_t> sorted_offsets;
+    sorted_offsets.ensure_capacity(removed_offsets.size());
+    for (auto offset : removed_offsets)
+        sorted_offsets.unchecked_append(offset);
+    quick_sort(sorted_offsets);
+
+    block.remove_instructions(sorted_offsets);
+}
+
+void EliminateDeadStores::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    VERIFY(executable.register_liveness);
+    auto liveness = executable.register_liveness.release_nonnull();
+
+    for (auto& block : executable.executable.basic_blocks)
+        eliminate_dead_stores(*block, *liveness);
+
+    finished();
+}
+
+}
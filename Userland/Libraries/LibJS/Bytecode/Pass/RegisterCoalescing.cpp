@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// The accumulator, and the register after it, which the generator never hands out either.
+static constexpr u32 first_allocatable_register = 2;
+
+struct LiveInterval {
+    u32 first_register { 0 };
+    u32 register_count { 1 };
+    size_t start { 0 };
+    size_t end { 0 };
+};
+
+void CoalesceRegisters::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    VERIFY(executable.register_liveness);
+    auto liveness = executable.register_liveness.release_nonnull();
+    auto number_of_registers = executable.executable.number_of_registers;
+
+    // Number all instructions in block order, and give every register a single interval that covers everything
+    // from the first to the last point where it's live. This ignores holes in the live ranges, but the generator
+    // mostly uses a register for a single temporary anyway, so it's a good fit for a plain linear scan.
+    Vector<Optional<LiveInterval>> intervals;
+    intervals.resize(number_of_registers);
+
+    auto extend = [&](u32 index, size_t position) {
+        if (index < first_allocatable_register)
+            return;
+        auto& interval = intervals[index];
+        if (!interval.has_value()) {
+            interval = LiveInterval { .first_register = index, .register_count = 1, .start = position, .end = position };
+            return;
+        }
+        interval->start = min(interval->start, position);
+        interval->end = max(interval->end, position);
+    };
+
+    Vector<LiveInterval> element_ranges;
+    size_t position = 0;
+    for (auto const& block : executable.executable.basic_blocks) {
+        auto block_start = position;
+
+        for (InstructionStreamIterator it { block->instruction_stream() }; !it.at_end(); ++it, ++position) {
+            if ((*it).type() == Instruction::Type::NewArray) {
+                auto const& new_array = static_cast<Op::NewArray const&>(*it);
+                if (!new_array.element_count())
+                    continue;
+                for (size_t i = 0; i < new_array.element_count(); ++i)
+                    extend(new_array.start().index() + i, position);
+                element_ranges.append({ .first_register = new_array.start().index(), .register_count = static_cast<u32>(new_array.element_count()) });
+                continue;
+            }
+
+            const_cast<Instruction&>(*it).for_each_register_operand([&](Register& reg, Instruction::RegisterAccess) {
+                extend(reg.index(), position);
+            });
+        }
+
+        auto block_end = position++;
+        auto const& live_in = *liveness->live_in.get(block.ptr());
+        auto const& live_out = *liveness->live_out.get(block.ptr());
+        for (u32 index = first_allocatable_register; index < number_of_registers; ++index) {
+            if (live_in.get(index))
+                extend(index, block_start);
+            if (live_out.get(index))
+                extend(index, block_end);
+        }
+    }
+
+    // Array elements are read straight out of a range of registers, so they have to stay consecutive.
+    // Merge overlapping ranges, and allocate every resulting group as a single unit.
+    quick_sort(element_ranges, [](auto const& a, auto const& b) { return a.first_register < b.first_register; });
+    Vector<LiveInterval> groups;
+    for (auto const& range : element_ranges) {
+        if (!groups.is_empty() && range.first_register < groups.last().first_register + groups.last().register_count) {
+            auto& group = groups.last();
+            group.register_count = max(group.register_count, range.first_register + range.register_count - group.first_register);
+            continue;
+        }
+        groups.append(range);
+    }
+
+    Vector<LiveInterval> work_list;
+    for (auto& group : groups) {
+        group.start = NumericLimits<size_t>::max();
+        group.end = 0;
+        for (u32 i = 0; i < group.register_count; ++i) {
+            auto& member = intervals[group.first_register + i];
+            if (!member.has_value())
+                continue;
+            group.start = min(group.start, member->start);
+            group.end = max(group.end, member->end);
+            member.clear();
+        }
+        work_list.append(group);
+    }
+    for (auto const& interval : intervals) {
+        if (interval.has_value())
+            work_list.append(*interval);
+    }
+    quick_sort(work_list, [](auto const& a, auto const& b) { return a.start < b.start; });
+
+    // Hand out the lowest registers that are free for the whole interval.
+    Vector<u32> mapping;
+    mapping.resize(number_of_registers);
+    for (u32 index = 0; index < first_allocatable_register; ++index)
+        mapping[index] = index;
+
+    Vector<Optional<size_t>> busy_until;
+    busy_until.resize(first_allocatable_register);
+
+    for (auto const& interval : work_list) {
+        auto is_free = [&](u32 physical) {
+            return physical >= busy_until.size() || !busy_until[physical].has_value() || *busy_until[physical] < interval.start;
+        };
+
+        u32 physical = first_allocatable_register;
+        for (;; ++physical) {
+            bool all_free = true;
+            for (u32 i = 0; i < interval.register_count && all_free; ++i)
+                all_free = is_free(physical + i);
+            if (all_free)
+                break;
+        }
+
+        if (busy_until.size() < physical + interval.register_count)
+            busy_until.resize(physical + interval.register_count);
+        for (u32 i = 0; i < interval.register_count; ++i) {
+            busy_until[physical + i] = interval.end;
+            mapping[interval.first_register + i] = physical + i;
+        }
+    }
+
+    for (auto& block : executable.executable.basic_blocks) {
+        for (InstructionStreamIterator it { block->instruction_stream() }; !it.at_end(); ++it) {
+            const_cast<Instruction&>(*it).for_each_register_operand([&](Register& reg, Instruction::RegisterAccess) {
+                reg = Register { mapping[reg.index()] };
+            });
+        }
+    }
+
+    executable.executable.number_of_registers = busy_until.size();
+
+    finished();
+}
+
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Bitmap.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode {
+
+void RegisterLiveness::step_backwards(Instruction const& instruction, Bitmap& live)
+{
+    auto& mutable_instruction = const_cast<Instruction&>(instruction);
+
+    mutable_instruction.for_each_register_operand([&](Register& reg, Instruction::RegisterAccess access) {
+        if (access == Instruction::RegisterAccess::Write)
+            live.set(reg.index(), false);
+    });
+
+    if (instruction.type() == Instruction::Type::NewArray) {
+        auto const& new_array = static_cast<Op::NewArray const&>(instruction);
+        if (new_array.element_count())
+            live.set_range<true, false>(new_array.start().index(), new_array.element_count());
+        return;
+    }
+
+    mutable_instruction.for_each_register_operand([&](Register& reg, Instruction::RegisterAccess access) {
+        if (access != Instruction::RegisterAccess::Write)
+            live.set(reg.index(), true);
+    });
+}
+
+}
+
+namespace JS::Bytecode::Passes {
+
+static Bitmap create_register_set(size_t number_of_registers)
+{
+    return Bitmap::create(number_of_registers, false).release_value_but_fixme_should_propagate_errors();
+}
+
+// Returns whether `destination` gained any registers.
+static bool merge_register_sets(Bitmap& destination, Bitmap const& source)
+{
+    bool changed = false;
+    for (size_t i = 0; i < destination.size_in_bytes(); ++i) {
+        u8 merged = destination.data()[i] | source.view().data()[i];
+        if (merged != destination.data()[i]) {
+            destination.data()[i] = merged;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+struct BlockSummary {
+    Bitmap uses;
+    Bitmap definitions;
+    Vector<BasicBlock const*> successors;
+};
+
+void AnalyzeRegisterLiveness::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    auto number_of_registers = executable.executable.number_of_registers;
+    auto const& basic_blocks = executable.executable.basic_blocks;
+
+    // GenerateCFG doesn't know where a finalizer continues after a ScheduleJump, and it only
+    // records the innermost handler for each block, so we gather a more conservative set of edges here:
+    // Every handler and finalizer can be entered from anywhere, and any ContinuePendingUnwind may
+    // resume at any ScheduleJump target.
+    HashTable<BasicBlock const*> handler_blocks;
+    Vector<BasicBlock const*> scheduled_jump_targets;
+    for (auto const& block : basic_blocks) {
+        for (InstructionStreamIterator it { block->instruction_stream() }; !it.at_end(); ++it) {
+            if ((*it).type() == Instruction::Type::EnterUnwindContext) {
+                auto const& enter = static_cast<Op::EnterUnwindContext const&>(*it);
+                if (enter.handler_target().has_value())
+                    handler_blocks.set(&enter.handler_target()->block());
+                if (enter.finalizer_target().has_value())
+                    handler_blocks.set(&enter.finalizer_target()->block());
+            } else if ((*it).type() == Instruction::Type::ScheduleJump) {
+                scheduled_jump_targets.append(&static_cast<Op::ScheduleJump const&>(*it).target().block());
+            }
+        }
+    }
+
+    HashMap<BasicBlock const*, BlockSummary> summaries;
+    for (auto const& block : basic_blocks) {
+        BlockSummary summary {
+            .uses = create_register_set(number_of_registers),
+            .definitions = create_register_set(number_of_registers),
+            .successors = {},
+        };
+
+        for (InstructionStreamIterator it { block->instruction_stream() }; !it.at_end(); ++it) {
+            auto const& instruction = *it;
+
+            if (instruction.type() == Instruction::Type::NewArray) {
+                auto const& new_array = static_cast<Op::NewArray const&>(instruction);
+                for (size_t i = 0; i < new_array.element_count(); ++i) {
+                    auto index = new_array.start().index() + i;
+                    if (!summary.definitions.get(index))
+                        summary.uses.set(index, true);
+                }
+            } else {
+                const_cast<Instruction&>(instruction).for_each_register_operand([&](Register& reg, Instruction::RegisterAccess access) {
+                    if (access != Instruction::RegisterAccess::Write && !summary.definitions.get(reg.index()))
+                        summary.uses.set(reg.index(), true);
+                    if (access != Instruction::RegisterAccess::Read)
+                        summary.definitions.set(reg.index(), true);
+                });
+            }
+
+            if (!instruction.is_terminator())
+                continue;
+
+            using enum Instruction::Type;
+            switch (instruction.type()) {
+            case Jump:
+            case JumpConditional:
+            case JumpNullish:
+            case JumpUndefined: {
+                auto const& jump = static_cast<Op::Jump const&>(instruction);
+                if (jump.true_target().has_value())
+                    summary.successors.append(&jump.true_target()->block());
+                if (jump.false_target().has_value())
+                    summary.successors.append(&jump.false_target()->block());
+                break;
+            }
+            case EnterUnwindContext:
+                summary.successors.append(&static_cast<Op::EnterUnwindContext const&>(instruction).entry_point().block());
+                break;
+            case ContinuePendingUnwind:
+                summary.successors.append(&static_cast<Op::ContinuePendingUnwind const&>(instruction).resume_target().block());
+                summary.successors.extend(scheduled_jump_targets);
+                break;
+            case ScheduleJump:
+                summary.successors.append(&static_cast<Op::ScheduleJump const&>(instruction).target().block());
+                break;
+            case Yield: {
+                auto const& continuation = static_cast<Op::Yield const&>(instruction).continuation();
+                if (continuation.has_value())
+                    summary.successors.append(&continuation->block());
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        summaries.set(block.ptr(), move(summary));
+    }
+
+    auto liveness_ptr = make_ref_counted<RegisterLiveness>();
+    auto& liveness = *liveness_ptr;
+    liveness.live_into_handlers = create_register_set(number_of_registers);
+    for (auto const& block : basic_blocks) {
+        liveness.live_in.set(block.ptr(), create_register_set(number_of_registers));
+        liveness.live_out.set(block.ptr(), create_register_set(number_of_registers));
+    }
+
+    // Plain backwards dataflow until nothing changes anymore, visiting the blocks in reverse to speed things up.
+    auto live_out = create_register_set(number_of_registers);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (auto const* handler : handler_blocks)
+            merge_register_sets(liveness.live_into_handlers, *liveness.live_in.get(handler));
+
+        for (size_t i = basic_blocks.size(); i > 0; --i) {
+            auto const* block = basic_blocks[i - 1].ptr();
+            auto const& summary = *summaries.get(block);
+
+            live_out.fill(false);
+            merge_register_sets(live_out, liveness.live_into_handlers);
+            for (auto const* successor : summary.successors)
+                merge_register_sets(live_out, *liveness.live_in.get(successor));
+            changed |= merge_register_sets(*liveness.live_out.get(block), live_out);
+
+            // live_in = uses | (live_out & ~definitions) | live_into_handlers
+            auto& live_in = *liveness.live_in.get(block);
+            for (size_t byte = 0; byte < live_out.size_in_bytes(); ++byte)
+                live_out.data()[byte] &= ~summary.definitions.view().data()[byte];
+            merge_register_sets(live_out, summary.uses);
+            merge_register_sets(live_out, liveness.live_into_handlers);
+            changed |= merge_register_sets(live_in, live_out);
+        }
+    }
+
+    executable.register_liveness = move(liveness_ptr);
+
+    finished();
+}
+
+}
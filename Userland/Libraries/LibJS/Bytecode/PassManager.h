@@ -6,17 +6,32 @@
 
 #pragma once
 
+#include <AK/Bitmap.h>
+#include <AK/RefCounted.h>
 #include <LibCore/ElapsedTimer.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Generator.h>
 
 namespace JS::Bytecode {
 
+struct RegisterLiveness : public RefCounted<RegisterLiveness> {
+    HashMap<BasicBlock const*, Bitmap> live_in {};
+    HashMap<BasicBlock const*, Bitmap> live_out {};
+
+    // Registers that an exception handler or finalizer may read. Since nearly every instruction can throw,
+    // these are live at every point of the executable, and are already included in live_in and live_out.
+    Bitmap live_into_handlers {};
+
+    // Turns `live` from the set of registers live after `instruction` into the set live before it.
+    static void step_backwards(Instruction const& instruction, Bitmap& live);
+};
+
 struct PassPipelineExecutable {
     Executable& executable;
     Optional<HashMap<BasicBlock const*, HashTable<BasicBlock const*>>> cfg {};
     Optional<HashMap<BasicBlock const*, HashTable<BasicBlock const*>>> inverted_cfg {};
     Optional<HashTable<BasicBlock const*>> exported_blocks {};
+    RefPtr<RegisterLiveness> register_liveness {};
 };
 
 class Pass {
@@ -131,6 +146,51 @@ private:
     virtual void perform(PassPipelineExecutable&) override;
 };
 
+class AnalyzeRegisterLiveness : public Pass {
+public:
+    AnalyzeRegisterLiveness() = default;
+    virtual ~AnalyzeRegisterLiveness() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class PropagateConstants : public Pass {
+public:
+    PropagateConstants() = default;
+    virtual ~PropagateConstants() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class PropagateCopies : public Pass {
+public:
+    PropagateCopies() = default;
+    virtual ~PropagateCopies() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class EliminateDeadStores : public Pass {
+public:
+    EliminateDeadStores() = default;
+    virtual ~EliminateDeadStores() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class CoalesceRegisters : public Pass {
+public:
+    CoalesceRegisters() = default;
+    virtual ~CoalesceRegisters() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
 }
 
 }
@@ -27,6 +27,10 @@ public:                                            \
     }                                              \
     friend class JS::Heap;
 
+// The Value counterpart of write_barrier(), for cells that rely on the write barrier but keep some of their
+// edges in Values. `holder` is the cell that overwrote or dropped `old_value`.
+void value_write_barrier(Cell& holder, Value old_value, Value new_value);
+
 class Cell {
     AK_MAKE_NONCOPYABLE(Cell);
     AK_MAKE_NONMOVABLE(Cell);
@@ -46,6 +50,14 @@ public:
     State state() const { return m_state; }
     void set_state(State state) { m_state = state; }
 
+    // Cells start out in the young generation and get promoted when they survive a collection.
+    bool is_young() const { return m_young; }
+    void set_young(bool b) { m_young = b; }
+
+    // Set on old cells that the write barrier saw storing a pointer to a young cell.
+    bool is_remembered() const { return m_remembered; }
+    void set_remembered(bool b) { m_remembered = b; }
+
     virtual StringView class_name() const = 0;
 
     class Visitor {
@@ -105,6 +117,8 @@ public:
 
     bool overrides_must_survive_garbage_collection(Badge<Heap>) const { return m_overrides_must_survive_garbage_collection; }
 
+    bool relies_on_write_barrier(Badge<Heap>) const { return m_relies_on_write_barrier; }
+
     Heap& heap() const;
     VM& vm() const;
 
@@ -113,10 +127,26 @@ protected:
 
     void set_overrides_must_survive_garbage_collection(bool b) { m_overrides_must_survive_garbage_collection = b; }
 
+    // Old cells are scanned by every minor collection, and revisited once incremental marking is done, since
+    // they may have picked up pointers to other cells through a Value or some out-of-line storage that we can't
+    // see. Cells that only ever point to other cells through their own GCPtr/NonnullGCPtr members, or that report
+    // every other change through did_overwrite_value(), can opt out of that, as the write barrier covers them.
+    void set_relies_on_write_barrier(bool b) { m_relies_on_write_barrier = b; }
+
+    // Cells that rely on the write barrier have to call this whenever they overwrite or drop a Value they hold.
+    void did_overwrite_value(Value old_value, Value new_value)
+    {
+        if (m_relies_on_write_barrier && (old_value.is_cell() || new_value.is_cell()))
+            value_write_barrier(*this, old_value, new_value);
+    }
+
 private:
     bool m_mark : 1 { false };
     bool m_overrides_must_survive_garbage_collection : 1 { false };
     State m_state : 1 { State::Live };
+    bool m_young : 1 { true };
+    bool m_remembered : 1 { false };
+    bool m_relies_on_write_barrier : 1 { false };
 };
 
 }
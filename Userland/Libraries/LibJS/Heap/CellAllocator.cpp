@@ -19,22 +19,25 @@ CellAllocator::CellAllocator(size_t cell_size)
 
 Cell* CellAllocator::allocate_cell(Heap& heap)
 {
-    if (m_usable_blocks.is_empty()) {
-        auto block = HeapBlock::create_with_cell_size(heap, m_cell_size);
-        m_usable_blocks.append(*block.leak_ptr());
+    if (m_nursery_blocks.is_empty() || m_nursery_blocks.last()->is_full()) {
+        if (!m_usable_blocks.is_empty()) {
+            m_nursery_blocks.append(*m_usable_blocks.last());
+        } else {
+            auto block = HeapBlock::create_with_cell_size(heap, m_cell_size);
+            heap.did_create_heap_block({}, *block);
+            m_nursery_blocks.append(*block.leak_ptr());
+        }
     }
 
-    auto& block = *m_usable_blocks.last();
-    auto* cell = block.allocate();
+    auto* cell = m_nursery_blocks.last()->allocate();
     VERIFY(cell);
-    if (block.is_full())
-        m_full_blocks.append(*m_usable_blocks.last());
     return cell;
 }
 
 void CellAllocator::block_did_become_empty(Badge<Heap>, HeapBlock& block)
 {
     auto& heap = block.heap();
+    heap.did_destroy_heap_block({}, block);
     block.m_list_node.remove();
     // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
     block.~HeapBlock();
@@ -47,4 +50,15 @@ void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
     m_usable_blocks.append(block);
 }
 
+void CellAllocator::retire_nursery_blocks(Badge<Heap>)
+{
+    while (!m_nursery_blocks.is_empty()) {
+        auto& block = *m_nursery_blocks.first();
+        if (block.is_full())
+            m_full_blocks.append(block);
+        else
+            m_usable_blocks.append(block);
+    }
+}
+
 }
@@ -33,11 +33,22 @@ public:
             if (callback(block) == IterationDecision::Break)
                 return IterationDecision::Break;
         }
+        return for_each_nursery_block(callback);
+    }
+
+    template<typename Callback>
+    IterationDecision for_each_nursery_block(Callback callback)
+    {
+        for (auto& block : m_nursery_blocks) {
+            if (callback(block) == IterationDecision::Break)
+                return IterationDecision::Break;
+        }
         return IterationDecision::Continue;
     }
 
     void block_did_become_empty(Badge<Heap>, HeapBlock&);
     void block_did_become_usable(Badge<Heap>, HeapBlock&);
+    void retire_nursery_blocks(Badge<Heap>);
 
 private:
     const size_t m_cell_size;
@@ -45,6 +56,11 @@ private:
     using BlockList = IntrusiveList<&HeapBlock::m_list_node>;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+
+    // New cells are only ever allocated in nursery blocks, so collecting the young generation only has to
+    // look at these. Fresh blocks get bump allocated through their lazy freelist, and once those run out we
+    // reuse the free cells of old blocks. After every collection, the nursery is retired into the lists above.
+    BlockList m_nursery_blocks;
 };
 
 }
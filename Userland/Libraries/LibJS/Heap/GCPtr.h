@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Traits.h>
 #include <AK/Types.h>
 
@@ -14,6 +15,29 @@ namespace JS {
 template<typename T>
 class GCPtr;
 
+// Called whenever a GCPtr or NonnullGCPtr is assigned, so the heap can remember old cells that start pointing
+// into the young generation, and so incremental marking doesn't lose track of cells that get moved around
+// while it's in progress. `slot` is the address of the pointer that was written to.
+void write_barrier(void const* slot, void const* old_target, void const* new_target);
+
+// How many heaps are marking incrementally right now, across all threads.
+extern Atomic<u32> g_heaps_marking_incrementally;
+
+// Most stores don't need the write barrier at all, so decide that inline instead of calling write_barrier().
+// This is the case when nobody is marking incrementally and the new target is null or in the old generation.
+// NOTE: We can only tell the generation of targets whose type is complete here, the rest takes the slow path.
+template<typename T>
+ALWAYS_INLINE bool can_skip_write_barrier(T const* new_target)
+{
+    if (g_heaps_marking_incrementally.load(AK::MemoryOrder::memory_order_relaxed) != 0)
+        return false;
+    if (!new_target)
+        return true;
+    if constexpr (requires { new_target->is_young(); })
+        return !new_target->is_young();
+    return false;
+}
+
 template<typename T>
 class NonnullGCPtr {
 public:
@@ -45,7 +69,7 @@ public:
 
     NonnullGCPtr& operator=(NonnullGCPtr const& other)
     {
-        m_ptr = other.ptr();
+        assign(other.ptr());
         return *this;
     }
 
@@ -53,13 +77,13 @@ public:
     NonnullGCPtr& operator=(NonnullGCPtr<U> const& other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = static_cast<T*>(other.ptr());
+        assign(static_cast<T*>(other.ptr()));
         return *this;
     }
 
     NonnullGCPtr& operator=(T& other)
     {
-        m_ptr = &other;
+        assign(&other);
         return *this;
     }
 
@@ -67,7 +91,7 @@ public:
     NonnullGCPtr& operator=(U& other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = &static_cast<T&>(other);
+        assign(&static_cast<T&>(other));
         return *this;
     }
 
@@ -82,6 +106,14 @@ public:
     operator T&() const { return *m_ptr; }
 
 private:
+    void assign(T* ptr)
+    {
+        auto* old_ptr = m_ptr;
+        m_ptr = ptr;
+        if (!can_skip_write_barrier(m_ptr))
+            write_barrier(this, old_ptr, m_ptr);
+    }
+
     T* m_ptr { nullptr };
 };
 
@@ -129,19 +161,23 @@ public:
     {
     }
 
-    GCPtr& operator=(GCPtr const&) = default;
+    GCPtr& operator=(GCPtr const& other)
+    {
+        assign(other.ptr());
+        return *this;
+    }
 
     template<typename U>
     GCPtr& operator=(GCPtr<U> const& other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = static_cast<T*>(other.ptr());
+        assign(static_cast<T*>(other.ptr()));
         return *this;
     }
 
     GCPtr& operator=(NonnullGCPtr<T> const& other)
     {
-        m_ptr = other.ptr();
+        assign(other.ptr());
         return *this;
     }
 
@@ -149,13 +185,13 @@ public:
     GCPtr& operator=(NonnullGCPtr<U> const& other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = static_cast<T*>(other.ptr());
+        assign(static_cast<T*>(other.ptr()));
         return *this;
     }
 
     GCPtr& operator=(T& other)
     {
-        m_ptr = &other;
+        assign(&other);
         return *this;
     }
 
@@ -163,13 +199,13 @@ public:
     GCPtr& operator=(U& other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = &static_cast<T&>(other);
+        assign(&static_cast<T&>(other));
         return *this;
     }
 
     GCPtr& operator=(T* other)
     {
-        m_ptr = other;
+        assign(other);
         return *this;
     }
 
@@ -177,7 +213,7 @@ public:
     GCPtr& operator=(U* other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = static_cast<T*>(other);
+        assign(static_cast<T*>(other));
         return *this;
     }
 
@@ -201,6 +237,14 @@ public:
     operator T*() const { return m_ptr; }
 
 private:
+    void assign(T* ptr)
+    {
+        auto* old_ptr = m_ptr;
+        m_ptr = ptr;
+        if ((old_ptr || m_ptr) && !can_skip_write_barrier(m_ptr))
+            write_barrier(this, old_ptr, m_ptr);
+    }
+
     T* m_ptr { nullptr };
 };
 
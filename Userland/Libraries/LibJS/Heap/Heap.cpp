@@ -33,6 +33,12 @@ static int gc_perf_string_id;
 // NOTE: We keep a per-thread list of custom ranges. This hinges on the assumption that there is one JS VM per thread.
 static __thread HashMap<FlatPtr*, size_t>* s_custom_ranges_for_conservative_scan = nullptr;
 
+// The heap that is currently marking incrementally, if any. The write barrier only gets to see slots and
+// targets, so this is how it finds out whether it has to shade them.
+static __thread Heap* s_heap_marking_incrementally = nullptr;
+
+Atomic<u32> g_heaps_marking_incrementally { 0 };
+
 Heap::Heap(VM& vm)
     : m_vm(vm)
 {
@@ -72,19 +78,39 @@ ALWAYS_INLINE CellAllocator& Heap::allocator_for_size(size_t cell_size)
     VERIFY_NOT_REACHED();
 }
 
+Heap::CollectionType Heap::next_automatic_collection_type() const
+{
+    if (m_incremental_marking_in_progress)
+        return CollectionType::CollectGarbage;
+    if (m_young_collections_since_last_full_collection >= m_max_young_collections_between_full_collections)
+        return CollectionType::CollectGarbage;
+    if (m_cells_promoted_since_last_full_collection > m_live_cells_after_last_full_collection)
+        return CollectionType::CollectGarbage;
+    return CollectionType::CollectYoungGeneration;
+}
+
 Cell* Heap::allocate_cell(size_t size)
 {
     if (should_collect_on_every_allocation()) {
         collect_garbage();
     } else if (m_allocations_since_last_gc > m_max_allocations_between_gc) {
         m_allocations_since_last_gc = 0;
-        collect_garbage();
+        auto collection_type = next_automatic_collection_type();
+        if (collection_type == CollectionType::CollectGarbage && !m_incremental_marking_in_progress && !m_incremental_marking_slice_budget.is_zero())
+            start_incremental_marking();
+        else
+            collect_garbage(collection_type);
     } else {
         ++m_allocations_since_last_gc;
+        if (m_incremental_marking_in_progress && m_allocations_since_last_gc % m_allocations_between_incremental_marking_slices == 0)
+            perform_incremental_marking_slice();
     }
 
     auto& allocator = allocator_for_size(size);
-    return allocator.allocate_cell(*this);
+    auto* cell = allocator.allocate_cell(*this);
+    if (m_incremental_marking_in_progress)
+        m_cells_allocated_during_incremental_marking.append(cell);
+    return cell;
 }
 
 void Heap::collect_garbage(CollectionType collection_type, bool print_report)
@@ -98,20 +124,35 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
 #endif
 
     Core::ElapsedTimer collection_measurement_timer;
-    if (print_report)
-        collection_measurement_timer.start();
+    collection_measurement_timer.start();
+
+    if (m_incremental_marking_in_progress) {
+        // Any collection requested in the middle of incremental marking finishes it, except for
+        // CollectEverything, which doesn't care about what's live.
+        if (collection_type == CollectionType::CollectEverything)
+            abandon_incremental_marking();
+        else
+            collection_type = CollectionType::CollectGarbage;
+    }
 
-    if (collection_type == CollectionType::CollectGarbage) {
+    if (collection_type != CollectionType::CollectEverything) {
         if (m_gc_deferrals) {
             m_should_gc_when_deferral_ends = true;
             return;
         }
-        HashTable<Cell*> roots;
-        gather_roots(roots);
-        mark_live_cells(roots);
+        if (m_incremental_marking_in_progress) {
+            finish_incremental_marking();
+        } else {
+            HashTable<Cell*> roots;
+            gather_roots(roots);
+            if (collection_type == CollectionType::CollectYoungGeneration)
+                mark_live_young_cells(roots);
+            else
+                mark_live_cells(roots);
+        }
     }
-    finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    finalize_unmarked_cells(collection_type);
+    sweep_dead_cells(collection_type, print_report, collection_measurement_timer);
 }
 
 void Heap::gather_roots(HashTable<Cell*>& roots)
@@ -183,18 +224,12 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
         }
     }
 
-    HashTable<HeapBlock*> all_live_heap_blocks;
-    for_each_block([&](auto& block) {
-        all_live_heap_blocks.set(&block);
-        return IterationDecision::Continue;
-    });
-
     for (auto possible_pointer : possible_pointers) {
         if (!possible_pointer)
             continue;
         dbgln_if(HEAP_DEBUG, "  ? {}", (void const*)possible_pointer);
         auto* possible_heap_block = HeapBlock::from_cell(reinterpret_cast<Cell const*>(possible_pointer));
-        if (all_live_heap_blocks.contains(possible_heap_block)) {
+        if (m_live_heap_blocks.contains(possible_heap_block)) {
             if (auto* cell = possible_heap_block->cell_from_possible_pointer(possible_pointer)) {
                 if (cell->state() == Cell::State::Live) {
                     dbgln_if(HEAP_DEBUG, "  ?-> {}", (void const*)cell);
@@ -209,7 +244,18 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
 
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    explicit MarkingVisitor(HashTable<Cell*> const& roots)
+    enum class Generation {
+        All,
+        YoungOnly,
+    };
+
+    explicit MarkingVisitor(Vector<Cell&>& work_queue, Generation generation = Generation::All)
+        : m_generation(generation)
+        , m_work_queue(work_queue)
+    {
+    }
+
+    void visit_roots(HashTable<Cell*> const& roots)
     {
         for (auto* root : roots) {
             visit(root);
@@ -220,6 +266,9 @@ public:
     {
         if (cell.is_marked())
             return;
+        // When only collecting the young generation, old cells are live by definition and we don't look inside them.
+        if (m_generation == Generation::YoungOnly && !cell.is_young())
+            return;
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
         cell.set_marked(true);
@@ -234,14 +283,16 @@ public:
     }
 
 private:
-    Vector<Cell&> m_work_queue;
+    Generation m_generation { Generation::All };
+    Vector<Cell&>& m_work_queue;
 };
 
 void Heap::mark_live_cells(HashTable<Cell*> const& roots)
 {
     dbgln_if(HEAP_DEBUG, "mark_live_cells:");
 
-    MarkingVisitor visitor(roots);
+    MarkingVisitor visitor(m_marking_work_queue);
+    visitor.visit_roots(roots);
     visitor.mark_all_live_cells();
 
     for (auto& inverse_root : m_uprooted_cells)
@@ -250,6 +301,128 @@ void Heap::mark_live_cells(HashTable<Cell*> const& roots)
     m_uprooted_cells.clear();
 }
 
+void Heap::mark_live_young_cells(HashTable<Cell*> const& roots)
+{
+    dbgln_if(HEAP_DEBUG, "mark_live_young_cells:");
+
+    MarkingVisitor visitor(m_marking_work_queue, MarkingVisitor::Generation::YoungOnly);
+    visitor.visit_roots(roots);
+
+    // Old cells may point into the young generation, so their edges are roots too.
+    for (auto* cell : m_remembered_cells)
+        cell->visit_edges(visitor);
+    for (auto* cell : m_old_cells_without_write_barrier)
+        cell->visit_edges(visitor);
+
+    visitor.mark_all_live_cells();
+
+    // Uprooted cells that are already old can only be collected by a full collection, so keep them around until then.
+    m_uprooted_cells.remove_all_matching([](auto& inverse_root) {
+        if (!inverse_root->is_young())
+            return false;
+        inverse_root->set_marked(false);
+        return true;
+    });
+}
+
+void Heap::start_incremental_marking()
+{
+    VERIFY(!m_incremental_marking_in_progress);
+
+    dbgln_if(HEAP_DEBUG, "start_incremental_marking:");
+
+    auto timer = Core::ElapsedTimer::start_new();
+
+    // Everything reachable from the roots right now is live, the write barrier takes care of the rest.
+    HashTable<Cell*> roots;
+    gather_roots(roots);
+    MarkingVisitor visitor(m_marking_work_queue);
+    visitor.visit_roots(roots);
+
+    m_incremental_marking_in_progress = true;
+    s_heap_marking_incrementally = this;
+    g_heaps_marking_incrementally.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    ++m_incremental_marking_cycles;
+
+    m_incremental_marking_slice_pauses.record(timer.elapsed_time());
+}
+
+void Heap::perform_incremental_marking_slice()
+{
+    VERIFY(m_incremental_marking_in_progress);
+    VERIFY(!m_collecting_garbage);
+
+    auto timer = Core::ElapsedTimer::start_new();
+
+    MarkingVisitor visitor(m_marking_work_queue);
+    size_t visited_cells = 0;
+    while (!m_marking_work_queue.is_empty()) {
+        auto& cell = m_marking_work_queue.take_last();
+        cell.visit_edges(visitor);
+        if (!cell.relies_on_write_barrier({}))
+            m_marked_cells_without_write_barrier.append(&cell);
+
+        // Looking at the clock isn't free, so only do it every now and then.
+        if (++visited_cells % 256 == 0 && timer.elapsed_time() >= m_incremental_marking_slice_budget)
+            break;
+    }
+
+    m_incremental_marking_slice_pauses.record(timer.elapsed_time());
+
+    if (m_marking_work_queue.is_empty())
+        collect_garbage();
+}
+
+void Heap::finish_incremental_marking()
+{
+    VERIFY(m_incremental_marking_in_progress);
+
+    dbgln_if(HEAP_DEBUG, "finish_incremental_marking:");
+
+    // The stack and registers aren't covered by the write barrier, so scan the roots again.
+    HashTable<Cell*> roots;
+    gather_roots(roots);
+    MarkingVisitor visitor(m_marking_work_queue);
+    visitor.visit_roots(roots);
+
+    for (auto* cell : m_cells_allocated_during_incremental_marking)
+        visitor.visit(cell);
+
+    for (auto* cell : m_marked_cells_without_write_barrier)
+        cell->visit_edges(visitor);
+
+    visitor.mark_all_live_cells();
+
+    for (auto& inverse_root : m_uprooted_cells)
+        inverse_root->set_marked(false);
+    m_uprooted_cells.clear();
+
+    m_cells_allocated_during_incremental_marking.clear_with_capacity();
+    m_marked_cells_without_write_barrier.clear_with_capacity();
+    m_incremental_marking_in_progress = false;
+    s_heap_marking_incrementally = nullptr;
+    g_heaps_marking_incrementally.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
+void Heap::abandon_incremental_marking()
+{
+    VERIFY(m_incremental_marking_in_progress);
+
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+            cell->set_marked(false);
+        });
+        return IterationDecision::Continue;
+    });
+
+    m_marking_work_queue.clear_with_capacity();
+    m_cells_allocated_during_incremental_marking.clear_with_capacity();
+    m_marked_cells_without_write_barrier.clear_with_capacity();
+    m_incremental_marking_in_progress = false;
+    s_heap_marking_incrementally = nullptr;
+    g_heaps_marking_incrementally.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
 bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
 {
     if (!cell.overrides_must_survive_garbage_collection({}))
@@ -257,10 +430,13 @@ bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
     return cell.must_survive_garbage_collection();
 }
 
-void Heap::finalize_unmarked_cells()
+void Heap::finalize_unmarked_cells(CollectionType collection_type)
 {
-    for_each_block([&](auto& block) {
-        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+    bool young_generation_only = collection_type == CollectionType::CollectYoungGeneration;
+    for_each_block_in(collection_type, [&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (young_generation_only && !cell->is_young())
+                return;
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
                 cell->finalize();
         });
@@ -268,7 +444,7 @@ void Heap::finalize_unmarked_cells()
     });
 }
 
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+void Heap::sweep_dead_cells(CollectionType collection_type, bool print_report, Core::ElapsedTimer const& measurement_timer)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
@@ -278,11 +454,22 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
     size_t live_cells = 0;
     size_t collected_cell_bytes = 0;
     size_t live_cell_bytes = 0;
+    size_t promoted_cells = 0;
 
-    for_each_block([&](auto& block) {
+    bool young_generation_only = collection_type == CollectionType::CollectYoungGeneration;
+
+    // Old cells only die in full collections, which rebuild this list from scratch.
+    if (!young_generation_only)
+        m_old_cells_without_write_barrier.clear_with_capacity();
+
+    for_each_block_in(collection_type, [&](auto& block) {
         bool block_has_live_cells = false;
         bool block_was_full = block.is_full();
         block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (young_generation_only && !cell->is_young()) {
+                block_has_live_cells = true;
+                return;
+            }
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
                 dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
                 block.deallocate(cell);
@@ -290,6 +477,13 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
                 collected_cell_bytes += block.cell_size();
             } else {
                 cell->set_marked(false);
+                if (cell->is_young()) {
+                    cell->set_young(false);
+                    ++promoted_cells;
+                }
+                cell->set_remembered(false);
+                if (!cell->relies_on_write_barrier({}))
+                    m_old_cells_without_write_barrier.append(cell);
                 block_has_live_cells = true;
                 ++live_cells;
                 live_cell_bytes += block.cell_size();
@@ -315,6 +509,31 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
     }
 
+    // Everything that survived has been promoted, so there's nothing young left to point to.
+    for (auto& allocator : m_allocators)
+        allocator->retire_nursery_blocks({});
+
+    if (young_generation_only) {
+        for (auto* cell : m_remembered_cells)
+            cell->set_remembered(false);
+    }
+    m_remembered_cells.clear_with_capacity();
+
+    if (young_generation_only) {
+        ++m_young_collections_since_last_full_collection;
+        m_cells_promoted_since_last_full_collection += promoted_cells;
+    } else {
+        m_young_collections_since_last_full_collection = 0;
+        m_cells_promoted_since_last_full_collection = 0;
+        m_live_cells_after_last_full_collection = live_cells;
+    }
+
+    Duration const time_spent = measurement_timer.elapsed_time();
+    if (young_generation_only)
+        m_young_collection_pauses.record(time_spent);
+    else
+        m_full_collection_pauses.record(time_spent);
+
     if constexpr (HEAP_DEBUG) {
         for_each_block([&](auto& block) {
             dbgln(" > Live HeapBlock @ {}: cell_size={}", &block, block.cell_size());
@@ -323,7 +542,6 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
     }
 
     if (print_report) {
-        Duration const time_spent = measurement_timer.elapsed_time();
         size_t live_block_count = 0;
         for_each_block([&](auto&) {
             ++live_block_count;
@@ -332,15 +550,78 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
 
         dbgln("Garbage collection report");
         dbgln("=============================================");
+        dbgln("     Collection: {}", young_generation_only ? "young generation"sv : "full"sv);
         dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
         dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
         dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
+        dbgln(" Promoted cells: {}", promoted_cells);
         dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
         dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
         dbgln("=============================================");
+        print_pause_histograms();
     }
 }
 
+void Heap::PauseHistogram::record(Duration pause)
+{
+    auto milliseconds = static_cast<u64>(pause.to_milliseconds());
+    size_t bucket = 0;
+    while (bucket < bucket_count - 1 && milliseconds >= (1ull << bucket))
+        ++bucket;
+    ++m_buckets[bucket];
+    ++m_pause_count;
+    m_total_time += pause;
+    if (pause > m_longest_pause)
+        m_longest_pause = pause;
+}
+
+void Heap::PauseHistogram::dump(StringView name) const
+{
+    if (!m_pause_count) {
+        dbgln("{} pauses: none", name);
+        return;
+    }
+    dbgln("{} pauses: {} (total {} ms, longest {} ms)", name, m_pause_count, m_total_time.to_milliseconds(), m_longest_pause.to_milliseconds());
+    for (size_t i = 0; i < bucket_count; ++i) {
+        if (!m_buckets[i])
+            continue;
+        if (i == bucket_count - 1)
+            dbgln("  >= {:4} ms: {}", 1ull << (i - 1), m_buckets[i]);
+        else
+            dbgln("  <  {:4} ms: {}", 1ull << i, m_buckets[i]);
+    }
+}
+
+void Heap::print_pause_histograms() const
+{
+    m_young_collection_pauses.dump("Young generation collection"sv);
+    m_full_collection_pauses.dump("Full collection"sv);
+    m_incremental_marking_slice_pauses.dump("Incremental marking slice"sv);
+    dbgln("=============================================");
+}
+
+Heap::Statistics Heap::statistics() const
+{
+    return {
+        .young_collections = m_young_collection_pauses.statistics(),
+        .full_collections = m_full_collection_pauses.statistics(),
+        .incremental_marking_slices = m_incremental_marking_slice_pauses.statistics(),
+        .incremental_marking_cycles = m_incremental_marking_cycles,
+    };
+}
+
+void Heap::dump_statistics(StringBuilder& builder) const
+{
+    auto statistics = this->statistics();
+    auto dump_pauses = [&](StringView name, PauseStatistics const& pauses) {
+        builder.appendff("{}: {} (total {} us, longest {} us)\n", name, pauses.count, pauses.total_time.to_microseconds(), pauses.longest_pause.to_microseconds());
+    };
+    dump_pauses("Young generation collections"sv, statistics.young_collections);
+    dump_pauses("Full collections"sv, statistics.full_collections);
+    dump_pauses("Incremental marking slices"sv, statistics.incremental_marking_slices);
+    builder.appendff("Incremental marking cycles: {}\n", statistics.incremental_marking_cycles);
+}
+
 void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
 {
     VERIFY(!m_handles.contains(impl));
@@ -377,6 +658,89 @@ void Heap::did_destroy_weak_container(Badge<WeakContainer>, WeakContainer& set)
     m_weak_containers.remove(set);
 }
 
+void Heap::did_create_heap_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    m_live_heap_blocks.set(&block);
+}
+
+void Heap::did_destroy_heap_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    m_live_heap_blocks.remove(&block);
+}
+
+void Heap::did_store_pointer_to_young_cell(void const* slot)
+{
+    // Everything that survives a collection gets promoted, so stores made while collecting don't matter.
+    if (m_collecting_garbage)
+        return;
+
+    // We only care about pointers stored inside old cells. Pointers on the stack or in malloc()'d memory are
+    // either roots, or belong to cells that minor collections scan anyway.
+    auto* slot_block = HeapBlock::from_cell(static_cast<Cell const*>(slot));
+    if (!m_live_heap_blocks.contains(slot_block))
+        return;
+    auto* holder = slot_block->cell_from_possible_pointer(bit_cast<FlatPtr>(slot));
+    if (!holder || holder->state() != Cell::State::Live)
+        return;
+    did_store_pointer_to_young_cell(*holder);
+}
+
+void Heap::did_store_pointer_to_young_cell(Cell& holder)
+{
+    if (m_collecting_garbage || holder.is_young() || holder.is_remembered())
+        return;
+    holder.set_remembered(true);
+    m_remembered_cells.append(&holder);
+}
+
+void Heap::shade_possible_cell(void const* pointer)
+{
+    VERIFY(m_incremental_marking_in_progress);
+
+    auto* block = HeapBlock::from_cell(static_cast<Cell const*>(pointer));
+    if (!m_live_heap_blocks.contains(block))
+        return;
+    auto* cell = block->cell_from_possible_pointer(bit_cast<FlatPtr>(pointer));
+    if (!cell || cell->state() != Cell::State::Live || cell->is_marked())
+        return;
+    cell->set_marked(true);
+    m_marking_work_queue.append(*cell);
+}
+
+// While marking incrementally, both the old and the new target of a store are shaded. Shading the old one keeps
+// the snapshot of the heap we took at the beginning intact, shading the new one covers cells that were moved
+// out of a cell without a write barrier, which we can't see.
+void write_barrier(void const* slot, void const* old_target, void const* new_target)
+{
+    if (auto* heap = s_heap_marking_incrementally) {
+        if (old_target)
+            heap->shade_possible_cell(old_target);
+        if (new_target)
+            heap->shade_possible_cell(new_target);
+    }
+
+    if (!new_target)
+        return;
+    auto* target_block = HeapBlock::from_cell(static_cast<Cell const*>(new_target));
+    auto* target_cell = target_block->cell_from_possible_pointer(bit_cast<FlatPtr>(new_target));
+    if (!target_cell || target_cell->state() != Cell::State::Live || !target_cell->is_young())
+        return;
+    target_block->heap().did_store_pointer_to_young_cell(slot);
+}
+
+void value_write_barrier(Cell& holder, Value old_value, Value new_value)
+{
+    if (auto* heap = s_heap_marking_incrementally) {
+        if (old_value.is_cell())
+            heap->shade_possible_cell(&old_value.as_cell());
+        if (new_value.is_cell())
+            heap->shade_possible_cell(&new_value.as_cell());
+    }
+
+    if (new_value.is_cell() && new_value.as_cell().is_young())
+        holder.heap().did_store_pointer_to_young_cell(holder);
+}
+
 void Heap::defer_gc(Badge<DeferGC>)
 {
     ++m_gc_deferrals;
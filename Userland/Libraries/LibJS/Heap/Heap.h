@@ -6,11 +6,13 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Badge.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -52,6 +54,7 @@ public:
 
     enum class CollectionType {
         CollectGarbage,
+        CollectYoungGeneration,
         CollectEverything,
     };
 
@@ -59,6 +62,29 @@ public:
 
     VM& vm() { return m_vm; }
 
+    // Full collections can spread their marking phase over short slices that run between allocations, instead of
+    // stopping the world until everything has been marked. Each slice stops once it has used up its budget.
+    // A zero budget (the default) turns this off.
+    void set_incremental_marking_slice_budget(Duration budget) { m_incremental_marking_slice_budget = budget; }
+    bool is_incremental_marking_in_progress() const { return m_incremental_marking_in_progress; }
+
+    struct PauseStatistics {
+        size_t count { 0 };
+        Duration total_time {};
+        Duration longest_pause {};
+    };
+
+    // Everything that stopped the mutator so far, for measuring GC jank.
+    struct Statistics {
+        PauseStatistics young_collections;
+        PauseStatistics full_collections;
+        PauseStatistics incremental_marking_slices;
+        size_t incremental_marking_cycles { 0 };
+    };
+
+    Statistics statistics() const;
+    void dump_statistics(StringBuilder&) const;
+
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
     void set_should_collect_on_every_allocation(bool b) { m_should_collect_on_every_allocation = b; }
 
@@ -71,6 +97,13 @@ public:
     void did_create_weak_container(Badge<WeakContainer>, WeakContainer&);
     void did_destroy_weak_container(Badge<WeakContainer>, WeakContainer&);
 
+    void did_create_heap_block(Badge<CellAllocator>, HeapBlock&);
+    void did_destroy_heap_block(Badge<CellAllocator>, HeapBlock&);
+
+    void did_store_pointer_to_young_cell(void const* slot);
+    void did_store_pointer_to_young_cell(Cell& holder);
+    void shade_possible_cell(void const*);
+
     void defer_gc(Badge<DeferGC>);
     void undefer_gc(Badge<DeferGC>);
 
@@ -83,11 +116,19 @@ private:
 
     Cell* allocate_cell(size_t);
 
+    CollectionType next_automatic_collection_type() const;
+
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
     void mark_live_cells(HashTable<Cell*> const& live_cells);
-    void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void mark_live_young_cells(HashTable<Cell*> const& live_cells);
+    void start_incremental_marking();
+    void perform_incremental_marking_slice();
+    void finish_incremental_marking();
+    void abandon_incremental_marking();
+    void finalize_unmarked_cells(CollectionType);
+    void sweep_dead_cells(CollectionType, bool print_report, Core::ElapsedTimer const&);
+    void print_pause_histograms() const;
 
     CellAllocator& allocator_for_size(size_t);
 
@@ -100,9 +141,43 @@ private:
         }
     }
 
+    template<typename Callback>
+    void for_each_block_in(CollectionType collection_type, Callback callback)
+    {
+        for (auto& allocator : m_allocators) {
+            auto decision = collection_type == CollectionType::CollectYoungGeneration
+                ? allocator->for_each_nursery_block(callback)
+                : allocator->for_each_block(callback);
+            if (decision == IterationDecision::Break)
+                return;
+        }
+    }
+
+    class PauseHistogram {
+    public:
+        void record(Duration);
+        void dump(StringView name) const;
+        PauseStatistics statistics() const { return { m_pause_count, m_total_time, m_longest_pause }; }
+
+    private:
+        // Bucket i counts pauses shorter than 2^i ms, the last one counts everything longer.
+        static constexpr size_t bucket_count = 10;
+        AK::Array<size_t, bucket_count> m_buckets {};
+        size_t m_pause_count { 0 };
+        Duration m_total_time {};
+        Duration m_longest_pause {};
+    };
+
     size_t m_max_allocations_between_gc { 100000 };
     size_t m_allocations_since_last_gc { 0 };
 
+    // Every so often, and whenever the old generation has doubled since the last full collection,
+    // an automatic collection collects everything instead of just the young generation.
+    size_t m_max_young_collections_between_full_collections { 8 };
+    size_t m_young_collections_since_last_full_collection { 0 };
+    size_t m_cells_promoted_since_last_full_collection { 0 };
+    size_t m_live_cells_after_last_full_collection { 0 };
+
     bool m_should_collect_on_every_allocation { false };
 
     VM& m_vm;
@@ -115,6 +190,30 @@ private:
 
     Vector<GCPtr<Cell>> m_uprooted_cells;
 
+    HashTable<HeapBlock*> m_live_heap_blocks;
+
+    // Old cells that minor collections have to treat as roots: those the write barrier has seen
+    // pointing into the young generation, and those whose edges it can't see at all.
+    Vector<Cell*> m_remembered_cells;
+    Vector<Cell*> m_old_cells_without_write_barrier;
+
+    PauseHistogram m_young_collection_pauses;
+    PauseHistogram m_full_collection_pauses;
+    PauseHistogram m_incremental_marking_slice_pauses;
+
+    // Grey cells: marked, but their edges haven't been visited yet.
+    Vector<Cell&> m_marking_work_queue;
+
+    Duration m_incremental_marking_slice_budget {};
+    size_t m_allocations_between_incremental_marking_slices { 1000 };
+    size_t m_incremental_marking_cycles { 0 };
+    bool m_incremental_marking_in_progress { false };
+
+    // Cells allocated while marking is in progress survive the cycle, but we only get to see their edges once
+    // they have been constructed. Cells without a write barrier get revisited as they may have changed behind our back.
+    Vector<Cell*> m_cells_allocated_during_incremental_marking;
+    Vector<Cell*> m_marked_cells_without_write_barrier;
+
     BlockAllocator m_block_allocator;
 
     size_t m_gc_deferrals { 0 };
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+
+namespace JS::JIT {
+
+// A tiny x86_64 encoder covering just the instructions the baseline compiler needs.
+// All memory operands are [base + disp32], and base must not be RSP or R12 (those need a SIB byte).
+class Assembler {
+public:
+    enum class Reg : u8 {
+        RAX = 0,
+        RCX = 1,
+        RDX = 2,
+        RBX = 3,
+        RSP = 4,
+        RBP = 5,
+        RSI = 6,
+        RDI = 7,
+        R8 = 8,
+        R9 = 9,
+        R10 = 10,
+        R11 = 11,
+        R12 = 12,
+        R13 = 13,
+        R14 = 14,
+        R15 = 15,
+    };
+
+    enum class Condition : u8 {
+        Overflow = 0x0,
+        NotOverflow = 0x1,
+        Below = 0x2,
+        AboveOrEqual = 0x3,
+        Equal = 0x4,
+        NotEqual = 0x5,
+        BelowOrEqual = 0x6,
+        Above = 0x7,
+        Sign = 0x8,
+        NotSign = 0x9,
+        LessThan = 0xc,
+        GreaterThanOrEqual = 0xd,
+        LessThanOrEqual = 0xe,
+        GreaterThan = 0xf,
+    };
+
+    enum class ALU : u8 {
+        Add = 0,
+        Or = 1,
+        And = 4,
+        Sub = 5,
+        Xor = 6,
+        Cmp = 7,
+    };
+
+    class Label {
+    public:
+        bool is_bound() const { return m_offset.has_value(); }
+        size_t offset() const { return m_offset.value(); }
+
+        void bind(Assembler& assembler)
+        {
+            VERIFY(!is_bound());
+            m_offset = assembler.m_output.size();
+            for (auto site : m_jump_sites)
+                assembler.patch_rel32(site, *m_offset);
+            m_jump_sites.clear();
+        }
+
+    private:
+        friend class Assembler;
+
+        void add_jump_site(Assembler& assembler, size_t site)
+        {
+            if (is_bound())
+                assembler.patch_rel32(site, *m_offset);
+            else
+                m_jump_sites.append(site);
+        }
+
+        Optional<size_t> m_offset;
+        Vector<size_t> m_jump_sites;
+    };
+
+    Vector<u8> const& output() const { return m_output; }
+    size_t offset() const { return m_output.size(); }
+
+    // mov reg, imm64
+    void mov_imm64(Reg dst, u64 imm)
+    {
+        emit_rex(true, 0, to_underlying(dst));
+        emit8(0xb8 | (to_underlying(dst) & 7));
+        emit64(imm);
+    }
+
+    // mov reg, reg (64-bit)
+    void mov(Reg dst, Reg src)
+    {
+        emit_rex(true, to_underlying(src), to_underlying(dst));
+        emit8(0x89);
+        emit_modrm_reg(to_underlying(src), to_underlying(dst));
+    }
+
+    // mov reg, [base + disp32]
+    void load64(Reg dst, Reg base, i32 displacement)
+    {
+        emit_rex(true, to_underlying(dst), to_underlying(base));
+        emit8(0x8b);
+        emit_modrm_mem(to_underlying(dst), base, displacement);
+    }
+
+    // mov [base + disp32], reg
+    void store64(Reg base, i32 displacement, Reg src)
+    {
+        emit_rex(true, to_underlying(src), to_underlying(base));
+        emit8(0x89);
+        emit_modrm_mem(to_underlying(src), base, displacement);
+    }
+
+    void push(Reg reg)
+    {
+        emit_rex_if_needed(0, to_underlying(reg));
+        emit8(0x50 | (to_underlying(reg) & 7));
+    }
+
+    void pop(Reg reg)
+    {
+        emit_rex_if_needed(0, to_underlying(reg));
+        emit8(0x58 | (to_underlying(reg) & 7));
+    }
+
+    // shr reg, imm8 (64-bit)
+    void shr64(Reg reg, u8 amount)
+    {
+        emit_rex(true, 0, to_underlying(reg));
+        emit8(0xc1);
+        emit_modrm_reg(5, to_underlying(reg));
+        emit8(amount);
+    }
+
+    // <alu> reg, imm32 (32-bit)
+    void alu32(ALU op, Reg reg, i32 imm)
+    {
+        emit_rex_if_needed(0, to_underlying(reg));
+        emit8(0x81);
+        emit_modrm_reg(to_underlying(op), to_underlying(reg));
+        emit32(static_cast<u32>(imm));
+    }
+
+    // <alu> dst, src (32-bit)
+    void alu32(ALU op, Reg dst, Reg src)
+    {
+        static constexpr u8 opcodes[] = { 0x01, 0x09, 0, 0, 0x21, 0x29, 0x31, 0x39 };
+        emit_rex_if_needed(to_underlying(src), to_underlying(dst));
+        emit8(opcodes[to_underlying(op)]);
+        emit_modrm_reg(to_underlying(src), to_underlying(dst));
+    }
+
+    // or dst, src (64-bit)
+    void or64(Reg dst, Reg src)
+    {
+        emit_rex(true, to_underlying(src), to_underlying(dst));
+        emit8(0x09);
+        emit_modrm_reg(to_underlying(src), to_underlying(dst));
+    }
+
+    // imul dst, src (32-bit)
+    void imul32(Reg dst, Reg src)
+    {
+        emit_rex_if_needed(to_underlying(dst), to_underlying(src));
+        emit8(0x0f);
+        emit8(0xaf);
+        emit_modrm_reg(to_underlying(dst), to_underlying(src));
+    }
+
+    // test lhs, rhs (32-bit)
+    void test32(Reg lhs, Reg rhs)
+    {
+        emit_rex_if_needed(to_underlying(rhs), to_underlying(lhs));
+        emit8(0x85);
+        emit_modrm_reg(to_underlying(rhs), to_underlying(lhs));
+    }
+
+    // test al, al
+    void test_al()
+    {
+        emit8(0x84);
+        emit8(0xc0);
+    }
+
+    // set<cc> al; movzx eax, al
+    void set_condition_into_eax(Condition condition)
+    {
+        emit8(0x0f);
+        emit8(0x90 | to_underlying(condition));
+        emit8(0xc0);
+        emit8(0x0f);
+        emit8(0xb6);
+        emit8(0xc0);
+    }
+
+    void jump(Label& label)
+    {
+        emit8(0xe9);
+        label.add_jump_site(*this, emit_rel32_placeholder());
+    }
+
+    void jump_if(Condition condition, Label& label)
+    {
+        emit8(0x0f);
+        emit8(0x80 | to_underlying(condition));
+        label.add_jump_site(*this, emit_rel32_placeholder());
+    }
+
+    // jmp reg
+    void jump(Reg reg)
+    {
+        emit_rex_if_needed(0, to_underlying(reg));
+        emit8(0xff);
+        emit_modrm_reg(4, to_underlying(reg));
+    }
+
+    // call reg
+    void call(Reg reg)
+    {
+        emit_rex_if_needed(0, to_underlying(reg));
+        emit8(0xff);
+        emit_modrm_reg(2, to_underlying(reg));
+    }
+
+    void ret() { emit8(0xc3); }
+
+private:
+    void emit8(u8 value) { m_output.append(value); }
+
+    void emit32(u32 value)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            emit8((value >> (i * 8)) & 0xff);
+    }
+
+    void emit64(u64 value)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            emit8((value >> (i * 8)) & 0xff);
+    }
+
+    void emit_rex(bool wide, u8 reg, u8 rm)
+    {
+        emit8(0x40 | (wide ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | ((rm & 8) ? 0x01 : 0));
+    }
+
+    void emit_rex_if_needed(u8 reg, u8 rm)
+    {
+        if ((reg | rm) & 8)
+            emit_rex(false, reg, rm);
+    }
+
+    void emit_modrm_reg(u8 reg, u8 rm)
+    {
+        emit8(0xc0 | ((reg & 7) << 3) | (rm & 7));
+    }
+
+    void emit_modrm_mem(u8 reg, Reg base, i32 displacement)
+    {
+        VERIFY((to_underlying(base) & 7) != to_underlying(Reg::RSP));
+        emit8(0x80 | ((reg & 7) << 3) | (to_underlying(base) & 7));
+        emit32(static_cast<u32>(displacement));
+    }
+
+    size_t emit_rel32_placeholder()
+    {
+        auto site = m_output.size();
+        emit32(0);
+        return site;
+    }
+
+    void patch_rel32(size_t site, size_t target)
+    {
+        auto relative = static_cast<i32>(static_cast<i64>(target) - static_cast<i64>(site + 4));
+        for (size_t i = 0; i < 4; ++i)
+            m_output[site + i] = (static_cast<u32>(relative) >> (i * 8)) & 0xff;
+    }
+
+    Vector<u8> m_output;
+};
+
+}
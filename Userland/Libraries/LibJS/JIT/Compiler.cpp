@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BitCast.h>
+#include <AK/Format.h>
+#include <AK/Platform.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+
+namespace JS::JIT {
+
+// Native code keeps the interpreter's register window in RBX and the interpreter itself in R12.
+// Both are callee-saved, so they survive calls back into C++.
+static constexpr auto REGISTER_WINDOW_BASE = Assembler::Reg::RBX;
+static constexpr auto INTERPRETER_BASE = Assembler::Reg::R12;
+
+static bool run_instruction_from_native_code(Bytecode::Interpreter& interpreter, Bytecode::Instruction const& instruction, Bytecode::BasicBlock const& block)
+{
+    return interpreter.run_instruction_for_jit(instruction, block);
+}
+
+static bool value_to_boolean_from_native_code(u64 encoded_value)
+{
+    return bit_cast<Value>(encoded_value).to_boolean();
+}
+
+void Compiler::load_register(Reg dst, Bytecode::Register reg)
+{
+    m_assembler.load64(dst, REGISTER_WINDOW_BASE, static_cast<i32>(reg.index() * sizeof(Value)));
+}
+
+void Compiler::store_register(Bytecode::Register reg, Reg src)
+{
+    m_assembler.store64(REGISTER_WINDOW_BASE, static_cast<i32>(reg.index() * sizeof(Value)), src);
+}
+
+void Compiler::branch_if_not_int32(Reg value, Assembler::Label& label)
+{
+    m_assembler.mov(Reg::RCX, value);
+    m_assembler.shr64(Reg::RCX, TAG_SHIFT);
+    m_assembler.alu32(Assembler::ALU::Cmp, Reg::RCX, static_cast<i32>(INT32_TAG));
+    m_assembler.jump_if(Assembler::Condition::NotEqual, label);
+}
+
+// NOTE: These expect the upper 32 bits of `value` to be clear, which every 32-bit operation guarantees.
+void Compiler::box_int32(Reg value)
+{
+    m_assembler.mov_imm64(Reg::RCX, SHIFTED_INT32_TAG);
+    m_assembler.or64(value, Reg::RCX);
+}
+
+void Compiler::box_boolean(Reg value)
+{
+    m_assembler.mov_imm64(Reg::RCX, BOOLEAN_TAG << TAG_SHIFT);
+    m_assembler.or64(value, Reg::RCX);
+}
+
+void Compiler::exit_to_interpreter(Bytecode::BasicBlock const& block, size_t offset)
+{
+    m_assembler.mov_imm64(Reg::RAX, bit_cast<FlatPtr>(&block));
+    m_assembler.mov_imm64(Reg::RDX, offset);
+    m_assembler.jump(m_exit_label);
+}
+
+void Compiler::call_instruction_slow_path(Bytecode::Instruction const& instruction, Bytecode::BasicBlock const& block, size_t offset)
+{
+    m_assembler.mov(Reg::RDI, INTERPRETER_BASE);
+    m_assembler.mov_imm64(Reg::RSI, bit_cast<FlatPtr>(&instruction));
+    m_assembler.mov_imm64(Reg::RDX, bit_cast<FlatPtr>(&block));
+    m_assembler.mov_imm64(Reg::RAX, bit_cast<FlatPtr>(&run_instruction_from_native_code));
+    m_assembler.call(Reg::RAX);
+
+    // The instruction left something behind for the interpreter to deal with (an exception, a jump, or a return).
+    Assembler::Label continue_natively;
+    m_assembler.test_al();
+    m_assembler.jump_if(Assembler::Condition::Equal, continue_natively);
+    exit_to_interpreter(block, offset);
+    continue_natively.bind(m_assembler);
+}
+
+void Compiler::compile_load(Bytecode::Op::Load const& op)
+{
+    load_register(Reg::RAX, op.src());
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+}
+
+void Compiler::compile_load_immediate(Bytecode::Op::LoadImmediate const& op)
+{
+    m_assembler.mov_imm64(Reg::RAX, op.value().encoded());
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+}
+
+void Compiler::compile_store(Bytecode::Op::Store const& op)
+{
+    load_register(Reg::RAX, Bytecode::Register::accumulator());
+    store_register(op.dst(), Reg::RAX);
+}
+
+void Compiler::compile_jump(Bytecode::Op::Jump const& op)
+{
+    m_assembler.jump(label_for(op.true_target()->block()));
+}
+
+void Compiler::compile_jump_conditional(Bytecode::Op::JumpConditional const& op)
+{
+    auto& true_label = label_for(op.true_target()->block());
+    auto& false_label = label_for(op.false_target()->block());
+
+    load_register(Reg::RAX, Bytecode::Register::accumulator());
+    m_assembler.mov(Reg::RCX, Reg::RAX);
+    m_assembler.shr64(Reg::RCX, TAG_SHIFT);
+
+    // Booleans and int32s are truthy exactly when their low 32 bits aren't all zero.
+    Assembler::Label test_low_bits;
+    m_assembler.alu32(Assembler::ALU::Cmp, Reg::RCX, static_cast<i32>(BOOLEAN_TAG));
+    m_assembler.jump_if(Assembler::Condition::Equal, test_low_bits);
+    m_assembler.alu32(Assembler::ALU::Cmp, Reg::RCX, static_cast<i32>(INT32_TAG));
+    m_assembler.jump_if(Assembler::Condition::Equal, test_low_bits);
+
+    m_assembler.mov(Reg::RDI, Reg::RAX);
+    m_assembler.mov_imm64(Reg::RAX, bit_cast<FlatPtr>(&value_to_boolean_from_native_code));
+    m_assembler.call(Reg::RAX);
+    m_assembler.test_al();
+    m_assembler.jump_if(Assembler::Condition::NotEqual, true_label);
+    m_assembler.jump(false_label);
+
+    test_low_bits.bind(m_assembler);
+    m_assembler.test32(Reg::RAX, Reg::RAX);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, true_label);
+    m_assembler.jump(false_label);
+}
+
+void Compiler::compile_jump_nullish_or_undefined(Bytecode::Op::Jump const& op, bool undefined_only)
+{
+    load_register(Reg::RCX, Bytecode::Register::accumulator());
+    m_assembler.shr64(Reg::RCX, TAG_SHIFT);
+    if (undefined_only) {
+        m_assembler.alu32(Assembler::ALU::Cmp, Reg::RCX, static_cast<i32>(UNDEFINED_TAG));
+    } else {
+        m_assembler.alu32(Assembler::ALU::And, Reg::RCX, static_cast<i32>(IS_NULLISH_EXTRACT_PATTERN));
+        m_assembler.alu32(Assembler::ALU::Cmp, Reg::RCX, static_cast<i32>(IS_NULLISH_PATTERN));
+    }
+    m_assembler.jump_if(Assembler::Condition::Equal, label_for(op.true_target()->block()));
+    m_assembler.jump(label_for(op.false_target()->block()));
+}
+
+void Compiler::compile_int32_binary_op(Bytecode::Instruction const& instruction, Bytecode::Register lhs, Bytecode::BasicBlock const& block, size_t offset)
+{
+    using Type = Bytecode::Instruction::Type;
+
+    Assembler::Label slow_path;
+    Assembler::Label done;
+
+    load_register(Reg::RAX, lhs);
+    branch_if_not_int32(Reg::RAX, slow_path);
+    load_register(Reg::RDX, Bytecode::Register::accumulator());
+    branch_if_not_int32(Reg::RDX, slow_path);
+
+    auto compare = [&](Assembler::Condition condition) {
+        m_assembler.alu32(Assembler::ALU::Cmp, Reg::RAX, Reg::RDX);
+        m_assembler.set_condition_into_eax(condition);
+        box_boolean(Reg::RAX);
+    };
+
+    switch (instruction.type()) {
+    case Type::Add:
+        m_assembler.alu32(Assembler::ALU::Add, Reg::RAX, Reg::RDX);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_path);
+        box_int32(Reg::RAX);
+        break;
+    case Type::Sub:
+        m_assembler.alu32(Assembler::ALU::Sub, Reg::RAX, Reg::RDX);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_path);
+        box_int32(Reg::RAX);
+        break;
+    case Type::Mul:
+        m_assembler.imul32(Reg::RAX, Reg::RDX);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_path);
+        // A zero product might have to be -0, which isn't an int32. Let the slow path sort that out.
+        m_assembler.test32(Reg::RAX, Reg::RAX);
+        m_assembler.jump_if(Assembler::Condition::Equal, slow_path);
+        box_int32(Reg::RAX);
+        break;
+    case Type::BitwiseAnd:
+        m_assembler.alu32(Assembler::ALU::And, Reg::RAX, Reg::RDX);
+        box_int32(Reg::RAX);
+        break;
+    case Type::BitwiseOr:
+        m_assembler.alu32(Assembler::ALU::Or, Reg::RAX, Reg::RDX);
+        box_int32(Reg::RAX);
+        break;
+    case Type::BitwiseXor:
+        m_assembler.alu32(Assembler::ALU::Xor, Reg::RAX, Reg::RDX);
+        box_int32(Reg::RAX);
+        break;
+    case Type::LessThan:
+        compare(Assembler::Condition::LessThan);
+        break;
+    case Type::LessThanEquals:
+        compare(Assembler::Condition::LessThanOrEqual);
+        break;
+    case Type::GreaterThan:
+        compare(Assembler::Condition::GreaterThan);
+        break;
+    case Type::GreaterThanEquals:
+        compare(Assembler::Condition::GreaterThanOrEqual);
+        break;
+    case Type::StrictlyEquals:
+    case Type::LooselyEquals:
+        compare(Assembler::Condition::Equal);
+        break;
+    case Type::StrictlyInequals:
+    case Type::LooselyInequals:
+        compare(Assembler::Condition::NotEqual);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    slow_path.bind(m_assembler);
+    call_instruction_slow_path(instruction, block, offset);
+    done.bind(m_assembler);
+}
+
+void Compiler::compile_int32_increment_or_decrement(Bytecode::Instruction const& instruction, Bytecode::BasicBlock const& block, size_t offset)
+{
+    Assembler::Label slow_path;
+    Assembler::Label done;
+
+    load_register(Reg::RAX, Bytecode::Register::accumulator());
+    branch_if_not_int32(Reg::RAX, slow_path);
+    auto op = instruction.type() == Bytecode::Instruction::Type::Increment ? Assembler::ALU::Add : Assembler::ALU::Sub;
+    m_assembler.alu32(op, Reg::RAX, 1);
+    m_assembler.jump_if(Assembler::Condition::Overflow, slow_path);
+    box_int32(Reg::RAX);
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    slow_path.bind(m_assembler);
+    call_instruction_slow_path(instruction, block, offset);
+    done.bind(m_assembler);
+}
+
+bool Compiler::compile_instruction(Bytecode::Instruction const& instruction, Bytecode::BasicBlock const& block, size_t offset)
+{
+    using Type = Bytecode::Instruction::Type;
+
+    auto has_native_targets = [&](Bytecode::Op::Jump const& jump, bool needs_false_target) {
+        if (!jump.true_target().has_value() || !has_label_for(jump.true_target()->block()))
+            return false;
+        if (needs_false_target && (!jump.false_target().has_value() || !has_label_for(jump.false_target()->block())))
+            return false;
+        return true;
+    };
+
+    switch (instruction.type()) {
+    case Type::Load:
+        compile_load(static_cast<Bytecode::Op::Load const&>(instruction));
+        return true;
+    case Type::LoadImmediate:
+        compile_load_immediate(static_cast<Bytecode::Op::LoadImmediate const&>(instruction));
+        return true;
+    case Type::Store:
+        compile_store(static_cast<Bytecode::Op::Store const&>(instruction));
+        return true;
+    case Type::Jump: {
+        auto& jump = static_cast<Bytecode::Op::Jump const&>(instruction);
+        if (!has_native_targets(jump, false))
+            break;
+        compile_jump(jump);
+        return false;
+    }
+    case Type::JumpConditional: {
+        auto& jump = static_cast<Bytecode::Op::JumpConditional const&>(instruction);
+        if (!has_native_targets(jump, true))
+            break;
+        compile_jump_conditional(jump);
+        return false;
+    }
+    case Type::JumpNullish:
+    case Type::JumpUndefined: {
+        auto& jump = static_cast<Bytecode::Op::Jump const&>(instruction);
+        if (!has_native_targets(jump, true))
+            break;
+        compile_jump_nullish_or_undefined(jump, instruction.type() == Type::JumpUndefined);
+        return false;
+    }
+#define JS_COMPILE_INT32_BINARY_OP(OpTitleCase)                                                                                     \
+    case Type::OpTitleCase:                                                                                                         \
+        compile_int32_binary_op(instruction, static_cast<Bytecode::Op::OpTitleCase const&>(instruction).lhs(), block, offset); \
+        return true;
+        JS_COMPILE_INT32_BINARY_OP(Add)
+        JS_COMPILE_INT32_BINARY_OP(Sub)
+        JS_COMPILE_INT32_BINARY_OP(Mul)
+        JS_COMPILE_INT32_BINARY_OP(BitwiseAnd)
+        JS_COMPILE_INT32_BINARY_OP(BitwiseOr)
+        JS_COMPILE_INT32_BINARY_OP(BitwiseXor)
+        JS_COMPILE_INT32_BINARY_OP(LessThan)
+        JS_COMPILE_INT32_BINARY_OP(LessThanEquals)
+        JS_COMPILE_INT32_BINARY_OP(GreaterThan)
+        JS_COMPILE_INT32_BINARY_OP(GreaterThanEquals)
+        JS_COMPILE_INT32_BINARY_OP(StrictlyEquals)
+        JS_COMPILE_INT32_BINARY_OP(StrictlyInequals)
+        JS_COMPILE_INT32_BINARY_OP(LooselyEquals)
+        JS_COMPILE_INT32_BINARY_OP(LooselyInequals)
+#undef JS_COMPILE_INT32_BINARY_OP
+    case Type::Increment:
+    case Type::Decrement:
+        compile_int32_increment_or_decrement(instruction, block, offset);
+        return true;
+    default:
+        break;
+    }
+
+    call_instruction_slow_path(instruction, block, offset);
+    return true;
+}
+
+void Compiler::compile_block(Bytecode::BasicBlock const& block)
+{
+    label_for(block).bind(m_assembler);
+
+    Bytecode::InstructionStreamIterator it(block.instruction_stream());
+    while (!it.at_end()) {
+        if (!compile_instruction(*it, block, it.offset()))
+            return;
+        ++it;
+    }
+
+    // We ran off the end of the block, which the interpreter treats as the end of the executable.
+    exit_to_interpreter(block, block.size());
+}
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable const& executable)
+{
+#if ARCH(X86_64)
+    Compiler compiler;
+    auto& assembler = compiler.m_assembler;
+
+    for (auto& block : executable.basic_blocks)
+        compiler.m_block_labels.set(block.ptr(), make<Assembler::Label>());
+
+    // Prologue: NativeExit entry(Value* registers, Interpreter* interpreter, void const* block_entry)
+    assembler.push(Reg::RBP);
+    assembler.mov(Reg::RBP, Reg::RSP);
+    assembler.push(REGISTER_WINDOW_BASE);
+    assembler.push(INTERPRETER_BASE);
+    assembler.mov(REGISTER_WINDOW_BASE, Reg::RDI);
+    assembler.mov(INTERPRETER_BASE, Reg::RSI);
+    assembler.jump(Reg::RDX);
+
+    for (auto& block : executable.basic_blocks)
+        compiler.compile_block(*block);
+
+    // Epilogue: the NativeExit has been put in RAX:RDX by whoever jumped here.
+    compiler.m_exit_label.bind(assembler);
+    assembler.pop(INTERPRETER_BASE);
+    assembler.pop(REGISTER_WINDOW_BASE);
+    assembler.pop(Reg::RBP);
+    assembler.ret();
+
+    HashMap<Bytecode::BasicBlock const*, size_t> block_offsets;
+    for (auto& it : compiler.m_block_labels)
+        block_offsets.set(it.key, it.value->offset());
+
+    auto native_executable = NativeExecutable::create(assembler.output().span(), move(block_offsets));
+    if (native_executable.is_error()) {
+        dbgln("JIT: Failed to create native code for {}: {}", executable.name, native_executable.error());
+        return nullptr;
+    }
+    return native_executable.release_value();
+#else
+    (void)executable;
+    return nullptr;
+#endif
+}
+
+}
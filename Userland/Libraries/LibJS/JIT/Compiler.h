@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/Assembler.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::JIT {
+
+// A baseline compiler that turns every basic block of an executable into straight-line x86_64 code.
+// Moves between registers, jumps, and int32 arithmetic and comparisons get native fast paths;
+// everything else calls back into the instruction's execute_impl() through the interpreter.
+// Whenever an instruction throws, jumps somewhere the interpreter has to handle, or returns,
+// the native code exits and the interpreter picks up from that instruction.
+class Compiler {
+public:
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable const&);
+
+private:
+    Compiler() = default;
+
+    using Reg = Assembler::Reg;
+
+    void compile_block(Bytecode::BasicBlock const&);
+    // Returns false if control never falls through to the next instruction.
+    bool compile_instruction(Bytecode::Instruction const&, Bytecode::BasicBlock const&, size_t offset);
+
+    void compile_load(Bytecode::Op::Load const&);
+    void compile_load_immediate(Bytecode::Op::LoadImmediate const&);
+    void compile_store(Bytecode::Op::Store const&);
+    void compile_jump(Bytecode::Op::Jump const&);
+    void compile_jump_conditional(Bytecode::Op::JumpConditional const&);
+    void compile_jump_nullish_or_undefined(Bytecode::Op::Jump const&, bool undefined_only);
+    void compile_int32_binary_op(Bytecode::Instruction const&, Bytecode::Register lhs, Bytecode::BasicBlock const&, size_t offset);
+    void compile_int32_increment_or_decrement(Bytecode::Instruction const&, Bytecode::BasicBlock const&, size_t offset);
+
+    void load_register(Reg dst, Bytecode::Register);
+    void store_register(Bytecode::Register, Reg src);
+    void branch_if_not_int32(Reg value, Assembler::Label& label);
+    void box_int32(Reg value);
+    void box_boolean(Reg value);
+
+    void call_instruction_slow_path(Bytecode::Instruction const&, Bytecode::BasicBlock const&, size_t offset);
+    void exit_to_interpreter(Bytecode::BasicBlock const&, size_t offset);
+
+    Assembler::Label& label_for(Bytecode::BasicBlock const& block) { return *m_block_labels.get(&block).value(); }
+    bool has_label_for(Bytecode::BasicBlock const& block) const { return m_block_labels.contains(&block); }
+
+    Assembler m_assembler;
+    Assembler::Label m_exit_label;
+    HashMap<Bytecode::BasicBlock const*, NonnullOwnPtr<Assembler::Label>> m_block_labels;
+};
+
+}
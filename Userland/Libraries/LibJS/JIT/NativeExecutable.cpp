@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <LibCore/System.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+using NativeEntry = NativeExit (*)(Value* registers, Bytecode::Interpreter* interpreter, void const* block_entry);
+
+ErrorOr<NonnullOwnPtr<NativeExecutable>> NativeExecutable::create(ReadonlyBytes code, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets)
+{
+    void* executable_view = nullptr;
+
+#if defined(AK_OS_SERENITY)
+    auto size = round_up_to_power_of_two(code.size(), PAGE_SIZE);
+
+    // W^X means we can't ever make an anonymous writable mapping executable, so map the same
+    // anonymous file twice instead: once writable to fill it in, and once executable to run it.
+    auto fd = TRY(Core::System::anon_create(size, O_CLOEXEC));
+    ScopeGuard close_fd = [&] { (void)Core::System::close(fd); };
+
+    auto* writable_view = TRY(Core::System::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "JS JIT code (writable)"sv));
+    code.copy_to({ static_cast<u8*>(writable_view), size });
+    TRY(Core::System::munmap(writable_view, size));
+
+    executable_view = TRY(Core::System::mmap(nullptr, size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0, 0, "JS JIT code"sv));
+#else
+    auto size = code.size();
+    executable_view = TRY(Core::System::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    code.copy_to({ static_cast<u8*>(executable_view), size });
+    if (mprotect(executable_view, size, PROT_READ | PROT_EXEC) < 0) {
+        auto saved_errno = errno;
+        (void)Core::System::munmap(executable_view, size);
+        return AK::Error::from_errno(saved_errno);
+    }
+#endif
+
+    return adopt_nonnull_own_or_enomem(new (nothrow) NativeExecutable(executable_view, size, move(block_offsets)));
+}
+
+NativeExecutable::NativeExecutable(void* code, size_t size, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets)
+    : m_code(code)
+    , m_size(size)
+    , m_block_offsets(move(block_offsets))
+{
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    MUST(Core::System::munmap(m_code, m_size));
+}
+
+NativeExit NativeExecutable::run(Bytecode::Interpreter& interpreter, Value* registers, Bytecode::BasicBlock const& entry_block) const
+{
+    auto block_offset = m_block_offsets.get(&entry_block);
+    VERIFY(block_offset.has_value());
+
+    // The code always starts with the shared prologue, which jumps to the block entry we pass in.
+    auto entry = reinterpret_cast<NativeEntry>(m_code);
+    return entry(registers, &interpreter, static_cast<u8 const*>(m_code) + *block_offset);
+}
+
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Forward.h>
+
+namespace JS::JIT {
+
+// Where native code handed control back to the bytecode interpreter.
+// The instruction at `offset` in `block` has either not run yet, or ran and left a result
+// in the interpreter for it to act on (an exception, a jump, or a return).
+struct NativeExit {
+    Bytecode::BasicBlock const* block { nullptr };
+    size_t offset { 0 };
+};
+
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    static ErrorOr<NonnullOwnPtr<NativeExecutable>> create(ReadonlyBytes code, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets);
+    ~NativeExecutable();
+
+    bool has_code_for(Bytecode::BasicBlock const& block) const { return m_block_offsets.contains(&block); }
+    NativeExit run(Bytecode::Interpreter&, Value* registers, Bytecode::BasicBlock const& entry_block) const;
+
+    size_t code_size() const { return m_size; }
+
+private:
+    NativeExecutable(void* code, size_t size, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets);
+
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_offsets;
+};
+
+}
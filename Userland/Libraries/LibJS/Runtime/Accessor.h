@@ -40,6 +40,7 @@ private:
         : m_getter(getter)
         , m_setter(setter)
     {
+        set_relies_on_write_barrier(true);
     }
 
     GCPtr<FunctionObject> m_getter;
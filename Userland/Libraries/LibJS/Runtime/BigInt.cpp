@@ -20,6 +20,7 @@ BigInt::BigInt(Crypto::SignedBigInteger big_integer)
     : m_big_integer(move(big_integer))
 {
     VERIFY(!m_big_integer.is_invalid());
+    set_relies_on_write_barrier(true);
 }
 
 ErrorOr<String> BigInt::to_string() const
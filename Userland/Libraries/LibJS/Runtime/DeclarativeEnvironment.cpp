@@ -76,6 +76,7 @@ ThrowCompletionOr<void> DeclarativeEnvironment::create_mutable_binding(VM&, Depr
         .can_be_deleted = can_be_deleted,
         .initialized = false,
     });
+    ++m_environment_serial_number;
 
     // 3. Return unused.
     return {};
@@ -96,6 +97,7 @@ ThrowCompletionOr<void> DeclarativeEnvironment::create_immutable_binding(VM&, De
         .can_be_deleted = false,
         .initialized = false,
     });
+    ++m_environment_serial_number;
 
     // 3. Return unused.
     return {};
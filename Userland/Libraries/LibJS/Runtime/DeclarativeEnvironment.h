@@ -60,6 +60,9 @@ public:
 
     void shrink_to_fit();
 
+    // Bumped whenever a binding is created, so caches that rely on a name *not* being bound here can tell when that changes.
+    u64 environment_serial_number() const { return m_environment_serial_number; }
+
 private:
     ThrowCompletionOr<Value> get_binding_value_direct(VM&, Binding&, bool strict);
     ThrowCompletionOr<void> set_mutable_binding_direct(VM&, Binding&, Value, bool strict);
@@ -121,6 +124,7 @@ private:
 
     Vector<Binding> m_bindings;
     Vector<DisposableResource> m_disposable_resource_stack;
+    u64 m_environment_serial_number { 0 };
 };
 
 template<>
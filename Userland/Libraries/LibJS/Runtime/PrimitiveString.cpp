@@ -24,21 +24,25 @@ PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
     , m_lhs(&lhs)
     , m_rhs(&rhs)
 {
+    set_relies_on_write_barrier(true);
 }
 
 PrimitiveString::PrimitiveString(String string)
     : m_utf8_string(move(string))
 {
+    set_relies_on_write_barrier(true);
 }
 
 PrimitiveString::PrimitiveString(DeprecatedString string)
     : m_deprecated_string(move(string))
 {
+    set_relies_on_write_barrier(true);
 }
 
 PrimitiveString::PrimitiveString(Utf16String string)
     : m_utf16_string(move(string))
 {
+    set_relies_on_write_barrier(true);
 }
 
 PrimitiveString::~PrimitiveString()
@@ -68,6 +68,10 @@ public:
     HashMap<StringOrSymbol, PropertyMetadata> const& property_table() const;
     u32 property_count() const { return m_property_count; }
 
+    // Bumped whenever this shape is changed in place (rather than by transitioning to a new one),
+    // so caches keyed on shape identity can tell that the property offsets they remember are stale.
+    u64 serial_number() const { return m_serial_number; }
+
     struct Property {
         StringOrSymbol key;
         PropertyMetadata value;
@@ -75,7 +79,11 @@ public:
 
     Vector<Property> property_table_ordered() const;
 
-    void set_prototype_without_transition(Object* new_prototype) { m_prototype = new_prototype; }
+    void set_prototype_without_transition(Object* new_prototype)
+    {
+        m_prototype = new_prototype;
+        ++m_serial_number;
+    }
 
     void remove_property_from_unique_shape(StringOrSymbol const&, size_t offset);
     void add_property_to_unique_shape(StringOrSymbol const&, PropertyAttributes attributes);
@@ -103,6 +111,7 @@ private:
     StringOrSymbol m_property_key;
     GCPtr<Object> m_prototype;
     u32 m_property_count { 0 };
+    u64 m_serial_number { 0 };
 
     PropertyAttributes m_attributes { 0 };
     TransitionType m_transition_type : 6 { TransitionType::Invalid };
@@ -15,6 +15,7 @@ Symbol::Symbol(Optional<String> description, bool is_global)
     : m_description(move(description))
     , m_is_global(is_global)
 {
+    set_relies_on_write_barrier(true);
 }
 
 NonnullGCPtr<Symbol> Symbol::create(VM& vm, Optional<String> description, bool is_global)
@@ -0,0 +1,25 @@
+test("young cells only reachable from old cells survive minor collections", () => {
+    const old = { values: [], accessor: {} };
+    gc();
+
+    // Allocate enough to trigger a bunch of young generation collections along the way.
+    for (let i = 0; i < 300_000; ++i) {
+        const young = { i, s: "value" + i };
+        if (i % 1000 === 0) {
+            old.values.push(young);
+            old.latest = young;
+            Object.defineProperty(old.accessor, "p" + i, { get: () => young, configurable: true });
+        }
+    }
+
+    expect(old.values).toHaveLength(300);
+    old.values.forEach((value, index) => {
+        expect(value.i).toBe(index * 1000);
+        expect(value.s).toBe("value" + index * 1000);
+    });
+    expect(old.latest.i).toBe(299_000);
+    expect(old.accessor.p150000.s).toBe("value150000");
+
+    gc();
+    expect(old.values[299].s).toBe("value299000");
+});
@@ -0,0 +1,75 @@
+function getX(o) {
+    return o.x;
+}
+
+function setX(o, value) {
+    o.x = value;
+}
+
+test("reads see the right slot across many shapes", () => {
+    const objects = [
+        { x: 1 },
+        { a: 0, x: 2 },
+        { a: 0, b: 0, x: 3 },
+        { a: 0, b: 0, c: 0, x: 4 },
+        { a: 0, b: 0, c: 0, d: 0, x: 5 },
+        { a: 0, b: 0, c: 0, d: 0, e: 0, x: 6 },
+    ];
+    for (let i = 0; i < 3; ++i) {
+        objects.forEach((o, index) => {
+            expect(getX(o)).toBe(index + 1);
+        });
+    }
+});
+
+test("deleting a property invalidates cached offsets", () => {
+    const o = { a: 1, b: 2, x: 3 };
+    for (let i = 0; i < 150; ++i) o["p" + i] = i;
+    expect(getX(o)).toBe(3);
+    delete o.a;
+    expect(getX(o)).toBe(3);
+    delete o.x;
+    expect(getX(o)).toBeUndefined();
+});
+
+test("accessors and non-writable properties are not bypassed", () => {
+    const o = { x: 1 };
+    expect(getX(o)).toBe(1);
+    Object.defineProperty(o, "x", { get: () => 42 });
+    expect(getX(o)).toBe(42);
+
+    const p = { x: 1 };
+    setX(p, 2);
+    expect(p.x).toBe(2);
+    Object.freeze(p);
+    setX(p, 3);
+    expect(p.x).toBe(2);
+});
+
+test("writes go to the right object", () => {
+    const a = { x: 1 };
+    const b = { x: 1 };
+    setX(a, 10);
+    setX(b, 20);
+    expect(a.x).toBe(10);
+    expect(b.x).toBe(20);
+});
+
+test("exotic objects are not cached", () => {
+    const target = { x: 1 };
+    const proxy = new Proxy(target, { get: () => "trapped" });
+    expect(getX(target)).toBe(1);
+    expect(getX(proxy)).toBe("trapped");
+});
+
+var cachedGlobal = "global";
+
+function getCachedGlobal() {
+    return cachedGlobal;
+}
+
+test("global variables", () => {
+    expect(getCachedGlobal()).toBe("global");
+    globalThis.cachedGlobal = "changed";
+    expect(getCachedGlobal()).toBe("changed");
+});
@@ -137,7 +137,12 @@ JS::ThrowCompletionOr<Optional<JS::PropertyDescriptor>> LegacyPlatformObject::le
     }
 
     // 3. Return OrdinaryGetOwnProperty(O, P).
-    return TRY(Object::internal_get_own_property(property_name));
+    auto descriptor = TRY(Object::internal_get_own_property(property_name));
+
+    // NOTE: A named property may start shadowing this one at any time, so nobody must remember where it's stored.
+    if (descriptor.has_value())
+        descriptor->property_offset = {};
+    return descriptor;
 }
 
 // https://webidl.spec.whatwg.org/#invoke-indexed-setter
@@ -202,7 +207,7 @@ JS::ThrowCompletionOr<Optional<JS::PropertyDescriptor>> LegacyPlatformObject::in
 }
 
 // https://webidl.spec.whatwg.org/#legacy-platform-object-set
-JS::ThrowCompletionOr<bool> LegacyPlatformObject::internal_set(JS::PropertyKey const& property_name, JS::Value value, JS::Value receiver)
+JS::ThrowCompletionOr<bool> LegacyPlatformObject::internal_set(JS::PropertyKey const& property_name, JS::Value value, JS::Value receiver, JS::CacheablePropertyMetadata*)
 {
     auto& vm = this->vm();
 
@@ -43,6 +43,7 @@
 #include <LibWeb/WebGL/EventNames.h>
 #include <LibWeb/WebIDL/AbstractOperations.h>
 #include <LibWeb/XHR/EventNames.h>
+#include <stdlib.h>
 
 namespace Web::Bindings {
 
@@ -78,6 +79,11 @@ ErrorOr<void> initialize_main_thread_vm()
     //       This avoids doing an exhaustive garbage collection on process exit.
     s_main_thread_vm->ref();
 
+    // Full collections of big page heaps can mark a few milliseconds at a time instead of freezing the page.
+    // FIXME: Turn this on by default once we have --dump-gc-statistics numbers showing that it pays off.
+    if (getenv("LIBWEB_INCREMENTAL_GC"))
+        s_main_thread_vm->heap().set_incremental_marking_slice_budget(Duration::from_milliseconds(2));
+
     // These strings could potentially live on the VM similar to CommonPropertyNames.
     TRY(DOM::MutationType::initialize_strings());
     TRY(HTML::AttributeNames::initialize_strings());
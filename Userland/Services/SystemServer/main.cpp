@@ -309,6 +309,16 @@ static ErrorOr<void> populate_devtmpfs_devices_based_on_devctl()
             }
             break;
         }
+        case 31: {
+            if (!is_block_device && minor_number == 0)
+                TRY(create_devtmpfs_char_device("/dev/perf_events"sv, 0600, 31, 0));
+            break;
+        }
+        case 32: {
+            if (!is_block_device && minor_number == 0)
+                TRY(create_devtmpfs_char_device("/dev/memory_pressure"sv, 0444, 32, 0));
+            break;
+        }
         case 3: {
             if (is_block_device) {
                 auto name = TRY(String::formatted("/dev/hd{}", offset_character_with_number('a', minor_number)));
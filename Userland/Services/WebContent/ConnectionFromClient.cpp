@@ -665,6 +665,13 @@ Messages::WebContentServer::DumpTextResponse ConnectionFromClient::dump_text()
     return document->body()->inner_text();
 }
 
+Messages::WebContentServer::DumpGcStatisticsResponse ConnectionFromClient::dump_gc_statistics()
+{
+    StringBuilder builder;
+    Web::Bindings::main_thread_vm().heap().dump_statistics(builder);
+    return builder.to_deprecated_string();
+}
+
 void ConnectionFromClient::set_content_filters(Vector<String> const& filters)
 {
     Web::ContentFilter::the().set_patterns(filters).release_value_but_fixme_should_propagate_errors();
@@ -7,6 +7,7 @@
 #include "ImageCodecPluginSerenity.h"
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalServer.h>
+#include <LibCore/MemoryPressureNotifier.h>
 #include <LibCore/StandardPaths.h>
 #include <LibCore/System.h>
 #include <LibFileSystem/FileSystem.h>
@@ -27,6 +28,13 @@ ErrorOr<int> serenity_main(Main::Arguments)
     Core::EventLoop event_loop;
     TRY(Core::System::pledge("stdio recvfd sendfd accept unix rpath thread"));
 
+    // We can do without memory pressure notifications, so don't refuse to start if they aren't available.
+    RefPtr<Core::MemoryPressureNotifier> memory_pressure_notifier;
+    if (auto notifier_or_error = Core::MemoryPressureNotifier::try_create(); notifier_or_error.is_error())
+        dbgln("WebContent: Unable to listen for memory pressure: {}", notifier_or_error.error());
+    else
+        memory_pressure_notifier = notifier_or_error.release_value();
+
     // This must be first; we can't check if /tmp/webdriver exists once we've unveiled other paths.
     auto webdriver_socket_path = DeprecatedString::formatted("{}/webdriver", TRY(Core::StandardPaths::runtime_directory()));
     if (FileSystem::exists(webdriver_socket_path))
@@ -48,6 +56,17 @@ ErrorOr<int> serenity_main(Main::Arguments)
     Web::ResourceLoader::initialize(TRY(WebView::RequestServerAdapter::try_create()));
     TRY(Web::Bindings::initialize_main_thread_vm());
 
+    if (memory_pressure_notifier) {
+        memory_pressure_notifier->on_level_change = [](MemoryPressureLevel level) {
+            if (level == MEMORY_PRESSURE_NORMAL)
+                return;
+            // NOTE: Decoded images that aren't visible are volatile already, so the kernel can take those by itself.
+            Web::ResourceLoader::the().clear_cache();
+            if (level == MEMORY_PRESSURE_CRITICAL)
+                Web::Bindings::main_thread_vm().heap().collect_garbage();
+        };
+    }
+
     auto client = TRY(IPC::take_over_accepted_client_from_system_server<WebContent::ConnectionFromClient>());
     return event_loop.exec();
 }
@@ -18,6 +18,7 @@
 #include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/MimeData.h>
+#include <LibCore/System.h>
 #include <LibFileSystem/FileSystem.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
@@ -159,11 +160,11 @@ ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
         .type = TRY(String::from_utf8(Core::guess_mime_type_based_on_filename(real_path.bytes_as_string_view()))),
         .length = TRY(FileSystem::size(real_path.bytes_as_string_view()))
     };
-    TRY(send_response(*stream, request, move(info)));
+    TRY(send_response(*stream, request, move(info), stream->fd()));
     return true;
 }
 
-ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info, Optional<int> response_fd)
 {
     StringBuilder builder;
     TRY(builder.try_append("HTTP/1.0 200 OK\r\n"sv));
@@ -182,6 +183,18 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
     TRY(m_socket->write_until_depleted(builder_contents));
     log_response(200, request);
 
+#ifdef AK_OS_SERENITY
+    // Have the kernel send the file straight to the socket. If it fails before sending anything
+    // (e.g. because the file isn't seekable), we fall back to copying through userspace.
+    if (auto socket_fd = m_socket->fd(); response_fd.has_value() && socket_fd.has_value()) {
+        while (true) {
+            auto nsent_or_error = Core::System::sendfile(*socket_fd, *response_fd, nullptr, content_info.length);
+            if (nsent_or_error.is_error() || nsent_or_error.value() == 0)
+                break;
+        }
+    }
+#endif
+
     char buffer[PAGE_SIZE];
     do {
         auto size = TRY(response.read_some({ buffer, sizeof(buffer) })).size();
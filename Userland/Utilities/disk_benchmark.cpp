@@ -14,7 +14,9 @@
 #include <LibCore/ElapsedTimer.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -40,6 +42,7 @@ static Result average_result(Vector<Result> const& results)
 }
 
 static ErrorOr<Result> benchmark(DeprecatedString const& filename, int file_size, ByteBuffer& buffer, bool allow_cache);
+static ErrorOr<Result> benchmark_with_queue_depth(DeprecatedString const& filename, int file_size, size_t block_size, bool allow_cache, size_t queue_depth);
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -50,6 +53,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Vector<size_t> file_sizes;
     Vector<size_t> block_sizes;
     bool allow_cache = false;
+    size_t queue_depth = 1;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(allow_cache, "Allow using disk cache", "cache", 'c');
@@ -57,8 +61,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(time_per_benchmark_sec, "Time elapsed per benchmark (seconds)", "time-per-benchmark", 't', "time-per-benchmark");
     args_parser.add_option(file_sizes, "A comma-separated list of file sizes", "file-size", 'f', "file-size");
     args_parser.add_option(block_sizes, "A comma-separated list of block sizes", "block-size", 'b', "block-size");
+    args_parser.add_option(queue_depth, "Number of requests to keep in flight at once (each from its own thread)", "queue-depth", 'q', "queue-depth");
     args_parser.parse(arguments);
 
+    if (queue_depth == 0) {
+        warnln("Queue depth must be at least 1");
+        return 1;
+    }
+
     Duration const time_per_benchmark = Duration::from_seconds(time_per_benchmark_sec);
 
     if (file_sizes.size() == 0) {
@@ -82,12 +92,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             }
             Vector<Result> results;
 
-            outln("Running: file_size={} block_size={}", file_size, block_size);
+            outln("Running: file_size={} block_size={} queue_depth={}", file_size, block_size, queue_depth);
             auto timer = Core::ElapsedTimer::start_new();
             while (timer.elapsed_time() < time_per_benchmark) {
                 out(".");
                 fflush(stdout);
-                auto result = TRY(benchmark(filename, file_size, buffer_result.value(), allow_cache));
+                auto result = queue_depth > 1
+                    ? TRY(benchmark_with_queue_depth(filename, file_size, block_size, allow_cache, queue_depth))
+                    : TRY(benchmark(filename, file_size, buffer_result.value(), allow_cache));
                 results.append(result);
                 usleep(100);
             }
@@ -143,3 +155,97 @@ ErrorOr<Result> benchmark(DeprecatedString const& filename, int file_size, ByteB
     result.read_bps = (u64)(timer.elapsed_milliseconds() ? (file_size / timer.elapsed_milliseconds()) : file_size) * 1000;
     return result;
 }
+
+struct Worker {
+    pthread_t thread {};
+    int fd { -1 };
+    off_t offset { 0 };
+    size_t size { 0 };
+    ByteBuffer buffer;
+    bool is_write { false };
+    int error { 0 };
+};
+
+static void* run_worker(void* argument)
+{
+    auto& worker = *static_cast<Worker*>(argument);
+    size_t done = 0;
+    while (done < worker.size) {
+        size_t chunk_size = min(worker.buffer.size(), worker.size - done);
+        auto ntransferred = worker.is_write
+            ? pwrite(worker.fd, worker.buffer.data(), chunk_size, worker.offset + done)
+            : pread(worker.fd, worker.buffer.data(), chunk_size, worker.offset + done);
+        if (ntransferred < 0) {
+            if (errno == EINTR)
+                continue;
+            worker.error = errno;
+            return nullptr;
+        }
+        if (ntransferred == 0) {
+            worker.error = EIO;
+            return nullptr;
+        }
+        done += ntransferred;
+    }
+    return nullptr;
+}
+
+// Splits the file into one region per worker thread, so that the kernel sees up to queue_depth
+// requests at once instead of one at a time.
+static ErrorOr<u64> run_workers(Vector<Worker>& workers, int file_size, bool is_write)
+{
+    auto timer = Core::ElapsedTimer::start_new();
+    for (auto& worker : workers) {
+        worker.is_write = is_write;
+        worker.error = 0;
+        if (int rc = pthread_create(&worker.thread, nullptr, run_worker, &worker); rc != 0)
+            return Error::from_errno(rc);
+    }
+    int error = 0;
+    for (auto& worker : workers) {
+        pthread_join(worker.thread, nullptr);
+        if (worker.error != 0)
+            error = worker.error;
+    }
+    if (error != 0)
+        return Error::from_errno(error);
+    return (u64)(timer.elapsed_milliseconds() ? (file_size / timer.elapsed_milliseconds()) : file_size) * 1000;
+}
+
+ErrorOr<Result> benchmark_with_queue_depth(DeprecatedString const& filename, int file_size, size_t block_size, bool allow_cache, size_t queue_depth)
+{
+    int flags = O_CREAT | O_TRUNC | O_RDWR;
+    if (!allow_cache)
+        flags |= O_DIRECT;
+
+    int fd = TRY(Core::System::open(filename, flags, 0644));
+
+    auto fd_cleanup = ScopeGuard([fd, filename] {
+        auto void_or_error = Core::System::close(fd);
+        if (void_or_error.is_error())
+            warnln("{}", void_or_error.release_error());
+
+        void_or_error = Core::System::unlink(filename);
+        if (void_or_error.is_error())
+            warnln("{}", void_or_error.release_error());
+    });
+
+    TRY(Core::System::ftruncate(fd, file_size));
+
+    // Every region starts on a block boundary, the last one takes whatever is left over.
+    size_t block_count = (file_size + block_size - 1) / block_size;
+    size_t blocks_per_worker = max<size_t>(1, block_count / queue_depth);
+    Vector<Worker> workers;
+    for (size_t i = 0; i < queue_depth; ++i) {
+        off_t offset = i * blocks_per_worker * block_size;
+        if (offset >= file_size)
+            break;
+        size_t size = (i == queue_depth - 1) ? file_size - offset : min<size_t>(blocks_per_worker * block_size, file_size - offset);
+        TRY(workers.try_append({ {}, fd, offset, size, TRY(ByteBuffer::create_uninitialized(block_size)), false, 0 }));
+    }
+
+    Result result;
+    result.write_bps = TRY(run_workers(workers, file_size, true));
+    result.read_bps = TRY(run_workers(workers, file_size, false));
+    return result;
+}
@@ -86,6 +86,11 @@ public:
         return String::from_deprecated_string(client().dump_text());
     }
 
+    ErrorOr<String> dump_gc_statistics()
+    {
+        return String::from_deprecated_string(client().dump_gc_statistics());
+    }
+
     void clear_content_filters()
     {
         client().async_set_content_filters({});
@@ -392,6 +397,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     StringView web_driver_ipc_path;
     bool dump_layout_tree = false;
     bool dump_text = false;
+    bool dump_gc_statistics = false;
     bool is_layout_test_mode = false;
     StringView test_root_path;
 
@@ -400,6 +406,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(screenshot_timeout, "Take a screenshot after [n] seconds (default: 1)", "screenshot", 's', "n");
     args_parser.add_option(dump_layout_tree, "Dump layout tree and exit", "dump-layout-tree", 'd');
     args_parser.add_option(dump_text, "Dump text and exit", "dump-text", 'T');
+    args_parser.add_option(dump_gc_statistics, "Dump garbage collector pause statistics once the page has loaded and exit", "dump-gc-statistics", 0);
     args_parser.add_option(test_root_path, "Run tests in path", "run-tests", 'R', "test-root-path");
     args_parser.add_option(resources_folder, "Path of the base resources folder (defaults to /res)", "resources", 'r', "resources-root-path");
     args_parser.add_option(web_driver_ipc_path, "Path to the WebDriver IPC socket", "webdriver-ipc-path", 0, "path");
@@ -448,6 +455,15 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             out("{}", text);
             fflush(stdout);
 
+            event_loop.quit(0);
+        };
+    } else if (dump_gc_statistics) {
+        view->on_load_finish = [&](auto const&) {
+            auto statistics = view->dump_gc_statistics().release_value_but_fixme_should_propagate_errors();
+
+            out("{}", statistics);
+            fflush(stdout);
+
             event_loop.quit(0);
         };
     } else if (web_driver_ipc_path.is_empty()) {
@@ -12,6 +12,7 @@
 #include <LibCore/System.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/InlineCache.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Console.h>
 #include <LibJS/Contrib/Test262/GlobalObject.h>
@@ -72,11 +73,12 @@ private:
 
 static bool s_dump_ast = false;
 static bool s_run_bytecode = false;
-static bool s_opt_bytecode = false;
+static JS::Bytecode::Interpreter::OptimizationLevel s_optimization_level = JS::Bytecode::Interpreter::OptimizationLevel::None;
 static bool s_as_module = false;
 static bool s_print_last_result = false;
 static bool s_strip_ansi = false;
 static bool s_disable_source_location_hints = false;
+static bool s_dump_ic_stats = false;
 static RefPtr<Line::Editor> s_editor;
 static String s_history_path = String {};
 static int s_repl_line_level = 0;
@@ -221,10 +223,13 @@ static ErrorOr<bool> parse_and_run(JS::Interpreter& interpreter, StringView sour
 
             auto executable = executable_result.release_value();
             executable->name = source_name;
-            if (s_opt_bytecode) {
-                auto& passes = JS::Bytecode::Interpreter::optimization_pipeline(JS::Bytecode::Interpreter::OptimizationLevel::Optimize);
+            if (s_optimization_level != JS::Bytecode::Interpreter::OptimizationLevel::None) {
+                auto bytecode_size_before = executable->bytecode_size();
+                auto registers_before = executable->number_of_registers;
+                auto& passes = JS::Bytecode::Interpreter::optimization_pipeline(s_optimization_level);
                 passes.perform(*executable);
                 dbgln("Optimisation passes took {}us", passes.elapsed());
+                dbgln("Bytecode size went from {} to {} bytes, and from {} to {} registers", bytecode_size_before, executable->bytecode_size(), registers_before, executable->number_of_registers);
             }
 
             if (JS::Bytecode::g_dump_bytecode)
@@ -595,12 +600,14 @@ private:
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction prot_exec"));
 
     bool gc_on_every_allocation = false;
     bool disable_syntax_highlight = false;
     bool disable_debug_printing = false;
     bool use_test262_global = false;
+    bool optimize_bytecode = false;
+    Optional<size_t> optimization_level;
     StringView evaluate_script;
     Vector<StringView> script_paths;
 
@@ -609,7 +616,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
     args_parser.add_option(s_run_bytecode, "Run the bytecode", "run-bytecode", 'b');
-    args_parser.add_option(s_opt_bytecode, "Optimize the bytecode", "optimize-bytecode", 'p');
+    args_parser.add_option(optimize_bytecode, "Optimize the bytecode (same as -O1)", "optimize-bytecode", 'p');
+    args_parser.add_option(optimization_level, "Bytecode optimization level: 0 (none), 1 (CFG cleanups), or 2 (also dataflow passes and register coalescing)", "optimization-level", 'O', "level");
+    args_parser.add_option(JS::Bytecode::g_jit_enabled, "Compile the bytecode to native code (implies --run-bytecode)", "jit", {});
+    args_parser.add_option(s_dump_ic_stats, "Dump bytecode inline cache statistics on exit", "dump-ic-stats", {});
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
@@ -622,6 +632,22 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_positional_argument(script_paths, "Path to script files", "scripts", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
+    if (optimize_bytecode && !optimization_level.has_value())
+        optimization_level = 1;
+    if (optimization_level.has_value()) {
+        if (*optimization_level >= to_underlying(JS::Bytecode::Interpreter::OptimizationLevel::__Count)) {
+            warnln("Unknown optimization level {}", *optimization_level);
+            return 1;
+        }
+        s_optimization_level = static_cast<JS::Bytecode::Interpreter::OptimizationLevel>(*optimization_level);
+        JS::Bytecode::g_function_optimization_level = s_optimization_level;
+    }
+
+    if (JS::Bytecode::g_jit_enabled)
+        s_run_bytecode = true;
+    else
+        TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction"));
+
     bool syntax_highlight = !disable_syntax_highlight;
 
     AK::set_debug_enabled(!disable_debug_printing);
@@ -912,9 +938,15 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         // We resolve modules as if it is the first file
 
-        if (!TRY(parse_and_run(*interpreter, builder.string_view(), source_name)))
+        if (!TRY(parse_and_run(*interpreter, builder.string_view(), source_name))) {
+            if (s_dump_ic_stats)
+                JS::Bytecode::dump_inline_cache_statistics();
             return 1;
+        }
     }
 
+    if (s_dump_ic_stats)
+        JS::Bytecode::dump_inline_cache_statistics();
+
     return 0;
 }